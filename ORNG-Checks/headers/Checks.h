@@ -0,0 +1,86 @@
+#pragma once
+#include <charconv>
+#include "util/Log.h"
+
+namespace ORNG::Checks {
+	// Positional arguments following the check name, missing ones fall back to the default passed in
+	class Args {
+	public:
+		Args(int argc, char** argv) {
+			for (int i = 0; i < argc; i++) {
+				m_args.emplace_back(argv[i]);
+			}
+		}
+
+		// Arguments that aren't unsigned integers are logged and make the args invalid, the default is returned in their place
+		unsigned GetUnsigned(size_t index, unsigned default_value) {
+			if (index >= m_args.size())
+				return default_value;
+
+			std::string_view arg = m_args[index];
+			unsigned value = 0;
+			auto [p_end, error] = std::from_chars(arg.data(), arg.data() + arg.size(), value);
+			if (error != std::errc{} || p_end != arg.data() + arg.size()) {
+				ORNG_CORE_ERROR("Argument {0} '{1}' isn't an unsigned integer", index, arg);
+				m_valid = false;
+				return default_value;
+			}
+
+			return value;
+		}
+
+		[[nodiscard]] std::string GetString(size_t index, const std::string& default_value) const {
+			return index < m_args.size() ? std::string{ m_args[index] } : default_value;
+		}
+
+		[[nodiscard]] bool IsValid() const noexcept { return m_valid; }
+
+	private:
+		std::vector<std::string_view> m_args;
+		bool m_valid = true;
+	};
+
+	// Every check logs its results and returns false if they're wrong or its arguments are invalid, timings are only reported and never fail a check
+
+	// [num_textures = 500] [num_frames = 2000] [budget_mb = 256]
+	bool SimulateTextureResidency(Args& args);
+
+	// [num_point_lights = 500] [num_spot_lights = 100] [samples_per_axis = 32]
+	bool ValidateLightClusters(Args& args);
+
+	// [num_rays = 1000] [mesh_filepath], generated terrain is used if no .omesh is given
+	bool CheckMeshCollider(Args& args);
+
+	// [grid_size = 64] [entities_per_cell = 16]
+	bool BenchmarkWorldPartition(Args& args);
+
+	// [num_entities = 50000] [num_rounds = 10]
+	bool BenchmarkEntityAllocation(Args& args);
+
+	// [num_entities = 100000]
+	bool BenchmarkSceneFormats(Args& args);
+
+	// [num_entities = 1000]
+	bool BenchmarkEntityDuplication(Args& args);
+
+	// [num_entities = 10000] [num_updates = 1000]
+	bool BenchmarkTransformHierarchy(Args& args);
+
+	// [num_entities = 200000]
+	bool BenchmarkEntityRemoval(Args& args);
+
+	// [num_bodies = 10000]
+	bool BenchmarkPhysicsBodyCreation(Args& args);
+
+	// [uuids_per_thread = 1000000] [num_threads = hardware threads]
+	bool BenchmarkUUIDGeneration(Args& args);
+
+	// [num_rays = 10000]
+	bool BenchmarkPhysicsQueries(Args& args);
+
+	// <recording_filepath> [log_each_step = 0]
+	bool ReplayPhysicsRecording(Args& args);
+
+	// Number of global operator new calls made by this executable so far
+	size_t GetNumAllocations() noexcept;
+}
@@ -0,0 +1,35 @@
+#include "pch/pch.h"
+#include "Checks.h"
+
+namespace {
+	std::atomic<size_t> s_num_allocations = 0;
+}
+
+// Replaces the global allocation functions for this executable so checks can count heap allocations
+// Aligned and sized overloads are left to the defaults, which forward to these or pair with each other
+void* operator new(std::size_t size) {
+	s_num_allocations.fetch_add(1, std::memory_order_relaxed);
+
+	if (void* p = std::malloc(size == 0 ? 1 : size))
+		return p;
+
+	throw std::bad_alloc{};
+}
+
+void* operator new[](std::size_t size) {
+	return operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+	std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+	std::free(p);
+}
+
+namespace ORNG::Checks {
+	size_t GetNumAllocations() noexcept {
+		return s_num_allocations.load(std::memory_order_relaxed);
+	}
+}
@@ -0,0 +1,70 @@
+#include "pch/pch.h"
+#include "Checks.h"
+#include "util/UUID.h"
+#include "util/TimeStep.h"
+
+namespace ORNG::Checks {
+	// Generates uuids_per_thread uuids on each of num_threads threads, first through a mutex guarded mt19937 (what the previous generator needed to be safe
+	// to share between threads) and then through UUIDGenerator
+	// Fails if UUIDGenerator produced any duplicates
+	bool BenchmarkUUIDGeneration(Args& args) {
+		const unsigned uuids_per_thread = args.GetUnsigned(0, 1'000'000);
+		const unsigned num_threads = args.GetUnsigned(1, std::max(std::thread::hardware_concurrency(), 1u));
+		if (!args.IsValid() || uuids_per_thread == 0 || num_threads == 0)
+			return false;
+
+		std::vector<std::vector<uint64_t>> results(num_threads);
+		for (auto& result : results) {
+			result.resize(uuids_per_thread);
+		}
+
+		auto run_threads = [&](auto&& generate) {
+			std::vector<std::thread> threads;
+			threads.reserve(num_threads);
+
+			TimeStep timer{ TimeStep::TimeUnits::MICROSECONDS };
+			for (unsigned t = 0; t < num_threads; t++) {
+				threads.emplace_back([&, t] {
+					for (auto& uuid : results[t]) {
+						uuid = generate();
+					}
+				});
+			}
+
+			for (auto& thread : threads) {
+				thread.join();
+			}
+
+			return timer.GetTimeInterval();
+		};
+
+		std::mutex mutex;
+		std::mt19937 engine{ std::random_device{}() };
+		std::uniform_int_distribution<uint64_t> distribution;
+		const auto locked_us = run_threads([&] {
+			std::scoped_lock lock{ mutex };
+			return distribution(engine);
+		});
+
+		const auto generator_us = run_threads([] { return UUIDGenerator::Next(); });
+
+		std::vector<uint64_t> all_uuids;
+		all_uuids.reserve(static_cast<size_t>(uuids_per_thread) * num_threads);
+		for (auto& result : results) {
+			all_uuids.insert(all_uuids.end(), result.begin(), result.end());
+		}
+		std::ranges::sort(all_uuids);
+		const auto num_duplicates = all_uuids.size() - static_cast<size_t>(std::ranges::distance(all_uuids.begin(), std::ranges::unique(all_uuids).begin()));
+
+		ORNG_CORE_INFO("UUID generation benchmark, {} uuids on each of {} threads", uuids_per_thread, num_threads);
+		ORNG_CORE_INFO("Locked mt19937: {}ms", static_cast<double>(locked_us) / 1000.0);
+		ORNG_CORE_INFO("UUIDGenerator: {}ms", static_cast<double>(generator_us) / 1000.0);
+
+		if (num_duplicates > 0) {
+			ORNG_CORE_ERROR("UUIDGenerator produced {} duplicate uuids", num_duplicates);
+			return false;
+		}
+
+		return true;
+	}
+}
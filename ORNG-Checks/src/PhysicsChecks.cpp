@@ -0,0 +1,304 @@
+#include "pch/pch.h"
+
+#include <Jolt/Jolt.h>
+
+#include "Checks.h"
+#include "scene/Scene.h"
+#include "assets/AssetSerializer.h"
+#include "components/systems/PhysicsSystem.h"
+#include "components/systems/MeshColliderCooker.h"
+#include "components/PhysicsComponent.h"
+#include "rendering/VAO.h"
+#include "util/TimeStep.h"
+#include "Jolt/Physics/Collision/RayCast.h"
+#include "Jolt/Physics/Collision/CastResult.h"
+#include "Jolt/Physics/Collision/Shape/BoxShape.h"
+
+namespace ORNG::Checks {
+	// Rolling terrain of grid_size * grid_size quads, used when no mesh is given so the check can run without any assets
+	static void GenerateTerrain(unsigned grid_size, VertexData3D& output) {
+		constexpr float quad_size = 1.f;
+		const unsigned row = grid_size + 1;
+
+		for (unsigned z = 0; z < row; z++) {
+			for (unsigned x = 0; x < row; x++) {
+				const float fx = static_cast<float>(x) * quad_size;
+				const float fz = static_cast<float>(z) * quad_size;
+				output.positions.insert(output.positions.end(), { fx, glm::sin(fx * 0.3f) * glm::cos(fz * 0.2f) * 4.f, fz });
+			}
+		}
+
+		for (unsigned z = 0; z < grid_size; z++) {
+			for (unsigned x = 0; x < grid_size; x++) {
+				const unsigned i = z * row + x;
+				output.indices.insert(output.indices.end(), { i, i + row, i + 1, i + 1, i + row, i + row + 1 });
+			}
+		}
+	}
+
+	// Casts num_rays rays at a cooked triangle mesh collider, checking each against a brute force intersection with the mesh's own triangles
+	// The collider is loaded or cooked from the .omesh at mesh_filepath, or cooked from generated terrain if no path is given
+	// Fails if any ray disagrees on whether it hit or on the hit distance
+	bool CheckMeshCollider(Args& args) {
+		const unsigned num_rays = args.GetUnsigned(0, 1000);
+		const std::string mesh_filepath = args.GetString(1, "");
+		if (!args.IsValid())
+			return false;
+
+		// Jolt's allocator and types are registered by a loaded PhysicsSystem
+		Scene scene;
+		scene.AddSystem(new PhysicsSystem{ &scene }, 0);
+		scene.LoadScene();
+
+		VertexData3D vertex_data;
+		JPH::Shape::ShapeResult result;
+		TimeStep cook_timer{ TimeStep::TimeUnits::MICROSECONDS };
+		if (mesh_filepath.empty()) {
+			GenerateTerrain(128, vertex_data);
+			result = MeshColliderCooker::Cook(vertex_data.positions, vertex_data.indices, MeshColliderCooker::ColliderType::TRIANGLE_MESH);
+		}
+		else {
+			if (!AssetSerializer::ReadVertexDataFromBinaryFile(mesh_filepath, vertex_data)) {
+				ORNG_CORE_ERROR("Could not read vertex data from '{}'", mesh_filepath);
+				return false;
+			}
+
+			result = MeshColliderCooker::LoadOrCook(mesh_filepath, MeshColliderCooker::ColliderType::TRIANGLE_MESH);
+		}
+		const auto cook_us = cook_timer.GetTimeInterval();
+
+		if (!result.IsValid()) {
+			ORNG_CORE_ERROR("Could not cook the mesh collider: '{}'", result.GetError().c_str());
+			return false;
+		}
+		JPH::RefConst<JPH::Shape> p_shape = result.Get();
+
+		const auto& positions = vertex_data.positions;
+		const auto& indices = vertex_data.indices;
+		const auto vertex = [&](unsigned idx) { return glm::vec3(positions[idx * 3], positions[idx * 3 + 1], positions[idx * 3 + 2]); };
+
+		glm::vec3 min{ std::numeric_limits<float>::max() };
+		glm::vec3 max{ std::numeric_limits<float>::lowest() };
+		for (size_t i = 0; i < positions.size() / 3; i++) {
+			min = glm::min(min, vertex(static_cast<unsigned>(i)));
+			max = glm::max(max, vertex(static_cast<unsigned>(i)));
+		}
+		const glm::vec3 center = (min + max) * 0.5f;
+		const float radius = glm::length(max - min) + 1.f;
+
+		// Two-sided Moller-Trumbore, returns the fraction along dir or FLT_MAX on a miss
+		const auto intersect_triangle = [](glm::vec3 origin, glm::vec3 dir, glm::vec3 v0, glm::vec3 v1, glm::vec3 v2) {
+			const glm::vec3 e1 = v1 - v0;
+			const glm::vec3 e2 = v2 - v0;
+			const glm::vec3 p = glm::cross(dir, e2);
+			const float det = glm::dot(e1, p);
+			if (glm::abs(det) < 1e-12f)
+				return FLT_MAX;
+
+			const float inv_det = 1.f / det;
+			const glm::vec3 t = origin - v0;
+			const float u = glm::dot(t, p) * inv_det;
+			if (u < 0.f || u > 1.f)
+				return FLT_MAX;
+
+			const glm::vec3 q = glm::cross(t, e1);
+			const float v = glm::dot(dir, q) * inv_det;
+			if (v < 0.f || u + v > 1.f)
+				return FLT_MAX;
+
+			const float fraction = glm::dot(e2, q) * inv_det;
+			return fraction >= 0.f && fraction <= 1.f ? fraction : FLT_MAX;
+		};
+
+		std::mt19937 engine{ 1234 };
+		std::uniform_real_distribution<float> distribution{ -1.f, 1.f };
+		unsigned num_hits = 0;
+		unsigned num_mismatches = 0;
+
+		for (unsigned i = 0; i < num_rays; i++) {
+			const glm::vec3 origin = center + glm::normalize(glm::vec3(distribution(engine), distribution(engine), distribution(engine)) + glm::vec3(1e-4f)) * radius;
+			const glm::vec3 target = center + (max - min) * 0.5f * glm::vec3(distribution(engine), distribution(engine), distribution(engine));
+			const glm::vec3 dir = (target - origin) * 2.f;
+
+			float expected = FLT_MAX;
+			for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+				expected = glm::min(expected, intersect_triangle(origin, dir, vertex(indices[t]), vertex(indices[t + 1]), vertex(indices[t + 2])));
+			}
+
+			JPH::RayCast ray{ JPH::Vec3(origin.x, origin.y, origin.z), JPH::Vec3(dir.x, dir.y, dir.z) };
+			JPH::RayCastResult hit;
+			const bool collider_hit = p_shape->CastRay(ray, JPH::SubShapeIDCreator{}, hit);
+			const bool mesh_hit = expected != FLT_MAX;
+
+			num_hits += mesh_hit;
+			// Distances are compared in world units as the fractions are along a ray several times the mesh's size
+			if (collider_hit != mesh_hit || (mesh_hit && glm::abs(hit.mFraction - expected) * glm::length(dir) > 1e-3f))
+				num_mismatches++;
+		}
+
+		ORNG_CORE_INFO("Mesh collider check for '{}', {} triangles, loaded/cooked in {}ms", mesh_filepath.empty() ? "generated terrain" : mesh_filepath,
+			indices.size() / 3, static_cast<double>(cook_us) / 1000.0);
+		ORNG_CORE_INFO("{} rays, {} hit the mesh, {} mismatches between the collider and the mesh", num_rays, num_hits, num_mismatches);
+
+		if (num_hits == 0) {
+			ORNG_CORE_ERROR("No rays hit the mesh, so nothing was compared");
+			return false;
+		}
+
+		if (num_mismatches > 0) {
+			ORNG_CORE_ERROR("{} rays disagreed between the collider and the mesh", num_mismatches);
+			return false;
+		}
+
+		return true;
+	}
+
+	// Adds num_bodies box bodies to a scene's physics system one at a time through the locking body interface (the previous approach),
+	// then creates num_bodies entities with physics components which are added through the batched body queue
+	// Fails if the physics system doesn't hold exactly the expected bodies after each add and remove
+	bool BenchmarkPhysicsBodyCreation(Args& args) {
+		const unsigned num_bodies = args.GetUnsigned(0, 10'000);
+		if (!args.IsValid() || num_bodies == 0)
+			return false;
+
+		Scene scene;
+		auto* p_physics = scene.AddSystem(new PhysicsSystem{ &scene }, 0);
+		scene.LoadScene();
+
+		if (num_bodies > p_physics->GetStats().max_bodies) {
+			ORNG_CORE_ERROR("num_bodies is above the scene's body capacity of {}", p_physics->GetStats().max_bodies);
+			return false;
+		}
+
+		unsigned num_count_mismatches = 0;
+		const auto expect_bodies = [&](const char* stage, unsigned expected) {
+			const unsigned num_bodies_held = p_physics->GetStats().num_bodies;
+			if (num_bodies_held == expected)
+				return;
+
+			ORNG_CORE_ERROR("{} physics bodies after {}, expected {}", num_bodies_held, stage, expected);
+			num_count_mismatches++;
+		};
+
+		auto& body_interface = p_physics->physics_system.GetBodyInterface();
+		JPH::BodyIDVector individual_ids;
+		individual_ids.reserve(num_bodies);
+
+		TimeStep individual_add_timer{ TimeStep::TimeUnits::MICROSECONDS };
+		for (unsigned i = 0; i < num_bodies; i++) {
+			JPH::BodyCreationSettings settings{ new JPH::BoxShape{ JPH::Vec3::sReplicate(0.5f) }, JPH::Vec3(static_cast<float>(i % 100) * 2.f, 0.f, static_cast<float>(i / 100) * 2.f),
+				JPH::Quat::sIdentity(), i % 2 ? JPH::EMotionType::Dynamic : JPH::EMotionType::Static, i % 2 ? Layers::MOVING : Layers::NON_MOVING };
+			individual_ids.push_back(body_interface.CreateAndAddBody(settings, JPH::EActivation::Activate));
+		}
+		const auto individual_add_us = individual_add_timer.GetTimeInterval();
+		expect_bodies("individual adds", num_bodies);
+
+		TimeStep individual_remove_timer{ TimeStep::TimeUnits::MICROSECONDS };
+		for (auto id : individual_ids) {
+			body_interface.RemoveBody(id);
+			body_interface.DestroyBody(id);
+		}
+		const auto individual_remove_us = individual_remove_timer.GetTimeInterval();
+		expect_bodies("individual removes", 0);
+
+		TimeStep batched_add_timer{ TimeStep::TimeUnits::MICROSECONDS };
+		for (unsigned i = 0; i < num_bodies; i++) {
+			auto& ent = scene.CreateEntity("Body");
+			ent.GetComponent<TransformComponent>()->SetAbsolutePosition({ static_cast<float>(i % 100) * 2.f, 0.f, static_cast<float>(i / 100) * 2.f });
+			ent.AddComponent<PhysicsComponent>(false, PhysicsComponent::BOX, i % 2 ? PhysicsComponent::DYNAMIC : PhysicsComponent::STATIC);
+		}
+		p_physics->FlushBodyQueue();
+		const auto batched_add_us = batched_add_timer.GetTimeInterval();
+		expect_bodies("batched adds", num_bodies);
+
+		TimeStep batched_remove_timer{ TimeStep::TimeUnits::MICROSECONDS };
+		scene.ClearAllEntities(false);
+		p_physics->FlushBodyQueue();
+		const auto batched_remove_us = batched_remove_timer.GetTimeInterval();
+		expect_bodies("batched removes", 0);
+
+		ORNG_CORE_INFO("Physics body creation benchmark, {} bodies", num_bodies);
+		ORNG_CORE_INFO("Individual add: {}ms, remove: {}ms", static_cast<double>(individual_add_us) / 1000.0, static_cast<double>(individual_remove_us) / 1000.0);
+		// The batched path also creates the entities and components
+		ORNG_CORE_INFO("Batched add: {}ms, remove: {}ms", static_cast<double>(batched_add_us) / 1000.0, static_cast<double>(batched_remove_us) / 1000.0);
+
+		return num_count_mismatches == 0;
+	}
+
+	// Casts num_rays random rays down at a 100x100 grid of boxes, once a ray at a time and once as a single batch
+	// Fails if no ray hits a box, or if the batched results differ from the individual ones
+	bool BenchmarkPhysicsQueries(Args& args) {
+		const unsigned num_rays = args.GetUnsigned(0, 10'000);
+		if (!args.IsValid() || num_rays == 0)
+			return false;
+
+		Scene scene;
+		auto* p_physics = scene.AddSystem(new PhysicsSystem{ &scene }, 0);
+		scene.LoadScene();
+
+		for (unsigned i = 0; i < 100 * 100; i++) {
+			auto& ent = scene.CreateEntity("Body");
+			ent.GetComponent<TransformComponent>()->SetAbsolutePosition({ static_cast<float>(i % 100) * 2.f, 0.f, static_cast<float>(i / 100) * 2.f });
+			ent.AddComponent<PhysicsComponent>(false, PhysicsComponent::BOX, PhysicsComponent::STATIC);
+		}
+		p_physics->FlushBodyQueue();
+
+		std::mt19937 engine{ 1234 };
+		std::uniform_real_distribution<float> distribution{ 0.f, 200.f };
+		std::vector<PhysicsSystem::RayQuery> queries(num_rays);
+		for (auto& query : queries) {
+			query.origin = { distribution(engine), 10.f, distribution(engine) };
+			query.direction = { 0.f, -1.f, 0.f };
+		}
+
+		std::vector<RaycastResults> individual_results(num_rays);
+		TimeStep individual_timer{ TimeStep::TimeUnits::MICROSECONDS };
+		for (unsigned i = 0; i < num_rays; i++) {
+			p_physics->CastRays(std::span{ &queries[i], 1 }, std::span{ &individual_results[i], 1 });
+		}
+		const auto individual_us = individual_timer.GetTimeInterval();
+
+		std::vector<RaycastResults> batched_results(num_rays);
+		TimeStep batched_timer{ TimeStep::TimeUnits::MICROSECONDS };
+		p_physics->CastRays(queries, batched_results);
+		const auto batched_us = batched_timer.GetTimeInterval();
+
+		unsigned num_hits = 0;
+		unsigned num_mismatches = 0;
+		for (unsigned i = 0; i < num_rays; i++) {
+			num_hits += batched_results[i].hit;
+			num_mismatches += individual_results[i].hit != batched_results[i].hit || individual_results[i].p_entity != batched_results[i].p_entity;
+		}
+
+		ORNG_CORE_INFO("Physics query benchmark, {} rays, {} hits", num_rays, num_hits);
+		ORNG_CORE_INFO("Individual: {}ms, batched: {}ms", static_cast<double>(individual_us) / 1000.0, static_cast<double>(batched_us) / 1000.0);
+
+		if (num_hits == 0) {
+			ORNG_CORE_ERROR("No rays hit a box, so nothing was compared");
+			return false;
+		}
+
+		if (num_mismatches > 0) {
+			ORNG_CORE_ERROR("{} batched ray results differed from casting the ray on its own", num_mismatches);
+			return false;
+		}
+
+		return true;
+	}
+
+	// Replays a recording written by PhysicsSystem::StopRecording in a bare scene, see PhysicsSystem::ReplayFile
+	// Fails if the recording can't be read or replayed, or if the replay diverges from it
+	bool ReplayPhysicsRecording(Args& args) {
+		const std::string filepath = args.GetString(0, "");
+		const bool log_each_step = args.GetUnsigned(1, 0) != 0;
+		if (!args.IsValid())
+			return false;
+
+		if (filepath.empty()) {
+			ORNG_CORE_ERROR("No recording given to replay");
+			return false;
+		}
+
+		return PhysicsSystem::ReplayFile(filepath, log_each_step);
+	}
+}
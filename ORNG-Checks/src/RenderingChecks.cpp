@@ -0,0 +1,183 @@
+#include "pch/pch.h"
+#include "Checks.h"
+#include "rendering/TextureResidencyPolicy.h"
+#include "rendering/LightClusterBuilder.h"
+#include "util/TimeStep.h"
+
+namespace ORNG::Checks {
+	// Drives a TextureResidencyPolicy with synthetic usage, no GL context needed
+	// num_textures are placed along a line the camera travels down over num_frames, each reports a screen size falling off with distance
+	// Stream requests complete a few frames after being issued to mimic upload latency
+	// Fails if committed memory ever exceeds the budget, if evictions aren't issued least recently needed first,
+	// or if a texture still in use is evicted below the resolution it needs
+	bool SimulateTextureResidency(Args& args) {
+		const unsigned num_textures = args.GetUnsigned(0, 500);
+		const unsigned num_frames = args.GetUnsigned(1, 2000);
+		const unsigned budget_mb = args.GetUnsigned(2, 256);
+		if (!args.IsValid() || num_textures == 0 || num_frames == 0)
+			return false;
+
+		constexpr float spacing = 10.f;
+		constexpr uint64_t stream_latency_frames = 3;
+
+		TextureResidencyPolicy policy{ static_cast<size_t>(budget_mb) * 1024ull * 1024ull };
+		std::mt19937 rng{ 0 };
+		std::uniform_int_distribution<uint32_t> size_dist{ 9, 12 };
+
+		size_t full_bytes = 0;
+		for (unsigned i = 0; i < num_textures; i++) {
+			const uint32_t dim = 1u << size_dist(rng);
+			policy.RegisterTexture(i, dim, dim, 4);
+			full_bytes += TextureResidencyPolicy::CalcMipRangeBytes(dim, dim, 4, 0, TextureResidencyPolicy::CalcNumMips(dim, dim));
+		}
+		const size_t base_bytes = policy.GetCommittedBytes();
+		if (base_bytes > policy.GetBudget()) {
+			ORNG_CORE_ERROR("Always resident mips need {0} bytes, more than the {1} byte budget", base_bytes, policy.GetBudget());
+			return false;
+		}
+
+		std::vector<TextureResidencyPolicy::StreamRequest> stream_requests;
+		std::vector<TextureResidencyPolicy::EvictRequest> evict_requests;
+		std::deque<std::pair<uint64_t, uint64_t>> in_flight; // Completion frame, texture id
+
+		size_t peak_bytes = policy.GetCommittedBytes();
+		size_t num_streams = 0;
+		size_t num_evictions = 0;
+		unsigned frames_over_budget = 0;
+		unsigned num_out_of_order_evictions = 0;
+		unsigned num_overtrimmed_evictions = 0;
+		// Frames where a visible texture was below the resolution it needed
+		size_t num_starved_texture_frames = 0;
+
+		const float path_length = static_cast<float>(num_textures) * spacing;
+		TimeStep timer{ TimeStep::TimeUnits::MICROSECONDS };
+		for (uint64_t frame = 1; frame <= num_frames; frame++) {
+			while (!in_flight.empty() && in_flight.front().first <= frame) {
+				policy.OnStreamComplete(in_flight.front().second, true);
+				in_flight.pop_front();
+			}
+
+			const float cam_pos = path_length * static_cast<float>(frame) / static_cast<float>(num_frames);
+			for (unsigned i = 0; i < num_textures; i++) {
+				const float distance = glm::abs(static_cast<float>(i) * spacing - cam_pos);
+				// Only textures in a window around the camera are "visible"
+				if (distance > 200.f)
+					continue;
+
+				policy.ReportScreenSize(i, 4096.f / glm::max(distance, 1.f), frame);
+			}
+
+			policy.Update(frame, stream_requests, evict_requests);
+			for (auto& request : stream_requests) {
+				in_flight.emplace_back(frame + stream_latency_frames, request.texture_id);
+			}
+
+			uint64_t prev_last_needed_frame = 0;
+			for (auto& request : evict_requests) {
+				auto* p_entry = policy.GetEntry(request.texture_id);
+				num_out_of_order_evictions += p_entry->last_needed_frame < prev_last_needed_frame;
+				prev_last_needed_frame = p_entry->last_needed_frame;
+
+				const bool in_use = frame - p_entry->last_needed_frame <= policy.eviction_grace_frames;
+				num_overtrimmed_evictions += in_use && request.new_resident_mip > p_entry->required_mip;
+			}
+
+			num_streams += stream_requests.size();
+			num_evictions += evict_requests.size();
+			peak_bytes = std::max(peak_bytes, policy.GetCommittedBytes());
+			frames_over_budget += policy.GetCommittedBytes() > policy.GetBudget();
+
+			for (unsigned i = 0; i < num_textures; i++) {
+				auto* p_entry = policy.GetEntry(i);
+				num_starved_texture_frames += p_entry->last_needed_frame == frame && p_entry->resident_mip > p_entry->required_mip;
+			}
+		}
+		const auto total_us = timer.GetTimeInterval();
+
+		constexpr double mb = 1024.0 * 1024.0;
+		ORNG_CORE_INFO("Texture residency simulation, {} textures over {} frames, {:.3f}ms per frame", num_textures, num_frames, static_cast<double>(total_us) / 1000.0 / num_frames);
+		ORNG_CORE_INFO("Budget: {:.1f}MB, always resident: {:.1f}MB, fully resident: {:.1f}MB, peak committed: {:.1f}MB", static_cast<double>(budget_mb),
+			static_cast<double>(base_bytes) / mb, static_cast<double>(full_bytes) / mb, static_cast<double>(peak_bytes) / mb);
+		ORNG_CORE_INFO("{} stream requests, {} evictions, {} texture frames below required resolution", num_streams, num_evictions, num_starved_texture_frames);
+
+		// Ordering can't be checked without evictions, so say so rather than passing silently
+		if (num_evictions == 0)
+			ORNG_CORE_WARN("The budget never forced an eviction, lower budget_mb to check eviction order");
+
+		bool passed = true;
+		if (frames_over_budget > 0) {
+			ORNG_CORE_ERROR("Committed memory exceeded the budget on {} frames", frames_over_budget);
+			passed = false;
+		}
+
+		if (num_out_of_order_evictions > 0) {
+			ORNG_CORE_ERROR("{} evictions were issued before a less recently needed texture's", num_out_of_order_evictions);
+			passed = false;
+		}
+
+		if (num_overtrimmed_evictions > 0) {
+			ORNG_CORE_ERROR("{} evictions dropped a texture still in use below its required resolution", num_overtrimmed_evictions);
+			passed = false;
+		}
+
+		return passed;
+	}
+
+	// Checks the CPU light cluster reference against brute-force assignment from a fixed camera, with lights scattered in and around its frustum
+	// Includes lights straddling the near plane, behind the camera, past the far plane and one that never falls off
+	// Fails if a light in range of a sample is missing from the sample's cluster
+	bool ValidateLightClusters(Args& args) {
+		const unsigned num_point_lights = args.GetUnsigned(0, 500);
+		const unsigned num_spot_lights = args.GetUnsigned(1, 100);
+		const unsigned samples_per_axis = args.GetUnsigned(2, 32);
+		if (!args.IsValid() || samples_per_axis == 0)
+			return false;
+
+		constexpr float znear = 0.1f;
+		constexpr float zfar = 300.f;
+		const glm::mat4 view = glm::lookAt(glm::vec3(0.f, 2.f, 0.f), glm::vec3(0.f, 2.f, -1.f), glm::vec3(0.f, 1.f, 0.f));
+		const glm::mat4 projection = glm::perspective(glm::radians(70.f), 16.f / 9.f, znear, zfar);
+
+		std::mt19937 rng{ 0 };
+		std::uniform_real_distribution<float> x_dist{ -200.f, 200.f };
+		std::uniform_real_distribution<float> y_dist{ -50.f, 50.f };
+		// Starts behind the camera and ends past the far plane
+		std::uniform_real_distribution<float> z_dist{ -zfar - 40.f, 40.f };
+		// Radii from roughly 10 to 50 units
+		std::uniform_real_distribution<float> exp_dist{ 0.1f, 2.f };
+
+		const auto generate_lights = [&](unsigned num_lights, std::vector<LightClusterBuilder::Light>& output) {
+			for (unsigned i = 0; i < num_lights; i++) {
+				glm::vec3 pos{ x_dist(rng), y_dist(rng), z_dist(rng) };
+				output.push_back({ pos, LightClusterBuilder::CalculateLightRadius(glm::vec3(1.f), 1.f, 0.1f, exp_dist(rng)) });
+			}
+		};
+
+		std::vector<LightClusterBuilder::Light> point_lights;
+		std::vector<LightClusterBuilder::Light> spot_lights;
+		generate_lights(num_point_lights, point_lights);
+		generate_lights(num_spot_lights, spot_lights);
+
+		// On the camera, so it straddles the near plane
+		point_lights.push_back({ glm::vec3(0.f, 2.f, 0.f), 5.f });
+		// Never falls off so it's in every cluster
+		point_lights.push_back({ glm::vec3(0.f, 2.f, -100.f), LightClusterBuilder::CalculateLightRadius(glm::vec3(1.f), 1.f, 0.f, 0.f) });
+
+		auto result = LightClusterBuilder::Validate(view, projection, znear, zfar, point_lights, spot_lights, samples_per_axis);
+
+		ORNG_CORE_INFO("Light clusters, {0} point lights, {1} spot lights, build: {2:.3f}ms, brute force: {3:.3f}ms", point_lights.size(), spot_lights.size(), result.build_ms, result.brute_force_ms);
+		ORNG_CORE_INFO("{0} samples, average lights per sample: {1:.1f} in cluster, {2:.1f} in range, {3} overflowed clusters", result.num_samples, result.avg_cluster_lights,
+			result.avg_affecting_lights, result.num_overflowed_clusters);
+
+		// Lights missing from overflowed clusters aren't counted, so overflows weaken the check
+		if (result.num_overflowed_clusters > 0)
+			ORNG_CORE_WARN("{0} clusters overflowed, lights missing from them weren't checked", result.num_overflowed_clusters);
+
+		if (result.num_missing > 0) {
+			ORNG_CORE_ERROR("{0} lights in range of a sample were missing from its cluster", result.num_missing);
+			return false;
+		}
+
+		return true;
+	}
+}
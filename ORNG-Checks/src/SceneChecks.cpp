@@ -0,0 +1,601 @@
+#include "pch/pch.h"
+#include "Checks.h"
+#include "scene/Scene.h"
+#include "scene/SceneEntity.h"
+#include "scene/SceneSerializer.h"
+#include "scene/BinarySceneSerializer.h"
+#include "scene/SerializationUtil.h"
+#include "assets/AssetManager.h"
+#include "components/systems/WorldPartitionSystem.h"
+#include "components/Lights.h"
+#include "components/systems/TransformHierarchySystem.h"
+#include "util/TimeStep.h"
+#include "util/ObjectPool.h"
+
+namespace ORNG::Checks {
+	struct PartitionRun {
+		WorldPartitionSystem::Stats peak;
+		unsigned num_frames = 0;
+		long long total_frame_us = 0;
+		long long max_frame_us = 0;
+		// Entities of cells within the load radius of the source that weren't in the scene once streaming settled
+		unsigned num_missing_entities = 0;
+	};
+
+	// Streams a synthetic grid_size * grid_size grid of cells through a separate scene along a diagonal path, then holds the source still
+	// until streaming settles and checks every cell in its load radius was fully instantiated
+	static bool StreamPartition(unsigned grid_size, unsigned entities_per_cell, const std::string& directory, PartitionRun& run) {
+		constexpr float cell_size = 50.f;
+
+		Scene scene;
+		auto* p_partition = scene.AddSystem(new WorldPartitionSystem{ &scene }, 0);
+		scene.LoadScene();
+
+		// The entities have no assets and there's no AssetManager to unload them from
+		p_partition->settings.unload_released_assets = false;
+		// Lifted so only the streaming radii limit residency, the cap would otherwise hide residency growing with the grid
+		p_partition->settings.max_resident_cells = std::numeric_limits<unsigned>::max();
+
+		const auto entities_per_row = static_cast<unsigned>(glm::ceil(glm::sqrt(static_cast<float>(entities_per_cell))));
+		const float spacing = cell_size / static_cast<float>(entities_per_row);
+
+		for (unsigned x = 0; x < grid_size; x++) {
+			for (unsigned z = 0; z < grid_size; z++) {
+				for (unsigned i = 0; i < entities_per_cell; i++) {
+					auto& ent = scene.CreateEntity(std::format("Cell {} {} - {}", x, z, i));
+					glm::vec3 pos{ static_cast<float>(x) * cell_size + static_cast<float>(i % entities_per_row) * spacing, 0.f,
+						static_cast<float>(z) * cell_size + static_cast<float>(i / entities_per_row) * spacing };
+					ent.GetComponent<TransformComponent>()->SetPosition(pos);
+				}
+			}
+		}
+
+		std::filesystem::remove_all(directory);
+		if (!WorldPartitionSystem::BuildPartition(scene, directory, cell_size)) {
+			ORNG_CORE_ERROR("Failed to build a partition in '{}'", directory);
+			return false;
+		}
+
+		scene.ClearAllEntities(false);
+		if (!p_partition->SetPartition(directory)) {
+			ORNG_CORE_ERROR("Failed to load the partition in '{}'", directory);
+			return false;
+		}
+
+		auto& source = scene.CreateEntity("Streaming source");
+		p_partition->AddStreamingSource(source.GetUUID());
+
+		const float path_length = static_cast<float>(grid_size) * cell_size;
+		constexpr float speed = 2.f;
+		run.num_frames = static_cast<unsigned>(path_length / speed);
+
+		for (unsigned frame = 0; frame < run.num_frames; frame++) {
+			float d = static_cast<float>(frame) * speed;
+			source.GetComponent<TransformComponent>()->SetPosition(glm::vec3(d, 0.f, d));
+
+			TimeStep frame_timer{ TimeStep::TimeUnits::MICROSECONDS };
+			scene.Update(1.f / 60.f);
+			auto frame_us = frame_timer.GetTimeInterval();
+
+			run.max_frame_us = std::max(run.max_frame_us, frame_us);
+			run.total_frame_us += frame_us;
+
+			auto stats = p_partition->GetStats();
+			run.peak.num_resident_cells = std::max(run.peak.num_resident_cells, stats.num_resident_cells);
+			run.peak.num_instantiated_cells = std::max(run.peak.num_instantiated_cells, stats.num_instantiated_cells);
+			run.peak.num_streamed_entities = std::max(run.peak.num_streamed_entities, stats.num_streamed_entities);
+		}
+
+		// Reads finish on worker threads and instantiation is budgeted, so updates continue until a frame changes nothing
+		constexpr unsigned max_settle_frames = 1000;
+		WorldPartitionSystem::Stats prev_stats = p_partition->GetStats();
+		for (unsigned frame = 0; frame < max_settle_frames; frame++) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			scene.Update(1.f / 60.f);
+
+			auto stats = p_partition->GetStats();
+			const bool settled = stats.num_reads_in_flight == 0 && stats.num_resident_cells == prev_stats.num_resident_cells &&
+				stats.num_instantiated_cells == prev_stats.num_instantiated_cells && stats.num_streamed_entities == prev_stats.num_streamed_entities;
+
+			prev_stats = stats;
+			if (settled)
+				break;
+		}
+
+		// Same distance as WorldPartitionSystem uses, from the source to the cell's bounds on the XZ plane
+		const glm::vec3 source_pos = source.GetComponent<TransformComponent>()->GetAbsPosition();
+		for (unsigned x = 0; x < grid_size; x++) {
+			for (unsigned z = 0; z < grid_size; z++) {
+				const glm::vec2 centre = (glm::vec2(static_cast<float>(x), static_cast<float>(z)) + 0.5f) * cell_size;
+				const glm::vec2 d = glm::max(glm::abs(glm::vec2(source_pos.x, source_pos.z) - centre) - cell_size * 0.5f, glm::vec2(0.f));
+				if (glm::length(d) > p_partition->settings.load_radius)
+					continue;
+
+				for (unsigned i = 0; i < entities_per_cell; i++) {
+					run.num_missing_entities += scene.GetEntity(std::format("Cell {} {} - {}", x, z, i)) == nullptr;
+				}
+			}
+		}
+
+		ORNG_CORE_INFO("World partition benchmark, {}x{} cells, {} entities per cell, {} frames", grid_size, grid_size, entities_per_cell, run.num_frames);
+		ORNG_CORE_INFO("Average frame: {}ms, slowest frame: {}ms", static_cast<double>(run.total_frame_us) / static_cast<double>(run.num_frames) / 1000.0,
+			static_cast<double>(run.max_frame_us) / 1000.0);
+		ORNG_CORE_INFO("Peak resident cells: {}, peak instantiated cells: {}, peak streamed entities: {}", run.peak.num_resident_cells,
+			run.peak.num_instantiated_cells, run.peak.num_streamed_entities);
+
+		scene.UnloadScene();
+		std::filesystem::remove_all(directory);
+		return true;
+	}
+
+	// Streams a grid half as wide and then the full grid, peak residency depends only on the streaming radii so it should match between them
+	// Fails if a peak is more than a couple of cells higher on the full grid, or if entities are missing after either run settles
+	bool BenchmarkWorldPartition(Args& args) {
+		const unsigned grid_size = args.GetUnsigned(0, 64);
+		const unsigned entities_per_cell = args.GetUnsigned(1, 16);
+		if (!args.IsValid())
+			return false;
+
+		// Half of this is still wider than the area around the source that's kept resident, so both runs reach the same steady state
+		constexpr unsigned min_grid_size = 40;
+		if (grid_size < min_grid_size || entities_per_cell == 0) {
+			ORNG_CORE_ERROR("grid_size must be at least {} and entities_per_cell at least 1", min_grid_size);
+			return false;
+		}
+
+		const std::string directory = (std::filesystem::temp_directory_path() / "orng-partition-check").string();
+
+		PartitionRun half_run;
+		PartitionRun full_run;
+		if (!StreamPartition(grid_size / 2, entities_per_cell, directory, half_run) || !StreamPartition(grid_size, entities_per_cell, directory, full_run))
+			return false;
+
+		bool passed = true;
+		for (auto* p_run : { &half_run, &full_run }) {
+			if (p_run->num_missing_entities > 0) {
+				ORNG_CORE_ERROR("{} entities in range of the source were missing after streaming settled", p_run->num_missing_entities);
+				passed = false;
+			}
+		}
+
+		const auto check_growth = [&](const char* name, size_t half_peak, size_t full_peak, size_t tolerance) {
+			if (full_peak <= half_peak + tolerance)
+				return;
+
+			ORNG_CORE_ERROR("Peak {} grew from {} to {} when the grid doubled in width", name, half_peak, full_peak);
+			passed = false;
+		};
+
+		// How many cells are mid-stream at a given frame depends on read timing, which is allowed for with a couple of cells
+		constexpr unsigned cell_tolerance = 2;
+		check_growth("resident cells", half_run.peak.num_resident_cells, full_run.peak.num_resident_cells, cell_tolerance);
+		check_growth("instantiated cells", half_run.peak.num_instantiated_cells, full_run.peak.num_instantiated_cells, cell_tolerance);
+		check_growth("streamed entities", half_run.peak.num_streamed_entities, full_run.peak.num_streamed_entities, cell_tolerance * entities_per_cell);
+
+		return passed;
+	}
+
+	// Creates and deletes num_entities SceneEntity objects num_rounds times, first allocating each individually with new/delete (the previous approach)
+	// and then from an ObjectPool, counting the heap allocations each path makes. Both construct the same entities on the same registry
+	// Fails if the pool doesn't save one allocation per entity beyond its own slabs, or if either path leaves registry entities behind
+	bool BenchmarkEntityAllocation(Args& args) {
+		const unsigned num_entities = args.GetUnsigned(0, 50'000);
+		const unsigned num_rounds = args.GetUnsigned(1, 10);
+		if (!args.IsValid() || num_entities == 0 || num_rounds == 0)
+			return false;
+
+		Scene scene;
+		scene.LoadScene();
+		auto& reg = scene.GetRegistry();
+
+		std::vector<SceneEntity*> entities;
+		entities.reserve(num_entities);
+		std::vector<entt::entity> handles;
+		handles.reserve(num_entities);
+		unsigned num_leaked_handles = 0;
+
+		// ~SceneEntity destroys its registry entity, checked here so neither path leaks them
+		const auto count_leaked_handles = [&] {
+			num_leaked_handles += static_cast<unsigned>(std::ranges::count_if(handles, [&](entt::entity handle) { return reg.valid(handle); }));
+			handles.clear();
+		};
+
+		const auto run_heap_round = [&] {
+			for (unsigned i = 0; i < num_entities; i++) {
+				entities.push_back(new SceneEntity(&scene, reg.create(), &reg, scene.GetStaticUUID()));
+				handles.push_back(entities.back()->GetEnttHandle());
+			}
+			for (auto* p_entity : entities) {
+				delete p_entity;
+			}
+			entities.clear();
+			count_leaked_handles();
+		};
+
+		// Sizes the registry's storage up front so neither timed path pays for it
+		run_heap_round();
+
+		size_t allocations_before = GetNumAllocations();
+		TimeStep heap_timer{ TimeStep::TimeUnits::MICROSECONDS };
+		for (unsigned round = 0; round < num_rounds; round++) {
+			run_heap_round();
+		}
+		const auto heap_us = heap_timer.GetTimeInterval();
+		const size_t heap_allocations = GetNumAllocations() - allocations_before;
+
+		ObjectPool<SceneEntity> pool;
+		allocations_before = GetNumAllocations();
+		TimeStep pool_timer{ TimeStep::TimeUnits::MICROSECONDS };
+		for (unsigned round = 0; round < num_rounds; round++) {
+			for (unsigned i = 0; i < num_entities; i++) {
+				entities.push_back(pool.New(&scene, reg.create(), &reg, scene.GetStaticUUID()));
+				handles.push_back(entities.back()->GetEnttHandle());
+			}
+			for (auto* p_entity : entities) {
+				pool.Delete(p_entity);
+			}
+			entities.clear();
+			count_leaked_handles();
+		}
+		const auto pool_us = pool_timer.GetTimeInterval();
+		const size_t pool_allocations = GetNumAllocations() - allocations_before;
+
+		const size_t num_created = static_cast<size_t>(num_entities) * num_rounds;
+		ORNG_CORE_INFO("Entity allocation benchmark, {} entities created and deleted {} times", num_entities, num_rounds);
+		ORNG_CORE_INFO("Individual allocation: {}ms, {} heap allocations", static_cast<double>(heap_us) / 1000.0, heap_allocations);
+		ORNG_CORE_INFO("Pooled allocation: {}ms, {} heap allocations, {} slabs", static_cast<double>(pool_us) / 1000.0, pool_allocations, pool.GetNumSlabs());
+
+		bool passed = true;
+		if (num_leaked_handles > 0) {
+			ORNG_CORE_ERROR("{} registry entities were still valid after their SceneEntity was deleted", num_leaked_handles);
+			passed = false;
+		}
+
+		// The pool may allocate its slabs and grow the vector holding them, anything else the paths share
+		if (pool_allocations + num_created > heap_allocations + 2 * pool.GetNumSlabs()) {
+			ORNG_CORE_ERROR("The pool made {} allocations against {} for individual allocation, expected at least {} fewer", pool_allocations, heap_allocations,
+				num_created - std::min(num_created, 2 * pool.GetNumSlabs()));
+			passed = false;
+		}
+
+		return passed;
+	}
+
+	// Compares load time and size of the YAML and binary scene formats on a generated scene with num_entities entities
+	// Entities are given a transform and a mesh component, which is only converted and never resolved so no assets are needed
+	// Fails if the YAML can't be converted or decoded, entities are lost, or converting back to YAML and then to binary again isn't lossless
+	bool BenchmarkSceneFormats(Args& args) {
+		const unsigned num_entities = args.GetUnsigned(0, 100'000);
+		if (!args.IsValid() || num_entities == 0)
+			return false;
+
+		Scene scene;
+		scene.LoadScene();
+		std::string scene_yaml;
+		SceneSerializer::SerializeScene(scene, scene_yaml, true);
+		YAML::Node scene_node = YAML::Load(scene_yaml);
+
+		YAML::Emitter entities_out;
+		entities_out << YAML::BeginSeq;
+		for (unsigned i = 0; i < num_entities; i++) {
+			entities_out << YAML::BeginMap;
+			Out(entities_out, "Entity", static_cast<uint64_t>(i + 1));
+			Out(entities_out, "Name", std::format("Entity {}", i));
+			// Chains of 8 entities so the hierarchy isn't flat
+			Out(entities_out, "ParentID", static_cast<uint64_t>(i % 8 == 0 ? 0 : i));
+
+			Out(entities_out, "TransformComp", YAML::BeginMap);
+			Out(entities_out, "Pos", glm::vec3(i, i * 0.5f, -static_cast<float>(i)));
+			Out(entities_out, "Scale", glm::vec3(1));
+			Out(entities_out, "Orientation", glm::vec3(0, static_cast<float>(i % 360), 0));
+			Out(entities_out, "Absolute", false);
+			entities_out << YAML::EndMap;
+
+			Out(entities_out, "MeshComp", YAML::BeginMap);
+			Out(entities_out, "MeshAssetID", static_cast<uint64_t>(BaseAssetIDs::CUBE_MESH));
+			Out(entities_out, "Materials", YAML::Flow);
+			entities_out << YAML::BeginSeq << static_cast<uint64_t>(BaseAssetIDs::DEFAULT_MATERIAL) << YAML::EndSeq;
+			entities_out << YAML::EndMap;
+
+			entities_out << YAML::EndMap;
+		}
+		entities_out << YAML::EndSeq;
+
+		scene_node["Entities"] = YAML::Load(entities_out.c_str());
+		YAML::Emitter scene_out;
+		scene_out << scene_node;
+		const std::string yaml = scene_out.c_str();
+
+		TimeStep yaml_timer{ TimeStep::TimeUnits::MICROSECONDS };
+		YAML::Node parsed = YAML::Load(yaml);
+		const auto yaml_parse_us = yaml_timer.GetTimeInterval();
+
+		std::vector<std::byte> binary;
+		if (!BinarySceneSerializer::ConvertYAMLToBinary(parsed, binary)) {
+			ORNG_CORE_ERROR("Failed to convert the generated YAML scene to binary");
+			return false;
+		}
+
+		TimeStep binary_timer{ TimeStep::TimeUnits::MICROSECONDS };
+		BinarySceneSerializer::DecodedScene decoded;
+		const bool decoded_ok = BinarySceneSerializer::Decode(binary, decoded);
+		const auto binary_decode_us = binary_timer.GetTimeInterval();
+
+		std::string round_trip;
+		std::vector<std::byte> round_trip_binary;
+		const bool round_trip_ok = BinarySceneSerializer::ConvertBinaryToYAML(binary, round_trip) &&
+			BinarySceneSerializer::ConvertYAMLToBinary(YAML::Load(round_trip), round_trip_binary);
+
+		ORNG_CORE_INFO("Scene format benchmark, {} entities", num_entities);
+		ORNG_CORE_INFO("YAML: {} bytes, parsed in {}ms", yaml.size(), static_cast<double>(yaml_parse_us) / 1000.0);
+		ORNG_CORE_INFO("Binary: {} bytes, decoded in {}ms", binary.size(), static_cast<double>(binary_decode_us) / 1000.0);
+
+		if (!decoded_ok) {
+			ORNG_CORE_ERROR("Failed to decode the converted binary scene");
+			return false;
+		}
+
+		bool passed = true;
+		if (decoded.entities.size() != num_entities) {
+			ORNG_CORE_ERROR("Binary scene holds {} entities, expected {}", decoded.entities.size(), num_entities);
+			passed = false;
+		}
+
+		if (!round_trip_ok || round_trip_binary != binary) {
+			ORNG_CORE_ERROR("Converting the binary scene to YAML and back wasn't lossless");
+			passed = false;
+		}
+
+		return passed;
+	}
+
+	// Number of entities in the original's subtree matched by an entity of the duplicate's subtree with the same position and light colour
+	// Duplicates are named after the entity they were duplicated from, which is how children are paired up
+	static unsigned CountMatchingDuplicates(Scene& scene, SceneEntity& original, SceneEntity& duplicate) {
+		if (original.GetComponent<TransformComponent>()->GetPosition() != duplicate.GetComponent<TransformComponent>()->GetPosition())
+			return 0;
+
+		auto* p_original_light = original.GetComponent<PointLightComponent>();
+		auto* p_duplicate_light = duplicate.GetComponent<PointLightComponent>();
+		if (!p_original_light || !p_duplicate_light || p_original_light->colour != p_duplicate_light->colour)
+			return 0;
+
+		std::unordered_map<std::string, SceneEntity*> duplicate_children;
+		duplicate.ForEachLevelOneChild([&](entt::entity e) {
+			auto* p_child = scene.GetEntity(e);
+			duplicate_children[p_child->GetName()] = p_child;
+		});
+
+		unsigned num_matching = 1;
+		original.ForEachLevelOneChild([&](entt::entity e) {
+			auto* p_child = scene.GetEntity(e);
+			if (auto it = duplicate_children.find(p_child->GetName() + " - Duplicate"); it != duplicate_children.end())
+				num_matching += CountMatchingDuplicates(scene, *p_child, *it->second);
+		});
+
+		return num_matching;
+	}
+
+	// Compares duplicating a generated hierarchy of num_entities entities (4 children per node) through a YAML round trip per entity (the previous approach)
+	// against SceneEntity::Duplicate, entities carry point lights rather than meshes so no assets are needed
+	// Fails if either duplicate doesn't reproduce every entity of the hierarchy with its position and light
+	bool BenchmarkEntityDuplication(Args& args) {
+		const unsigned num_entities = args.GetUnsigned(0, 1000);
+		if (!args.IsValid() || num_entities == 0)
+			return false;
+
+		Scene scene;
+		scene.LoadScene();
+
+		std::vector<SceneEntity*> hierarchy;
+		hierarchy.reserve(num_entities);
+		hierarchy.push_back(&scene.CreateEntity("Duplication benchmark"));
+		hierarchy[0]->AddComponent<PointLightComponent>();
+
+		for (unsigned i = 1; i < num_entities; i++) {
+			auto& ent = scene.CreateEntity(std::format("Node {}", i));
+			ent.SetParent(*hierarchy[(i - 1) / 4]);
+			ent.AddComponent<PointLightComponent>()->colour = glm::vec3(static_cast<float>(i % 8), 1.f, 0.5f);
+			ent.GetComponent<TransformComponent>()->SetPosition(glm::vec3(i % 4, 1, 0));
+			hierarchy.push_back(&ent);
+		}
+
+		TimeStep yaml_timer{ TimeStep::TimeUnits::MICROSECONDS };
+		std::vector<SceneEntity*> yaml_duplicates;
+		yaml_duplicates.reserve(num_entities);
+		for (unsigned i = 0; i < num_entities; i++) {
+			auto& dup = scene.CreateEntity(hierarchy[i]->GetName() + " - Duplicate");
+			if (i != 0)
+				dup.SetParent(*yaml_duplicates[(i - 1) / 4]);
+
+			SceneSerializer::DeserializeEntityFromString(scene, SceneSerializer::SerializeEntityIntoString(*hierarchy[i]), dup, true);
+			yaml_duplicates.push_back(&dup);
+		}
+		const auto yaml_us = yaml_timer.GetTimeInterval();
+
+		TimeStep clone_timer{ TimeStep::TimeUnits::MICROSECONDS };
+		auto& clone = hierarchy[0]->Duplicate();
+		const auto clone_us = clone_timer.GetTimeInterval();
+
+		// Deserialization copies the original's name, renamed after timing so both duplicates are named alike
+		for (unsigned i = 0; i < num_entities; i++) {
+			yaml_duplicates[i]->SetName(hierarchy[i]->GetName() + " - Duplicate");
+		}
+
+		ORNG_CORE_INFO("Duplication benchmark, {} entities", num_entities);
+		ORNG_CORE_INFO("YAML round trip: {}ms", static_cast<double>(yaml_us) / 1000.0);
+		ORNG_CORE_INFO("Component clone: {}ms", static_cast<double>(clone_us) / 1000.0);
+
+		bool passed = true;
+		if (const unsigned num_matching = CountMatchingDuplicates(scene, *hierarchy[0], *yaml_duplicates[0]); num_matching != num_entities) {
+			ORNG_CORE_ERROR("YAML round trip reproduced {} of {} entities", num_matching, num_entities);
+			passed = false;
+		}
+
+		if (const unsigned num_matching = CountMatchingDuplicates(scene, *hierarchy[0], clone); num_matching != num_entities) {
+			ORNG_CORE_ERROR("Component clone reproduced {} of {} entities", num_matching, num_entities);
+			passed = false;
+		}
+
+		return passed;
+	}
+
+	// Hierarchy of num_entities entities with 4 children per node, each offset and rotated from its parent
+	static std::vector<SceneEntity*> BuildTransformHierarchy(Scene& scene, unsigned num_entities) {
+		std::vector<SceneEntity*> hierarchy;
+		hierarchy.reserve(num_entities);
+		hierarchy.push_back(&scene.CreateEntity("Hierarchy benchmark"));
+		for (unsigned i = 1; i < num_entities; i++) {
+			auto& ent = scene.CreateEntity(std::format("Node {}", i));
+			ent.SetParent(*hierarchy[(i - 1) / 4]);
+			auto* p_transform = ent.GetComponent<TransformComponent>();
+			p_transform->SetPosition(glm::vec3(i % 4, 1, 0));
+			p_transform->SetOrientation(glm::vec3(0, static_cast<float>(i % 90), 0));
+			hierarchy.push_back(&ent);
+		}
+
+		return hierarchy;
+	}
+
+	// Moves the root and inner nodes of a num_entities entity hierarchy num_updates times, once on a scene propagating through child links
+	// and once on a scene propagating through the flat hierarchy (Scene::flat_transform_hierarchy), then times a single RebuildWorldTransforms
+	// Fails if any world transform differs between the two scenes after the updates or after the rebuild
+	bool BenchmarkTransformHierarchy(Args& args) {
+		const unsigned num_entities = args.GetUnsigned(0, 10'000);
+		const unsigned num_updates = args.GetUnsigned(1, 1000);
+		if (!args.IsValid() || num_entities == 0 || num_updates == 0)
+			return false;
+
+		Scene linked_scene;
+		linked_scene.AddSystem(new TransformHierarchySystem{ &linked_scene }, 0);
+		linked_scene.LoadScene();
+		auto linked_hierarchy = BuildTransformHierarchy(linked_scene, num_entities);
+
+		Scene flat_scene;
+		auto* p_flat_system = flat_scene.AddSystem(new TransformHierarchySystem{ &flat_scene }, 0);
+		flat_scene.LoadScene();
+		auto flat_hierarchy = BuildTransformHierarchy(flat_scene, num_entities);
+		flat_scene.flat_transform_hierarchy = true;
+		flat_scene.Update(0.f);
+
+		// Alternates between the root (whole hierarchy) and an inner node (a subtree)
+		const auto run = [&](std::vector<SceneEntity*>& hierarchy) {
+			TimeStep timer{ TimeStep::TimeUnits::MICROSECONDS };
+			for (unsigned i = 0; i < num_updates; i++) {
+				auto* p_ent = i % 2 == 0 ? hierarchy[0] : hierarchy[(i * 7919u) % ((num_entities + 3) / 4)];
+				p_ent->GetComponent<TransformComponent>()->SetPosition(glm::vec3(static_cast<float>(i), 0, 0));
+			}
+			return timer.GetTimeInterval();
+		};
+
+		const auto count_mismatches = [&] {
+			unsigned num_mismatches = 0;
+			for (unsigned i = 0; i < num_entities; i++) {
+				const auto& linked = linked_hierarchy[i]->GetComponent<TransformComponent>()->GetMatrix();
+				const auto& flat = flat_hierarchy[i]->GetComponent<TransformComponent>()->GetMatrix();
+				bool matches = true;
+				for (int c = 0; c < 4; c++) {
+					for (int r = 0; r < 4; r++) {
+						matches &= glm::abs(linked[c][r] - flat[c][r]) <= 1e-3f * glm::max(glm::abs(linked[c][r]), 1.f);
+					}
+				}
+				num_mismatches += !matches;
+			}
+			return num_mismatches;
+		};
+
+		const auto linked_us = run(linked_hierarchy);
+		const auto flat_us = run(flat_hierarchy);
+		const unsigned num_update_mismatches = count_mismatches();
+
+		TimeStep rebuild_timer{ TimeStep::TimeUnits::MICROSECONDS };
+		p_flat_system->RebuildWorldTransforms();
+		const auto rebuild_us = rebuild_timer.GetTimeInterval();
+		const unsigned num_rebuild_mismatches = count_mismatches();
+
+		ORNG_CORE_INFO("Transform hierarchy benchmark, {} entities, {} updates", num_entities, num_updates);
+		ORNG_CORE_INFO("Child link propagation: {}ms", static_cast<double>(linked_us) / 1000.0);
+		ORNG_CORE_INFO("Flat hierarchy propagation: {}ms", static_cast<double>(flat_us) / 1000.0);
+		ORNG_CORE_INFO("Single RebuildWorldTransforms: {}ms", static_cast<double>(rebuild_us) / 1000.0);
+
+		bool passed = true;
+		if (num_update_mismatches > 0) {
+			ORNG_CORE_ERROR("{} world transforms differ between child link and flat hierarchy propagation", num_update_mismatches);
+			passed = false;
+		}
+
+		if (num_rebuild_mismatches > 0) {
+			ORNG_CORE_ERROR("{} world transforms differ from child link propagation after RebuildWorldTransforms", num_rebuild_mismatches);
+			passed = false;
+		}
+
+		return passed;
+	}
+
+	// Times name lookups, per-entity deletion and bulk clearing on a scene holding num_entities entities, half of them parented
+	// Fails if a lookup doesn't find an entity that exists, or if entities remain after deleting each one or after clearing
+	bool BenchmarkEntityRemoval(Args& args) {
+		const unsigned num_entities = args.GetUnsigned(0, 200'000);
+		if (!args.IsValid() || num_entities == 0)
+			return false;
+
+		Scene scene;
+		scene.LoadScene();
+
+		const auto populate = [&] {
+			for (unsigned i = 0; i < num_entities; i++) {
+				auto& ent = scene.CreateEntity(std::format("Entity {}", i));
+				// Half the entities are parented so hierarchies are deleted too
+				if (i % 2 == 1)
+					ent.SetParent(*scene.GetEntities()[scene.GetEntities().size() - 2]);
+			}
+		};
+
+		populate();
+
+		constexpr unsigned num_lookups = 10'000;
+		TimeStep lookup_timer{ TimeStep::TimeUnits::MICROSECONDS };
+		unsigned num_found = 0;
+		for (unsigned i = 0; i < num_lookups; i++) {
+			num_found += scene.GetEntity(std::format("Entity {}", (i * 7919u) % num_entities)) != nullptr;
+		}
+		const auto lookup_us = lookup_timer.GetTimeInterval();
+
+		TimeStep delete_timer{ TimeStep::TimeUnits::MICROSECONDS };
+		while (!scene.GetEntities().empty()) {
+			scene.DeleteEntity(scene.GetEntities()[0]);
+		}
+		const auto delete_us = delete_timer.GetTimeInterval();
+		// Deleted entities must also be gone from the name index
+		const bool deleted_found = scene.GetEntity("Entity 0") != nullptr;
+
+		populate();
+		TimeStep clear_timer{ TimeStep::TimeUnits::MICROSECONDS };
+		scene.ClearAllEntities(false);
+		const auto clear_us = clear_timer.GetTimeInterval();
+		const size_t num_remaining = scene.GetEntities().size();
+
+		ORNG_CORE_INFO("Entity removal benchmark, {} entities", num_entities);
+		ORNG_CORE_INFO("{} name lookups: {}ms", num_lookups, static_cast<double>(lookup_us) / 1000.0);
+		ORNG_CORE_INFO("DeleteEntity on each entity: {}ms", static_cast<double>(delete_us) / 1000.0);
+		ORNG_CORE_INFO("ClearAllEntities: {}ms", static_cast<double>(clear_us) / 1000.0);
+
+		bool passed = true;
+		if (num_found != num_lookups) {
+			ORNG_CORE_ERROR("{} of {} name lookups found their entity", num_found, num_lookups);
+			passed = false;
+		}
+
+		if (deleted_found) {
+			ORNG_CORE_ERROR("A deleted entity was still found by name");
+			passed = false;
+		}
+
+		if (num_remaining > 0) {
+			ORNG_CORE_ERROR("{} entities remained after ClearAllEntities", num_remaining);
+			passed = false;
+		}
+
+		return passed;
+	}
+}
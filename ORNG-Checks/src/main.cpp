@@ -0,0 +1,64 @@
+#include "pch/pch.h"
+#include "Checks.h"
+#include "events/EventManager.h"
+
+using namespace ORNG;
+
+namespace {
+	struct Check {
+		std::string_view name;
+		bool(*p_func)(Checks::Args&);
+		std::string_view usage;
+	};
+
+	constexpr std::array s_checks = {
+		Check{ "texture_residency", &Checks::SimulateTextureResidency, "[num_textures = 500] [num_frames = 2000] [budget_mb = 256]" },
+		Check{ "light_clusters", &Checks::ValidateLightClusters, "[num_point_lights = 500] [num_spot_lights = 100] [samples_per_axis = 32]" },
+		Check{ "mesh_collider", &Checks::CheckMeshCollider, "[num_rays = 1000] [mesh_filepath]" },
+		Check{ "world_partition", &Checks::BenchmarkWorldPartition, "[grid_size = 64] [entities_per_cell = 16]" },
+		Check{ "entity_allocation", &Checks::BenchmarkEntityAllocation, "[num_entities = 50000] [num_rounds = 10]" },
+		Check{ "scene_formats", &Checks::BenchmarkSceneFormats, "[num_entities = 100000]" },
+		Check{ "duplication", &Checks::BenchmarkEntityDuplication, "[num_entities = 1000]" },
+		Check{ "transform_hierarchy", &Checks::BenchmarkTransformHierarchy, "[num_entities = 10000] [num_updates = 1000]" },
+		Check{ "entity_removal", &Checks::BenchmarkEntityRemoval, "[num_entities = 200000]" },
+		Check{ "physics_body_creation", &Checks::BenchmarkPhysicsBodyCreation, "[num_bodies = 10000]" },
+		Check{ "uuid_generation", &Checks::BenchmarkUUIDGeneration, "[uuids_per_thread = 1000000] [num_threads = hardware threads]" },
+		Check{ "physics_queries", &Checks::BenchmarkPhysicsQueries, "[num_rays = 10000]" },
+		Check{ "physics_replay", &Checks::ReplayPhysicsRecording, "<recording_filepath> [log_each_step = 0]" },
+	};
+
+	void PrintUsage() {
+		std::cout << "Usage: ORNG_CHECKS <check> [args...]\n";
+		for (const auto& check : s_checks) {
+			std::cout << "  " << check.name << " " << check.usage << "\n";
+		}
+	}
+}
+
+// Runs one check without a window or any engine modules other than events and logging, exits with 0 only if the check passes
+int main(int argc, char** argv) {
+	if (argc < 2) {
+		PrintUsage();
+		return 1;
+	}
+
+	auto it = std::ranges::find(s_checks, std::string_view{ argv[1] }, &Check::name);
+	if (it == s_checks.end()) {
+		std::cout << "Unknown check '" << argv[1] << "'\n";
+		PrintUsage();
+		return 1;
+	}
+
+	Events::EventManager::Init();
+	Logger::Init();
+
+	Checks::Args args{ argc - 2, argv + 2 };
+	const bool passed = it->p_func(args);
+
+	if (passed)
+		ORNG_CORE_INFO("Check '{0}' passed", it->name);
+	else
+		ORNG_CORE_ERROR("Check '{0}' failed", it->name);
+
+	return passed ? 0 : 1;
+}
@@ -6,8 +6,13 @@ namespace ORNG {
 	struct Asset {
 		Asset(const std::string& t_filepath) : filepath(t_filepath) {}
 		Asset(const std::string& t_filepath, uint64_t _uuid) : filepath(t_filepath), uuid(_uuid) {}
-		Asset(const Asset& other) = default;
-		Asset& operator=(const Asset& other) = default;
+		// Reference count isn't copied, copies start unreferenced
+		Asset(const Asset& other) : filepath(other.filepath), uuid(other.uuid) {}
+		Asset& operator=(const Asset& other) {
+			filepath = other.filepath;
+			uuid = other.uuid;
+			return *this;
+		}
 		virtual ~Asset() = default;
 
 		bool operator == (const std::string& t_filepath) {
@@ -18,6 +23,9 @@ namespace ORNG {
 			return ORNG::PathEqualTo(path, filepath);
 		}
 
+		// Number of AssetHandles currently pointing to this asset
+		[[nodiscard]] uint32_t GetRefCount() const noexcept { return m_ref_count.load(std::memory_order_relaxed); }
+
 		std::string filepath = "";
 		UUID<uint64_t> uuid{};
 
@@ -26,5 +34,10 @@ namespace ORNG {
 			s.object(uuid);
 			s.text1b(filepath, filepath.size());
 		}
+	private:
+		friend class AssetHandleBase;
+
+		// Mutable so handles to const assets can still reference them, atomic as handles can be created on loading threads
+		mutable std::atomic<uint32_t> m_ref_count = 0;
 	};
 }
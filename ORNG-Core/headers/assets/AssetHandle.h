@@ -0,0 +1,70 @@
+#pragma once
+#include "assets/Asset.h"
+
+namespace ORNG {
+	class AssetHandleBase {
+	protected:
+		// Defined in AssetManager.cpp, referencing an unloaded asset causes it to be reloaded
+		static void AddRef(const Asset* p_asset);
+		static void RemoveRef(const Asset* p_asset);
+	};
+
+	// Non-owning pointer to an asset that keeps the asset counted as referenced
+	// Assets with no handles pointing to them can be unloaded with AssetManager::UnloadUnreferencedAssets
+	// Converts implicitly to and from T* so it can be used in place of a raw asset pointer
+	template<std::derived_from<Asset> T>
+	class AssetHandle : public AssetHandleBase {
+	public:
+		AssetHandle() = default;
+		AssetHandle(std::nullptr_t) {}
+
+		AssetHandle(T* p_asset) : mp_asset(p_asset) {
+			if (mp_asset)
+				AddRef(mp_asset);
+		}
+
+		AssetHandle(const AssetHandle& other) : AssetHandle(other.mp_asset) {}
+
+		AssetHandle(AssetHandle&& other) noexcept : mp_asset(std::exchange(other.mp_asset, nullptr)) {}
+
+		~AssetHandle() {
+			Reset();
+		}
+
+		AssetHandle& operator=(const AssetHandle& other) {
+			if (other.mp_asset == mp_asset)
+				return *this;
+
+			Reset();
+			mp_asset = other.mp_asset;
+			if (mp_asset)
+				AddRef(mp_asset);
+
+			return *this;
+		}
+
+		AssetHandle& operator=(AssetHandle&& other) noexcept {
+			if (this == &other)
+				return *this;
+
+			Reset();
+			mp_asset = std::exchange(other.mp_asset, nullptr);
+			return *this;
+		}
+
+		void Reset() {
+			if (mp_asset)
+				RemoveRef(mp_asset);
+
+			mp_asset = nullptr;
+		}
+
+		[[nodiscard]] T* Get() const noexcept { return mp_asset; }
+
+		operator T*() const noexcept { return mp_asset; }
+		T* operator->() const noexcept { return mp_asset; }
+		T& operator*() const noexcept { return *mp_asset; }
+	private:
+		T* mp_asset = nullptr;
+	};
+}
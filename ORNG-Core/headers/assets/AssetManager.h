@@ -4,6 +4,7 @@
 #include "scripting/ScriptingEngine.h"
 #include "assets/SoundAsset.h"
 #include "AssetSerializer.h"
+#include "rendering/TextureStreamer.h"
 
 namespace ORNG {
 	enum class BaseAssetIDs {
@@ -30,6 +31,7 @@ namespace ORNG {
 		friend class EditorLayer;
 		friend class SceneSerializer;
 		friend class AssetSerializer;
+		friend class AssetHandleBase;
 
 		static AssetManager& Get() {
 			DEBUG_ASSERT(mp_instance);
@@ -40,6 +42,10 @@ namespace ORNG {
 			return Get().serializer;
 		}
 
+		static TextureStreamer& GetTextureStreamer() {
+			return Get().texture_streamer;
+		}
+
 		static void Init(AssetManager* p_instance = nullptr) { 
 			if (p_instance) {
 				ASSERT(!mp_instance);
@@ -59,18 +65,23 @@ namespace ORNG {
 			ASSERT(!Get().m_assets.contains(uuid));
 
 			Get().m_assets[uuid] = static_cast<Asset*>(p_asset);
+			Get().AddToIndices(p_asset);
 			HandleAssetAddition(p_asset);
 			return p_asset;
 		}
 
+		// Returns all non-base assets whose most-derived type is exactly T
 		template<std::derived_from<Asset> T>
 		static std::vector<T*> GetView() {
 			std::vector<T*> vec;
-			for (auto [uuid, p_asset] : Get().m_assets) {
-				if (T* p_typed_asset = dynamic_cast<T*>(p_asset); p_typed_asset &&
-					uuid >= static_cast<uint64_t>(BaseAssetIDs::NUM_BASE_ASSETS)
-					)
-					vec.push_back(p_typed_asset);
+			auto it = Get().m_typed_storage.find(std::type_index{ typeid(T) });
+			if (it == Get().m_typed_storage.end())
+				return vec;
+
+			vec.reserve(it->second.assets.size());
+			for (Asset* p_asset : it->second.assets) {
+				if (p_asset->uuid() >= static_cast<uint64_t>(BaseAssetIDs::NUM_BASE_ASSETS))
+					vec.push_back(static_cast<T*>(p_asset));
 			}
 
 			return vec;
@@ -79,8 +90,8 @@ namespace ORNG {
 		// Returns ptr to asset or nullptr if no valid asset was found
 		template<std::derived_from<Asset> T>
 		static T* GetAsset(uint64_t uuid) {
-			if (Get().m_assets.contains(uuid)) {
-				if (auto* p_asset = dynamic_cast<T*>(Get().m_assets[uuid]))
+			if (auto it = Get().m_assets.find(uuid); it != Get().m_assets.end()) {
+				if (auto* p_asset = dynamic_cast<T*>(it->second))
 					return p_asset;
 				else {
 					ORNG_CORE_TRACE("GetAsset failed, asset with uuid '{0}' doesn't match type provided", uuid);
@@ -94,15 +105,19 @@ namespace ORNG {
 		}
 
 		// Returns ptr to asset or nullptr if no valid asset was found
+		// Paths are compared the same way as ORNG::PathEqualTo, assets with paths modified after being added must be updated through SetAssetFilepath
 		template<std::derived_from<Asset> T>
 		static T* GetAsset(const std::string& filepath) {
-			for (auto& [uuid, p_asset] : Get().m_assets) {
-				if (p_asset->PathEqualTo(filepath)) {
-					if (auto* p_typed_asset = dynamic_cast<T*>(p_asset))
-						return p_typed_asset;
-					else {
-						ORNG_CORE_TRACE("GetAsset failed, asset with path '{0}' doesn't match type provided", filepath);
-					}
+			auto [begin, end] = Get().m_path_index.equal_range(NormalisePathForLookup(filepath));
+			for (auto it = begin; it != end; it++) {
+				auto asset_it = Get().m_assets.find(it->second);
+				if (asset_it == Get().m_assets.end())
+					continue;
+
+				if (auto* p_typed_asset = dynamic_cast<T*>(asset_it->second))
+					return p_typed_asset;
+				else {
+					ORNG_CORE_TRACE("GetAsset failed, asset with path '{0}' doesn't match type provided", filepath);
 				}
 			}
 
@@ -111,10 +126,12 @@ namespace ORNG {
 		}
 
 		static bool DeleteAsset(uint64_t uuid) {
-			if (Get().m_assets.contains(uuid)) {
-				HandleAssetDeletion(Get().m_assets[uuid]);
-				delete Get().m_assets[uuid];
+			if (auto it = Get().m_assets.find(uuid); it != Get().m_assets.end()) {
+				Asset* p_asset = it->second;
+				HandleAssetDeletion(p_asset);
+				Get().RemoveFromIndices(p_asset);
 				Get().m_assets.erase(uuid);
+				delete p_asset;
 
 				return true;
 			}
@@ -126,18 +143,32 @@ namespace ORNG {
 
 		template <std::derived_from<Asset> T>
 		static bool DeleteAsset(T* p_asset) {
-			for (auto [key, val] : Get().m_assets) {
-				if (val == dynamic_cast<T*>(p_asset)) {
-					HandleAssetDeletion(val);
-					delete p_asset;
-					Get().m_assets.erase(key);
-					return true;
-				}
-			}
+			auto it = Get().m_assets.find(p_asset->uuid());
+			if (it == Get().m_assets.end() || it->second != static_cast<Asset*>(p_asset))
+				return false;
 
-			return false;
+			return DeleteAsset(p_asset->uuid());
 		}
 
+		// Use instead of writing to Asset::filepath directly once an asset has been added, keeps path lookups valid
+		static void SetAssetFilepath(Asset* p_asset, const std::string& filepath);
+
+		// Must be called after the working directory is changed for good (e.g a project being made active), path lookups strip the cached working directory
+		// Temporary changes that are reverted before any lookup don't need this
+		static void OnWorkingDirectoryChanged();
+
+		// Must be called after a material's texture slots are changed once it has been added, keeps the texture->material dependency index valid
+		static void OnMaterialTexturesChanged(Material* p_material);
+
+		// Unloads the GPU and CPU data of every mesh, texture and material that no AssetHandle references, call after switching scenes
+		// Unloaded assets stay registered and are reloaded from their files as soon as a handle references them again
+		static void UnloadUnreferencedAssets();
+
+		// Assets kept alive are never unloaded by UnloadUnreferencedAssets, base assets are always kept alive
+		static void SetKeepAlive(uint64_t uuid, bool keep_alive);
+
+		[[nodiscard]] static bool IsUnloaded(uint64_t uuid);
+
 		// Clears all assets including base replacement ones
 		static void Shutdown() {
 			Get().IOnShutdown();
@@ -150,6 +181,9 @@ namespace ORNG {
 		inline static void ClearAll() { Get().IClearAll(); }
 
 		AssetSerializer serializer{ *this };
+
+		// Handles mip residency of textures loaded from project files
+		TextureStreamer texture_streamer;
 	private:
 		void I_Init();
 		void IOnShutdown();
@@ -160,6 +194,31 @@ namespace ORNG {
 
 		static void OnTextureDelete(Texture2D* p_tex);
 
+		// Called by AssetHandleBase when the first handle to an asset is created
+		void OnAssetReferenced(const Asset* p_asset);
+
+		// Returns false if the asset can't be unloaded as there is no file to reload it from
+		bool UnloadAsset(Asset* p_asset);
+		void ReloadAsset(Asset* p_asset);
+
+		// Reloads unloaded assets that were referenced from threads other than the main thread
+		void ProcessReloadQueue();
+
+		// Strips separators and dots and the working directory prefix so lookups match ORNG::PathEqualTo
+		static std::string NormalisePathForLookup(const std::string& filepath);
+
+		void AddToIndices(Asset* p_asset);
+		void RemoveFromIndices(Asset* p_asset);
+
+		void IndexPath(Asset* p_asset);
+		void UnindexPath(uint64_t uuid);
+
+		void IndexMaterialDependencies(Material* p_material);
+		void UnindexMaterialDependencies(uint64_t material_uuid);
+
+		// Removes a base asset from all lookups without deleting it, base assets are owned by the unique_ptrs below
+		void RemoveBaseAssetEntry(BaseAssetIDs id);
+
 		static void DispatchAssetEvent(Events::AssetEventType type, uint8_t* data_payload);
 
 		void IClearAll();
@@ -185,7 +244,44 @@ namespace ORNG {
 
 		std::unordered_map<uint64_t, Asset*> m_assets;
 
-		// Update listener checks if futures in m_mesh_loading_queue are ready and handles them if they are
+		struct AssetTypeStorage {
+			std::vector<Asset*> assets;
+			// Key = asset uuid, Val = index into assets, used for swap-removal
+			std::unordered_map<uint64_t, size_t> indices;
+		};
+
+		// Dense storage per most-derived asset type
+		std::unordered_map<std::type_index, AssetTypeStorage> m_typed_storage;
+
+		// Key = normalised filepath, Val = asset uuid
+		std::unordered_multimap<std::string, uint64_t> m_path_index;
+
+		// Working directory with the same characters stripped as NormalisePathForLookup, refreshed by OnWorkingDirectoryChanged
+		std::string m_normalised_cwd;
+
+		// Key = asset uuid, Val = the normalised filepath the asset is indexed under
+		std::unordered_map<uint64_t, std::string> m_indexed_paths;
+
+		// Key = texture uuid, Val = uuids of materials using it
+		std::unordered_map<uint64_t, std::unordered_set<uint64_t>> m_texture_dependents;
+
+		// Key = material uuid, Val = uuids of textures it was indexed as using
+		std::unordered_map<uint64_t, std::vector<uint64_t>> m_material_dependencies;
+
+		// Uuids of assets whose data has been unloaded, guarded by m_unload_mutex as handles can reference assets from loading threads
+		std::unordered_set<uint64_t> m_unloaded_assets;
+		std::vector<uint64_t> m_reload_queue;
+		std::mutex m_unload_mutex;
+
+		std::unordered_set<uint64_t> m_keep_alive_assets;
+
+		// Key = material uuid, Val = uuids of the textures in each texture slot, restored when the material is reloaded
+		std::unordered_map<uint64_t, std::array<uint64_t, Material::NUM_TEXTURE_SLOTS>> m_unloaded_material_textures;
+
+		// Assets referenced on this thread are reloaded immediately, others are queued
+		std::thread::id m_main_thread_id;
+
+		// Update listener checks if futures in m_mesh_loading_queue are ready and handles them if they are, also drives texture streaming
 		Events::EventListener<Events::EngineCoreEvent> m_update_listener;
 	};
 }
@@ -93,6 +93,13 @@ namespace ORNG {
 
 		bool TryFetchRawTextureData(Texture2D& tex, std::vector<std::byte>& output);
 
+		// Reads the encoded image data out of a serialized .otex file without touching GL state, safe to call from worker threads
+		static bool ReadRawTextureDataFromBinaryFile(const std::string& filepath, std::vector<std::byte>& output);
+
+		// Reads the vertex data out of a serialized .omesh file without touching GL state, safe to call from worker threads
+		// Indices are offset by their submesh's base vertex so they index the whole vertex array
+		static bool ReadVertexDataFromBinaryFile(const std::string& filepath, VertexData3D& output);
+
 		bool TryFetchRawSoundData(SoundAsset& sound, std::vector<std::byte>& output);
 
 		void SerializeAssets();
@@ -117,6 +124,7 @@ namespace ORNG {
 		void LoadSceneAssetFromFile(const std::string& rel_path);
 
 		void SerializeSceneAsset(class SceneAsset& scene_asset, BufferSerializer& ser);
+		void SerializePrefabAsset(struct Prefab& prefab, BufferSerializer& ser);
 		template<typename SerializerType>
 		void SerializeTexture2D(Texture2D& tex, SerializerType& ser, std::byte* p_data = nullptr, size_t data_size = 0) {
 			std::vector<std::byte> texture_data;
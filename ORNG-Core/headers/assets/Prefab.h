@@ -4,6 +4,8 @@
 #include <bitsery/traits/string.h>
 
 namespace ORNG {
+	struct PrefabTemplate;
+
 	struct Prefab final : public Asset {
 		explicit Prefab(const std::string& _filepath) : Asset(_filepath) {}
 		~Prefab() override = default;
@@ -14,6 +16,12 @@ namespace ORNG {
 		// Parsed version of "serialized_content"
 		YAML::Node node;
 
+		// Prefab contents in the BinarySceneSerializer format, used instead of node if not empty (packaged builds)
+		std::vector<std::byte> binary_data;
+
+		// Compiled on first instantiation, mutable as it's purely a cache of the data above
+		mutable std::shared_ptr<const PrefabTemplate> p_compiled_template = nullptr;
+
 		template<typename S>
 		void serialize(S& s) {
 			s.text1b(serialized_content, 10000);
@@ -12,6 +12,9 @@ namespace ORNG {
 
         // Scene contents
         YAML::Node node;
+
+        // Scene contents in the BinarySceneSerializer format, used instead of node if not empty (packaged builds)
+        std::vector<std::byte> binary_data;
     };
 }
 
@@ -17,6 +17,7 @@ namespace ORNG {
 		friend class AudioSystem;
 		friend class EditorLayer;
 		friend class SceneSerializer;
+		friend class BinarySceneSerializer;
 	public:
 		AudioComponent() = delete;
 		explicit AudioComponent(SceneEntity* p_entity);
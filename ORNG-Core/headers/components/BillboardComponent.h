@@ -1,8 +1,8 @@
 #pragma once
 #include "Component.h"
+#include "rendering/Material.h"
 
 namespace ORNG {
-	class Material;
 	class MeshInstanceGroup;
 
 	struct BillboardComponent final : public Component {
@@ -12,7 +12,7 @@ namespace ORNG {
 		BillboardComponent(const BillboardComponent&) = default;
 		~BillboardComponent() override = default;
 
-		Material* p_material = nullptr;
+		AssetHandle<Material> p_material = nullptr;
 	private:
 		MeshInstanceGroup* mp_instance_group = nullptr;
 	};
@@ -34,9 +34,14 @@ namespace ORNG {
 		RelationshipComponent(SceneEntity* p_entity) : Component(p_entity) {}
 		int num_children = 0;
 		entt::entity first{ entt::null };
+		// Kept so children can be appended without walking the sibling list
+		entt::entity last{ entt::null };
 		entt::entity prev{ entt::null };
 		entt::entity next{ entt::null };
 		entt::entity parent{ entt::null };
+		// Bumped whenever this entity is reparented or renamed, or gains, loses or renames a child
+		// EntityNodeRef caches stay valid while none of the entities along their path change this
+		uint64_t generation = 0;
 	};
 }
 #endif
@@ -7,4 +7,6 @@
 #include "components/systems/SceneUBOSystem.h"
 #include "components/systems/ScriptSystem.h"
 #include "components/systems/SpotlightSystem.h"
+#include "components/systems/TextureStreamingSystem.h"
 #include "components/systems/TransformHierarchySystem.h"
+#include "components/systems/WorldPartitionSystem.h"
@@ -1,5 +1,6 @@
 #pragma once
 #include "components/Component.h"
+#include "rendering/Material.h"
 
 namespace ORNG {
 	struct DecalComponent final : public Component {
@@ -9,6 +10,6 @@ namespace ORNG {
 		~DecalComponent() override = default;
 
 		// If p_material is nullptr, this decal will not be rendered
-		class Material* p_material = nullptr;
+		AssetHandle<Material> p_material = nullptr;
 	};
 }
@@ -33,6 +33,7 @@ namespace ORNG {
 	public:
 		friend class EditorLayer;
 		friend class SceneSerializer;
+		friend class BinarySceneSerializer;
 		friend class SpotlightSystem;
 		explicit SpotLightComponent(SceneEntity* p_entity);
 		void SetLightDirection(float i, float j, float k);
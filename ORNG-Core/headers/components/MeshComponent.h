@@ -22,7 +22,8 @@ namespace ORNG {
 		MeshComponent(SceneEntity* p_entity, MeshAsset* p_asset);
 		MeshComponent(SceneEntity* p_entity, MeshAsset* p_asset, std::vector<const Material*>&& materials);
 		MeshComponent(const MeshComponent& other) = delete;
-		~MeshComponent() override = default;
+		// Defined out of line as MeshAsset is incomplete here
+		~MeshComponent() override;
 
 
 		void SetMaterialID(unsigned int index, const Material* p_material);
@@ -33,10 +34,10 @@ namespace ORNG {
 
 	private:
 		void DispatchUpdateEvent();
-		std::vector<const Material*> m_materials;
+		std::vector<AssetHandle<const Material>> m_materials;
 
 		MeshInstanceGroup* mp_instance_group = nullptr;
-		MeshAsset* mp_mesh_asset = nullptr;
+		AssetHandle<MeshAsset> mp_mesh_asset = nullptr;
 	};
 
 }
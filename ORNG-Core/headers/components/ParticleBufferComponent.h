@@ -8,6 +8,7 @@ namespace ORNG {
 	class ParticleBufferComponent final : public Component {
 		friend class ParticleSystem;
 		friend class SceneSerializer;
+		friend class BinarySceneSerializer;
 		friend class EditorLayer;
 	public:
 		explicit ParticleBufferComponent(SceneEntity* p_entity) : Component(p_entity) {}
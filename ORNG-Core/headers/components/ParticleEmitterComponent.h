@@ -1,21 +1,20 @@
 #pragma once
 #include "Component.h"
 #include "util/Interpolators.h"
+#include "rendering/MeshAsset.h"
 
 namespace ORNG {
-	class Material;
-	class MeshAsset;
 
 	struct ParticleMeshResources : public Component {
 		explicit ParticleMeshResources(SceneEntity* p_entity) : Component(p_entity) {}
 
-		MeshAsset* p_mesh = nullptr;
-		std::vector<const Material*> materials;
+		AssetHandle<MeshAsset> p_mesh = nullptr;
+		std::vector<AssetHandle<const Material>> materials;
 	};
 
 	struct ParticleBillboardResources : public Component {
 		explicit ParticleBillboardResources(SceneEntity* p_entity) : Component(p_entity) {}
-		Material* p_material = nullptr;
+		AssetHandle<const Material> p_material = nullptr;
 	};
 
 
@@ -24,6 +23,7 @@ namespace ORNG {
 		friend class EditorLayer;
 		friend class SceneRenderer;
 		friend class SceneSerializer;
+		friend class BinarySceneSerializer;
 	public:
 		enum EmitterType : uint8_t {
 			BILLBOARD,
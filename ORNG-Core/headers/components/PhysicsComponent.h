@@ -5,6 +5,7 @@
 
 #include "Component.h"
 #include "Jolt/Physics/Body/Body.h"
+#include "Jolt/Physics/Character/CharacterVirtual.h"
 #include "util/UUID.h"
 
 namespace ORNG {
@@ -32,8 +33,8 @@ namespace ORNG {
 			DYNAMIC = 1,
 		};
 
-		PhysicsComponent(SceneEntity* p_entity, bool is_trigger, GeometryType geom_type, RigidBodyType body_type) : Component(p_entity),
-			m_geometry_type(geom_type), m_body_type(body_type), m_is_trigger(is_trigger) {}
+		PhysicsComponent(SceneEntity* p_entity, bool is_trigger, GeometryType geom_type, RigidBodyType body_type, JPH::ObjectLayer layer = JPH::cObjectLayerInvalid) : Component(p_entity),
+			m_geometry_type(geom_type), m_body_type(body_type), m_is_trigger(is_trigger), m_layer(layer) {}
 
 		void UpdateGeometry(GeometryType type);
 		void SetBodyType(RigidBodyType type);
@@ -41,6 +42,10 @@ namespace ORNG {
 		void SetTrigger(bool is_trigger);
 		bool IsTrigger() const { return m_is_trigger; }
 
+		// Index into the scene's PhysicsSystem::Settings::layers, the default (Layers::AUTO) picks a layer from the body type
+		void SetLayer(JPH::ObjectLayer layer);
+		JPH::ObjectLayer GetLayer() const { return m_layer; }
+
 		JPH::BodyID body_id{};
 	private:
 		void SendUpdateEvent();
@@ -48,17 +53,74 @@ namespace ORNG {
 		GeometryType m_geometry_type = BOX;
 		RigidBodyType m_body_type = STATIC;
 		bool m_is_trigger = false;
+		JPH::ObjectLayer m_layer = JPH::cObjectLayerInvalid;
 	};
 
+	// Kinematic capsule moved by the PhysicsSystem each step, it slides along geometry, climbs steps and can't walk up slopes steeper than max_slope_degrees
+	// The entity's position is at the bottom of the capsule, only its position is driven by the character
+	// Characters collide with and push physics bodies, but never collide with other characters and pass straight through them
 	struct CharacterControllerComponent : public Component {
 	public:
 		friend class PhysicsSystem;
+		friend class EditorLayer;
 		explicit CharacterControllerComponent(SceneEntity* p_entity) : Component(p_entity) {}
+		CharacterControllerComponent(SceneEntity* p_entity, float radius, float height) : Component(p_entity), m_radius(radius), m_height(height) {}
 		CharacterControllerComponent& operator=(const CharacterControllerComponent&) = default;
 		CharacterControllerComponent(const CharacterControllerComponent&) = default;
 		~CharacterControllerComponent() override = default;
 
+		enum class GroundState : uint8_t {
+			// On ground that isn't too steep to stand on
+			ON_GROUND,
+			ON_STEEP_GROUND,
+			// Touching something, but it isn't supporting the character
+			NOT_SUPPORTED,
+			IN_AIR
+		};
+
+		// Total height includes both caps, so it's clamped to at least 2 * radius, recreates the character
+		void SetShape(float radius, float height);
+		float GetRadius() const { return m_radius; }
+		float GetHeight() const { return m_height; }
+
+		// Applied on the next step if the character is on walkable ground, dropped otherwise
+		void Jump(float speed) { m_jump_speed = speed; }
+
+		GroundState GetGroundState() const { return m_ground_state; }
+		bool IsGrounded() const { return m_ground_state == GroundState::ON_GROUND; }
+		glm::vec3 GetGroundNormal() const { return m_ground_normal; }
+
+		// Velocity the character moved at in the last step
+		glm::vec3 GetVelocity() const { return m_velocity; }
+
+		// World space velocity the character tries to move at, only the horizontal part is used
+		glm::vec3 desired_velocity{ 0.f };
+
+		float max_slope_degrees = 45.f;
+
+		// Steps up to this high are climbed when walked into
+		float step_height = 0.4f;
+
+		// Keeps the character on the ground when walking down slopes or steps up to this deep, rather than it briefly becoming airborne
+		float stick_to_floor_distance = 0.5f;
+
+		bool use_gravity = true;
+
+		// True if the character's position changed in the last update
 		bool moved_during_frame = false;
+	private:
+		void SendUpdateEvent();
+
+		JPH::Ref<JPH::CharacterVirtual> mp_character = nullptr;
+
+		float m_radius = 0.3f;
+		float m_height = 1.8f;
+
+		float m_jump_speed = 0.f;
+
+		GroundState m_ground_state = GroundState::IN_AIR;
+		glm::vec3 m_ground_normal{ 0.f, 1.f, 0.f };
+		glm::vec3 m_velocity{ 0.f };
 	};
 
 	enum JointEventType {
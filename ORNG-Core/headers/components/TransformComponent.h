@@ -26,6 +26,7 @@ namespace ORNG {
 	{
 	public:
 		friend class SceneSerializer;
+		friend class BinarySceneSerializer;
 		friend class EditorLayer;
 		friend class SceneEntity;
 		friend class TransformHierarchySystem;
@@ -77,6 +78,24 @@ namespace ORNG {
 			}
 		}
 
+		// Sets the absolute position and orientation with a single matrix rebuild, dispatching one POSE update instead of a translation and orientation update
+		// If dispatch_event is false no event is dispatched, the caller is then responsible for notifying listeners e.g through EventManager::DispatchEventBatch
+		void SetAbsolutePose(glm::vec3 pos, glm::quat q, bool dispatch_event = true) {
+			if (m_parent_handle == entt::null) {
+				m_orientation = q;
+			} else {
+				glm::quat parent_accumulated = m_abs_orientation * glm::inverse(m_orientation);
+				m_orientation = glm::inverse(parent_accumulated) * q;
+			}
+
+			if (GetParent() && !m_is_absolute)
+				m_pos = glm::inverse(GetParent()->GetMatrix()) * glm::vec4(pos, 1.0);
+			else
+				m_pos = pos;
+
+			RebuildMatrix(UpdateType::POSE, dispatch_event);
+		}
+
 		[[nodiscard]] glm::quat GetAbsOrientationQuat() const noexcept {
 			return m_abs_orientation;
 		}
@@ -132,6 +151,16 @@ namespace ORNG {
 
 		const glm::mat4x4& GetMatrix() const { return m_transform; }
 
+		// Matrix renderers should draw with, the same as GetMatrix() unless a render matrix has been set, e.g by physics interpolation
+		// Any rebuild of the transform clears the render matrix
+		const glm::mat4x4& GetRenderMatrix() const { return m_has_render_transform ? m_render_transform : m_transform; }
+
+		[[nodiscard]] bool HasRenderMatrix() const noexcept { return m_has_render_transform; }
+
+		// Both dispatch a RENDER update, which only renderers and the transform hierarchy respond to
+		void SetRenderMatrix(const glm::mat4& matrix, bool dispatch_event = true);
+		void ClearRenderMatrix(bool dispatch_event = true);
+
 		glm::vec3 GetPosition() const { return m_pos; }
 		glm::vec3 GetScale() const { return m_scale; }
 		glm::vec3 GetOrientation() const { return glm::degrees(glm::eulerAngles(m_orientation)); }
@@ -141,14 +170,18 @@ namespace ORNG {
 			TRANSLATION = 0,
 			SCALE = 1,
 			ORIENTATION = 2,
-			ALL = 3
+			ALL = 3,
+			// Translation and orientation, scale unchanged
+			POSE = 4,
+			// Only the render matrix changed
+			RENDER = 5
 		};
 
 		glm::vec3 forward = { 0.0, 0.0, -1.0 };
 		glm::vec3 up = { 0.0, 1.0, 0.0 };
 		glm::vec3 right = { 1.0, 0.0, 0.0 };
 
-		void RebuildMatrix(UpdateType type);
+		void RebuildMatrix(UpdateType type, bool dispatch_event = true);
 	private:
 		void UpdateAbsTransforms();
 
@@ -158,6 +191,9 @@ namespace ORNG {
 
 		glm::mat4 m_transform = glm::mat4(1);
 
+		glm::mat4 m_render_transform = glm::mat4(1);
+		bool m_has_render_transform = false;
+
 		glm::vec3 m_scale = glm::vec3(1.0f, 1.0f, 1.0f);
 		glm::quat m_orientation = {1.f, 0.f, 0.f, 0.f};
 		glm::vec3 m_pos = glm::vec3(0.0f, 0.0f, 0.0f);
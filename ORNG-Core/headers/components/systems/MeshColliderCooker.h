@@ -0,0 +1,67 @@
+#pragma once
+
+#include <Jolt/Jolt.h>
+#include "Jolt/Physics/Collision/Shape/Shape.h"
+
+namespace ORNG {
+	class MeshAsset;
+
+	// Builds collision shapes from mesh vertex data, triangle meshes for static bodies and convex hulls for dynamic bodies (Jolt can't simulate dynamic triangle meshes)
+	// Shapes are cooked on worker threads and saved next to the .omesh with Jolt's binary shape serialization, so each mesh is only cooked once
+	// and later loads restore the saved shape (including its BVH) instead of rebuilding it
+	class MeshColliderCooker {
+	public:
+		enum class ColliderType : uint8_t {
+			TRIANGLE_MESH,
+			CONVEX_HULL
+		};
+
+		struct CookedShape {
+			uint64_t mesh_uuid = 0;
+			ColliderType type = ColliderType::TRIANGLE_MESH;
+			JPH::RefConst<JPH::Shape> p_shape = nullptr;
+		};
+
+		// Waits for any cooks in flight, as do Clear and the destructor
+		MeshColliderCooker() = default;
+		~MeshColliderCooker() = default;
+
+		// Starts loading or cooking the shape on a worker thread if it isn't already, the shape is handed out by Poll once it's ready
+		// Returns false if the shape couldn't be cooked, failures are logged once and not retried until Clear or Invalidate is called
+		bool RequestShape(const MeshAsset& mesh, ColliderType type);
+
+		// Appends shapes that finished since the last call to output, returns true if any cook finished (including failures)
+		// The cooker keeps no reference to handed out shapes, requesting one again later reloads it from its cooked file
+		bool Poll(std::vector<CookedShape>& output);
+
+		void Clear();
+
+		// Forgets the mesh's shapes and failures so the next request reloads or recooks them, called when the mesh is reloaded or deleted
+		void Invalidate(uint64_t mesh_uuid);
+
+		// Loads the cooked shape for the .omesh at mesh_filepath, cooking and saving it first if it's missing or older than the mesh
+		// Safe to call from worker threads
+		static JPH::Shape::ShapeResult LoadOrCook(const std::string& mesh_filepath, ColliderType type);
+
+		// positions are tightly packed xyz, indices are absolute (not relative to a submesh)
+		static JPH::Shape::ShapeResult Cook(const std::vector<float>& positions, const std::vector<unsigned>& indices, ColliderType type);
+
+		static std::string GetCookedFilepath(const std::string& mesh_filepath, ColliderType type);
+
+	private:
+		static bool SaveShape(const JPH::Shape& shape, const std::string& filepath);
+		static JPH::Shape::ShapeResult LoadShape(const std::string& filepath);
+
+		// Bumped whenever the cooking settings change so old cooked files are rebuilt
+		static constexpr uint32_t COOKED_SHAPE_VERSION = 1;
+
+		struct Entry {
+			std::future<JPH::Shape::ShapeResult> future;
+			bool failed = false;
+		};
+
+		// Key = (mesh uuid, collider type), only in flight and failed requests have an entry
+		std::map<std::pair<uint64_t, ColliderType>, Entry> m_entries;
+		unsigned m_num_in_flight = 0;
+	};
+}
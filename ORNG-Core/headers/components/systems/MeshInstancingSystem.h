@@ -27,6 +27,9 @@ namespace ORNG {
 		void OnMeshAssetDeletion(MeshAsset* p_asset);
 		void OnMaterialDeletion(Material* p_material);
 
+		void AddGroupToMaterialLookup(MeshInstanceGroup* p_group);
+		void RemoveGroupFromMaterialLookup(MeshInstanceGroup* p_group);
+
 		void SortBillboardIntoInstanceGroup(BillboardComponent* p_comp);
 		void OnBillboardAdd(BillboardComponent* p_comp);
 		void OnBillboardRemove(BillboardComponent* p_comp);
@@ -38,6 +41,15 @@ namespace ORNG {
 		Events::ECS_EventListener<BillboardComponent> m_billboard_listener;
 		std::vector<MeshInstanceGroup*> m_billboard_instance_groups;
 
+		// Handles mesh and material asset deletion
+		Events::EventListener<Events::AssetEvent> m_asset_listener;
+
+		// Key = material, Val = mesh instance groups using it in any submesh slot
+		std::unordered_map<const Material*, std::unordered_set<MeshInstanceGroup*>> m_material_group_lookup;
+
+		// Key = material, Val = the billboard instance group using it, billboard groups only ever have one material
+		std::unordered_map<const Material*, MeshInstanceGroup*> m_billboard_group_lookup;
+
 		entt::connection m_mesh_add_connection;
 		entt::connection m_mesh_remove_connection;
 		entt::connection m_billboard_add_connection;
@@ -4,12 +4,16 @@
 #include <Jolt/Core/TempAllocator.h>
 #include <Jolt/Core/JobSystemThreadPool.h>
 #include <Jolt/Physics/Collision/BroadPhase/BroadPhaseLayer.h>
+#include <Jolt/Physics/Collision/ContactListener.h>
+#include <Jolt/Physics/StateRecorderImpl.h>
 
 #include "components/systems/ComponentSystem.h"
 #include "scene/SceneSerializer.h"
 #include "components/PhysicsComponent.h"
+#include "components/systems/MeshColliderCooker.h"
 #include "components/TransformComponent.h"
 #include "Jolt/Physics/PhysicsSystem.h"
+#include "Jolt/Physics/Body/BodyCreationSettings.h"
 #include "scripting/ScriptShared.h"
 
 namespace YAML {
@@ -19,53 +23,68 @@ namespace YAML {
 
 namespace ORNG {
 	// Layer that objects can be in, determines which other objects it can collide with
-	// Typically you at least want to have 1 layer for moving bodies and 1 layer for static bodies, but you can have more
-	// layers if you want. E.g. you could have a layer for high detail collision (which is not used by the physics simulation
-	// but only if you do collision testing).
+	// These are the default layers, the full set and which pairs collide are defined per scene through PhysicsSystem::Settings::layers
 	namespace Layers {
 		static constexpr JPH::ObjectLayer NON_MOVING = 0;
 		static constexpr JPH::ObjectLayer MOVING = 1;
-		static constexpr JPH::ObjectLayer NUM_LAYERS = 2;
+		static constexpr JPH::ObjectLayer DEBRIS = 2;
+		static constexpr JPH::ObjectLayer TRIGGER = 3;
+		static constexpr JPH::ObjectLayer CHARACTER = 4;
+		static constexpr JPH::ObjectLayer NUM_DEFAULT_LAYERS = 5;
+
+		// Collision masks are 32 bit
+		static constexpr JPH::ObjectLayer MAX_LAYERS = 32;
+
+		// Layer of a PhysicsComponent that hasn't been assigned one, resolved from its body type
+		static constexpr JPH::ObjectLayer AUTO = JPH::cObjectLayerInvalid;
+	};
+
+	// Each object layer is mapped to one of these, the broadphase keeps a separate tree per layer
+	// so layers that are queried or collide differently (e.g lots of sleeping debris) don't slow each other down
+	namespace BroadPhaseLayers {
+		static constexpr JPH::BroadPhaseLayer NON_MOVING{0};
+		static constexpr JPH::BroadPhaseLayer MOVING{1};
+		static constexpr JPH::BroadPhaseLayer DEBRIS{2};
+		static constexpr JPH::BroadPhaseLayer TRIGGER{3};
+		static constexpr JPH::BroadPhaseLayer CHARACTER{4};
+		static constexpr unsigned NUM_LAYERS = 5;
+	};
+
+	struct CollisionLayer {
+		std::string name;
+
+		// Index of the broadphase layer in BroadPhaseLayers
+		uint8_t broad_phase_layer = 0;
+
+		// Bit n is set if this layer collides with layer n
+		uint32_t collision_mask = 0;
 	};
 
+	// One layer for each of the default layers in Layers
+	[[nodiscard]] std::vector<CollisionLayer> GetDefaultCollisionLayers();
+
 	/// Class that determines if two object layers can collide
 	class ObjectLayerPairFilterImpl : public JPH::ObjectLayerPairFilter {
 	public:
 		bool ShouldCollide(JPH::ObjectLayer inObject1, JPH::ObjectLayer inObject2) const override {
-			switch (inObject1) {
-				case Layers::NON_MOVING:
-					return inObject2 == Layers::MOVING; // Non moving only collides with moving
-				case Layers::MOVING:
-					return true; // Moving collides with everything
-				default:
-					JPH_ASSERT(false);
-					return false;
-			}
+			JPH_ASSERT(inObject1 < Layers::MAX_LAYERS && inObject2 < Layers::MAX_LAYERS);
+			return (m_collision_masks[inObject1] >> inObject2) & 1u;
 		}
-	};
 
-	namespace BroadPhaseLayers {
-		static constexpr JPH::BroadPhaseLayer NON_MOVING{0};
-		static constexpr JPH::BroadPhaseLayer MOVING{1};
-		static constexpr unsigned NUM_LAYERS = 2;
+		// Masks must be symmetric
+		std::array<uint32_t, Layers::MAX_LAYERS> m_collision_masks{};
 	};
 
 	// BroadPhaseLayerInterface implementation
 	// This defines a mapping between object and broadphase layers.
 	class BPLayerInterfaceImpl final : public JPH::BroadPhaseLayerInterface {
 	public:
-		BPLayerInterfaceImpl() {
-			// Create a mapping table from object to broad phase layer
-			mObjectToBroadPhase[Layers::NON_MOVING] = BroadPhaseLayers::NON_MOVING;
-			mObjectToBroadPhase[Layers::MOVING] = BroadPhaseLayers::MOVING;
-		}
-
 		JPH::uint GetNumBroadPhaseLayers() const override {
 			return BroadPhaseLayers::NUM_LAYERS;
 		}
 
 		JPH::BroadPhaseLayer GetBroadPhaseLayer(JPH::ObjectLayer inLayer) const override {
-			JPH_ASSERT(inLayer < Layers::NUM_LAYERS);
+			JPH_ASSERT(inLayer < Layers::MAX_LAYERS);
 			return mObjectToBroadPhase[inLayer];
 		}
 
@@ -74,38 +93,142 @@ namespace ORNG {
 			switch (static_cast<JPH::BroadPhaseLayer::Type>(inLayer)) {
 				case static_cast<JPH::BroadPhaseLayer::Type>(BroadPhaseLayers::NON_MOVING):	return "NON_MOVING";
 				case static_cast<JPH::BroadPhaseLayer::Type>(BroadPhaseLayers::MOVING):		return "MOVING";
+				case static_cast<JPH::BroadPhaseLayer::Type>(BroadPhaseLayers::DEBRIS):		return "DEBRIS";
+				case static_cast<JPH::BroadPhaseLayer::Type>(BroadPhaseLayers::TRIGGER):		return "TRIGGER";
+				case static_cast<JPH::BroadPhaseLayer::Type>(BroadPhaseLayers::CHARACTER):	return "CHARACTER";
 				default: JPH_ASSERT(false); return "INVALID";
 			}
 		}
 #endif // JPH_EXTERNAL_PROFILE || JPH_PROFILE_ENABLED
 
-	private:
-		JPH::BroadPhaseLayer mObjectToBroadPhase[Layers::NUM_LAYERS];
+		// Can't change while any bodies are in the broadphase
+		std::array<JPH::BroadPhaseLayer, Layers::MAX_LAYERS> mObjectToBroadPhase{};
 	};
 
 	class ObjectVsBroadPhaseLayerFilterImpl : public JPH::ObjectVsBroadPhaseLayerFilter {
 	public:
 		bool ShouldCollide(JPH::ObjectLayer inLayer1, JPH::BroadPhaseLayer inLayer2) const override {
-			switch (inLayer1) {
-				case Layers::NON_MOVING:
-					return inLayer2 == BroadPhaseLayers::MOVING; // Non-moving only collides with moving
-				case Layers::MOVING:
-					return true; // Moving collides with everything
-				default:
-					JPH_ASSERT(false);
-					return false;
-			}
+			JPH_ASSERT(inLayer1 < Layers::MAX_LAYERS);
+			return (m_broad_phase_masks[inLayer1] >> static_cast<JPH::BroadPhaseLayer::Type>(inLayer2)) & 1u;
 		}
+
+		// Bit n is set if the layer collides with any object layer in broadphase layer n
+		std::array<uint8_t, Layers::MAX_LAYERS> m_broad_phase_masks{};
 	};
 
+	// Forwards to a TempAllocatorImpl while recording the most memory it has had in use at once
+	class TrackingTempAllocator final : public JPH::TempAllocator {
+	public:
+		explicit TrackingTempAllocator(JPH::uint size) : m_allocator(size), m_capacity(size) {}
 
+		void* Allocate(JPH::uint inSize) override {
+			m_usage += JPH::AlignUp(inSize, JPH_RVECTOR_ALIGNMENT);
+			m_high_water_mark = std::max(m_high_water_mark, m_usage);
+			return m_allocator.Allocate(inSize);
+		}
 
+		void Free(void* inAddress, JPH::uint inSize) override {
+			m_usage -= JPH::AlignUp(inSize, JPH_RVECTOR_ALIGNMENT);
+			m_allocator.Free(inAddress, inSize);
+		}
 
+		[[nodiscard]] size_t GetCapacity() const noexcept { return m_capacity; }
+		[[nodiscard]] size_t GetHighWaterMark() const noexcept { return m_high_water_mark; }
 
-	struct PhysicsCollisionEvent : public Events::Event {
-		PhysicsCollisionEvent(SceneEntity* _p0, SceneEntity* _p1) : p0(_p0), p1(_p1) {}
+	private:
+		JPH::TempAllocatorImpl m_allocator;
+		size_t m_capacity = 0;
+		size_t m_usage = 0;
+		size_t m_high_water_mark = 0;
+	};
+
+	enum class ContactEventType : uint8_t {
+		ADDED,
+		PERSISTED,
+		REMOVED
+	};
+
+	// Records contacts reported while the simulation steps, callbacks come from the job threads
+	// Each thread claims its own buffer on its first contact of a step so recording never takes a lock, buffers keep their capacity between steps
+	class ContactRecorder final : public JPH::ContactListener {
+	public:
+		struct Record {
+			// Raw JPH::BodyID values, body_a is always the lower of the pair so both orders of a pair sort together
+			uint32_t body_a;
+			uint32_t body_b;
+			ContactEventType type;
+
+			auto operator<=>(const Record&) const = default;
+		};
+
+		ContactRecorder() : m_buffers(std::max(std::thread::hardware_concurrency(), 1u)) {}
+
+		void OnContactAdded(const JPH::Body& body1, const JPH::Body& body2, const JPH::ContactManifold&, JPH::ContactSettings&) override {
+			Push(body1.GetID(), body2.GetID(), ContactEventType::ADDED);
+			m_num_contacts.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		void OnContactPersisted(const JPH::Body& body1, const JPH::Body& body2, const JPH::ContactManifold&, JPH::ContactSettings&) override {
+			Push(body1.GetID(), body2.GetID(), ContactEventType::PERSISTED);
+			m_num_contacts.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		// The bodies may already be destroyed here, so only their ids are recorded
+		void OnContactRemoved(const JPH::SubShapeIDPair& pair) override {
+			Push(pair.GetBody1ID(), pair.GetBody2ID(), ContactEventType::REMOVED);
+		}
+
+		// Moves every record since the last call into output sorted by pair then type, there's a record per sub shape pair so a body pair can have several of each type
+		// Must not be called while the simulation is stepping
+		void Collect(std::vector<Record>& output);
+
+		void ResetContactCount() { m_num_contacts.store(0, std::memory_order_relaxed); }
+		[[nodiscard]] unsigned GetContactCount() const { return m_num_contacts.load(std::memory_order_relaxed); }
+
+	private:
+		void Push(JPH::BodyID body1, JPH::BodyID body2, ContactEventType type);
+
+		// Aligned so threads writing to neighbouring buffers don't share cache lines
+		struct alignas(64) ThreadBuffer {
+			std::vector<Record> records;
+		};
+
+		std::vector<ThreadBuffer> m_buffers;
+		std::atomic<unsigned> m_num_claimed_buffers = 0;
+
+		// Changed by each Collect so threads claim a fresh buffer, unique across recorders so a thread's claim can't carry over to another recorder
+		uint32_t m_generation = NextGeneration();
+		static uint32_t NextGeneration();
+
+		// Used by threads beyond the number of buffers, e.g if the job system has more threads than cores
+		std::mutex m_overflow_mutex;
+		std::vector<Record> m_overflow;
+
+		std::atomic<unsigned> m_num_contacts = 0;
+	};
+
+	struct PhysicsContact {
 		SceneEntity* p0 = nullptr;
 		SceneEntity* p1 = nullptr;
+
+		JPH::BodyID body0;
+		JPH::BodyID body1;
+
+		ContactEventType type = ContactEventType::ADDED;
+
+		// At least one of the bodies is a trigger, triggers don't collide so their contacts are only ever enter/leave events
+		bool is_trigger = false;
+	};
+
+	// Dispatched once per update with the contacts of every step taken, in step order, before scripts are notified
+	// Each pair appears at most once per step, a pair is ADDED when its first sub shapes start touching and only REMOVED once none of them are touching anymore,
+	// even when that happens steps later
+	// Pairs where either body was removed from the simulation during the step are dropped
+	// Listeners must not delete entities while handling this, as later contacts in the batch may reference them
+	struct PhysicsCollisionEvent : public Events::Event {
+		PhysicsCollisionEvent(Scene* _p_scene, std::span<const PhysicsContact> _contacts) : p_scene(_p_scene), contacts(_contacts) {}
+		Scene* p_scene = nullptr;
+		std::span<const PhysicsContact> contacts;
 	};
 
 	class PhysicsSystem : public ComponentSystem {
@@ -126,33 +249,397 @@ namespace ORNG {
 			VEHICLE
 		};
 
+		// Adds bodies created since the last flush to the broadphase in one batch and removes queued bodies, called at the start of each update
+		// Call directly if bodies created this frame need to be visible to queries straight away
+		void FlushBodyQueue();
+
+		enum class InterpolationMode : uint8_t {
+			// Transforms are rendered at the pose of the latest step
+			NONE,
+			// Render transforms are blended between the last two steps, so they trail the simulation by up to one step
+			INTERPOLATE,
+			// Render transforms are projected forward from the last two steps, no latency but mispredicts on collisions
+			EXTRAPOLATE
+		};
+
+		// Length of each simulation step in seconds, the simulation always advances by whole steps
 		float step_size = 1.f / 90.f;
+
+		// Upper bound on steps taken in one update, time beyond this is dropped so a slow frame can't cause a spiral of ever slower frames
+		unsigned max_substeps = 4;
+
+		// How the render matrices of active bodies are produced between steps, see TransformComponent::GetRenderMatrix
+		InterpolationMode interpolation_mode = InterpolationMode::INTERPOLATE;
+
+		struct Settings {
+			// Maximum number of bodies in the simulation, including bodies queued for addition
+			unsigned max_bodies = 65'536;
+
+			// Maximum number of overlapping body pairs queued for the narrowphase at once, overflowing this is slower but not an error
+			unsigned max_body_pairs = 65'536;
+
+			// Contacts found past this limit are ignored, letting bodies interpenetrate
+			unsigned max_contact_constraints = 32'768;
+
+			// Scratch memory used by each step, compare against Stats::temp_allocator_high_water_mark when tuning
+			unsigned temp_allocator_size = 32 * 1024 * 1024;
+
+			// Indexed by object layer, masks are made symmetric when applied so a pair collides if either layer lists the other
+			std::vector<CollisionLayer> layers = GetDefaultCollisionLayers();
+		};
+
+		struct Stats {
+			unsigned num_bodies = 0;
+			unsigned num_active_bodies = 0;
+			unsigned max_bodies = 0;
+
+			// Contacts added or persisted in the last step
+			unsigned num_contacts = 0;
+
+			// Contact events delivered in the last update that stepped, after de-duplication
+			unsigned num_contact_events = 0;
+
+			unsigned num_characters = 0;
+
+			size_t temp_allocator_high_water_mark = 0;
+			size_t temp_allocator_size = 0;
+		};
+
+		[[nodiscard]] const Settings& GetSettings() const noexcept { return m_settings; }
+
+		// Capacity or broadphase layer changes reinitialize the simulation, which recreates every body
+		// Returns false and changes nothing if the settings are invalid
+		bool ApplySettings(const Settings& settings);
+
+		// Takes effect immediately, no bodies are recreated
+		void SetLayersCollide(JPH::ObjectLayer layer_a, JPH::ObjectLayer layer_b, bool collide);
+
+		// Returns Layers::AUTO if no layer is named name
+		[[nodiscard]] JPH::ObjectLayer GetLayer(const std::string& name) const;
+
+		[[nodiscard]] Stats GetStats() const;
+
+		/*
+			Batched queries
+			Each batch is split across the job system and waited on, results are written straight into the caller's spans so nothing is allocated
+			Queries only see bodies already in the broadphase (see FlushBodyQueue) and must not be made while the simulation is stepping
+		*/
+
+		struct RayQuery {
+			glm::vec3 origin{ 0.f };
+			// Doesn't need to be normalized
+			glm::vec3 direction{ 0.f, 0.f, -1.f };
+			float max_distance = 100.f;
+
+			// Bit n set to hit bodies in object layer n
+			uint32_t layer_mask = std::numeric_limits<uint32_t>::max();
+			// e.g the body of the entity casting the ray
+			JPH::BodyID ignored_body;
+		};
+
+		enum class QueryShapeType : uint8_t {
+			SPHERE,
+			BOX
+		};
+
+		struct ShapeQuery {
+			QueryShapeType type = QueryShapeType::SPHERE;
+			// x is the radius of a sphere
+			glm::vec3 half_extents{ 0.5f };
+
+			glm::vec3 position{ 0.f };
+			glm::quat orientation{ 1.f, 0.f, 0.f, 0.f };
+
+			uint32_t layer_mask = std::numeric_limits<uint32_t>::max();
+			JPH::BodyID ignored_body;
+		};
+
+		struct ShapeCastQuery {
+			ShapeQuery shape;
+			glm::vec3 direction{ 0.f, 0.f, -1.f };
+			float max_distance = 100.f;
+		};
+
+		// Closest hit along each ray, results.size() must equal queries.size()
+		void CastRays(std::span<const RayQuery> queries, std::span<RaycastResults> results) const;
+
+		// Closest hit along each sweep, hit_dist is how far the shape travelled before touching
+		void CastShapes(std::span<const ShapeCastQuery> queries, std::span<RaycastResults> results) const;
+
+		// Entities overlapping each shape, query i writes up to max_hits_per_query entities to hits[i * max_hits_per_query] onwards and their count to hit_counts[i]
+		void OverlapShapes(std::span<const ShapeQuery> queries, std::span<SceneEntity*> hits, unsigned max_hits_per_query, std::span<unsigned> hit_counts) const;
+
+		/*
+			Snapshots and recordings
+			A recording holds the settings, bodies and full state of the simulation when it began, followed by every step and every change made through this class
+			(bodies added/removed, poses set from transforms, shape swaps, broadphase rebuilds, layer changes) in the order they happened
+			Replaying it re-simulates the same steps without the scene, e.g for profiling a pathological frame in isolation
+			Characters aren't recorded, so recording is refused while any exist, changes made to physics_system directly aren't recorded either and make replays diverge
+		*/
+
+		// Full simulation state of every body and contact, restoring requires the same bodies to exist as when it was saved
+		void SaveState(std::vector<std::byte>& output) const;
+		bool RestoreState(std::span<const std::byte> state);
+
+		// Flushes queued bodies and snapshots the simulation, any recording in progress is discarded
+		// Returns false without recording if the scene has characters, as their movement and the impulses they apply to bodies can't be replayed
+		// A character added while recording discards the recording
+		bool StartRecording();
+
+		// Writes the recording to output, returns false if nothing was being recorded
+		// Recording also stops if the simulation is reinitialized by ApplySettings
+		bool StopRecording(std::vector<std::byte>& output);
+
+		[[nodiscard]] bool IsRecording() const noexcept { return mp_recording != nullptr; }
+
+		// Replaces every body in the simulation with the recording's, meant for a scene made only to replay in as components in the scene lose their bodies
+		// Returns false if the recording is invalid, the simulation is left empty
+		bool LoadReplay(std::span<const std::byte> recording);
+
+		struct ReplayStep {
+			float time_ms = 0.f;
+			unsigned num_active_bodies = 0;
+			// Poses of active bodies after the step didn't match the recording
+			bool diverged = false;
+		};
+
+		// Applies the changes recorded before the next step then takes it, returns false once the recording has no more steps
+		bool StepReplay(ReplayStep& result);
+
+		[[nodiscard]] unsigned GetNumReplaySteps() const noexcept { return mp_replay ? mp_replay->num_steps : 0; }
+
+		// Replays a recording file in a bare scene holding only a PhysicsSystem, then logs the total, average and slowest step times and any divergence
+		// log_each_step also logs every step's time as it's taken, returns false if the file couldn't be read or replayed or the replay diverged
+		static bool ReplayFile(const std::string& filepath, bool log_each_step = false);
+
 		JPH::PhysicsSystem physics_system;
 	private:
-		void Tick();
+		enum class RecordedCommand : uint8_t {
+			STEP,
+			ADD_BODIES,
+			REMOVE_BODIES,
+			SET_POSE,
+			SET_SHAPE,
+			OPTIMIZE_BROAD_PHASE,
+			SET_LAYER_MASKS,
+			END
+		};
+
+		struct Recording {
+			JPH::StateRecorderImpl stream;
+
+			// Shapes, materials and group filters shared between bodies are only written once
+			JPH::Shape::ShapeToIDMap shape_ids;
+			JPH::Shape::MaterialToIDMap material_ids;
+			JPH::BodyCreationSettings::GroupFilterToIDMap group_filter_ids;
+
+			// The maps above are keyed by address, so every object written is kept alive until the recording stops,
+			// otherwise a new object allocated where a freed one was would be written as a reference to the freed one. Indexed by id
+			std::vector<JPH::RefConst<JPH::Shape>> shapes;
+			std::vector<JPH::RefConst<JPH::PhysicsMaterial>> materials;
+			std::vector<JPH::RefConst<JPH::GroupFilter>> group_filters;
+
+			// Call after writing anything using the maps above
+			void RetainWrittenObjects();
+
+			unsigned num_steps = 0;
+		};
+
+		struct Replay {
+			JPH::StateRecorderImpl stream;
+
+			JPH::Shape::IDToShapeMap shapes;
+			JPH::Shape::IDToMaterialMap materials;
+			JPH::BodyCreationSettings::IDToGroupFilterMap group_filters;
+
+			unsigned num_steps = 0;
+			bool finished = false;
+		};
+
+		static constexpr uint32_t RECORDING_MAGIC = 0x4F524E50; // "ORNP"
+		static constexpr uint32_t RECORDING_VERSION = 1;
+
+		// Writes the count, ids and creation settings of bodies to the recording
+		void WriteRecordedBodies(std::span<const JPH::BodyID> bodies);
+
+		// Reads bodies written by WriteRecordedBodies and creates them with their recorded ids, without adding them to the broadphase
+		bool ReadRecordedBodies(JPH::BodyIDVector& output);
+
+		// Hash of the pose of every active body, used to detect replays diverging from their recording
+		[[nodiscard]] uint64_t GetActiveBodyChecksum();
+
+
+		// Initializes physics_system and the temp allocator from m_settings
+		void InitPhysicsSystem();
+
+		// Rebuilds the filters Jolt queries from m_settings.layers
+		void UpdateLayerFilters();
+
+		// Object layer a component's body is created in
+		[[nodiscard]] JPH::ObjectLayer GetObjectLayer(const PhysicsComponent* p_comp) const;
+
+		// Broadphase layers holding any of the object layers in layer_mask
+		[[nodiscard]] uint8_t GetBroadPhaseMask(uint32_t layer_mask) const;
+
+		void SerializeSettings(YAML::Emitter& out) const;
+		void DeserializeSettings(const YAML::Node& node);
+
+		// Creates a body for p_comp without adding it to the broadphase, it's added with the rest of the batch in FlushBodyQueue
+		void CreateQueuedBody(PhysicsComponent* p_comp, const JPH::BodyCreationSettings& settings);
+
+		// The body stays in the simulation until the next flush, its user data is cleared so it's never mapped back to an entity
+		void QueueBodyRemoval(JPH::BodyID id);
+
+		void OptimizeBroadPhaseIfDegraded();
+
+		// Returns a shape shared with every other body of the same geometry and (quantized) scale, nullptr if the geometry type isn't supported
+		JPH::RefConst<JPH::Shape> GetCachedShape(PhysicsComponent* p_comp);
+
+		// Swaps the body's shape for the one matching its current scale
+		void UpdateBodyShape(PhysicsComponent* p_comp);
+
+		// Drops shapes no body uses anymore
+		void PruneShapeCache();
+
+		// Creates bodies for components that were waiting on mesh colliders to cook, components that already have a body have their shape swapped instead
+		void CreateAwaitingBodies();
+
+		// Drops every cached shape built from the mesh, if update_bodies is true bodies using the mesh are given shapes built from its new data
+		void OnMeshChanged(uint64_t mesh_uuid, bool update_bodies);
 
 		void InitComponent(PhysicsComponent* p_comp);
 
 		void UpdateComponentState(PhysicsComponent* p_comp);
 		void OnTransformEvent(const Events::ECS_Event<TransformComponent>& t_event);
 
+		// Copies the pose of every active body into its transform and notifies transform listeners with one batched dispatch
+		void WriteBackActiveTransforms();
+
+		// Merges the contacts recorded in the last step and resolves them to entities, appending them to m_contacts
+		void CollectContacts();
+
+		// Dispatches m_contacts as one PhysicsCollisionEvent then notifies scripts, called once the poses of the update are written back
+		void DispatchContactEvents();
+
+		// Records the pose of each active body and character before and after the final step of an update
+		void CaptureInterpolationStates();
+		void FinishInterpolationStates();
+
+		// Sets the render matrix of each body captured in the last stepped update from the time left in the accumulator
+		void UpdateRenderTransforms(bool stepped_this_update);
+
+		// Clears the render matrices set by UpdateRenderTransforms and stops interpolating until the next capture
+		void ResetInterpolation();
+
 		void RemoveComponent(PhysicsComponent* p_comp);
 
+		// Creates (or recreates) the CharacterVirtual of p_comp at its entity's position
+		void InitCharacter(CharacterControllerComponent* p_comp);
+
+		// Moves every character by one step, characters are split across the job system and push dynamic bodies through locked writes
+		// Characters don't collide with each other, they only collide with bodies
+		void UpdateCharacters(float dt);
+
+		// Copies character positions into their transforms with one batched dispatch
+		void WriteBackCharacters();
+
 		void InitListeners();
 		void DeinitListeners();
 
 		void SerializeEntity(SceneEntity& entity, YAML::Emitter* p_emitter);
 		void DeserializeEntity(SceneEntity& entity, const YAML::Node* p_node);
+		void CloneEntity(SceneEntity& src, SceneEntity& dst);
 
 		float m_accumulator = 0.f;
 		bool m_is_updating = true;
-		// Increments whenever a body is added or deleted, resets to 0 upon optimization
-		int num_body_events_since_last_broadphase_optimization = 0;
+		// Created but not yet added to the broadphase
+		JPH::BodyIDVector m_pending_body_adds;
+
+		// Removed and destroyed on the next flush
+		JPH::BodyIDVector m_pending_body_removals;
+
+		// Bodies added or removed since OptimizeBroadPhase was last called, resets to 0 upon optimization
+		unsigned m_body_changes_since_optimization = 0;
+
+		struct ShapeKey {
+			PhysicsComponent::GeometryType geometry_type;
+			// 0 if the entity has no mesh
+			uint64_t mesh_uuid;
+			// Scale * SHAPE_SCALE_QUANTIZATION, (0, 0, 0) for the unit scale base shapes that scaled shapes wrap
+			glm::ivec3 quantized_scale;
+			// Triangle mesh geometry on dynamic bodies
+			bool convex_hull = false;
+
+			bool operator==(const ShapeKey&) const = default;
+		};
+
+		struct ShapeKeyHash {
+			size_t operator()(const ShapeKey& key) const noexcept {
+				size_t hash = std::hash<uint64_t>{}(key.mesh_uuid) ^ (static_cast<size_t>(key.geometry_type) << 1 | static_cast<size_t>(key.convex_hull));
+				for (int i = 0; i < 3; i++) {
+					hash ^= std::hash<int>{}(key.quantized_scale[i]) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+				}
+				return hash;
+			}
+		};
+
+		// Scales within 1/SHAPE_SCALE_QUANTIZATION of each other share a shape
+		static constexpr float SHAPE_SCALE_QUANTIZATION = 1000.f;
+		static constexpr size_t MIN_SHAPE_CACHE_PRUNE_THRESHOLD = 256;
+
+		// Holds a reference to each shape, so shapes outlive the bodies using them until pruned
+		std::unordered_map<ShapeKey, JPH::RefConst<JPH::Shape>, ShapeKeyHash> m_shape_cache;
+		size_t m_shape_cache_prune_threshold = MIN_SHAPE_CACHE_PRUNE_THRESHOLD;
+
+		MeshColliderCooker m_collider_cooker;
+		// Reused by OnUpdate to receive shapes from m_collider_cooker
+		std::vector<MeshColliderCooker::CookedShape> m_cooked_shapes;
+		std::vector<uint64_t> m_entities_awaiting_colliders;
+
+		// Reused each step by the transform write-back
+		JPH::BodyIDVector m_active_bodies;
+		std::vector<TransformComponent*> m_written_back_transforms;
+
+		// Gathered once per update that steps, entt keeps component addresses stable until components are added or removed
+		std::vector<CharacterControllerComponent*> m_characters;
+
+		// One per character job as temp allocators aren't thread-safe, created on first use since Jolt's allocator must be registered first
+		std::vector<std::unique_ptr<JPH::TempAllocatorImpl>> m_character_allocators;
+
+		struct InterpolatedBody {
+			entt::entity entity;
+			// Invalid for characters, which are read through their CharacterControllerComponent
+			JPH::BodyID body_id;
+
+			glm::vec3 prev_pos;
+			glm::quat prev_orientation;
+
+			glm::vec3 curr_pos;
+			glm::quat curr_orientation;
+		};
+
+		// Bodies that were active in the last step, and every character
+		std::vector<InterpolatedBody> m_interpolated_bodies;
+		std::vector<TransformComponent*> m_render_transforms;
+
+		Settings m_settings;
+		ContactRecorder m_contact_recorder;
+
+		std::unique_ptr<Recording> mp_recording = nullptr;
+		std::unique_ptr<Replay> mp_replay = nullptr;
+
+		// Reused each update, m_contacts holds the contacts of the last update that stepped
+		std::vector<ContactRecorder::Record> m_contact_records;
+		std::vector<PhysicsContact> m_contacts;
 
-		TransformComponent* mp_currently_updating_transform = nullptr;
+		// (ContactRecorder::Record::body_a << 32 | body_b, number of sub shape pairs of the bodies currently touching), sorted by key
+		// Kept across steps so adds and removals of individual sub shapes in later steps don't start or end the body pair's contact
+		// Rebuilt into the second vector each step and swapped, so both keep their capacity and steps don't allocate once they've grown
+		std::vector<std::pair<uint64_t, uint32_t>> m_touching_sub_shape_counts;
+		std::vector<std::pair<uint64_t, uint32_t>> m_next_touching_sub_shape_counts;
 
 		// These can only be created after the Factory singleton, so they're kept as unique ptrs.
-		std::unique_ptr<JPH::TempAllocatorImpl> mp_temp_allocator = nullptr;
+		std::unique_ptr<TrackingTempAllocator> mp_temp_allocator = nullptr;
 		std::unique_ptr<JPH::JobSystemThreadPool> mp_job_system = nullptr;
 
 		BPLayerInterfaceImpl m_broad_phase_layer_interface;
@@ -161,8 +648,11 @@ namespace ORNG {
 
 		std::array<entt::connection, 8> m_connections;
 		Events::ECS_EventListener<PhysicsComponent> m_phys_listener;
+		Events::ECS_EventListener<CharacterControllerComponent> m_character_listener;
 		Events::ECS_EventListener<TransformComponent> m_transform_listener;
 		Events::EventListener<EntitySerializationEvent> m_serialization_listener;
+		Events::EventListener<SceneSerializationEvent> m_scene_serialization_listener;
+		Events::EventListener<Events::AssetEvent> m_asset_listener;
 
 		// Number of loaded instances of this class, used for managing the factory singleton
 		inline static int s_num_loaded_instances = 0;
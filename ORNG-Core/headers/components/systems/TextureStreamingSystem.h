@@ -0,0 +1,20 @@
+#pragma once
+#include "components/systems/ComponentSystem.h"
+
+namespace ORNG {
+	class Material;
+
+	// Reports the on-screen size of every material texture used by visible meshes to the asset manager's TextureStreamer
+	class TextureStreamingSystem : public ComponentSystem {
+	public:
+		explicit TextureStreamingSystem(Scene* p_scene) : ComponentSystem(p_scene) {}
+		~TextureStreamingSystem() override = default;
+
+		void OnUpdate() override;
+
+		inline static constexpr uint64_t GetSystemUUID() { return 6120938475610293; }
+
+	private:
+		void ReportMaterial(const Material* p_material, float screen_size_pixels);
+	};
+}
@@ -2,6 +2,7 @@
 
 #include "components/systems/ComponentSystem.h"
 #include "components/TransformComponent.h"
+#include "scene/FlatHierarchy.h"
 
 namespace ORNG {
 	class TransformHierarchySystem : public ComponentSystem {
@@ -11,14 +12,42 @@ namespace ORNG {
 
 		void OnLoad() override;
 
-		void OnUnload() override {
-			Events::EventManager::DeregisterListener(m_transform_event_listener.GetRegisterID());
-		}
+		// Applies Scene::flat_transform_hierarchy and rebuilds the flat hierarchy if anything invalidated it since the last update
+		void OnUpdate() override;
+
+		void OnUnload() override;
+
+		// Maintains a FlatHierarchy of the scene which transform updates are propagated through, prefer setting Scene::flat_transform_hierarchy
+		// as OnUpdate overwrites this with it
+		void SetFlatHierarchyEnabled(bool enabled);
+
+		// Brought up to date before being returned, nullptr if the flat hierarchy isn't enabled
+		[[nodiscard]] const FlatHierarchy* GetFlatHierarchy();
+
+		// Rebuilds every world transform in a single pass over the flat hierarchy instead of propagating through child lists
+		// Transform update events are still dispatched for each entity, does nothing if the flat hierarchy isn't enabled
+		void RebuildWorldTransforms();
 
 		inline static constexpr uint64_t GetSystemUUID() { return 934898474626; }
 
 	private:
 		void UpdateChildTransforms(const Events::ECS_Event<TransformComponent>&);
+		void UpdateChildRenderTransforms(const Events::ECS_Event<TransformComponent>&);
+		// Rebuilds every descendant of the updated entity in one linear pass over its range in the flat hierarchy, skipping the subtrees of absolute children
+		// Falls back to UpdateChildTransforms while the flat hierarchy is dirty
+		void UpdateSubtreeTransforms(const Events::ECS_Event<TransformComponent>&);
+
+		void OnRelationshipConstruct(entt::registry& registry, entt::entity entity);
+		void OnRelationshipDestroy(entt::registry& registry, entt::entity entity);
+
 		Events::ECS_EventListener<TransformComponent> m_transform_event_listener;
+		Events::ECS_EventListener<RelationshipComponent> m_relationship_event_listener;
+
+		std::unique_ptr<FlatHierarchy> mp_flat_hierarchy = nullptr;
+		std::array<entt::connection, 2> m_flat_hierarchy_connections;
+
+		// Flat hierarchy index of the entity a subtree pass is currently rebuilding, its update event isn't propagated as the pass covers its descendants
+		// Updates to any other entity (e.g made by other listeners) still propagate
+		uint32_t m_rebuilding_index = FlatHierarchy::INVALID_INDEX;
 	};
 }
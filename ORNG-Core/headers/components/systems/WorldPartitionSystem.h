@@ -0,0 +1,167 @@
+#pragma once
+#include "components/systems/ComponentSystem.h"
+#include "scene/BinarySceneSerializer.h"
+#include "assets/AssetHandle.h"
+
+namespace ORNG {
+	// Streams a level split into a grid of cells on the XZ plane, each cell is a binary entity array written by BuildPartition
+	// Cells near a streaming source are read and decoded on worker threads and have their assets referenced (reloading them if unloaded) before
+	// their entities are instantiated within a per-frame budget, cells that move out of range are deleted again the same way.
+	// Only cells around the sources are ever visited, so memory use and frame time depend on the streaming radii rather than the size of the world.
+	// Streamed entities are ordinary scene entities, clear the partition before serializing the scene if they shouldn't be saved with it.
+	class WorldPartitionSystem : public ComponentSystem {
+	public:
+		struct Settings {
+			// Cells closer than this to a source are instantiated
+			float load_radius = 200.f;
+
+			// Cells within load_radius + prefetch_distance are read and have their assets referenced, but aren't instantiated yet
+			float prefetch_distance = 100.f;
+
+			// Instantiated cells are only removed once further than this, should be larger than load_radius so cells on the boundary don't thrash
+			float unload_radius = 300.f;
+
+			// Upper bound on cells held in memory at once, the furthest cells are dropped first when exceeded
+			unsigned max_resident_cells = 64;
+
+			// Upper bound on cells being read on worker threads at once
+			unsigned max_concurrent_reads = 4;
+
+			// Maximum time spent creating and deleting cell entities each frame
+			float budget_ms = 2.f;
+
+			// If true, AssetManager::UnloadUnreferencedAssets is called on frames where a cell released its assets,
+			// so assets only used by cells that moved out of range are freed
+			bool unload_released_assets = true;
+		};
+
+		struct Stats {
+			unsigned num_resident_cells = 0;
+			unsigned num_instantiated_cells = 0;
+			unsigned num_reads_in_flight = 0;
+			size_t num_streamed_entities = 0;
+		};
+
+		explicit WorldPartitionSystem(Scene* p_scene) : ComponentSystem(p_scene) {}
+		// Futures in flight block on destruction so this waits for any reads to finish
+		~WorldPartitionSystem() override = default;
+
+		void OnUpdate() override;
+
+		// Scene entities are already deleted by the time this is called, so only the streaming state is dropped
+		void OnUnload() override;
+
+		// Loads the partition manifest in directory, entities streamed in from a previous partition are deleted
+		bool SetPartition(const std::string& directory);
+
+		// Deletes every streamed entity immediately and stops streaming
+		void ClearPartition();
+
+		// Splits the root entities of scene (and their children) into cells by world position and writes them and a manifest to directory
+		// The scene isn't modified, delete the partitioned entities before streaming them back in as streamed entities keep their uuids
+		static bool BuildPartition(Scene& scene, const std::string& directory, float cell_size);
+
+		// The active camera is always a source if the scene has a CameraSystem, entities added here are sources too
+		void AddStreamingSource(uint64_t entity_uuid);
+		void RemoveStreamingSource(uint64_t entity_uuid);
+
+		[[nodiscard]] Stats GetStats() const noexcept;
+
+		[[nodiscard]] bool HasPartition() const noexcept { return m_cell_size > 0.f; }
+
+		Settings settings;
+
+		inline static constexpr uint64_t GetSystemUUID() { return 5512093847562019; }
+
+		static constexpr const char* MANIFEST_FILENAME = "partition.yml";
+	private:
+		enum class CellState {
+			UNLOADED,
+			READING,
+			PREFETCHED,
+			INSTANTIATING,
+			INSTANTIATED,
+			UNLOADING,
+			// Cell file couldn't be read, it isn't retried until the partition is set again
+			FAILED
+		};
+
+		// Produced on a worker thread, holds everything needed to instantiate the cell without further file access or decoding
+		struct CellData {
+			std::vector<std::byte> data;
+			BinarySceneSerializer::DecodedScene decoded;
+
+			// Index of each entity's parent in decoded.entities, -1 for root entities of the cell
+			std::vector<int> parent_indices;
+
+			std::vector<uint64_t> dependency_uuids;
+			bool valid = false;
+		};
+
+		struct Cell {
+			int x = 0;
+			int z = 0;
+			uint32_t num_entities = 0;
+
+			CellState state = CellState::UNLOADED;
+			std::future<CellData> read_future;
+			CellData loaded;
+
+			// Keeps the cell's assets resident while it's prefetched or instantiated
+			std::vector<AssetHandle<Asset>> dependencies;
+
+			// Uuids of the entities instantiated so far, in record order
+			std::vector<uint64_t> entity_uuids;
+
+			// Serialized uuid -> instantiated uuid, for entities whose serialized uuid was already taken
+			std::unordered_map<uint64_t, uint64_t> uuid_remaps;
+
+			// Progress through the current instantiation/unload stage
+			size_t cursor = 0;
+
+			// Distance from the nearest source to the cell's bounds, updated each frame
+			float distance = std::numeric_limits<float>::max();
+		};
+
+		static CellData ReadCell(std::string filepath);
+
+		[[nodiscard]] static uint64_t CellKey(int x, int z) noexcept {
+			return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(z);
+		}
+
+		[[nodiscard]] std::string GetCellFilepath(int x, int z) const;
+
+		void GatherSourcePositions(std::vector<glm::vec3>& output);
+		void UpdateCellDistances(const std::vector<glm::vec3>& sources);
+
+		void BeginRead(Cell& cell);
+		void ReleaseCell(Cell& cell);
+
+		// Both return true once the cell has finished the stage
+		bool StepInstantiation(Cell& cell);
+		bool StepUnload(Cell& cell);
+
+		void Reset(bool delete_entities);
+
+		std::string m_directory;
+		float m_cell_size = 0.f;
+
+		// Every cell in the manifest, Key = CellKey
+		std::unordered_map<uint64_t, Cell> m_cells;
+
+		// Keys of cells not in the UNLOADED or FAILED state, the only cells visited each frame besides those around sources
+		std::unordered_set<uint64_t> m_resident_cells;
+
+		// Reads of cells that were dropped while reading, kept until they finish as the futures block on destruction
+		std::vector<std::future<CellData>> m_abandoned_reads;
+
+		std::vector<uint64_t> m_source_uuids;
+
+		// Set when a cell drops its asset handles, cleared once unreferenced assets are unloaded
+		bool m_assets_released = false;
+
+		// Reused each frame
+		std::vector<uint64_t> m_candidates;
+		std::vector<glm::vec3> m_source_positions;
+	};
+}
@@ -137,6 +137,7 @@ namespace ORNG {
 			static constexpr int TRANSFORMS = 0;
 			static constexpr int POINT_LIGHTS = 1;
 			static constexpr int SPOT_LIGHTS = 2;
+			static constexpr int LIGHT_CLUSTERS = 3;
 			static constexpr int PARTICLE_EMITTERS = 5;
 			static constexpr int PARTICLES = 6;
 		};
@@ -91,6 +91,28 @@ namespace ORNG::Events {
 				}
 		}
 
+		// Dispatches an event for each component with one pass over the listeners instead of one pass per component
+		// Components must all belong to the same scene, listeners receive them listener by listener rather than component by component
+		template<std::derived_from<Component> T>
+		static void DispatchEventBatch(ECS_EventType event_type, std::span<T* const> components, uint8_t sub_event_type = UINT8_MAX, void* p_data = nullptr) {
+			if (components.empty())
+				return;
+
+			const uint64_t scene_id = components[0]->GetStaticSceneUUID();
+			ECS_Event<T> e_event{ event_type, nullptr, sub_event_type };
+			e_event.p_data = p_data;
+
+			for (auto [entity, listener] : Get().m_listener_registry.view<ECS_EventListener<T>>().each()) {
+				if (listener.scene_id != scene_id)
+					continue;
+
+				for (T* p_component : components) {
+					e_event.p_component = p_component;
+					listener.OnEvent(e_event);
+				}
+			}
+		}
+
 
 		static void DeregisterListener(entt::entity entt_handle) {
 			if (Get().m_listener_registry.valid(entt_handle))
@@ -84,6 +84,8 @@ namespace ORNG::Events {
 		MATERIAL_LOADED,
 		TEXTURE_LOADED,
 		TEXTURE_DELETED,
+		MESH_DELETED,
+		MATERIAL_DELETED,
 	};
 
 	struct AssetEvent : public Event {
@@ -49,3 +49,8 @@
 #include <variant>
 #include <deque>
 #include <span>
+#include <bit>
+#include <typeindex>
+#include <atomic>
+#include <mutex>
+#include <thread>
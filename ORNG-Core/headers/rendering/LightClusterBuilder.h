@@ -0,0 +1,86 @@
+#pragma once
+
+namespace ORNG {
+	// Splits the view frustum into a grid of clusters (froxels) and assigns point and spot lights to the clusters their bounding spheres touch,
+	// so lighting only evaluates the lights in a pixel's cluster instead of every light in the scene.
+	// This is the CPU reference of LightClusterCS.glsl and contains no GL calls so it can be checked against brute-force assignment headlessly,
+	// both produce the same layout and use the same bounds and intersection tests.
+	class LightClusterBuilder {
+	public:
+		// Must match the defines passed to LightClusterCS.glsl and LightingCS.glsl, see GetShaderDefines
+		static constexpr uint32_t NUM_X = 16;
+		static constexpr uint32_t NUM_Y = 9;
+		// Slices are spaced exponentially between the near and far planes so clusters stay roughly cubic with depth
+		static constexpr uint32_t NUM_Z = 24;
+		static constexpr uint32_t NUM_CLUSTERS = NUM_X * NUM_Y * NUM_Z;
+
+		// Combined for both light types, lights past this in a cluster are dropped (spot lights first as they're assigned last)
+		static constexpr uint32_t MAX_LIGHTS_PER_CLUSTER = 256;
+
+		// Each cluster is [num point lights, num spot lights, point light indices..., spot light indices...]
+		static constexpr uint32_t CLUSTER_STRIDE = 2 + MAX_LIGHTS_PER_CLUSTER;
+
+		// Lights are culled once their attenuated colour drops below this
+		static constexpr float LIGHT_CUTOFF = 1.f / 256.f;
+
+		// World space bounding sphere of a light
+		struct Light {
+			glm::vec3 pos{ 0 };
+			float radius = 0.f;
+		};
+
+		struct ValidationResult {
+			unsigned num_samples = 0;
+			// Lights brute force found within range of a sample but missing from the sample's cluster
+			unsigned num_missing = 0;
+			// Clusters that hit MAX_LIGHTS_PER_CLUSTER, lights missing from these aren't counted as errors
+			unsigned num_overflowed_clusters = 0;
+			// Average number of lights evaluated per sample with clusters and with brute force
+			double avg_cluster_lights = 0.0;
+			double avg_affecting_lights = 0.0;
+			double build_ms = 0.0;
+			double brute_force_ms = 0.0;
+		};
+
+		// Distance at which max(colour) / attenuation falls to LIGHT_CUTOFF, written into pos.w of the light SSBOs
+		// FLT_MAX if the light never falls off (no linear or exp term)
+		static float CalculateLightRadius(glm::vec3 colour, float constant, float linear, float exp);
+
+		// Projection must be perspective, znear/zfar are positive distances
+		void Build(const glm::mat4& view, const glm::mat4& projection, float znear, float zfar, std::span<const Light> point_lights, std::span<const Light> spot_lights);
+
+		// screen_uv in [0, 1], view_depth is the positive distance along the view direction
+		[[nodiscard]] static uint32_t GetClusterIndex(glm::vec2 screen_uv, float view_depth, float znear, float zfar);
+
+		// View space AABB of cluster (x, y, z)
+		static void GetClusterBounds(uint32_t x, uint32_t y, uint32_t z, const glm::mat4& inv_projection, float znear, float zfar, glm::vec3& bounds_min, glm::vec3& bounds_max);
+
+		[[nodiscard]] static bool SphereIntersectsAABB(glm::vec3 centre, float radius, glm::vec3 bounds_min, glm::vec3 bounds_max);
+
+		// Valid after Build, indices are into the spans passed to it
+		[[nodiscard]] std::span<const uint32_t> GetPointLights(uint32_t cluster) const;
+		[[nodiscard]] std::span<const uint32_t> GetSpotLights(uint32_t cluster) const;
+
+		[[nodiscard]] unsigned GetNumOverflowedClusters() const noexcept { return m_num_overflowed_clusters; }
+
+		// Same layout as the GPU cluster buffer
+		[[nodiscard]] const std::vector<uint32_t>& GetData() const noexcept { return m_data; }
+
+		// Builds clusters then samples points spread through the frustum, checking every light brute force finds within range of a point
+		// is present in that point's cluster
+		static ValidationResult Validate(const glm::mat4& view, const glm::mat4& projection, float znear, float zfar, std::span<const Light> point_lights, std::span<const Light> spot_lights, unsigned samples_per_axis = 32);
+
+		// Defines shaders including LightClusterINCL.glsl need
+		static std::vector<std::string> GetShaderDefines();
+	private:
+		// Appends the lights touching the bounds to p_indices after the num_existing indices already there, returns the number appended
+		static uint32_t AssignLights(uint32_t* p_indices, uint32_t num_existing, glm::vec3 bounds_min, glm::vec3 bounds_max, std::span<const glm::vec4> view_lights, bool& overflowed);
+
+		std::vector<uint32_t> m_data;
+		// View space pos + radius, reused between builds
+		std::vector<glm::vec4> m_view_point_lights;
+		std::vector<glm::vec4> m_view_spot_lights;
+
+		unsigned m_num_overflowed_clusters = 0;
+	};
+}
@@ -1,5 +1,5 @@
 #pragma once
-#include "assets/Asset.h"
+#include "assets/AssetHandle.h"
 #include "Textures.h"
 
 namespace ORNG {
@@ -120,13 +120,15 @@ namespace ORNG {
 		// Alpha values from the albedo texture below this value will cause the pixel to be discarded in normal opaque shading, such as the gbuffer
 		float alpha_cutoff = 1.f;
 
-		Texture2D* base_colour_texture = nullptr;
-		Texture2D* normal_map_texture = nullptr;
-		Texture2D* metallic_texture = nullptr;
-		Texture2D* roughness_texture = nullptr;
-		Texture2D* ao_texture = nullptr;
-		Texture2D* displacement_texture = nullptr;
-		Texture2D* emissive_texture = nullptr;
+		static constexpr unsigned NUM_TEXTURE_SLOTS = 7;
+
+		AssetHandle<Texture2D> base_colour_texture = nullptr;
+		AssetHandle<Texture2D> normal_map_texture = nullptr;
+		AssetHandle<Texture2D> metallic_texture = nullptr;
+		AssetHandle<Texture2D> roughness_texture = nullptr;
+		AssetHandle<Texture2D> ao_texture = nullptr;
+		AssetHandle<Texture2D> displacement_texture = nullptr;
+		AssetHandle<Texture2D> emissive_texture = nullptr;
 
 		SpriteSheetData spritesheet_data;
 
@@ -41,15 +41,16 @@ namespace ORNG {
 	// Textures and materials here are heap-allocated and need to be freed later
 	struct MeshLoadResult {
 		void Free() {
-			for (auto& tex : textures) {
-				delete tex.p_tex;
-			}
-			textures.clear();
-
+			// Materials hold handles to the textures so are deleted first
 			for (auto* p_mat : materials) {
 				delete p_mat;
 			}
 			materials.clear();
+
+			for (auto& tex : textures) {
+				delete tex.p_tex;
+			}
+			textures.clear();
 		}
 
 		std::string original_file_path;
@@ -73,6 +74,7 @@ namespace ORNG {
 		friend class SceneRenderer;
 		friend class MeshInstancingSystem;
 		friend class SceneSerializer;
+		friend class BinarySceneSerializer;
 		friend class AssetManager;
 		friend class AssetSerializer;
 
@@ -28,6 +28,11 @@ namespace ORNG {
 			const Material* const* materials, MaterialFlags mat_flags, MaterialFlags mat_flags_excluded, bool allow_state_changes,
 			GLenum primitive_type = GL_TRIANGLES);
 
+		// For components that hold references to their materials
+		static void DrawMeshGBuffer(ShaderVariants* p_shader, const MeshAsset* p_mesh, RenderGroup render_group, int instances,
+			const AssetHandle<const Material>* materials, MaterialFlags mat_flags, MaterialFlags mat_flags_excluded, bool allow_state_changes,
+			GLenum primitive_type = GL_TRIANGLES);
+
 		static void DrawInstanceGroupGBuffer(ShaderVariants* p_shader, const MeshInstanceGroup* p_group, RenderGroup render_group, MaterialFlags mat_flags,
 			MaterialFlags mat_flags_exclusion, bool allow_state_changes, GLenum primitive_type = GL_TRIANGLES);
 
@@ -41,6 +46,11 @@ namespace ORNG {
 
 		static std::vector<std::string> GetGBufferUniforms();
 	private:
+		// MaterialPtr is either a raw pointer or a handle to a material, only instantiated in SceneRenderer.cpp
+		template<typename MaterialPtr>
+		static void DrawMeshGBufferImpl(ShaderVariants* p_shader, const MeshAsset* p_mesh, RenderGroup render_group, int instances,
+			const MaterialPtr* materials, MaterialFlags mat_flags, MaterialFlags mat_flags_excluded, bool allow_state_changes, GLenum primitive_type);
+
 		void UpdateLightSpaceMatrices(CameraComponent* p_cam, Scene* p_scene);
 	};
 }
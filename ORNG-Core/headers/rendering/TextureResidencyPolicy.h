@@ -0,0 +1,97 @@
+#pragma once
+
+namespace ORNG {
+	// Decides which mip levels of streamed textures should be resident under a memory budget.
+	// Contains no GL calls so it can be driven with synthetic data, the GPU side is handled by TextureStreamer.
+	class TextureResidencyPolicy {
+	public:
+		struct StreamRequest {
+			uint64_t texture_id;
+			// Mip that should become the highest resolution resident mip once the request completes
+			uint8_t target_mip;
+		};
+
+		struct EvictRequest {
+			uint64_t texture_id;
+			// All mips above this (higher resolution) can be released
+			uint8_t new_resident_mip;
+		};
+
+		struct Entry {
+			uint32_t width = 0;
+			uint32_t height = 0;
+			uint32_t bytes_per_texel = 0;
+			uint8_t num_mips = 0;
+
+			// Highest resolution mip that is always resident, mips at or below ALWAYS_RESIDENT_DIM are never evicted
+			uint8_t base_mip = 0;
+
+			// Highest resolution mip currently uploaded, 0 = full resolution
+			uint8_t resident_mip = 0;
+
+			// Highest resolution mip needed to render the texture at its current largest on-screen size
+			uint8_t required_mip = 0;
+
+			// Mip currently being streamed in, INVALID_MIP if no request is in flight
+			uint8_t pending_mip = INVALID_MIP;
+
+			uint64_t last_needed_frame = 0;
+		};
+
+		static constexpr uint8_t INVALID_MIP = UINT8_MAX;
+		static constexpr uint32_t ALWAYS_RESIDENT_DIM = 64;
+
+		explicit TextureResidencyPolicy(size_t budget_bytes = 512ull * 1024ull * 1024ull) : m_budget_bytes(budget_bytes) {}
+
+		// Returns the mip that should be uploaded initially, every mip from this one down to the smallest is considered resident
+		uint8_t RegisterTexture(uint64_t texture_id, uint32_t width, uint32_t height, uint32_t bytes_per_texel);
+
+		void UnregisterTexture(uint64_t texture_id);
+
+		// Called for every visible use of a texture, screen_size_pixels is the number of pixels one repetition of the texture covers along its largest axis
+		// Multiple reports in the same frame keep the highest resolution requirement
+		void ReportScreenSize(uint64_t texture_id, float screen_size_pixels, uint64_t frame);
+
+		// Fills the request vectors with the work that should be done this frame, requests are ordered by priority
+		// Evictions are always issued before the stream requests they make room for
+		void Update(uint64_t frame, std::vector<StreamRequest>& stream_requests, std::vector<EvictRequest>& evict_requests);
+
+		// Must be called once for every StreamRequest issued, if success is false the reserved memory is released and the request can be reissued
+		void OnStreamComplete(uint64_t texture_id, bool success);
+
+		void SetBudget(size_t budget_bytes) noexcept { m_budget_bytes = budget_bytes; }
+		[[nodiscard]] size_t GetBudget() const noexcept { return m_budget_bytes; }
+
+		// Memory used by resident mips plus memory reserved by in-flight stream requests
+		[[nodiscard]] size_t GetCommittedBytes() const noexcept { return m_committed_bytes; }
+
+		// Returns nullptr if texture isn't registered
+		[[nodiscard]] const Entry* GetEntry(uint64_t texture_id) const;
+
+		[[nodiscard]] size_t GetNumTextures() const noexcept { return m_entries.size(); }
+
+		static uint8_t CalcNumMips(uint32_t width, uint32_t height);
+
+		// Size of mips [first_mip, last_mip)
+		static size_t CalcMipRangeBytes(uint32_t width, uint32_t height, uint32_t bytes_per_texel, uint8_t first_mip, uint8_t last_mip);
+
+		// Number of frames a texture can go without being reported before all of its streamed mips become evictable
+		uint64_t eviction_grace_frames = 120;
+	private:
+		size_t CalcRangeBytes(const Entry& entry, uint8_t first_mip, uint8_t last_mip) const {
+			return CalcMipRangeBytes(entry.width, entry.height, entry.bytes_per_texel, first_mip, last_mip);
+		}
+
+		// Evicts least recently needed mips until bytes_needed fits in the budget, returns false if it cannot be made to fit
+		bool MakeRoom(size_t bytes_needed, uint64_t frame, uint64_t requesting_id, std::vector<EvictRequest>& evict_requests);
+
+		std::unordered_map<uint64_t, Entry> m_entries;
+
+		// Reused each update to avoid reallocating
+		std::vector<std::pair<uint64_t, Entry*>> m_candidates;
+		std::vector<std::pair<uint64_t, Entry*>> m_eviction_candidates;
+
+		size_t m_budget_bytes;
+		size_t m_committed_bytes = 0;
+	};
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include "rendering/TextureResidencyPolicy.h"
+
+namespace ORNG {
+	class Texture2D;
+
+	// Keeps only the low resolution tail of each streamed texture's mip chain resident initially,
+	// higher resolution mips are decoded on worker threads and uploaded on demand within the policy's memory budget.
+	class TextureStreamer {
+	public:
+		TextureStreamer() = default;
+		~TextureStreamer();
+
+		// Decodes encoded_data and uploads only the mips the policy keeps permanently resident
+		// Falls back to a full upload if the texture can't be streamed, returns false if the data couldn't be decoded
+		bool LoadResidentMips(Texture2D& tex, std::vector<std::byte>& encoded_data);
+
+		// screen_size_pixels - how many pixels one repetition of the texture covers along its largest axis
+		void ReportScreenSize(const Texture2D* p_tex, float screen_size_pixels);
+
+		// Processes finished stream requests and issues new ones, call once per frame after screen sizes have been reported
+		void Update();
+
+		// Must be called before a streamed texture is deleted
+		void OnTextureDeleted(Texture2D* p_tex);
+
+		// Unregisters the texture and lifts the mip clamp, call before reloading a streamed texture's full mip chain
+		void StopStreaming(Texture2D& tex);
+
+		void SetBudget(size_t budget_bytes) { m_policy.SetBudget(budget_bytes); }
+
+		[[nodiscard]] const TextureResidencyPolicy& GetPolicy() const noexcept { return m_policy; }
+
+		[[nodiscard]] bool IsStreamed(const Texture2D* p_tex) const;
+
+		// If false, LoadResidentMips uploads full mip chains and nothing is streamed
+		bool enabled = true;
+
+		// Limits the number of textures being decoded at once
+		unsigned max_concurrent_requests = 4;
+	private:
+		struct StreamedTexture {
+			Texture2D* p_tex = nullptr;
+			int channels = 0;
+			uint8_t resident_mip = 0;
+			uint8_t num_mips = 0;
+		};
+
+		struct MipData {
+			int width = 0;
+			int height = 0;
+			std::vector<std::byte> data;
+		};
+
+		struct StreamResult {
+			uint64_t texture_id = 0;
+			uint8_t first_mip = 0;
+			std::vector<MipData> mips;
+			bool success = false;
+		};
+
+		void ProcessFinishedRequests();
+
+		// Decodes the image and box-filters it down, mips [first_mip, last_mip) are written to output
+		static bool GenerateMipRange(std::byte* p_encoded_data, size_t size, uint8_t first_mip, uint8_t last_mip, std::vector<MipData>& output, int& channels);
+
+		TextureResidencyPolicy m_policy;
+		std::unordered_map<uint64_t, StreamedTexture> m_textures;
+		std::vector<std::future<StreamResult>> m_stream_queue;
+
+		std::vector<TextureResidencyPolicy::StreamRequest> m_stream_requests;
+		std::vector<TextureResidencyPolicy::EvictRequest> m_evict_requests;
+	};
+}
@@ -134,6 +134,18 @@ namespace ORNG {
 		bool LoadFromBinary(std::byte* p_data, size_t size, bool is_decompressed, int width = -1, int height = -1, int channels = -1, bool is_float = false);
 		[[nodiscard]] const Texture2DSpec& GetSpec() const noexcept { return m_spec; }
 
+		// Uploads a single mip level of tightly packed 8-bit data, used for streaming mips in individually
+		bool UploadMipLevel(uint8_t level, int width, int height, int channels, const std::byte* p_data);
+
+		// Frees the memory of a mip level, the level should be outside of the range set with SetMipRange
+		void ReleaseMipLevel(uint8_t level, int channels);
+
+		// Restricts sampling to mips [base_level, max_level]
+		void SetMipRange(uint8_t base_level, uint8_t max_level);
+
+		// Returns false if channels isn't in the range 1-4
+		static bool GetFormatsFromChannels(int channels, bool srgb, int& internal_format, unsigned& format);
+
 	protected:
 		Texture2DSpec m_spec;
 	};
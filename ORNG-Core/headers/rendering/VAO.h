@@ -240,6 +240,9 @@ namespace ORNG {
 		// Fill all buffers with data provided to vectors in class
 		void FillBuffers() override;
 
+		// Frees the GPU memory of all buffers, the buffer objects stay valid and can be refilled with FillBuffers
+		void ReleaseBuffers();
+
 		VertexData3D vertex_data;
 
 	private:
@@ -2,6 +2,7 @@
 #include "rendering/renderpasses/Renderpass.h"
 #include "rendering/Textures.h"
 #include "shaders/Shader.h"
+#include "rendering/VAO.h"
 
 namespace ORNG {
 	class LightingPass : public Renderpass {
@@ -12,14 +13,25 @@ namespace ORNG {
 
 		void DoPass() override;
 
+		// Returns the number of clusters that differ from the CPU reference, logging the first few, slow as it stalls on the GPU
+		// Clusters that only differ by lights grazing their bounds are within float precision of each other so aren't counted
+		unsigned ValidateLightClusters();
+
 		class Scene* p_scene = nullptr;
 
 		// Accumulated cone tracing radiance
 		FullscreenTexture2D cone_trace_accum_tex{ {0.5f, 0.5f} };
 
-		// Applies direct lighting over image
+		// Applies direct lighting over image, only evaluating the lights assigned to each pixel's cluster
 		Shader shader;
 
+		// Assigns point and spot lights to clusters before lighting, see LightClusterBuilder
+		Shader light_cluster_shader;
+		SSBO<uint32_t> light_cluster_ssbo{ false, 0 };
+
+		// If set, the next pass reads light_cluster_ssbo back and compares it with LightClusterBuilder built from the same matrices and lights, then resets this
+		bool validate_light_clusters = false;
+
 		// Used for upscaling cone tracing radiance tex
 		ShaderVariants depth_aware_upsample_sv;
 
@@ -0,0 +1,85 @@
+#pragma once
+#include <yaml-cpp/node/node.h>
+#include "scene/BinarySceneSerializer.h"
+
+namespace ORNG {
+	class Scene;
+	class SceneAsset;
+
+	// Loads a scene without stalling the frame, YAML is parsed on a worker thread and entities are then
+	// instantiated on the main thread in chunks limited by a per-frame time budget.
+	// Driven by Scene::Update, the target scene keeps its current entities until parsing finishes.
+	class AsyncSceneLoader {
+	public:
+		enum class Stage {
+			PARSING,
+			CLEARING_PREVIOUS,
+			CREATING_ENTITIES,
+			DESERIALIZING_ENTITIES,
+			RESOLVING_REFERENCES,
+			FINISHED,
+			FAILED
+		};
+
+		// success is false if the scene data couldn't be parsed, in which case the scene is left untouched
+		using Callback = std::function<void(Scene& scene, bool success)>;
+
+		// The asset's data is copied, so the asset can be modified or unloaded while the load is in progress
+		AsyncSceneLoader(Scene& scene, const SceneAsset& scene_asset, Callback on_complete);
+
+		AsyncSceneLoader(Scene& scene, const std::string& filepath, Callback on_complete);
+
+		// Futures returned from std::async block on destruction, so this waits for parsing to finish if it's in progress
+		~AsyncSceneLoader() = default;
+
+		// Advances the load, spending at most roughly budget_ms on instantiation
+		// Returns true once the load has finished or failed
+		bool Update(float budget_ms);
+
+		// Called by the scene once the loader has been detached from it, so the callback can safely begin another load
+		void InvokeCallback();
+
+		[[nodiscard]] Stage GetStage() const noexcept { return m_stage; }
+
+		// [0, 1], stays at 0 while parsing
+		[[nodiscard]] float GetProgress() const noexcept;
+
+		// True once the target scene has started being modified
+		[[nodiscard]] bool IsInstantiating() const noexcept {
+			return m_stage != Stage::PARSING && m_stage != Stage::FAILED;
+		}
+	private:
+		struct ParsedScene {
+			YAML::Node data;
+			std::vector<YAML::Node> entity_nodes;
+			std::vector<uint64_t> entity_uuids;
+			std::vector<std::string> entity_names;
+			bool valid = false;
+
+			// Set instead of data/entity_nodes if the scene is in the binary format
+			bool is_binary = false;
+			std::vector<std::byte> binary_data;
+			BinarySceneSerializer::DecodedScene decoded;
+		};
+
+		// Runs on the worker thread, pulls out everything the main thread would otherwise have to look up per entity
+		// data must not share memory with any node used on another thread, see YAML::Clone
+		static ParsedScene Parse(YAML::Node data);
+		static ParsedScene ParseBinary(std::vector<std::byte> data);
+
+		void BeginInstantiation();
+
+		Scene& m_scene;
+		Callback m_on_complete;
+
+		std::future<ParsedScene> m_parse_future;
+		ParsedScene m_parsed;
+
+		Stage m_stage = Stage::PARSING;
+
+		// Index of the next entity to process in the current stage
+		size_t m_cursor = 0;
+
+		size_t m_num_previous_entities = 0;
+	};
+}
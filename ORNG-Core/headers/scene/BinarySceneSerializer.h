@@ -0,0 +1,121 @@
+#pragma once
+
+namespace YAML {
+	class Node;
+}
+
+namespace ORNG {
+	class Scene;
+	class SceneEntity;
+	struct Prefab;
+	struct PrefabTemplate;
+	struct PrefabInstanceTransform;
+
+	// Compact binary encoding of scenes and prefabs, used in packaged builds so scene data doesn't have to be re-parsed from YAML text.
+	// Layout is a header, scene-level chunks (scenes only), then a record per entity holding its uuid, name, parent and a list of component chunks.
+	// Every chunk is tagged with an id, a version and its size, so readers skip chunks they don't recognise and can migrate older versions.
+	class BinarySceneSerializer {
+	public:
+		enum class ChunkID : uint16_t {
+			TRANSFORM = 0,
+			MESH = 1,
+			POINTLIGHT = 2,
+			SPOTLIGHT = 3,
+			CAMERA = 4,
+			SCRIPT = 5,
+			AUDIO = 6,
+			PARTICLE_EMITTER = 7,
+			PARTICLE_BUFFER = 8,
+
+			// Directional light, fog and bloom
+			SCENE_SETTINGS = 1000,
+
+			// YAML written by EntitySerializationEvent/SceneSerializationEvent listeners (physics, skybox etc)
+			// Kept as text so systems outside the serializer don't need their own binary codecs
+			EXTENSION_YAML = 2000,
+		};
+
+		enum class ContentType : uint8_t {
+			SCENE,
+			// Prefabs and other groups of entities without scene settings
+			ENTITY_ARRAY
+		};
+
+		struct ChunkRef {
+			ChunkID id;
+			uint16_t version;
+			// Byte offset of the chunk payload in the source data
+			uint32_t offset;
+			uint32_t size;
+		};
+
+		struct EntityRecord {
+			uint64_t uuid;
+			uint64_t parent_uuid;
+			std::string name;
+			uint32_t first_chunk;
+			uint32_t num_chunks;
+		};
+
+		// Layout of binary scene data, decoding this doesn't touch any scene so it can be done on a worker thread
+		struct DecodedScene {
+			ContentType type = ContentType::SCENE;
+			std::string name;
+			uint64_t uuid = 0;
+
+			std::vector<ChunkRef> scene_chunks;
+			std::vector<EntityRecord> entities;
+
+			// Component chunks of every entity, indexed by EntityRecord::first_chunk
+			std::vector<ChunkRef> chunks;
+		};
+
+		static constexpr uint32_t MAGIC = 0x4E43534F; // "OSCN"
+		static constexpr uint16_t FORMAT_VERSION = 1;
+
+		[[nodiscard]] static bool IsBinaryScene(const std::vector<std::byte>& data);
+
+		// Reads just the header, returns false if data isn't a valid binary scene
+		static bool ReadHeader(const std::vector<std::byte>& data, ContentType& type, std::string& name, uint64_t& uuid);
+
+		static bool Decode(const std::vector<std::byte>& data, DecodedScene& output);
+
+		// Appends the uuids of every mesh, material and sound referenced by the decoded entities, duplicates are skipped
+		// Only reads the chunk data, so like Decode this is safe to call on a worker thread
+		static void CollectAssetDependencies(const std::vector<std::byte>& data, const DecodedScene& decoded, std::vector<uint64_t>& output);
+
+		static void SerializeScene(Scene& scene, std::vector<std::byte>& output);
+
+		// Entities should be ordered so parents come before their children, as they are when instantiated
+		static void SerializeEntities(const std::vector<SceneEntity*>& entities, std::vector<std::byte>& output);
+
+		// Binary equivalent of SceneSerializer::DeserializeScene, entities are added to the scene without clearing it
+		static bool DeserializeScene(Scene& scene, const std::vector<std::byte>& data);
+
+		// Binary equivalent of SceneSerializer::DeserializePrefab, entities are given new uuids and references between them are remapped
+		static std::vector<SceneEntity*> DeserializePrefab(Scene& scene, const Prefab& prefab);
+
+		// Applies the components of one decoded entity record, the entity and its parent must already exist in scene
+		static void DeserializeEntity(Scene& scene, const std::vector<std::byte>& data, const DecodedScene& decoded, const EntityRecord& record, SceneEntity& entity, bool ignore_parent = false);
+
+		// Applies scene-level chunks, entities are expected to already be deserialized
+		static void DeserializeSceneSettings(Scene& scene, const std::vector<std::byte>& data, const DecodedScene& decoded);
+
+		// Compiles prefab into a template that can be instantiated repeatedly without any YAML work, returns nullptr on failure
+		static std::shared_ptr<const PrefabTemplate> CompilePrefab(const Prefab& prefab);
+
+		// Instantiates one copy of the template, appending its entities to output_entities in template order (parents before children)
+		// If p_root_transform isn't null it replaces the stored transform of the root entities
+		static void InstantiateTemplate(Scene& scene, const PrefabTemplate& prefab_template, const PrefabInstanceTransform* p_root_transform, std::vector<SceneEntity*>& output_entities);
+
+		// Lossless conversion between the YAML produced by SceneSerializer and this format, works for both scenes and entity arrays (prefabs)
+		// Conversion is done purely on the data, no assets or scenes are needed
+		static bool ConvertYAMLToBinary(const YAML::Node& node, std::vector<std::byte>& output);
+		static bool ConvertBinaryToYAML(const std::vector<std::byte>& data, std::string& output);
+	private:
+		struct ChunkWriter;
+
+		static void WriteEntity(SceneEntity& entity, ChunkWriter& writer);
+		static void ApplyComponentChunk(const ChunkRef& chunk, const std::vector<std::byte>& data, SceneEntity& entity);
+	};
+}
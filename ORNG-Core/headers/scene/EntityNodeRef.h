@@ -2,6 +2,8 @@
 #ifndef ENTITY_NODE_REF
 #define ENTITY_NODE_REF
 
+#include "entt/entity/entity.hpp"
+
 namespace ORNG {
 	class SceneEntity;
 
@@ -17,6 +19,7 @@ namespace ORNG {
 		// ../ traverses up the hierarchy, e.g ../../ searches for src_entity -> src_entity_parent -> src_entity_parent_parent
 		// If path starts with '::/' it is absolute
 		void GenAndCacheInstructionsFromStringPath(const std::string& path) {
+			InvalidateCache();
 			std::string current_ent_name = "";
 
 			for (size_t i = 0; i < path.size(); i++) {
@@ -44,11 +47,21 @@ namespace ORNG {
 
 		SceneEntity* GetSrc() const { return mp_src; }
 
+		// Forces the next Scene::TryFindEntity call to walk the path again
+		void InvalidateCache() const noexcept { mp_cached_scene = nullptr; }
+
 	private:
 		// The entity this reference is relative to
 		SceneEntity* mp_src = nullptr;
 
 		std::vector<std::string> m_instructions;
+
+		// Result of the last successful Scene::TryFindEntity, valid while every entity the path stepped from still exists with the same
+		// RelationshipComponent::generation (and the scene's root generation is unchanged for absolute paths)
+		mutable entt::entity m_cached_target{ entt::null };
+		mutable std::vector<std::pair<entt::entity, uint64_t>> m_cached_path;
+		mutable uint64_t m_cached_root_generation = 0;
+		mutable const void* mp_cached_scene = nullptr;
 	};
 }
 
@@ -0,0 +1,89 @@
+#pragma once
+#include "entt/entity/registry.hpp"
+#include "components/Component.h"
+
+namespace ORNG {
+	// The entity hierarchy of a registry flattened into arrays in depth-first order, parents always come before their children
+	// and every subtree is a contiguous range starting at its root, so whole-hierarchy and subtree passes are linear walks over memory
+	// instead of chasing RelationshipComponent links. Entities created as roots are appended in place, and subtrees at the end of the arrays
+	// are moved and removed in place, which covers hierarchies built top down (duplication, instantiation) and leaves destroyed last.
+	// Any other reparenting or deletion marks the arrays dirty, and they're rebuilt in one pass the next time Update is called.
+	class FlatHierarchy {
+	public:
+		static constexpr uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+
+		explicit FlatHierarchy(entt::registry& registry) : m_registry(registry) {}
+
+		// Call when an entity gets a RelationshipComponent, it has no parent or children at that point
+		void OnEntityCreated(entt::entity entity);
+
+		// Call after an entity's parent changed
+		void OnParentChanged(entt::entity entity);
+
+		// Call when an entity's RelationshipComponent is destroyed
+		void OnEntityDestroyed(entt::entity entity);
+
+		void MarkDirty() noexcept { m_dirty = true; }
+
+		// Rebuilds the arrays if they're out of date, must be called before reading them
+		void Update();
+
+		[[nodiscard]] bool IsDirty() const noexcept { return m_dirty; }
+
+		[[nodiscard]] size_t GetSize() const noexcept { return m_entities.size(); }
+
+		[[nodiscard]] const std::vector<entt::entity>& GetEntities() const noexcept { return m_entities; }
+
+		// -1 for root entities
+		[[nodiscard]] const std::vector<int>& GetParentIndices() const noexcept { return m_parent_indices; }
+
+		// Number of entities in the subtree rooted at each entity, including itself
+		[[nodiscard]] const std::vector<uint32_t>& GetSubtreeSizes() const noexcept { return m_subtree_sizes; }
+
+		// INVALID_INDEX if the entity isn't in the hierarchy
+		[[nodiscard]] uint32_t GetIndex(entt::entity entity) const noexcept;
+
+		// The entity followed by all of its descendants in depth-first order, empty if the entity isn't in the hierarchy
+		[[nodiscard]] std::span<const entt::entity> GetSubtree(entt::entity entity) const noexcept;
+
+		// Visits every entity in the hierarchy with its parent (entt::null for roots), parents are visited before their children
+		template<std::invocable<entt::entity, entt::entity> F>
+		void ForEach(F&& func) const {
+			for (size_t i = 0; i < m_entities.size(); i++) {
+				func(m_entities[i], m_parent_indices[i] == -1 ? entt::entity{ entt::null } : m_entities[m_parent_indices[i]]);
+			}
+		}
+
+		// Visits every descendant of entity, not including entity itself
+		template<std::invocable<entt::entity> F>
+		void ForEachInSubtree(entt::entity entity, F&& func) const {
+			auto subtree = GetSubtree(entity);
+			for (size_t i = 1; i < subtree.size(); i++) {
+				func(subtree[i]);
+			}
+		}
+
+	private:
+		void Rebuild();
+
+		void Append(entt::entity entity, int parent_index);
+
+		// Adds delta to the subtree size of the entity at index and all of its ancestors, -1 does nothing
+		void AddToSubtreeSizes(int index, int delta);
+
+		entt::registry& m_registry;
+
+		std::vector<entt::entity> m_entities;
+		std::vector<int> m_parent_indices;
+		std::vector<uint32_t> m_subtree_sizes;
+
+		// Index into the arrays above for each entity, indexed by entt::to_entity
+		std::vector<uint32_t> m_index_lookup;
+
+		// Reused by Rebuild
+		std::vector<std::pair<entt::entity, int>> m_stack;
+		std::vector<entt::entity> m_children;
+
+		bool m_dirty = true;
+	};
+}
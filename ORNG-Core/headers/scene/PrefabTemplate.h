@@ -0,0 +1,28 @@
+#pragma once
+#include <yaml-cpp/node/node.h>
+#include "scene/BinarySceneSerializer.h"
+
+namespace ORNG {
+	// World transform given to the root entities of an instantiated prefab, overriding the transform stored in the prefab
+	struct PrefabInstanceTransform {
+		glm::vec3 pos{ 0 };
+		glm::quat orientation{ 1, 0, 0, 0 };
+		glm::vec3 scale{ 1 };
+	};
+
+	// A prefab compiled into its binary component chunks with parents resolved to indices, built once per prefab and reused for every instantiation
+	// Instantiating from this skips all YAML parsing and uuid lookups, see BinarySceneSerializer::InstantiateTemplate
+	struct PrefabTemplate {
+		std::vector<std::byte> data;
+		BinarySceneSerializer::DecodedScene decoded;
+
+		// Index of each entity's parent in decoded.entities, -1 for root entities
+		std::vector<int> parent_indices;
+
+		// Pre-parsed extension chunk of each entity, null if the entity has none
+		std::vector<YAML::Node> extensions;
+
+		// Entity references can only be stored in extension data, so instances only need their references remapped if this is true
+		bool has_extensions = false;
+	};
+}
@@ -15,11 +15,14 @@
 #include "components/Component.h"
 #include "components/Lights.h"
 #include "util/UUID.h"
+#include "util/ObjectPool.h"
 
 namespace ORNG {
 	struct Prefab;
+	struct PrefabInstanceTransform;
 	class SceneEntity;
 	class ComponentSystem;
+	class AsyncSceneLoader;
 
 	struct UUIDChangeEvent : public Events::Event {
 		UUIDChangeEvent(uint64_t _old, uint64_t _new) : old_uuid(_old), new_uuid(_new) {}
@@ -32,11 +35,14 @@ namespace ORNG {
 		friend class EditorLayer;
 		friend class SceneRenderer;
 		friend class SceneSerializer;
+		friend class BinarySceneSerializer;
 		friend class SceneEntity;
 		friend class AssetManagerWindow;
 		friend class RuntimeLayer;
+		friend class AsyncSceneLoader;
 
-		Scene() = default;
+		// Defined out of line as the entity pool needs SceneEntity to be complete
+		Scene();
 		~Scene();
 
 		// Call this just before this scene starts getting updated but after it's fully loaded
@@ -113,14 +119,33 @@ namespace ORNG {
 
 		// This method will clear the scene and deserialize from the scene asset provided
 		// This must be the deserialization method used in scripts to avoid crashes or UB
-		// scene_asset must be valid at the end of the frame
+		// Loads asynchronously, if the scene has been started it's started again once the new entities are instantiated
+		// scene_asset must stay valid until the load finishes
 		void DeserializeAtEndOfFrame(class SceneAsset& scene_asset);
 
+		// Parses the scene on a worker thread, then clears this scene and instantiates the new entities over multiple calls to Update(), spending up to async_load_budget_ms each frame
+		// Existing entities are kept until parsing finishes, to keep the previous scene fully intact until the switch, load into a separate scene and swap once on_complete is called
+		// on_complete is called once every entity is instantiated, the scene is not started automatically
+		// Beginning a new load replaces any load in progress
+		void LoadAsync(const class SceneAsset& scene_asset, std::function<void(Scene& scene, bool success)> on_complete = nullptr);
+		void LoadAsync(const std::string& filepath, std::function<void(Scene& scene, bool success)> on_complete = nullptr);
+
+		[[nodiscard]] bool IsLoadingAsync() const noexcept {
+			return mp_async_loader != nullptr;
+		}
+
+		// True once an async load has started replacing this scene's entities, the scene is incomplete until the load finishes
+		[[nodiscard]] bool IsInstantiatingAsync() const noexcept;
+
+		// [0, 1], 1 if no load is in progress
+		[[nodiscard]] float GetAsyncLoadProgress() const noexcept;
+
 		// Specify uuid if deserializing
 		SceneEntity& CreateEntity(const std::string& name, uint64_t uuid = 0);
 		void DeleteEntity(SceneEntity* p_entity);
 		void DeleteEntityAtEndOfFrame(SceneEntity* p_entity);
 		SceneEntity* GetEntity(uint64_t uuid);
+		// Returns the first entity found with this name, or nullptr if none exist
 		SceneEntity* GetEntity(const std::string& name);
 		SceneEntity* GetEntity(entt::entity handle);
 
@@ -128,22 +153,33 @@ namespace ORNG {
 			return m_entities;
 		}
 
+		[[nodiscard]] const ObjectPool<SceneEntity>& GetEntityPool() const noexcept {
+			return m_entity_pool;
+		}
+
 		// Instantiates prefab
 		// call_on_create will call the OnCreate function of any script components attached to the prefab or its child entities if true
 		SceneEntity& InstantiatePrefab(const Prefab& prefab, bool call_on_create = true);
 
 		SceneEntity* InstantiatePrefab(uint64_t prefab_uuid, bool call_on_create = true);
 
+		// Instantiates count copies of prefab from its compiled template, returns the root entity of each copy
+		// transforms is either empty (prefab transforms are kept) or holds one world transform per copy, applied to the root entities
+		std::vector<SceneEntity*> InstantiatePrefab(const Prefab& prefab, size_t count, std::span<const PrefabInstanceTransform> transforms, bool call_on_create = true);
+
 		// This Duplicate method is what scripts will use, it calls the OnCreate method on the script component of the entity if it has one
 		SceneEntity& DuplicateEntityCallScript(SceneEntity& original);
 
 		// Uses a noderef to attempt to find an entity, returns nullptr if none found
-		// Begins searching last layer starting from child at index "child_start"
+		// The result is cached on the ref until an entity is reparented, renamed or deleted, names must be changed with SceneEntity::SetName for this to be reliable
 		SceneEntity* TryFindEntity(const EntityNodeRef& ref);
 
 		// Searches only root entities (entities without a parent), returns nullptr if none found
 		SceneEntity* TryFindRootEntityByName(const std::string& name);
 
+		// Same result as SceneEntity::GetChild, parents with many children are searched through a hashed name table
+		SceneEntity* TryFindChildByName(SceneEntity& parent, const std::string& name);
+
 		// Generates a node ref that can be used to locally reference an entity from src "p_src".
 		EntityNodeRef GenEntityNodeRef(SceneEntity* p_src, SceneEntity* p_target);
 
@@ -151,26 +187,9 @@ namespace ORNG {
 
 		static void SortEntitiesNumParents(std::vector<SceneEntity*>& entities, bool descending);
 
-		void ClearAllEntities(bool clear_reg = true) {
-			unsigned int max_iters = 10'000'000;
-			unsigned int i = 0;
-			while (!m_entities.empty()) {
-				i++;
-
-				if (i > max_iters) {
-					ORNG_CORE_CRITICAL("Scene::ClearAllEntities exceeded max iteration count of 10,000,000, exiting");
-					break;
-				}
-
-				DeleteEntity(m_entities[0]);
-			}
-
-			if (clear_reg) m_registry.clear();
-
-			ASSERT(m_entities.empty());
-			ASSERT(m_root_entities.empty());
-		}
-
+		// Deletes every entity at once, much faster than deleting them one by one as hierarchies don't need to be unlinked
+		// If clear_reg is true the registry is also cleared, which removes entities not created through this scene such as the editor camera
+		void ClearAllEntities(bool clear_reg = true);
 
 		entt::registry& GetRegistry() {
 			return m_registry;
@@ -187,6 +206,17 @@ namespace ORNG {
 		PostProcessingSettings post_processing;
 		DirectionalLight directional_light;
 
+		// Maximum time spent instantiating entities each frame during an async load
+		float async_load_budget_ms = 4.f;
+
+		// If true, AssetManager::UnloadUnreferencedAssets is called at the end of every successful async load (including DeserializeAtEndOfFrame),
+		// releasing the assets only the outgoing scene used
+		bool unload_unreferenced_assets_on_load = true;
+
+		// If true, TransformHierarchySystem propagates transform updates by walking the updated entity's subtree in a FlatHierarchy instead of following child links
+		// Applied by the system each update, only worth the bookkeeping for large hierarchies
+		bool flat_transform_hierarchy = false;
+
 		std::unordered_map<uint64_t, ComponentSystem*> systems;
 		std::unordered_map<uint64_t, SceneEntity*> m_entity_uuid_lookup;
 		
@@ -219,7 +249,9 @@ namespace ORNG {
 		// Set externally by either editor or runtime layer
 		RenderGraph* mp_render_graph = nullptr;
 
-		SceneAsset* mp_pending_deserialization_asset = nullptr;
+		void UpdateAsyncLoad();
+
+		std::unique_ptr<AsyncSceneLoader> mp_async_loader = nullptr;
 
 		bool m_is_loaded = false;
 		bool m_started = false;
@@ -237,8 +269,30 @@ namespace ORNG {
 		// For performance, it's better to store the duplicates as children of some other entity and just call DuplicateEntity() on that one entity, refs get resolved locally quickly this way
 		std::vector<SceneEntity*> DuplicateEntityGroup(const std::vector<SceneEntity*>& group);
 
+		// Storage for every entity in m_entities, so creating/deleting entities doesn't go through the global allocator and entities are packed together
+		ObjectPool<SceneEntity> m_entity_pool;
+
+		// Unordered, entities are swap-removed using SceneEntity::m_scene_index
 		std::vector<SceneEntity*> m_entities;
-		std::vector<SceneEntity*> m_entity_deletion_queue;
+
+		// Uuids rather than pointers as an entity in the queue may be deleted along with its parent first
+		std::vector<uint64_t> m_entity_deletion_queue;
+
+		// Key = entity name, Val = entities with that name, each entity stores its slot so it can be swap-removed
+		std::unordered_map<std::string, std::vector<SceneEntity*>> m_name_index;
+
+		void IndexEntityName(SceneEntity& entity);
+		void UnindexEntityName(SceneEntity& entity);
+
+		// Incremented whenever an entity becomes or stops being a root, or a root is renamed, the per-entity equivalent is RelationshipComponent::generation
+		uint64_t m_root_generation = 1;
+
+		// Key = parent, Val = (parent's RelationshipComponent::generation when built, table of child name -> first child with that name)
+		// Built on demand, a table is rebuilt when its parent's generation changes
+		std::unordered_map<entt::entity, std::pair<uint64_t, std::unordered_map<std::string, entt::entity>>> m_child_name_tables;
+
+		// Parents with fewer children than this are searched linearly, as building a table costs more than a few string compares
+		static constexpr int CHILD_NAME_TABLE_THRESHOLD = 8;
 
 		// Entities without a parent, stored so they can be quickly found when a noderef path is being formed
 		std::unordered_set<entt::entity> m_root_entities;
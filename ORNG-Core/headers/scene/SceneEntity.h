@@ -10,6 +10,7 @@
 namespace ORNG {
 
 	class SceneEntity {
+		friend class Scene;
 	public:
 		SceneEntity() = delete;
 		SceneEntity(Scene* scene, entt::entity entt_handle, entt::registry* p_reg, uint64_t scene_uuid) : m_entt_handle(entt_handle), mp_scene(scene),
@@ -21,6 +22,10 @@ namespace ORNG {
 		}
 
 		~SceneEntity() {
+			// Already destroyed if the scene cleared all of its entities in bulk
+			if (!mp_registry->valid(m_entt_handle))
+				return;
+
 			RemoveParent();
 			mp_registry->destroy(m_entt_handle);
 		}
@@ -51,11 +56,26 @@ namespace ORNG {
 			mp_registry->erase<T>(m_entt_handle);
 		}
 
+		// Visits every descendant depth-first, parents before their children
 		// Do not delete children or rearrange them in the scene graph in the callback function
-		void ForEachChildRecursive(std::function<void(entt::entity)> func_ptr);
+		template<std::invocable<entt::entity> F>
+		void ForEachChildRecursive(F&& func) {
+			ForEachChildRecursiveInternal(func, m_entt_handle);
+		}
 
 		// Do not delete children or rearrange them in the scene graph in the callback function
-		void ForEachLevelOneChild(std::function<void(entt::entity)> func_ptr);
+		template<std::invocable<entt::entity> F>
+		void ForEachLevelOneChild(F&& func) {
+			auto& rel_comp = mp_registry->get<RelationshipComponent>(m_entt_handle);
+			entt::entity current_entity = rel_comp.first;
+
+			for (int i = 0; i < rel_comp.num_children; i++) {
+				// Store 'next' up here in case func ends up changing it which can cause this loop to jump between entities
+				auto next = mp_registry->get<RelationshipComponent>(current_entity).next;
+				func(current_entity);
+				current_entity = next;
+			}
+		}
 
 		entt::entity GetParent() {
 			return GetComponent<RelationshipComponent>()->parent;
@@ -68,7 +88,7 @@ namespace ORNG {
 			for (int i = 0; i < rel_comp.num_children; i++) {
 				auto* p_ent = mp_registry->get<TransformComponent>(current_entity).GetEntity();
 
-				if (p_ent->name == _name)
+				if (p_ent->m_name == _name)
 					return p_ent;
 
 				current_entity = mp_registry->get<RelationshipComponent>(current_entity).next;
@@ -97,11 +117,36 @@ namespace ORNG {
 
 		entt::entity GetEnttHandle() const { return m_entt_handle; }
 
-		std::string name = "Entity";
+		// Reindexes the entity so Scene::GetEntity(name) stays correct
+		void SetName(const std::string& new_name);
+
+		const std::string& GetName() const { return m_name; }
 	private:
+		std::string m_name = "Entity";
+
 		UUID<uint64_t> m_uuid;
 
-		void ForEachChildRecursiveInternal(std::function<void(entt::entity)> func_ptr, entt::entity search_entity);
+		// Position in Scene::m_entities
+		size_t m_scene_index = 0;
+
+		// Slot this entity is stored under in Scene::m_name_index
+		size_t m_name_index_slot = std::numeric_limits<size_t>::max();
+
+		bool m_pending_deletion = false;
+
+		template<typename F>
+		void ForEachChildRecursiveInternal(F& func, entt::entity search_entity) {
+			auto& rel_comp = mp_registry->get<RelationshipComponent>(search_entity);
+			entt::entity current_entity = rel_comp.first;
+
+			for (int i = 0; i < rel_comp.num_children; i++) {
+				// Store 'next' up here in case func ends up changing it which can cause this loop to jump between entities
+				auto next = mp_registry->get<RelationshipComponent>(current_entity).next;
+				func(current_entity);
+				ForEachChildRecursiveInternal(func, current_entity);
+				current_entity = next;
+			}
+		}
 
 		entt::entity m_entt_handle;
 
@@ -30,6 +30,9 @@ namespace ORNG {
 
 			// Entity is being duplicated,
 			ENTITY_REFERENCE_REMAP,
+
+			// Entity is being duplicated, listeners copy their components from the source entity directly without serializing them
+			CLONING,
 		} event_type;
 
 		EntitySerializationEvent(SceneEntity* p_ent, YAML::Emitter* p_emitter) : event_type(Type::SERIALIZING), p_entity(p_ent) {
@@ -48,6 +51,11 @@ namespace ORNG {
 			data.p_uuid_lookup = p_uuid_lookup;
 		}
 
+		// p_ent is the duplicate being created from p_src
+		EntitySerializationEvent(SceneEntity* p_ent, SceneEntity* p_src) : event_type(Type::CLONING), p_entity(p_ent) {
+			data.p_src = p_src;
+		}
+
 		SceneEntity* p_entity;
 
 		union {
@@ -60,6 +68,9 @@ namespace ORNG {
 			// Valid if event_type == ENTITY_REFERENCE_REMAP
 			// Map of original_entity_uuid -> duplicate_entity_uuid
 			const std::unordered_map<uint64_t, uint64_t>* p_uuid_lookup;
+
+			// Valid if event_type == CLONING
+			SceneEntity* p_src;
 		} data;
 	};
 
@@ -91,6 +102,10 @@ namespace ORNG {
 		// Output is either the filepath to write to or a string to be written to, if write_to_string is true then the string will be written to, no files
 		static void SerializeScene(Scene& scene, std::string& output, bool write_to_string = false);
 
+		// Snapshots the scene on the calling thread, then emits the YAML and writes it to filepath on a worker thread
+		// The file is replaced atomically once fully written, the future holds the written document, or nullopt if the save failed
+		static std::future<std::optional<YAML::Node>> SerializeSceneAsync(Scene& scene, const std::string& filepath);
+
 		// Produces a .h file with UUID values for each named entity and asset, used in scripts
 		static void SerializeSceneUUIDs(const std::vector<class SceneAsset*>& scenes, std::string& output);
 
@@ -98,6 +113,10 @@ namespace ORNG {
 		// If "node" is provided, the scene will be deserialized from that instead
 		static bool DeserializeScene(Scene& scene, const std::string& input, bool input_is_filepath = true, std::optional<YAML::Node*> node = std::nullopt);
 
+		// Loads the directional light, post processing and any data handled by SceneSerializationEvent listeners from a top-level scene node
+		// Entities are expected to already be deserialized
+		static void DeserializeSceneSettings(Scene& scene, YAML::Node& data);
+
 		static void SerializeEntity(SceneEntity& entity, YAML::Emitter& out);
 
 		// Entity argument is the entity that the data will be loaded into
@@ -120,6 +139,11 @@ namespace ORNG {
 
 		static SceneEntity& DeserializeEntityUUIDFromString(Scene& scene, const std::string& str);
 
+		// Copies every component of src onto dst directly, equivalent to serializing src and deserializing into dst without the parent
+		// Components outside of the serializer are copied by EntitySerializationEvent listeners (CLONING)
+		// dst should be freshly created, references to other entities are not remapped
+		static void CloneEntityComponents(SceneEntity& src, SceneEntity& dst);
+
 		static void SerializeEntityNodeRef(YAML::Emitter& out, const EntityNodeRef& ref);
 
 		static void DeserializeEntityNodeRef(const YAML::Node& node, EntityNodeRef& ref);
@@ -4,6 +4,7 @@ namespace ORNG {
 	class InterpolatorV1 {
 		friend class ExtraUI;
 		friend class SceneSerializer;
+		friend class BinarySceneSerializer;
 		friend struct InterpolatorSerializer;
 
 	public:
@@ -45,6 +46,7 @@ namespace ORNG {
 	class InterpolatorV3 {
 		friend class ExtraUI;
 		friend class SceneSerializer;
+		friend class BinarySceneSerializer;
 		friend struct InterpolatorSerializer;
 	public:
 		InterpolatorV3(glm::vec2 t_min_max_x, glm::vec2 t_min_max_yzw, glm::vec3 p1_val, glm::vec3 p2_val) : x_min_max(t_min_max_x), yzw_min_max(t_min_max_yzw) {
@@ -0,0 +1,68 @@
+#pragma once
+
+namespace ORNG {
+	// Allocates objects of type T from fixed-size slabs, freed slots are reused through an intrusive free list so the global allocator
+	// is only hit once per SLAB_SIZE objects. Addresses stay stable for the lifetime of an object, slabs are only released when the pool is destroyed.
+	// Not thread-safe
+	template<typename T, size_t SLAB_SIZE = 1024>
+	class ObjectPool {
+	public:
+		ObjectPool() = default;
+		ObjectPool(const ObjectPool&) = delete;
+		ObjectPool& operator=(const ObjectPool&) = delete;
+
+		// Objects still alive at this point are released without their destructors being called
+		~ObjectPool() = default;
+
+		template<typename... Args>
+		T* New(Args&&... args) {
+			if (!mp_free_list)
+				AllocateSlab();
+
+			Slot* p_slot = mp_free_list;
+			// Read before constructing as the object overwrites the link
+			Slot* p_next = p_slot->p_next_free;
+			T* p_object = std::construct_at(reinterpret_cast<T*>(p_slot->storage), std::forward<Args>(args)...);
+
+			mp_free_list = p_next;
+			m_num_live++;
+			return p_object;
+		}
+
+		void Delete(T* p_object) {
+			if (!p_object)
+				return;
+
+			std::destroy_at(p_object);
+
+			auto* p_slot = reinterpret_cast<Slot*>(p_object);
+			p_slot->p_next_free = mp_free_list;
+			mp_free_list = p_slot;
+			m_num_live--;
+		}
+
+		[[nodiscard]] size_t GetNumLive() const noexcept { return m_num_live; }
+		[[nodiscard]] size_t GetNumSlabs() const noexcept { return m_slabs.size(); }
+		[[nodiscard]] size_t GetCapacity() const noexcept { return m_slabs.size() * SLAB_SIZE; }
+
+	private:
+		union Slot {
+			Slot* p_next_free;
+			alignas(T) std::byte storage[sizeof(T)];
+		};
+
+		void AllocateSlab() {
+			Slot* p_slots = m_slabs.emplace_back(new Slot[SLAB_SIZE]).get();
+
+			// Linked in reverse so a fresh slab is handed out in address order
+			for (size_t i = SLAB_SIZE; i > 0; i--) {
+				p_slots[i - 1].p_next_free = mp_free_list;
+				mp_free_list = &p_slots[i - 1];
+			}
+		}
+
+		std::vector<std::unique_ptr<Slot[]>> m_slabs;
+		Slot* mp_free_list = nullptr;
+		size_t m_num_live = 0;
+	};
+}
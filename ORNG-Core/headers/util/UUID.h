@@ -9,17 +9,96 @@
 #endif
 
 namespace ORNG {
+	// Generates uuids from a xoshiro256** state kept per thread, so uuids can be created from any thread without locking
+	// Each thread's state is seeded once through splitmix64 from a process-wide random seed and a counter, giving every thread a separate stream
+	class UUIDGenerator {
+	public:
+		// Returns true if the uuid is already in use, a new one is generated in that case
+		using CollisionCheck = bool(*)(uint64_t uuid);
+
+		// Never returns 0 as that's used to mean "no uuid" throughout the engine
+		static uint64_t Next() noexcept {
+			auto check = s_collision_check.load(std::memory_order_relaxed);
+
+			uint64_t uuid;
+			do {
+				uuid = NextRaw();
+			} while (uuid == 0 || (check && check(uuid)));
+
+			return uuid;
+		}
+
+		// Never returns 0, the collision check isn't used as it works on 64-bit uuids
+		static uint32_t Next32() noexcept {
+			uint32_t uuid;
+			do {
+				// Upper bits are the strongest in xoshiro256** output
+				uuid = static_cast<uint32_t>(NextRaw() >> 32);
+			} while (uuid == 0);
+
+			return uuid;
+		}
+
+		// Only applies to 64-bit uuids
+		// Must be thread-safe as it's called from whichever thread generates a uuid, pass nullptr to remove it
+		static void SetCollisionCheck(CollisionCheck check) noexcept {
+			s_collision_check.store(check, std::memory_order_relaxed);
+		}
+
+	private:
+		struct State {
+			State() noexcept {
+				static const uint64_t s_process_seed = (static_cast<uint64_t>(std::random_device{}()) << 32) ^ std::random_device{}() ^
+					static_cast<uint64_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+
+				uint64_t seed = s_process_seed ^ (s_thread_counter.fetch_add(1, std::memory_order_relaxed) * 0x9E3779B97F4A7C15ull);
+				for (auto& word : s) {
+					word = SplitMix64(seed);
+				}
+			}
+
+			uint64_t s[4];
+		};
+
+		static uint64_t SplitMix64(uint64_t& x) noexcept {
+			uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+			return z ^ (z >> 31);
+		}
+
+		static uint64_t NextRaw() noexcept {
+			auto& s = s_state.s;
+			const uint64_t result = std::rotl(s[1] * 5, 7) * 9;
+			const uint64_t t = s[1] << 17;
+
+			s[2] ^= s[0];
+			s[3] ^= s[1];
+			s[1] ^= s[2];
+			s[0] ^= s[3];
+			s[2] ^= t;
+			s[3] = std::rotl(s[3], 45);
+
+			return result;
+		}
+
+		inline static thread_local State s_state;
+		inline static std::atomic<uint64_t> s_thread_counter = 0;
+		inline static std::atomic<CollisionCheck> s_collision_check = nullptr;
+	};
+
 	template<std::integral T>
 	requires(std::is_same_v<T, uint32_t> || std::is_same_v<T, uint64_t>)
 	class UUID {
 	public:
 		friend class SceneSerializer;
 		UUID() {
-			static std::random_device s_random_device;
-			static std::mt19937 s_engine(s_random_device());
-			static std::uniform_int_distribution<T> s_uniform_distribution;
-
-			m_uuid = s_uniform_distribution(s_engine);
+			if constexpr (std::is_same_v<T, uint64_t>) {
+				m_uuid = UUIDGenerator::Next();
+			}
+			else {
+				m_uuid = UUIDGenerator::Next32();
+			}
 		}
 
 		explicit UUID(T uuid) : m_uuid(uuid) {}
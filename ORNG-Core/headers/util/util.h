@@ -122,6 +122,9 @@ namespace ORNG {
 
 	bool WriteTextFile(const std::string& filepath, const std::string& content);
 
+	// Writes to a temporary file next to filepath then renames it over filepath, so filepath is never left partially written
+	bool WriteTextFileAtomic(const std::string& filepath, const std::string& content);
+
 	bool WriteBinaryFile(const std::string& filepath, std::byte* p_data, size_t size);
 
 	// Returns filepath with modified extension, "new_extension" should include the '.', e.g ".png", ".jpg"
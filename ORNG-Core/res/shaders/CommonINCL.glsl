@@ -70,7 +70,7 @@ struct DirectionalLight {
 
 struct PointLight {
 	vec4 colour; //vec4s used to prevent implicit padding
-	vec4 pos;
+	vec4 pos; // w = cull radius
 
 	float shadow_distance;
 	//attenuation
@@ -82,7 +82,7 @@ struct PointLight {
 
 struct SpotLight { //140 BYTES
 	vec4 colour; //vec4s used to prevent implicit padding
-	vec4 pos;
+	vec4 pos; // w = cull radius
 	vec4 dir;
 	mat4 light_transform_matrix;
 
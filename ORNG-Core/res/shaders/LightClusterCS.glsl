@@ -0,0 +1,93 @@
+#version 460 core
+
+// Assigns point and spot lights to the clusters their bounding spheres (pos.xyz, pos.w = radius) touch, one invocation per cluster
+// Mirrors LightClusterBuilder::Build
+ORNG_INCLUDE "LightClusterINCL.glsl"
+
+#define GROUP_SIZE 64
+
+layout(local_size_x = GROUP_SIZE, local_size_y = 1, local_size_z = 1) in;
+
+// View space pos + radius of the batch of lights currently being tested by the group
+shared vec4 s_lights[GROUP_SIZE];
+
+void GetClusterBounds(uvec3 cluster, out vec3 bounds_min, out vec3 bounds_max) {
+	vec2 ndc_min = vec2(cluster.x / float(LIGHT_CLUSTERS_X), cluster.y / float(LIGHT_CLUSTERS_Y)) * 2.0 - 1.0;
+	vec2 ndc_max = vec2((cluster.x + 1) / float(LIGHT_CLUSTERS_X), (cluster.y + 1) / float(LIGHT_CLUSTERS_Y)) * 2.0 - 1.0;
+
+	float depth_ratio = ubo_common.cam_zfar / ubo_common.cam_znear;
+	float slice_near = ubo_common.cam_znear * pow(depth_ratio, cluster.z / float(LIGHT_CLUSTERS_Z));
+	float slice_far = ubo_common.cam_znear * pow(depth_ratio, (cluster.z + 1) / float(LIGHT_CLUSTERS_Z));
+
+	bounds_min = vec3(3.402823466e+38);
+	bounds_max = vec3(-3.402823466e+38);
+
+	for (int i = 0; i < 4; i++) {
+		vec2 ndc = vec2((i & 1) != 0 ? ndc_max.x : ndc_min.x, (i & 2) != 0 ? ndc_max.y : ndc_min.y);
+		// Point on the near plane, the tile's edges are rays from the origin through it
+		vec4 p = PVMatrices.inv_projection * vec4(ndc, -1.0, 1.0);
+		vec3 ray = p.xyz / p.w;
+
+		vec3 corner_near = ray * (slice_near / -ray.z);
+		vec3 corner_far = ray * (slice_far / -ray.z);
+		bounds_min = min(bounds_min, min(corner_near, corner_far));
+		bounds_max = max(bounds_max, max(corner_near, corner_far));
+	}
+}
+
+bool SphereIntersectsAABB(vec4 sphere, vec3 bounds_min, vec3 bounds_max) {
+	vec3 diff = clamp(sphere.xyz, bounds_min, bounds_max) - sphere.xyz;
+	return dot(diff, diff) <= sphere.w * sphere.w;
+}
+
+void main() {
+	uint cluster = gl_GlobalInvocationID.x;
+	// Out of range invocations still take part in loading batches so barriers are reached by the whole group
+	bool active = cluster < NUM_LIGHT_CLUSTERS;
+
+	vec3 bounds_min, bounds_max;
+	GetClusterBounds(uvec3(cluster % LIGHT_CLUSTERS_X, (cluster / LIGHT_CLUSTERS_X) % LIGHT_CLUSTERS_Y, cluster / (LIGHT_CLUSTERS_X * LIGHT_CLUSTERS_Y)), bounds_min, bounds_max);
+
+	uint base = cluster * LIGHT_CLUSTER_STRIDE;
+	uint num_points = 0;
+	uint num_spots = 0;
+
+	uint total_points = ubo_point_lights.lights.length();
+	for (uint batch = 0; batch < total_points; batch += uint(GROUP_SIZE)) {
+		uint load_index = batch + gl_LocalInvocationIndex;
+		if (load_index < total_points) {
+			vec4 pos = ubo_point_lights.lights[load_index].pos;
+			s_lights[gl_LocalInvocationIndex] = vec4((PVMatrices.view * vec4(pos.xyz, 1.0)).xyz, pos.w);
+		}
+		barrier();
+
+		uint batch_size = min(uint(GROUP_SIZE), total_points - batch);
+		for (uint i = 0; active && i < batch_size; i++) {
+			if (num_points < MAX_LIGHTS_PER_CLUSTER && SphereIntersectsAABB(s_lights[i], bounds_min, bounds_max))
+				ssbo_light_clusters.data[base + 2 + num_points++] = batch + i;
+		}
+		barrier();
+	}
+
+	uint total_spots = ubo_spot_lights.lights.length();
+	for (uint batch = 0; batch < total_spots; batch += uint(GROUP_SIZE)) {
+		uint load_index = batch + gl_LocalInvocationIndex;
+		if (load_index < total_spots) {
+			vec4 pos = ubo_spot_lights.lights[load_index].pos;
+			s_lights[gl_LocalInvocationIndex] = vec4((PVMatrices.view * vec4(pos.xyz, 1.0)).xyz, pos.w);
+		}
+		barrier();
+
+		uint batch_size = min(uint(GROUP_SIZE), total_spots - batch);
+		for (uint i = 0; active && i < batch_size; i++) {
+			if (num_points + num_spots < MAX_LIGHTS_PER_CLUSTER && SphereIntersectsAABB(s_lights[i], bounds_min, bounds_max))
+				ssbo_light_clusters.data[base + 2 + num_points + num_spots++] = batch + i;
+		}
+		barrier();
+	}
+
+	if (active) {
+		ssbo_light_clusters.data[base] = num_points;
+		ssbo_light_clusters.data[base + 1] = num_spots;
+	}
+}
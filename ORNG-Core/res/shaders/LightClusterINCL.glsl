@@ -0,0 +1,34 @@
+// GLSL side of LightClusterBuilder, the defines below are passed in from LightClusterBuilder::GetShaderDefines
+ORNG_INCLUDE "BuffersINCL.glsl"
+
+#ifndef LIGHT_CLUSTERS_X
+#error "Light cluster dimensions not defined, use LightClusterBuilder::GetShaderDefines"
+#endif
+
+#define NUM_LIGHT_CLUSTERS (LIGHT_CLUSTERS_X * LIGHT_CLUSTERS_Y * LIGHT_CLUSTERS_Z)
+#define LIGHT_CLUSTER_STRIDE (2 + MAX_LIGHTS_PER_CLUSTER)
+
+// Each cluster is [num point lights, num spot lights, point light indices..., spot light indices...]
+layout(std430, binding = 3) buffer LightClusters {
+	uint data[];
+} ssbo_light_clusters;
+
+uint GetLightClusterIndex(vec2 screen_uv, float view_depth) {
+	screen_uv = clamp(screen_uv, vec2(0.0), vec2(1.0));
+	uint x = min(uint(screen_uv.x * LIGHT_CLUSTERS_X), LIGHT_CLUSTERS_X - 1);
+	uint y = min(uint(screen_uv.y * LIGHT_CLUSTERS_Y), LIGHT_CLUSTERS_Y - 1);
+
+	float slice = log(max(view_depth, ubo_common.cam_znear) / ubo_common.cam_znear) / log(ubo_common.cam_zfar / ubo_common.cam_znear) * LIGHT_CLUSTERS_Z;
+	uint z = min(uint(max(slice, 0.0)), LIGHT_CLUSTERS_Z - 1);
+
+	return x + y * LIGHT_CLUSTERS_X + z * LIGHT_CLUSTERS_X * LIGHT_CLUSTERS_Y;
+}
+
+// Offset of the cluster containing world_pos in ssbo_light_clusters
+uint GetLightClusterBase(vec3 world_pos) {
+	vec4 clip = PVMatrices.proj_view * vec4(world_pos, 1.0);
+	vec2 screen_uv = clip.xy / clip.w * 0.5 + 0.5;
+	float view_depth = -(PVMatrices.view * vec4(world_pos, 1.0)).z;
+
+	return GetLightClusterIndex(screen_uv, view_depth) * LIGHT_CLUSTER_STRIDE;
+}
@@ -2,6 +2,10 @@
 ORNG_INCLUDE "BuffersINCL.glsl"
 ORNG_INCLUDE "ShadowsINCL.glsl"
 
+#ifdef LIGHT_CLUSTERS_X
+ORNG_INCLUDE "LightClusterINCL.glsl"
+#endif
+
 #ifndef SPECULAR_PREFILTER_SAMPLER
 #error "No specular prefilter sampler defined for lighting calculations"
 #endif
@@ -168,6 +172,27 @@ vec3 CalcDirectionalLight(vec3 v, vec3 f0, vec3 n, float roughness, float metall
 
 
 
+vec3 CalcShadowedSpotLight(int i, vec3 v, vec3 f0, vec3 world_pos, vec3 n, float roughness, float metallic, vec3 albedo) {
+	if (ubo_spot_lights.lights[i].shadow_distance > 0.f) {
+		float shadow = ShadowCalculationSpotlight(ubo_spot_lights.lights[i], i, world_pos);
+
+		if (shadow >= 0.99)
+			return vec3(0);
+
+		return CalcSpotLight(ubo_spot_lights.lights[i], v, f0, i, world_pos, n, roughness, metallic, albedo) * (1.0 - shadow);
+	} else {
+		return CalcSpotLight(ubo_spot_lights.lights[i], v, f0, i, world_pos, n, roughness, metallic, albedo);
+	}
+}
+
+vec3 CalcShadowedPointLight(int i, vec3 v, vec3 f0, vec3 world_pos, vec3 n, float roughness, float metallic, vec3 albedo) {
+	if (ubo_point_lights.lights[i].shadow_distance > 0.f)
+		return CalcPointLight(ubo_point_lights.lights[i], v, f0, i, world_pos, n, roughness, metallic, albedo) * (1.0 - ShadowCalculationPointlight(ubo_point_lights.lights[i], i, world_pos));
+	else
+		return CalcPointLight(ubo_point_lights.lights[i], v, f0, i, world_pos, n, roughness, metallic, albedo);
+}
+
+// If the including shader has LightClusterBuilder::GetShaderDefines, only lights in world_pos's cluster are evaluated
 vec3 CalculateDirectLightContribution(vec3 v, vec3 f0, vec3 world_pos, vec3 n, float roughness, float metallic, vec3 albedo) {
 	vec3 total_light = vec3(0);
 	// Directional light
@@ -178,28 +203,31 @@ vec3 CalculateDirectLightContribution(vec3 v, vec3 f0, vec3 world_pos, vec3 n, f
 		total_light += CalcDirectionalLight(v, f0, n, roughness, metallic, albedo);
 	}
 
-	//Spotlights
-	for (int i = 0; i < ubo_spot_lights.lights.length(); i++) {
-		if (ubo_spot_lights.lights[i].shadow_distance > 0.f) {
-			float shadow = ShadowCalculationSpotlight(ubo_spot_lights.lights[i], i, world_pos);
+#ifdef LIGHT_CLUSTERS_X
+	uint cluster_base = GetLightClusterBase(world_pos);
+	uint num_cluster_points = ssbo_light_clusters.data[cluster_base];
+	uint num_cluster_spots = ssbo_light_clusters.data[cluster_base + 1];
 
-			if (shadow >= 0.99)
-				continue;
+	//Spotlights
+	for (uint j = 0; j < num_cluster_spots; j++) {
+		total_light += CalcShadowedSpotLight(int(ssbo_light_clusters.data[cluster_base + 2 + num_cluster_points + j]), v, f0, world_pos, n, roughness, metallic, albedo);
+	}
 
-			total_light += CalcSpotLight(ubo_spot_lights.lights[i], v, f0, i, world_pos, n, roughness, metallic, albedo) * (1.0 - shadow);
-		} else {
-			total_light += CalcSpotLight(ubo_spot_lights.lights[i], v, f0, i, world_pos, n, roughness, metallic, albedo);
-		}
+	// Pointlights
+	for (uint j = 0; j < num_cluster_points; j++) {
+		total_light += CalcShadowedPointLight(int(ssbo_light_clusters.data[cluster_base + 2 + j]), v, f0, world_pos, n, roughness, metallic, albedo);
+	}
+#else
+	//Spotlights
+	for (int i = 0; i < ubo_spot_lights.lights.length(); i++) {
+		total_light += CalcShadowedSpotLight(i, v, f0, world_pos, n, roughness, metallic, albedo);
 	}
 
-		// Pointlights
+	// Pointlights
 	for (int i = 0; i < ubo_point_lights.lights.length(); i++) {
-		if (ubo_point_lights.lights[i].shadow_distance > 0.f)
-			total_light += CalcPointLight(ubo_point_lights.lights[i], v, f0, i, world_pos, n, roughness, metallic, albedo) * (1.0 - ShadowCalculationPointlight(ubo_point_lights.lights[i], i, world_pos));
-		else
-			total_light += CalcPointLight(ubo_point_lights.lights[i], v, f0, i, world_pos, n, roughness, metallic, albedo) ;
+		total_light += CalcShadowedPointLight(i, v, f0, world_pos, n, roughness, metallic, albedo);
 	}
-
+#endif
 
 	return total_light;
 }
@@ -5,10 +5,29 @@
 #include "rendering/MeshAsset.h"
 #include "core/GLStateManager.h"
 #include "rendering/EnvMapLoader.h"
+#include "util/Timers.h"
 
 
 namespace ORNG {
+	static constexpr std::array<AssetHandle<Texture2D> Material::*, Material::NUM_TEXTURE_SLOTS> MATERIAL_TEXTURE_SLOTS = {
+		&Material::base_colour_texture, &Material::normal_map_texture, &Material::metallic_texture, &Material::roughness_texture,
+		&Material::ao_texture, &Material::displacement_texture, &Material::emissive_texture
+	};
+
+	void AssetHandleBase::AddRef(const Asset* p_asset) {
+		// Only the first reference can require a reload, assets are never unloaded while referenced
+		if (p_asset->m_ref_count.fetch_add(1, std::memory_order_relaxed) == 0 && AssetManager::mp_instance)
+			AssetManager::Get().OnAssetReferenced(p_asset);
+	}
+
+	void AssetHandleBase::RemoveRef(const Asset* p_asset) {
+		DEBUG_ASSERT(p_asset->m_ref_count > 0);
+		p_asset->m_ref_count.fetch_sub(1, std::memory_order_relaxed);
+	}
+
 	void AssetManager::I_Init() {
+		m_main_thread_id = std::this_thread::get_id();
+		OnWorkingDirectoryChanged();
 		InitBaseAssets();
 		serializer.Init();
 
@@ -16,6 +35,8 @@ namespace ORNG {
 		m_update_listener.OnEvent = [this](const Events::EngineCoreEvent& t_event) {
 			if (t_event.event_type != Events::EngineCoreEvent::EventType::UPDATE) return;
 			serializer.ProcessAssetQueues();
+			ProcessReloadQueue();
+			texture_streamer.Update();
 			};
 
 		Events::EventManager::RegisterListener(m_update_listener);
@@ -38,30 +59,332 @@ namespace ORNG {
 			}
 
 			HandleAssetDeletion(it->second);
+			RemoveFromIndices(it->second);
 			delete it->second;
 			it = m_assets.erase(it);
 		}
 	}
 
 
+	static bool IsIgnoredPathChar(char c) {
+		return c == '\\' || c == '/' || c == '.';
+	}
+
+	void AssetManager::OnWorkingDirectoryChanged() {
+		Get().m_normalised_cwd = std::filesystem::current_path().string();
+		std::erase_if(Get().m_normalised_cwd, IsIgnoredPathChar);
+	}
+
+	std::string AssetManager::NormalisePathForLookup(const std::string& filepath) {
+		std::string normalised = filepath;
+		std::erase_if(normalised, IsIgnoredPathChar);
+
+		const std::string& cwd = Get().m_normalised_cwd;
+		if (normalised.starts_with(cwd))
+			normalised.erase(0, cwd.size());
+
+		return normalised;
+	}
+
+	void AssetManager::IndexPath(Asset* p_asset) {
+		if (p_asset->filepath.empty())
+			return;
+
+		std::string key = NormalisePathForLookup(p_asset->filepath);
+		m_path_index.emplace(key, p_asset->uuid());
+		m_indexed_paths[p_asset->uuid()] = std::move(key);
+	}
+
+	void AssetManager::UnindexPath(uint64_t uuid) {
+		auto path_it = m_indexed_paths.find(uuid);
+		if (path_it == m_indexed_paths.end())
+			return;
+
+		auto [begin, end] = m_path_index.equal_range(path_it->second);
+		for (auto it = begin; it != end; it++) {
+			if (it->second == uuid) {
+				m_path_index.erase(it);
+				break;
+			}
+		}
+
+		m_indexed_paths.erase(path_it);
+	}
+
+	void AssetManager::IndexMaterialDependencies(Material* p_material) {
+		auto& dependencies = m_material_dependencies[p_material->uuid()];
+
+		for (auto slot : MATERIAL_TEXTURE_SLOTS) {
+			Texture2D* p_tex = p_material->*slot;
+			if (!p_tex)
+				continue;
+
+			m_texture_dependents[p_tex->uuid()].insert(p_material->uuid());
+			dependencies.push_back(p_tex->uuid());
+		}
+	}
+
+	void AssetManager::UnindexMaterialDependencies(uint64_t material_uuid) {
+		auto it = m_material_dependencies.find(material_uuid);
+		if (it == m_material_dependencies.end())
+			return;
+
+		for (uint64_t tex_uuid : it->second) {
+			if (auto dependents_it = m_texture_dependents.find(tex_uuid); dependents_it != m_texture_dependents.end())
+				dependents_it->second.erase(material_uuid);
+		}
+
+		m_material_dependencies.erase(it);
+	}
+
+	void AssetManager::AddToIndices(Asset* p_asset) {
+		auto& storage = m_typed_storage[std::type_index{ typeid(*p_asset) }];
+		storage.indices[p_asset->uuid()] = storage.assets.size();
+		storage.assets.push_back(p_asset);
+
+		IndexPath(p_asset);
+
+		if (auto* p_material = dynamic_cast<Material*>(p_asset))
+			IndexMaterialDependencies(p_material);
+	}
+
+	void AssetManager::RemoveFromIndices(Asset* p_asset) {
+		uint64_t uuid = p_asset->uuid();
+
+		if (auto type_it = m_typed_storage.find(std::type_index{ typeid(*p_asset) }); type_it != m_typed_storage.end()) {
+			AssetTypeStorage& storage = type_it->second;
+			if (auto idx_it = storage.indices.find(uuid); idx_it != storage.indices.end()) {
+				size_t idx = idx_it->second;
+				storage.indices.erase(idx_it);
+
+				// Swap-remove, fix up the index of the asset moved into the gap
+				if (idx != storage.assets.size() - 1) {
+					storage.assets[idx] = storage.assets.back();
+					storage.indices[storage.assets[idx]->uuid()] = idx;
+				}
+
+				storage.assets.pop_back();
+			}
+		}
+
+		UnindexPath(uuid);
+		UnindexMaterialDependencies(uuid);
+		m_texture_dependents.erase(uuid);
+
+		m_keep_alive_assets.erase(uuid);
+		m_unloaded_material_textures.erase(uuid);
+		std::scoped_lock lock{ m_unload_mutex };
+		m_unloaded_assets.erase(uuid);
+	}
+
+	void AssetManager::RemoveBaseAssetEntry(BaseAssetIDs id) {
+		auto it = m_assets.find(static_cast<uint64_t>(id));
+		if (it == m_assets.end())
+			return;
+
+		RemoveFromIndices(it->second);
+		m_assets.erase(it);
+	}
+
+	void AssetManager::SetAssetFilepath(Asset* p_asset, const std::string& filepath) {
+		auto& instance = Get();
+		p_asset->filepath = filepath;
+
+		if (!instance.m_assets.contains(p_asset->uuid()))
+			return;
+
+		instance.UnindexPath(p_asset->uuid());
+		instance.IndexPath(p_asset);
+	}
+
+	void AssetManager::OnMaterialTexturesChanged(Material* p_material) {
+		auto& instance = Get();
+		if (!instance.m_assets.contains(p_material->uuid()))
+			return;
+
+		instance.UnindexMaterialDependencies(p_material->uuid());
+		instance.IndexMaterialDependencies(p_material);
+	}
+
+
 	void AssetManager::OnTextureDelete(Texture2D* p_tex) {
+		auto& instance = Get();
+		instance.texture_streamer.OnTextureDeleted(p_tex);
+
+		auto it = instance.m_texture_dependents.find(p_tex->uuid());
+		if (it == instance.m_texture_dependents.end())
+			return;
+
 		// If any materials use this texture, remove it from them
-		for (auto& [key, p_asset] : Get().m_assets) {
-			auto* p_material = dynamic_cast<Material*>(p_asset);
-			if (!p_material)
+		for (uint64_t material_uuid : it->second) {
+			auto material_it = instance.m_assets.find(material_uuid);
+			if (material_it == instance.m_assets.end())
 				continue;
 
-			p_material->base_colour_texture = p_material->base_colour_texture == p_tex ? nullptr : p_material->base_colour_texture;
-			p_material->normal_map_texture = p_material->normal_map_texture == p_tex ? nullptr : p_material->normal_map_texture;
-			p_material->emissive_texture = p_material->emissive_texture == p_tex ? nullptr : p_material->emissive_texture;
-			p_material->displacement_texture = p_material->displacement_texture == p_tex ? nullptr : p_material->displacement_texture;
-			p_material->metallic_texture = p_material->metallic_texture == p_tex ? nullptr : p_material->metallic_texture;
-			p_material->roughness_texture = p_material->roughness_texture == p_tex ? nullptr : p_material->roughness_texture;
+			auto* p_material = static_cast<Material*>(material_it->second);
+			for (auto slot : MATERIAL_TEXTURE_SLOTS) {
+				if (p_material->*slot == p_tex)
+					p_material->*slot = nullptr;
+			}
 		}
 	}
 
 	
 
+	void AssetManager::OnAssetReferenced(const Asset* p_asset) {
+		{
+			std::scoped_lock lock{ m_unload_mutex };
+			if (!m_unloaded_assets.contains(p_asset->uuid()))
+				return;
+
+			// GL calls can only be made on the main thread
+			if (std::this_thread::get_id() != m_main_thread_id) {
+				m_reload_queue.push_back(p_asset->uuid());
+				return;
+			}
+
+			m_unloaded_assets.erase(p_asset->uuid());
+		}
+
+		// Lock is released first as reloading a material references its textures, which can recurse back into here
+		// Handles only hold const pointers to some assets, the asset itself is owned and mutable here
+		ReloadAsset(m_assets[p_asset->uuid()]);
+	}
+
+	void AssetManager::ProcessReloadQueue() {
+		std::vector<uint64_t> reload_queue;
+		{
+			std::scoped_lock lock{ m_unload_mutex };
+			if (m_reload_queue.empty())
+				return;
+
+			reload_queue.swap(m_reload_queue);
+		}
+
+		for (uint64_t uuid : reload_queue) {
+			{
+				std::scoped_lock lock{ m_unload_mutex };
+				// May have been reloaded already by a reference on the main thread
+				if (!m_unloaded_assets.contains(uuid))
+					continue;
+
+				m_unloaded_assets.erase(uuid);
+			}
+
+			if (auto it = m_assets.find(uuid); it != m_assets.end())
+				ReloadAsset(it->second);
+		}
+	}
+
+	bool AssetManager::UnloadAsset(Asset* p_asset) {
+		if (auto* p_tex = dynamic_cast<Texture2D*>(p_asset)) {
+			if (GetFileExtension(p_tex->filepath) != ".otex" || !FileExists(p_tex->filepath))
+				return false;
+
+			texture_streamer.OnTextureDeleted(p_tex);
+			p_tex->Unload();
+		}
+		else if (auto* p_mesh = dynamic_cast<MeshAsset*>(p_asset)) {
+			if (GetFileExtension(p_mesh->filepath) != ".omesh" || !FileExists(p_mesh->filepath))
+				return false;
+
+			// AABB is kept as it's small and used without the mesh being drawn
+			p_mesh->ClearCPU_VertexData();
+			p_mesh->m_vao.ReleaseBuffers();
+			p_mesh->m_submeshes.clear();
+			p_mesh->m_is_loaded = false;
+		}
+		else if (auto* p_material = dynamic_cast<Material*>(p_asset)) {
+			// Releasing the texture handles allows textures only used by unreferenced materials to be unloaded
+			auto& texture_uuids = m_unloaded_material_textures[p_material->uuid()];
+			for (size_t i = 0; i < MATERIAL_TEXTURE_SLOTS.size(); i++) {
+				AssetHandle<Texture2D>& slot = p_material->*MATERIAL_TEXTURE_SLOTS[i];
+				texture_uuids[i] = slot ? slot->uuid() : 0;
+				slot = nullptr;
+			}
+		}
+		else {
+			return false;
+		}
+
+		return true;
+	}
+
+	void AssetManager::ReloadAsset(Asset* p_asset) {
+		ORNG_PROFILE_FUNC();
+
+		if (auto* p_tex = dynamic_cast<Texture2D*>(p_asset)) {
+			// Deserializing resets the spec which overwrites the filepath
+			std::string filepath = p_tex->filepath;
+			std::vector<std::byte> binary_data;
+			serializer.DeserializeAssetBinary(filepath, *p_tex, &binary_data);
+			p_tex->filepath = filepath;
+
+			if (!texture_streamer.LoadResidentMips(*p_tex, binary_data))
+				ORNG_CORE_ERROR("Failed reloading texture '{0}'", filepath);
+		}
+		else if (auto* p_mesh = dynamic_cast<MeshAsset*>(p_asset)) {
+			serializer.DeserializeAssetBinary(p_mesh->filepath, *p_mesh);
+			serializer.LoadMeshAssetIntoGL(p_mesh);
+		}
+		else if (auto* p_material = dynamic_cast<Material*>(p_asset)) {
+			auto it = m_unloaded_material_textures.find(p_material->uuid());
+			if (it == m_unloaded_material_textures.end())
+				return;
+
+			// Textures that were deleted while the material was unloaded are left empty
+			for (size_t i = 0; i < MATERIAL_TEXTURE_SLOTS.size(); i++) {
+				if (it->second[i] != 0)
+					p_material->*MATERIAL_TEXTURE_SLOTS[i] = GetAsset<Texture2D>(it->second[i]);
+			}
+
+			m_unloaded_material_textures.erase(it);
+		}
+	}
+
+	void AssetManager::UnloadUnreferencedAssets() {
+		ORNG_PROFILE_FUNC();
+		auto& instance = Get();
+		std::scoped_lock lock{ instance.m_unload_mutex };
+
+		size_t num_unloaded = 0;
+
+		// Materials go first as unloading them releases their textures
+		for (auto type : { std::type_index{ typeid(Material) }, std::type_index{ typeid(MeshAsset) }, std::type_index{ typeid(Texture2D) } }) {
+			auto storage_it = instance.m_typed_storage.find(type);
+			if (storage_it == instance.m_typed_storage.end())
+				continue;
+
+			for (Asset* p_asset : storage_it->second.assets) {
+				uint64_t uuid = p_asset->uuid();
+				if (p_asset->GetRefCount() != 0 || uuid < static_cast<uint64_t>(BaseAssetIDs::NUM_BASE_ASSETS) ||
+					instance.m_keep_alive_assets.contains(uuid) || instance.m_unloaded_assets.contains(uuid))
+					continue;
+
+				if (instance.UnloadAsset(p_asset)) {
+					instance.m_unloaded_assets.insert(uuid);
+					num_unloaded++;
+				}
+			}
+		}
+
+		ORNG_CORE_INFO("Unloaded {0} unreferenced assets", num_unloaded);
+	}
+
+	void AssetManager::SetKeepAlive(uint64_t uuid, bool keep_alive) {
+		auto& instance = Get();
+		if (keep_alive)
+			instance.m_keep_alive_assets.insert(uuid);
+		else
+			instance.m_keep_alive_assets.erase(uuid);
+	}
+
+	bool AssetManager::IsUnloaded(uint64_t uuid) {
+		auto& instance = Get();
+		std::scoped_lock lock{ instance.m_unload_mutex };
+		return instance.m_unloaded_assets.contains(uuid);
+	}
+
 	void AssetManager::HandleAssetAddition(Asset* p_asset) {
 		if (auto* p_material = dynamic_cast<Material*>(p_asset)) {
 			DispatchAssetEvent(Events::AssetEventType::MATERIAL_LOADED, reinterpret_cast<uint8_t*>(p_material));
@@ -73,17 +396,23 @@ namespace ORNG {
 			OnTextureDelete(p_tex);
 			DispatchAssetEvent(Events::AssetEventType::TEXTURE_DELETED, reinterpret_cast<uint8_t*>(p_tex));
 		}
+		else if (auto* p_material = dynamic_cast<Material*>(p_asset)) {
+			DispatchAssetEvent(Events::AssetEventType::MATERIAL_DELETED, reinterpret_cast<uint8_t*>(p_material));
+		}
+		else if (auto* p_mesh = dynamic_cast<MeshAsset*>(p_asset)) {
+			DispatchAssetEvent(Events::AssetEventType::MESH_DELETED, reinterpret_cast<uint8_t*>(p_mesh));
+		}
 	}
 
 	void AssetManager::LoadExternalBaseAssets(const std::string& project_dir) {
-		m_assets.erase(static_cast<uint64_t>(BaseAssetIDs::CLICK_SOUND));
+		RemoveBaseAssetEntry(BaseAssetIDs::CLICK_SOUND);
 		mp_base_sound = std::make_unique<SoundAsset>(project_dir + "res/core-res/audio/mouse-click.mp3");
 		mp_base_sound->uuid = UUID<uint64_t>(static_cast<uint64_t>(BaseAssetIDs::CLICK_SOUND));
 		mp_base_sound->source_filepath = project_dir + "res/core-res/audio/mouse-click.mp3";
 		mp_base_sound->CreateSoundFromFile();
 		AddAsset(&*mp_base_sound);
 
-		m_assets.erase(static_cast<uint64_t>(BaseAssetIDs::SPHERE_MESH));
+		RemoveBaseAssetEntry(BaseAssetIDs::SPHERE_MESH);
 		mp_base_sphere = nullptr;
 		mp_base_sphere = std::make_unique<MeshAsset>("res/meshes/sphere.obmesh");
 		serializer.DeserializeAssetBinary("res/core-res/meshes/sphere.obmesh", *mp_base_sphere);
@@ -93,7 +422,7 @@ namespace ORNG {
 		mp_base_sphere->m_material_uuids.push_back(static_cast<uint64_t>(BaseAssetIDs::DEFAULT_MATERIAL));
 		AddAsset(&*mp_base_sphere);
 
-		m_assets.erase(static_cast<uint64_t>(BaseAssetIDs::CUBE_MESH));
+		RemoveBaseAssetEntry(BaseAssetIDs::CUBE_MESH);
 		mp_base_cube = nullptr;
 		mp_base_cube = std::make_unique<MeshAsset>("res/meshes/cube.obmesh");
 		serializer.DeserializeAssetBinary("res/core-res/meshes/cube.obmesh", *mp_base_cube);
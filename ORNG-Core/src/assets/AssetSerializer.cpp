@@ -19,10 +19,11 @@
 #include "core/GLStateManager.h"
 #include "core/Window.h" // For shared loading context
 #include "assets/SceneAsset.h"
+#include "scene/BinarySceneSerializer.h"
 
 using namespace ORNG;
 
-constexpr size_t MAX_SCENE_YAML_SIZE = 100'000'000;
+constexpr size_t MAX_BINARY_SCENE_SIZE = 1'000'000'000;
 
 void AssetSerializer::ProcessAssetQueues() {
 	for (size_t i = 0; i < m_mesh_loading_queue.size(); i++) {
@@ -150,14 +151,75 @@ bool AssetSerializer::TryFetchRawTextureData(Texture2D& tex, std::vector<std::by
 	return false;
 }
 
+bool AssetSerializer::ReadRawTextureDataFromBinaryFile(const std::string& filepath, std::vector<std::byte>& output) {
+	std::vector<std::byte> buf;
+	if (!ReadBinaryFile(filepath, buf))
+		return false;
+
+	BufferDeserializer des{ buf.begin(), buf.end() };
+	Texture2DSpec spec;
+	UUID<uint64_t> uuid{ 0 };
+	des.object(spec);
+	des.object(uuid);
+	des.container1b(output, UINT64_MAX);
+
+	return !output.empty();
+}
+
+bool AssetSerializer::ReadVertexDataFromBinaryFile(const std::string& filepath, VertexData3D& output) {
+	std::vector<std::byte> buf;
+	if (!ReadBinaryFile(filepath, buf))
+		return false;
+
+	// Same layout as DeserializeMeshAsset, stopping after the submeshes
+	BufferDeserializer des{ buf.begin(), buf.end() };
+	AABB aabb;
+	uint32_t num_submeshes = 0;
+	des.object(output);
+	des.object(aabb);
+	des.value4b(num_submeshes);
+
+	std::vector<MeshEntry> submeshes(num_submeshes);
+	for (auto& entry : submeshes) {
+		des.object(entry);
+	}
+
+	if (des.adapter().error() != bitsery::ReaderError::NoError)
+		return false;
+
+	for (const auto& entry : submeshes) {
+		const size_t end = std::min(static_cast<size_t>(entry.base_index) + entry.num_indices, output.indices.size());
+		for (size_t i = entry.base_index; i < end; i++) {
+			output.indices[i] += entry.base_vertex;
+		}
+	}
+
+	return !output.positions.empty();
+}
+
 void AssetSerializer::SerializeSceneAsset(SceneAsset &scene_asset, BufferSerializer &ser) {
+	// Scenes are packaged in the binary scene format so they don't need to be parsed from YAML at runtime
+	std::vector<std::byte> binary_data;
 	std::string content = ReadTextFile(scene_asset.filepath);
-	if (content.empty()) {
-		ORNG_CORE_ERROR("Failed to serialize scene asset, yaml contents could not be read from: '{}'", scene_asset.filepath);
-		return;
+
+	try {
+		if (content.empty() || !BinarySceneSerializer::ConvertYAMLToBinary(YAML::Load(content), binary_data))
+			ORNG_CORE_ERROR("Failed to serialize scene asset, yaml contents could not be read from: '{}'", scene_asset.filepath);
+	} catch (const YAML::Exception& e) {
+		ORNG_CORE_ERROR("Failed to serialize scene asset '{}', '{}'", scene_asset.filepath, e.what());
 	}
 
-	ser.text1b(content, MAX_SCENE_YAML_SIZE);
+	// Always written so the package layout stays intact, empty data fails to load as a scene
+	ser.container1b(binary_data, MAX_BINARY_SCENE_SIZE);
+}
+
+void AssetSerializer::SerializePrefabAsset(Prefab& prefab, BufferSerializer& ser) {
+	std::vector<std::byte> binary_data;
+	if (!BinarySceneSerializer::ConvertYAMLToBinary(prefab.node, binary_data))
+		ORNG_CORE_ERROR("Failed to serialize prefab asset '{}'", prefab.filepath);
+
+	ser.object(prefab.uuid);
+	ser.container1b(binary_data, MAX_BINARY_SCENE_SIZE);
 }
 
 void AssetSerializer::DeserializeAssetsFromBinaryPackage(const std::string& package_filepath) {
@@ -173,13 +235,13 @@ void AssetSerializer::DeserializeAssetsFromBinaryPackage(const std::string& pack
 
 	BufferDeserializer des{ file_data.begin(), file_data.end() };
 
-	uint32_t num_textures, num_meshes, num_sounds, num_prefabs, num_materials, num_phys_materials, num_scenes;
+	// Must match the layout written in CreateBinaryAssetPackage
+	uint32_t num_textures, num_meshes, num_sounds, num_prefabs, num_materials, num_scenes;
 	des.value4b(num_textures);
 	des.value4b(num_meshes);
 	des.value4b(num_sounds);
 	des.value4b(num_prefabs);
 	des.value4b(num_materials);
-	des.value4b(num_phys_materials);
 	des.value4b(num_scenes);
 
 	std::vector<std::byte> bin_data;
@@ -214,8 +276,8 @@ void AssetSerializer::DeserializeAssetsFromBinaryPackage(const std::string& pack
 	for (uint32_t i = 0; i < num_prefabs; i++) {
 		auto* p_prefab = new Prefab{""};
 
-		des.object(*p_prefab);
-		p_prefab->node = YAML::Load(p_prefab->serialized_content);
+		des.object(p_prefab->uuid);
+		des.container1b(p_prefab->binary_data, MAX_BINARY_SCENE_SIZE);
 		m_manager.AddAsset(p_prefab);
 	}
 
@@ -229,15 +291,15 @@ void AssetSerializer::DeserializeAssetsFromBinaryPackage(const std::string& pack
 	for (uint32_t i = 0; i < num_scenes; i++) {
 		auto* p_scene = new SceneAsset{""};
 
-		std::string contents;
-		des.text1b(contents, MAX_SCENE_YAML_SIZE);
+		des.container1b(p_scene->binary_data, MAX_BINARY_SCENE_SIZE);
 
-		try {
-			p_scene->node = YAML::Load(contents);
-			p_scene->uuid = UUID<uint64_t>{p_scene->node["SceneUUID"].as<uint64_t>()};
-		} catch(std::exception& e) {
-			ORNG_CORE_ERROR("Failed to deserialize scene: '{}'", e.what());
-		}
+		BinarySceneSerializer::ContentType type;
+		std::string name;
+		uint64_t uuid = 0;
+		if (BinarySceneSerializer::ReadHeader(p_scene->binary_data, type, name, uuid))
+			p_scene->uuid = UUID<uint64_t>{uuid};
+		else
+			ORNG_CORE_ERROR("Failed to deserialize scene, binary data is invalid");
 
 		AssetManager::AddAsset(p_scene);
 	}
@@ -247,30 +309,12 @@ void AssetSerializer::CreateBinaryAssetPackage(const std::string& output_path) {
 	std::vector<std::byte> ser_buffer;
 	BufferSerializer ser{ ser_buffer };
 
-	auto texture_view = std::vector<Texture2D*>();
-	auto mesh_view = std::vector<MeshAsset*>();
-	auto sound_view = std::vector<SoundAsset*>();
-	auto prefab_view = std::vector<Prefab*>();
-	auto mat_view = std::vector<Material*>();
-	auto scene_view = std::vector<SceneAsset*>();
-
-	for (auto& [uuid, p_asset] : m_manager.m_assets) {
-		if (p_asset->uuid() < static_cast<uint64_t>(BaseAssetIDs::NUM_BASE_ASSETS))
-			continue;
-
-		if (auto* p_casted0 = dynamic_cast<Texture2D*>(p_asset))
-			texture_view.push_back(p_casted0);
-		else if (auto* p_casted1 = dynamic_cast<MeshAsset*>(p_asset))
-			mesh_view.push_back(p_casted1);
-		else if (auto* p_casted2 = dynamic_cast<SoundAsset*>(p_asset))
-			sound_view.push_back(p_casted2);
-		else if (auto* p_casted3 = dynamic_cast<Prefab*>(p_asset))
-			prefab_view.push_back(p_casted3);
-		else if (auto* p_casted4 = dynamic_cast<Material*>(p_asset))
-			mat_view.push_back(p_casted4);
-		else if (auto* p_casted5 = dynamic_cast<SceneAsset*>(p_asset))
-			scene_view.push_back(p_casted5);
-	}
+	auto texture_view = m_manager.GetView<Texture2D>();
+	auto mesh_view = m_manager.GetView<MeshAsset>();
+	auto sound_view = m_manager.GetView<SoundAsset>();
+	auto prefab_view = m_manager.GetView<Prefab>();
+	auto mat_view = m_manager.GetView<Material>();
+	auto scene_view = m_manager.GetView<SceneAsset>();
 
 	// Begin layout with number of assets
 	ser.value4b(static_cast<uint32_t>(texture_view.size()));
@@ -290,7 +334,7 @@ void AssetSerializer::CreateBinaryAssetPackage(const std::string& output_path) {
 		SerializeSoundAsset(*p_sound, ser);
 	}
 	for (auto* p_prefab : prefab_view) {
-		ser.object(*p_prefab);
+		SerializePrefabAsset(*p_prefab, ser);
 	}
 	for (auto* p_mat : mat_view) {
 		ser.object(*p_mat);
@@ -374,7 +418,7 @@ void AssetSerializer::LoadTexture2DAssetFromFile(const std::string& rel_path) {
 	DeserializeAssetBinary(rel_path, *p_tex, &binary_data);
 	p_tex->filepath = rel_path;
 	m_manager.AddAsset(p_tex);
-	p_tex->LoadFromBinary(binary_data.data(), binary_data.size(), false);
+	m_manager.texture_streamer.LoadResidentMips(*p_tex, binary_data);
 	m_manager.DispatchAssetEvent(Events::AssetEventType::TEXTURE_LOADED, reinterpret_cast<uint8_t*>(p_tex));
 };
 
@@ -8,6 +8,6 @@ namespace ORNG {
 	uint64_t Component::GetEntityUUID() const { return mp_entity->GetUUID(); }
 	entt::entity Component::GetEnttHandle() const { return mp_entity->GetEnttHandle(); }
 	uint64_t Component::GetStaticSceneUUID() const { return mp_entity->GetScene()->GetStaticUUID(); }
-	std::string Component::GetEntityName() const { return mp_entity->name; }
+	std::string Component::GetEntityName() const { return mp_entity->GetName(); }
 
 }
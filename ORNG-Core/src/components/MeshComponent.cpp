@@ -1,6 +1,7 @@
 #include "pch/pch.h"
 
 #include "components/MeshComponent.h"
+#include "rendering/MeshAsset.h"
 #include "events/EventManager.h"
 
 namespace ORNG {
@@ -13,7 +14,9 @@ namespace ORNG {
 	};
 
 	MeshComponent::MeshComponent(SceneEntity* p_entity, MeshAsset* p_asset, std::vector<const Material*>&& materials) : Component(p_entity),
-	m_materials(std::move(materials)), mp_mesh_asset(p_asset) {}
+	m_materials(materials.begin(), materials.end()), mp_mesh_asset(p_asset) {}
+
+	MeshComponent::~MeshComponent() = default;
 
 
 	void MeshComponent::SetMeshAsset(MeshAsset* p_asset) {
@@ -19,8 +19,24 @@ namespace ORNG {
 		SendUpdateEvent(); // Shape needs recreating
 	}
 
+	void PhysicsComponent::SetLayer(JPH::ObjectLayer layer) {
+		m_layer = layer;
+		SendUpdateEvent(); // Body needs recreating in the new layer
+	}
+
 	void PhysicsComponent::SendUpdateEvent() {
 		Events::ECS_Event<PhysicsComponent> phys_event{ Events::ECS_EventType::COMP_UPDATED, this };
 		Events::EventManager::DispatchEvent(phys_event);
 	}
+
+	void CharacterControllerComponent::SetShape(float radius, float height) {
+		m_radius = glm::max(radius, 0.01f);
+		m_height = glm::max(height, m_radius * 2.f);
+		SendUpdateEvent(); // Character needs recreating with the new capsule
+	}
+
+	void CharacterControllerComponent::SendUpdateEvent() {
+		Events::ECS_Event<CharacterControllerComponent> character_event{ Events::ECS_EventType::COMP_UPDATED, this };
+		Events::EventManager::DispatchEvent(character_event);
+	}
 }
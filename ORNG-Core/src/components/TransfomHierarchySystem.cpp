@@ -2,6 +2,7 @@
 #include "components/systems/TransformHierarchySystem.h"
 #include "scene/SceneEntity.h"
 #include "scene/Scene.h"
+#include "util/Timers.h"
 
 namespace ORNG {
 
@@ -13,24 +14,173 @@ namespace ORNG {
 
 		for (int i = 0; i < p_relationship_comp->num_children; i++) {
 			auto& transform = reg.get<TransformComponent>(current_entity);
+			// Fetched before rebuilding as the rebuild recurses into this entity's own children
+			entt::entity next = reg.get<RelationshipComponent>(current_entity).next;
 
-			if (transform.m_is_absolute)
+			if (!transform.m_is_absolute)
+				transform.RebuildMatrix(static_cast<TransformComponent::UpdateType>(t_event.sub_event_type));
+
+			current_entity = next;
+		}
+	}
+
+	void TransformHierarchySystem::UpdateChildRenderTransforms(const Events::ECS_Event<TransformComponent>& t_event) {
+		auto* p_parent = t_event.p_component;
+		auto* p_relationship_comp = p_parent->GetEntity()->GetComponent<RelationshipComponent>();
+		if (p_relationship_comp->num_children == 0)
+			return;
+
+		// Children follow the parent's render matrix by taking on the same offset from their logical matrix
+		const bool has_offset = p_parent->HasRenderMatrix();
+		const glm::mat4 offset = has_offset ? p_parent->GetRenderMatrix() * glm::inverse(p_parent->GetMatrix()) : glm::mat4(1);
+
+		auto& reg = mp_scene->GetRegistry();
+		entt::entity current_entity = p_relationship_comp->first;
+
+		for (int i = 0; i < p_relationship_comp->num_children; i++) {
+			auto& transform = reg.get<TransformComponent>(current_entity);
+			entt::entity next = reg.get<RelationshipComponent>(current_entity).next;
+
+			if (!transform.m_is_absolute) {
+				if (has_offset)
+					transform.SetRenderMatrix(offset * transform.GetMatrix());
+				else if (transform.HasRenderMatrix())
+					transform.ClearRenderMatrix();
+			}
+
+			current_entity = next;
+		}
+	}
+
+	void TransformHierarchySystem::UpdateSubtreeTransforms(const Events::ECS_Event<TransformComponent>& t_event) {
+		// Something was reparented or deleted out of order since the last rebuild, which is left for OnUpdate so child links are followed until then
+		if (mp_flat_hierarchy->IsDirty()) {
+			UpdateChildTransforms(t_event);
+			return;
+		}
+
+		auto* p_hierarchy = mp_flat_hierarchy.get();
+		uint32_t root_index = p_hierarchy->GetIndex(t_event.p_component->GetEnttHandle());
+		if (root_index == FlatHierarchy::INVALID_INDEX)
+			return;
+
+		// Dispatched by the rebuild in an outer pass, which goes on to rebuild this entity's descendants itself
+		if (root_index == m_rebuilding_index)
+			return;
+
+		auto& entities = p_hierarchy->GetEntities();
+		auto& subtree_sizes = p_hierarchy->GetSubtreeSizes();
+		auto& reg = mp_scene->GetRegistry();
+
+		const uint32_t end = root_index + subtree_sizes[root_index];
+		const uint32_t prev_rebuilding_index = m_rebuilding_index;
+
+		// Listeners can remove entities from the end of the arrays mid-pass
+		for (uint32_t i = root_index + 1; i < end && i < entities.size();) {
+			// May have been deleted by a listener earlier in the pass
+			auto* p_transform = reg.try_get<TransformComponent>(entities[i]);
+			// Absolute entities don't depend on their parent, so neither do their descendants
+			if (!p_transform || p_transform->m_is_absolute) {
+				i += subtree_sizes[i];
 				continue;
+			}
 
-			transform.RebuildMatrix(static_cast<TransformComponent::UpdateType>(t_event.sub_event_type));
-			current_entity = reg.get<RelationshipComponent>(current_entity).next;
+			m_rebuilding_index = i;
+			p_transform->RebuildMatrix(static_cast<TransformComponent::UpdateType>(t_event.sub_event_type));
+			i++;
 		}
+
+		m_rebuilding_index = prev_rebuilding_index;
 	}
 
 	void TransformHierarchySystem::OnLoad() {
 		// On transform update event, update all child transforms
 		m_transform_event_listener.OnEvent = [this](const Events::ECS_Event<TransformComponent>& t_event) {
 			[[likely]] if (t_event.event_type == Events::ECS_EventType::COMP_UPDATED) {
-				UpdateChildTransforms(t_event);
+				if (t_event.sub_event_type == TransformComponent::UpdateType::RENDER)
+					UpdateChildRenderTransforms(t_event);
+				else if (mp_flat_hierarchy)
+					UpdateSubtreeTransforms(t_event);
+				else
+					UpdateChildTransforms(t_event);
 			}
 		};
 
 		m_transform_event_listener.scene_id = GetSceneUUID();
 		Events::EventManager::RegisterListener(m_transform_event_listener);
 	}
+
+	void TransformHierarchySystem::OnUpdate() {
+		SetFlatHierarchyEnabled(mp_scene->flat_transform_hierarchy);
+
+		// At most one rebuild per frame, however many changes marked it dirty
+		if (mp_flat_hierarchy)
+			mp_flat_hierarchy->Update();
+	}
+
+	void TransformHierarchySystem::OnUnload() {
+		SetFlatHierarchyEnabled(false);
+		Events::EventManager::DeregisterListener(m_transform_event_listener.GetRegisterID());
+	}
+
+	void TransformHierarchySystem::SetFlatHierarchyEnabled(bool enabled) {
+		if (enabled == static_cast<bool>(mp_flat_hierarchy))
+			return;
+
+		auto& reg = mp_scene->GetRegistry();
+
+		if (enabled) {
+			mp_flat_hierarchy = std::make_unique<FlatHierarchy>(reg);
+			m_flat_hierarchy_connections[0] = reg.on_construct<RelationshipComponent>().connect<&TransformHierarchySystem::OnRelationshipConstruct>(*this);
+			m_flat_hierarchy_connections[1] = reg.on_destroy<RelationshipComponent>().connect<&TransformHierarchySystem::OnRelationshipDestroy>(*this);
+
+			m_relationship_event_listener.OnEvent = [this](const Events::ECS_Event<RelationshipComponent>& t_event) {
+				mp_flat_hierarchy->OnParentChanged(t_event.p_component->GetEnttHandle());
+			};
+			m_relationship_event_listener.scene_id = GetSceneUUID();
+			Events::EventManager::RegisterListener(m_relationship_event_listener);
+		}
+		else {
+			for (auto& connection : m_flat_hierarchy_connections) {
+				connection.release();
+			}
+			Events::EventManager::DeregisterListener(m_relationship_event_listener.GetRegisterID());
+			mp_flat_hierarchy = nullptr;
+		}
+	}
+
+	const FlatHierarchy* TransformHierarchySystem::GetFlatHierarchy() {
+		if (!mp_flat_hierarchy)
+			return nullptr;
+
+		mp_flat_hierarchy->Update();
+		return mp_flat_hierarchy.get();
+	}
+
+	void TransformHierarchySystem::RebuildWorldTransforms() {
+		ORNG_PROFILE_FUNC();
+
+		auto* p_hierarchy = GetFlatHierarchy();
+		if (!p_hierarchy)
+			return;
+
+		auto& reg = mp_scene->GetRegistry();
+
+		auto& entities = p_hierarchy->GetEntities();
+		for (uint32_t i = 0; i < entities.size(); i++) {
+			if (auto* p_transform = reg.try_get<TransformComponent>(entities[i])) {
+				m_rebuilding_index = i;
+				p_transform->RebuildMatrix(TransformComponent::UpdateType::ALL);
+			}
+		}
+		m_rebuilding_index = FlatHierarchy::INVALID_INDEX;
+	}
+
+	void TransformHierarchySystem::OnRelationshipConstruct(entt::registry&, entt::entity entity) {
+		mp_flat_hierarchy->OnEntityCreated(entity);
+	}
+
+	void TransformHierarchySystem::OnRelationshipDestroy(entt::registry&, entt::entity entity) {
+		mp_flat_hierarchy->OnEntityDestroyed(entity);
+	}
 }
@@ -39,7 +39,7 @@ namespace ORNG {
 		return m_parent_handle == entt::null ? nullptr : &GetEntity()->GetRegistry()->get<TransformComponent>(m_parent_handle);
 	}
 
-	void TransformComponent::RebuildMatrix(UpdateType type) {
+	void TransformComponent::RebuildMatrix(UpdateType type, bool dispatch_event) {
 		//ORNG_TRACY_PROFILE;
 		UpdateAbsTransforms();
 
@@ -102,10 +102,30 @@ namespace ORNG {
 		}
 
 		m_abs_pos = glm::vec3(m_transform[3][0], m_transform[3][1], m_transform[3][2]);
+		m_has_render_transform = false;
 
-		if (GetEntity()) {
+		if (dispatch_event && GetEntity()) {
 			Events::ECS_Event<TransformComponent> e_event{ Events::ECS_EventType::COMP_UPDATED, this, type };
 			Events::EventManager::DispatchEvent(e_event);
 		}
 	}
+
+	void TransformComponent::SetRenderMatrix(const glm::mat4& matrix, bool dispatch_event) {
+		m_render_transform = matrix;
+		m_has_render_transform = true;
+
+		if (dispatch_event && GetEntity()) {
+			Events::ECS_Event<TransformComponent> e_event{ Events::ECS_EventType::COMP_UPDATED, this, UpdateType::RENDER };
+			Events::EventManager::DispatchEvent(e_event);
+		}
+	}
+
+	void TransformComponent::ClearRenderMatrix(bool dispatch_event) {
+		m_has_render_transform = false;
+
+		if (dispatch_event && GetEntity()) {
+			Events::ECS_Event<TransformComponent> e_event{ Events::ECS_EventType::COMP_UPDATED, this, UpdateType::RENDER };
+			Events::EventManager::DispatchEvent(e_event);
+		}
+	}
 }
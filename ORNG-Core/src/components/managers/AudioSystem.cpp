@@ -95,6 +95,9 @@ namespace ORNG {
 	}
 
 	void AudioSystem::OnTransformEvent(const Events::ECS_Event<TransformComponent>& e_event) {
+		if (e_event.sub_event_type == TransformComponent::UpdateType::RENDER)
+			return;
+
 		if (auto* p_sound_comp = e_event.p_component->GetEntity()->GetComponent<AudioComponent>()) {
 			auto pos = e_event.p_component->GetAbsPosition();
 			*p_sound_comp->mp_fmod_pos = { pos.x, pos.y, pos.z };
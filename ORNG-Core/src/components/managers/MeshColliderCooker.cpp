@@ -0,0 +1,207 @@
+#include "pch/pch.h"
+
+#include <Jolt/Jolt.h>
+
+#include "components/systems/MeshColliderCooker.h"
+#include "assets/AssetSerializer.h"
+#include "rendering/MeshAsset.h"
+#include "util/util.h"
+#include "util/UUID.h"
+#include "Jolt/Core/StreamWrapper.h"
+#include "Jolt/Physics/Collision/Shape/MeshShape.h"
+#include "Jolt/Physics/Collision/Shape/ConvexHullShape.h"
+
+using namespace ORNG;
+using namespace JPH;
+
+bool MeshColliderCooker::RequestShape(const MeshAsset& mesh, ColliderType type) {
+	auto [it, inserted] = m_entries.try_emplace({ mesh.uuid(), type });
+	auto& entry = it->second;
+
+	if (inserted) {
+		if (GetFileExtension(mesh.filepath) != ".omesh") {
+			ORNG_CORE_ERROR("Cannot create mesh collider for '{0}', colliders are only cooked from .omesh files", mesh.filepath);
+			entry.failed = true;
+		}
+		else {
+			entry.future = std::async(std::launch::async, [filepath = mesh.filepath, type] { return LoadOrCook(filepath, type); });
+			m_num_in_flight++;
+		}
+	}
+
+	return !entry.failed;
+}
+
+bool MeshColliderCooker::Poll(std::vector<CookedShape>& output) {
+	if (m_num_in_flight == 0)
+		return false;
+
+	bool any_finished = false;
+	for (auto it = m_entries.begin(); it != m_entries.end();) {
+		auto& [key, entry] = *it;
+		if (!entry.future.valid() || entry.future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+			it++;
+			continue;
+		}
+
+		Shape::ShapeResult result = entry.future.get();
+		m_num_in_flight--;
+		any_finished = true;
+
+		if (result.IsValid()) {
+			output.push_back(CookedShape{ key.first, key.second, result.Get() });
+			it = m_entries.erase(it);
+		}
+		else {
+			ORNG_CORE_ERROR("Failed to cook collider for mesh '{0}': '{1}'", key.first, result.GetError().c_str());
+			entry.failed = true;
+			it++;
+		}
+	}
+
+	return any_finished;
+}
+
+void MeshColliderCooker::Clear() {
+	m_entries.clear();
+	m_num_in_flight = 0;
+}
+
+void MeshColliderCooker::Invalidate(uint64_t mesh_uuid) {
+	for (auto type : { ColliderType::TRIANGLE_MESH, ColliderType::CONVEX_HULL }) {
+		auto it = m_entries.find({ mesh_uuid, type });
+		if (it == m_entries.end())
+			continue;
+
+		// Destroying the future waits for a cook in flight to finish
+		if (it->second.future.valid())
+			m_num_in_flight--;
+
+		m_entries.erase(it);
+	}
+}
+
+std::string MeshColliderCooker::GetCookedFilepath(const std::string& mesh_filepath, ColliderType type) {
+	std::string base = mesh_filepath.ends_with(".omesh") ? mesh_filepath.substr(0, mesh_filepath.size() - 6) : mesh_filepath;
+	return base + (type == ColliderType::TRIANGLE_MESH ? ".trimesh.ocol" : ".hull.ocol");
+}
+
+Shape::ShapeResult MeshColliderCooker::LoadOrCook(const std::string& mesh_filepath, ColliderType type) {
+	const std::string cooked_filepath = GetCookedFilepath(mesh_filepath, type);
+
+	std::error_code mesh_ec;
+	std::error_code cooked_ec;
+	const auto mesh_write_time = std::filesystem::last_write_time(mesh_filepath, mesh_ec);
+	const auto cooked_write_time = std::filesystem::last_write_time(cooked_filepath, cooked_ec);
+
+	if (!cooked_ec && (mesh_ec || cooked_write_time >= mesh_write_time)) {
+		Shape::ShapeResult result = LoadShape(cooked_filepath);
+		// Recooked if the file is from an older version or is corrupt
+		if (result.IsValid())
+			return result;
+	}
+
+	VertexData3D vertex_data;
+	if (!AssetSerializer::ReadVertexDataFromBinaryFile(mesh_filepath, vertex_data)) {
+		Shape::ShapeResult result;
+		result.SetError("Mesh vertex data could not be read");
+		return result;
+	}
+
+	Shape::ShapeResult result = Cook(vertex_data.positions, vertex_data.indices, type);
+	// A failed save only means the shape is cooked again next time
+	if (result.IsValid())
+		SaveShape(*result.Get(), cooked_filepath);
+
+	return result;
+}
+
+Shape::ShapeResult MeshColliderCooker::Cook(const std::vector<float>& positions, const std::vector<unsigned>& indices, ColliderType type) {
+	const size_t num_vertices = positions.size() / 3;
+
+	if (type == ColliderType::TRIANGLE_MESH) {
+		VertexList vertices;
+		vertices.reserve(num_vertices);
+		for (size_t i = 0; i < num_vertices; i++) {
+			vertices.push_back(Float3{ positions[i * 3], positions[i * 3 + 1], positions[i * 3 + 2] });
+		}
+
+		IndexedTriangleList triangles;
+		triangles.reserve(indices.size() / 3);
+		for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+			if (indices[i] >= num_vertices || indices[i + 1] >= num_vertices || indices[i + 2] >= num_vertices)
+				continue;
+
+			triangles.push_back(IndexedTriangle{ indices[i], indices[i + 1], indices[i + 2] });
+		}
+
+		if (triangles.empty()) {
+			Shape::ShapeResult result;
+			result.SetError("Mesh has no triangles");
+			return result;
+		}
+
+		MeshShapeSettings settings{ std::move(vertices), std::move(triangles) };
+		return settings.Create();
+	}
+
+	Array<Vec3> points;
+	points.reserve(num_vertices);
+	for (size_t i = 0; i < num_vertices; i++) {
+		points.push_back(Vec3{ positions[i * 3], positions[i * 3 + 1], positions[i * 3 + 2] });
+	}
+
+	ConvexHullShapeSettings settings{ points };
+	return settings.Create();
+}
+
+bool MeshColliderCooker::SaveShape(const Shape& shape, const std::string& filepath) {
+	std::stringstream stream{ std::ios::in | std::ios::out | std::ios::binary };
+	stream.write(reinterpret_cast<const char*>(&COOKED_SHAPE_VERSION), sizeof(COOKED_SHAPE_VERSION));
+
+	StreamOutWrapper stream_out{ stream };
+	Shape::ShapeToIDMap shape_map;
+	Shape::MaterialToIDMap material_map;
+	shape.SaveWithChildren(stream_out, shape_map, material_map);
+	if (stream_out.IsFailed())
+		return false;
+
+	// Written to a temporary file first so a shape being loaded elsewhere is never read half-written,
+	// the name is unique so concurrent cooks of the same shape (e.g from separate scenes) don't write into each other's file
+	const std::string temp_filepath = std::format("{}.{}.TEMP", filepath, UUIDGenerator::Next());
+	std::string data = stream.str();
+	if (!WriteBinaryFile(temp_filepath, reinterpret_cast<std::byte*>(data.data()), data.size()))
+		return false;
+
+	std::error_code ec;
+	std::filesystem::rename(temp_filepath, filepath, ec);
+	if (!ec)
+		return true;
+
+	// Nothing would ever overwrite it as the name isn't reused
+	std::filesystem::remove(temp_filepath, ec);
+	return false;
+}
+
+Shape::ShapeResult MeshColliderCooker::LoadShape(const std::string& filepath) {
+	Shape::ShapeResult result;
+
+	std::vector<std::byte> data;
+	uint32_t version = 0;
+	if (!ReadBinaryFile(filepath, data) || data.size() < sizeof(version)) {
+		result.SetError("Cooked shape could not be read");
+		return result;
+	}
+
+	std::memcpy(&version, data.data(), sizeof(version));
+	if (version != COOKED_SHAPE_VERSION) {
+		result.SetError("Cooked shape is out of date");
+		return result;
+	}
+
+	std::stringstream stream{ std::string{ reinterpret_cast<const char*>(data.data()) + sizeof(version), data.size() - sizeof(version) }, std::ios::in | std::ios::binary };
+	StreamInWrapper stream_in{ stream };
+	Shape::IDToShapeMap shape_map;
+	Shape::IDToMaterialMap material_map;
+	return Shape::sRestoreWithChildren(stream_in, shape_map, material_map);
+}
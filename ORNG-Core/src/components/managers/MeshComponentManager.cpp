@@ -37,35 +37,53 @@ namespace ORNG {
 		if (!comp->mp_mesh_asset)
 			return;
 
-		size_t group_index = std::numeric_limits<size_t>::max();
-
-		// check if new entity can merge into already existing instance group
-		for (size_t i = 0; i < m_instance_groups.size(); i++) {
+		MeshInstanceGroup* p_group = nullptr;
+		auto is_compatible = [comp](const MeshInstanceGroup* p_candidate) {
 			//if same data and material, can be combined so instancing is possible
-			if (m_instance_groups[i]->m_mesh_asset == comp->mp_mesh_asset
-				&& m_instance_groups[i]->m_materials == comp->m_materials) {
-				group_index = i;
-				break;
+			return p_candidate->m_mesh_asset == comp->mp_mesh_asset && std::ranges::equal(p_candidate->m_materials, comp->m_materials);
+			};
+
+		// check if new entity can merge into already existing instance group, any compatible group must share the first material so only those are checked
+		if (!comp->m_materials.empty()) {
+			if (auto it = m_material_group_lookup.find(comp->m_materials[0]); it != m_material_group_lookup.end()) {
+				auto group_it = std::ranges::find_if(it->second, is_compatible);
+				p_group = group_it == it->second.end() ? nullptr : *group_it;
 			}
 		}
-
-		if (group_index != std::numeric_limits<size_t>::max()) { // if instance group exists, place into
-			// add mesh component's world transform into instance group for instanced rendering
-			MeshInstanceGroup* group = m_instance_groups[group_index];
-			group->AddInstance(comp->GetEntity());
+		else {
+			auto group_it = std::ranges::find_if(m_instance_groups, is_compatible);
+			p_group = group_it == m_instance_groups.end() ? nullptr : *group_it;
 		}
-		else { //else if instance group doesn't exist but mesh data exists, create group with existing data
-			MeshInstanceGroup* group = new MeshInstanceGroup(comp->mp_mesh_asset, comp->m_materials, mp_scene->GetRegistry());
-			m_instance_groups.push_back(group);
-			group->AddInstance(comp->GetEntity());
 
-			group_index = m_instance_groups.size() - 1;
+		if (!p_group) { // if instance group doesn't exist but mesh data exists, create group with existing data
+			p_group = new MeshInstanceGroup(comp->mp_mesh_asset, { comp->m_materials.begin(), comp->m_materials.end() }, mp_scene->GetRegistry());
+			m_instance_groups.push_back(p_group);
+			AddGroupToMaterialLookup(p_group);
 		}
 
-		auto* p_group = m_instance_groups[group_index];
+		// add mesh component's world transform into instance group for instanced rendering
+		p_group->AddInstance(comp->GetEntity());
 		comp->mp_instance_group = p_group;
 	}
 
+	void MeshInstancingSystem::AddGroupToMaterialLookup(MeshInstanceGroup* p_group) {
+		for (const Material* p_material : p_group->m_materials) {
+			m_material_group_lookup[p_material].insert(p_group);
+		}
+	}
+
+	void MeshInstancingSystem::RemoveGroupFromMaterialLookup(MeshInstanceGroup* p_group) {
+		for (const Material* p_material : p_group->m_materials) {
+			auto it = m_material_group_lookup.find(p_material);
+			if (it == m_material_group_lookup.end())
+				continue;
+
+			it->second.erase(p_group);
+			if (it->second.empty())
+				m_material_group_lookup.erase(it);
+		}
+	}
+
 	void MeshInstancingSystem::OnBillboardAdd(BillboardComponent* p_comp) {
 		if (!p_comp->p_material) {
 			p_comp->p_material = AssetManager::GetAsset<Material>(static_cast<uint64_t>(BaseAssetIDs::DEFAULT_MATERIAL));
@@ -79,27 +97,21 @@ namespace ORNG {
 	}
 
 	void MeshInstancingSystem::SortBillboardIntoInstanceGroup(BillboardComponent* p_comp) {
-		size_t group_index = std::numeric_limits<size_t>::max();
-
-		for (size_t i = 0; i < m_billboard_instance_groups.size(); i++) {
-			if (m_billboard_instance_groups[i]->m_materials[0] == p_comp->p_material) {
-				group_index = i;
-			}
-		}
+		MeshInstanceGroup* p_group = nullptr;
 
-		if (group_index != std::numeric_limits<size_t>::max()) {
-			m_billboard_instance_groups[group_index]->AddInstance(p_comp->GetEntity());
+		if (auto it = m_billboard_group_lookup.find(p_comp->p_material); it != m_billboard_group_lookup.end()) {
+			p_group = it->second;
 		}
 		else {
-			auto* p_group = new MeshInstanceGroup(AssetManager::GetAsset<MeshAsset>(static_cast<uint64_t>(BaseAssetIDs::QUAD_MESH)),
+			p_group = new MeshInstanceGroup(AssetManager::GetAsset<MeshAsset>(static_cast<uint64_t>(BaseAssetIDs::QUAD_MESH)),
 				 p_comp->p_material, mp_scene->GetRegistry());
 			p_group->m_materials.push_back(p_comp->p_material);
 			m_billboard_instance_groups.push_back(p_group);
-			p_group->AddInstance(p_comp->GetEntity());
-			group_index = m_billboard_instance_groups.size() - 1;
+			m_billboard_group_lookup[p_comp->p_material] = p_group;
 		}
 
-		p_comp->mp_instance_group = m_billboard_instance_groups[group_index];
+		p_group->AddInstance(p_comp->GetEntity());
+		p_comp->mp_instance_group = p_group;
 	}
 
 
@@ -132,9 +144,17 @@ namespace ORNG {
 			};
 
 
+		m_asset_listener.OnEvent = [this](const Events::AssetEvent& t_event) {
+			if (t_event.event_type == Events::AssetEventType::MATERIAL_DELETED)
+				OnMaterialDeletion(reinterpret_cast<Material*>(t_event.data_payload));
+			else if (t_event.event_type == Events::AssetEventType::MESH_DELETED)
+				OnMeshAssetDeletion(reinterpret_cast<MeshAsset*>(t_event.data_payload));
+			};
+
 		Events::EventManager::RegisterListener(m_mesh_listener);
 		Events::EventManager::RegisterListener(m_transform_listener);
 		Events::EventManager::RegisterListener(m_billboard_listener);
+		Events::EventManager::RegisterListener(m_asset_listener);
 	};
 
 
@@ -211,6 +231,7 @@ namespace ORNG {
 		Events::EventManager::DeregisterListener(m_transform_listener.GetRegisterID());
 		Events::EventManager::DeregisterListener(m_mesh_listener.GetRegisterID());
 		Events::EventManager::DeregisterListener(m_billboard_listener.GetRegisterID());
+		Events::EventManager::DeregisterListener(m_asset_listener.GetRegisterID());
 
 		m_mesh_add_connection.release();
 		m_mesh_remove_connection.release();
@@ -222,62 +243,97 @@ namespace ORNG {
 		}
 
 		m_instance_groups.clear();
+		m_material_group_lookup.clear();
+		m_billboard_group_lookup.clear();
 	}
 
 	void MeshInstancingSystem::OnMeshAssetDeletion(MeshAsset* p_asset) {
 		auto& reg = mp_scene->GetRegistry();
+		auto* p_replacement = AssetManager::GetAsset<MeshAsset>(static_cast<uint64_t>(BaseAssetIDs::CUBE_MESH));
 
-		// Remove asset from all components using it
-		for (auto [entity, mesh] : reg.view<MeshComponent>().each()) {
-			if (mesh.GetMeshData() == p_asset)
-				mesh.SetMeshAsset(AssetManager::GetAsset<MeshAsset>(static_cast<uint64_t>(BaseAssetIDs::CUBE_MESH)));
-		}
+		// Copied as resorting components below can create new groups
+		std::vector<MeshInstanceGroup*> groups = m_instance_groups;
 
-		std::array<std::vector<MeshInstanceGroup*>*, 2> groups = { &m_instance_groups, &m_billboard_instance_groups };
-
-		for (size_t y = 0; y < 2; y++) {
-			for (size_t i = 0; i < groups[y]->size(); i++) {
-				MeshInstanceGroup* group = (*groups[y])[i];
+		for (MeshInstanceGroup* p_group : groups) {
+			if (p_group->m_mesh_asset != p_asset)
+				continue;
 
-				if (group->m_mesh_asset == p_asset) {
-					group->ClearMeshes();
-					for (auto [entt_handle, index] : group->m_instances) {
-						reg.get<MeshComponent>(entt_handle).mp_mesh_asset = nullptr;
-					}
+			std::vector<entt::entity> entities = p_group->m_entities_to_instance;
+			for (auto [entt_handle, index] : p_group->m_instances) {
+				entities.push_back(entt_handle);
+			}
 
-					// Delete all mesh instance groups using the asset as they cannot function without it
-					m_instance_groups.erase(m_instance_groups.begin() + static_cast<long long>(i));
-					delete group;
-				}
+			// Resorting removes each component from this group
+			for (entt::entity entt_handle : entities) {
+				reg.get<MeshComponent>(entt_handle).SetMeshAsset(p_replacement);
 			}
+
+			// Delete the group now rather than in OnUpdate as it cannot function without the asset
+			RemoveGroupFromMaterialLookup(p_group);
+			std::erase(m_instance_groups, p_group);
+			delete p_group;
 		}
 	}
 
 	void MeshInstancingSystem::OnMaterialDeletion(Material* p_material) {
-		for (size_t i = 0; i < m_instance_groups.size(); i++) {
-			MeshInstanceGroup* group = m_instance_groups[i];
+		auto& reg = mp_scene->GetRegistry();
+		auto* p_replacement = AssetManager::GetAsset<Material>(static_cast<uint64_t>(BaseAssetIDs::DEFAULT_MATERIAL));
+
+		if (auto it = m_material_group_lookup.find(p_material); it != m_material_group_lookup.end()) {
+			// Copied as the lookup is modified below
+			std::vector<MeshInstanceGroup*> groups{ it->second.begin(), it->second.end() };
 
-			std::vector<unsigned int> material_indices;
+			for (MeshInstanceGroup* p_group : groups) {
+				RemoveGroupFromMaterialLookup(p_group);
 
-			// Replace material in group if it contains it
-			for (size_t y = 0; y < group->m_materials.size(); y++) {
-				const Material*& p_group_mat = group->m_materials[y];
-				if (p_group_mat == p_material) {
-					p_group_mat = AssetManager::GetAsset<Material>(static_cast<uint64_t>(BaseAssetIDs::DEFAULT_MATERIAL));
-					material_indices.push_back(static_cast<unsigned>(y));
+				// Replace material in group
+				std::vector<unsigned int> material_indices;
+				for (size_t y = 0; y < p_group->m_materials.size(); y++) {
+					if (p_group->m_materials[y] == p_material) {
+						p_group->m_materials[y] = p_replacement;
+						material_indices.push_back(static_cast<unsigned>(y));
+					}
 				}
-			}
 
-			if (material_indices.empty())
-				continue;
+				AddGroupToMaterialLookup(p_group);
+
+				// Replace material in meshes of the group
+				auto replace_in_mesh = [&](entt::entity entt_handle) {
+					auto& mesh = reg.get<MeshComponent>(entt_handle);
+					for (auto valid_replacement_index : material_indices) {
+						if (valid_replacement_index < mesh.m_materials.size())
+							mesh.m_materials[valid_replacement_index] = p_replacement;
+					}
+					};
+
+				for (auto [entt_handle, index] : p_group->m_instances) {
+					replace_in_mesh(entt_handle);
+				}
 
-			// Replace material in mesh if it contains it
-			for (auto [entt_handle, index] : group->m_instances) {
-				for (auto valid_replacement_index : material_indices) {
-					mp_scene->GetRegistry().get<MeshComponent>(entt_handle).m_materials[valid_replacement_index] = AssetManager::GetAsset<Material>(static_cast<uint64_t>(BaseAssetIDs::DEFAULT_MATERIAL));
+				for (entt::entity entt_handle : p_group->m_entities_to_instance) {
+					replace_in_mesh(entt_handle);
 				}
 			}
 		}
+
+		if (auto it = m_billboard_group_lookup.find(p_material); it != m_billboard_group_lookup.end()) {
+			MeshInstanceGroup* p_group = it->second;
+			m_billboard_group_lookup.erase(it);
+
+			for (const Material*& p_group_mat : p_group->m_materials) {
+				p_group_mat = p_replacement;
+			}
+
+			for (auto [entt_handle, index] : p_group->m_instances) {
+				reg.get<BillboardComponent>(entt_handle).p_material = p_replacement;
+			}
+
+			for (entt::entity entt_handle : p_group->m_entities_to_instance) {
+				reg.get<BillboardComponent>(entt_handle).p_material = p_replacement;
+			}
+
+			m_billboard_group_lookup.try_emplace(p_replacement, p_group);
+		}
 	}
 
 
@@ -293,6 +349,14 @@ namespace ORNG {
 				// Check if group should be deleted
 				if (group->m_instances.empty()) {
 					group->ProcessUpdates();
+
+					if (y == 0) {
+						RemoveGroupFromMaterialLookup(group);
+					}
+					else if (auto it = m_billboard_group_lookup.find(group->m_materials[0]); it != m_billboard_group_lookup.end() && it->second == group) {
+						m_billboard_group_lookup.erase(it);
+					}
+
 					groups[y]->erase(groups[y]->begin() + static_cast<long long>(i));
 					delete group;
 					i--;
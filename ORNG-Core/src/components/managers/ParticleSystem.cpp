@@ -98,7 +98,7 @@ namespace ORNG {
 
 		m_transform_listener.scene_id = GetSceneUUID();
 		m_transform_listener.OnEvent = [this](const Events::ECS_Event<TransformComponent>& e_event) {
-			if (e_event.event_type == Events::ECS_EventType::COMP_UPDATED) {
+			if (e_event.event_type == Events::ECS_EventType::COMP_UPDATED && e_event.sub_event_type != TransformComponent::UpdateType::RENDER) {
 				if (auto* p_emitter = e_event.p_component->GetEntity()->GetComponent<ParticleEmitterComponent>())
 					OnEmitterUpdate(p_emitter);
 			}
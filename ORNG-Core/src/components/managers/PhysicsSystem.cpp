@@ -16,10 +16,24 @@
 #include "Jolt/Physics/Body/BodyCreationSettings.h"
 #include "Jolt/Physics/Collision/Shape/BoxShape.h"
 #include "Jolt/Physics/Collision/Shape/SphereShape.h"
+#include "Jolt/Physics/Collision/Shape/ScaledShape.h"
+#include "Jolt/Physics/Collision/Shape/CapsuleShape.h"
+#include "Jolt/Physics/Collision/Shape/RotatedTranslatedShape.h"
+#include "Jolt/Physics/Collision/RayCast.h"
+#include "Jolt/Physics/Collision/CastResult.h"
+#include "Jolt/Physics/Collision/ShapeCast.h"
+#include "Jolt/Physics/Collision/CollideShape.h"
+#include "Jolt/Physics/Collision/CollisionCollectorImpl.h"
+#include "Jolt/Physics/Body/BodyFilter.h"
+#include "Jolt/Physics/Body/BodyLock.h"
+#include "Jolt/Core/HashCombine.h"
 #include "rendering/MeshAsset.h"
 #include "scene/SceneEntity.h"
+#include "scene/Scene.h"
 #include "scene/SerializationUtil.h"
 #include "util/Timers.h"
+#include "util/TimeStep.h"
+#include "util/util.h"
 #include "yaml-cpp/yaml.h"
 
 using namespace ORNG;
@@ -57,9 +71,497 @@ inline static Quat GlmToJph(const glm::quat& q) {
 	return Quat{q.x, q.y, q.z, q.w};
 }
 
+std::vector<CollisionLayer> ORNG::GetDefaultCollisionLayers() {
+	constexpr auto bit = [](ObjectLayer layer) { return 1u << layer; };
+	constexpr auto bp = [](BroadPhaseLayer layer) { return static_cast<uint8_t>(static_cast<BroadPhaseLayer::Type>(layer)); };
+
+	// Indexed by the values in Layers
+	return {
+		{ "NonMoving", bp(BroadPhaseLayers::NON_MOVING), bit(Layers::MOVING) | bit(Layers::DEBRIS) | bit(Layers::CHARACTER) },
+		{ "Moving", bp(BroadPhaseLayers::MOVING), bit(Layers::NON_MOVING) | bit(Layers::MOVING) | bit(Layers::DEBRIS) | bit(Layers::TRIGGER) | bit(Layers::CHARACTER) },
+		// Debris doesn't collide with itself or characters so large piles stay cheap
+		{ "Debris", bp(BroadPhaseLayers::DEBRIS), bit(Layers::NON_MOVING) | bit(Layers::MOVING) },
+		{ "Trigger", bp(BroadPhaseLayers::TRIGGER), bit(Layers::MOVING) | bit(Layers::CHARACTER) },
+		{ "Character", bp(BroadPhaseLayers::CHARACTER), bit(Layers::NON_MOVING) | bit(Layers::MOVING) | bit(Layers::TRIGGER) | bit(Layers::CHARACTER) },
+	};
+}
+
 ORNG::PhysicsSystem::PhysicsSystem(Scene* p_scene) : ComponentSystem(p_scene) {
 };
 
+void ORNG::PhysicsSystem::InitPhysicsSystem() {
+	// Jolt can't be initialized twice, so any previous state is dropped by reconstructing it
+	std::destroy_at(&physics_system);
+	std::construct_at(&physics_system);
+
+	// The new system starts without contacts, any removals for the old one are never reported
+	m_touching_sub_shape_counts.clear();
+
+	mp_temp_allocator = std::make_unique<TrackingTempAllocator>(m_settings.temp_allocator_size);
+	UpdateLayerFilters();
+
+	// 0 body mutexes picks a default based on max_bodies
+	physics_system.Init(m_settings.max_bodies, 0, m_settings.max_body_pairs, m_settings.max_contact_constraints, m_broad_phase_layer_interface,
+		m_object_vs_broadphase_layer_filter, m_object_vs_object_layer_filter);
+	physics_system.SetContactListener(&m_contact_recorder);
+}
+
+void ORNG::PhysicsSystem::UpdateLayerFilters() {
+	const auto& layers = m_settings.layers;
+
+	m_object_vs_object_layer_filter.m_collision_masks.fill(0);
+	m_object_vs_broadphase_layer_filter.m_broad_phase_masks.fill(0);
+	m_broad_phase_layer_interface.mObjectToBroadPhase.fill(BroadPhaseLayers::NON_MOVING);
+
+	for (size_t i = 0; i < layers.size(); i++) {
+		m_broad_phase_layer_interface.mObjectToBroadPhase[i] = BroadPhaseLayer{ layers[i].broad_phase_layer };
+
+		for (size_t j = 0; j < layers.size(); j++) {
+			if (!((layers[i].collision_mask >> j) & 1u) && !((layers[j].collision_mask >> i) & 1u))
+				continue;
+
+			m_object_vs_object_layer_filter.m_collision_masks[i] |= 1u << j;
+			m_object_vs_broadphase_layer_filter.m_broad_phase_masks[i] |= static_cast<uint8_t>(1u << layers[j].broad_phase_layer);
+		}
+	}
+
+	if (mp_recording) {
+		auto& stream = mp_recording->stream;
+		stream.Write(RecordedCommand::SET_LAYER_MASKS);
+		stream.Write(static_cast<uint32_t>(layers.size()));
+		// Layers can be added without reinitializing, so their broadphase layers are written too
+		for (const auto& layer : layers) {
+			stream.Write(layer.broad_phase_layer);
+			stream.Write(layer.collision_mask);
+		}
+	}
+}
+
+bool ORNG::PhysicsSystem::ApplySettings(const Settings& settings) {
+	if (settings.layers.size() < Layers::NUM_DEFAULT_LAYERS || settings.layers.size() > Layers::MAX_LAYERS) {
+		ORNG_CORE_ERROR("Physics settings must define between {0} and {1} layers, {2} defined", Layers::NUM_DEFAULT_LAYERS, Layers::MAX_LAYERS, settings.layers.size());
+		return false;
+	}
+
+	for (const auto& layer : settings.layers) {
+		if (layer.broad_phase_layer >= BroadPhaseLayers::NUM_LAYERS) {
+			ORNG_CORE_ERROR("Physics layer '{0}' has invalid broadphase layer {1}", layer.name, layer.broad_phase_layer);
+			return false;
+		}
+	}
+
+	if (settings.max_bodies == 0 || settings.temp_allocator_size == 0) {
+		ORNG_CORE_ERROR("Physics settings must allow at least one body and some temp allocator memory");
+		return false;
+	}
+
+	// Bodies in the broadphase can't change broadphase layer and Jolt can't be resized, so either requires starting over
+	bool reinitialize = settings.max_bodies != m_settings.max_bodies || settings.max_body_pairs != m_settings.max_body_pairs ||
+		settings.max_contact_constraints != m_settings.max_contact_constraints || settings.temp_allocator_size != m_settings.temp_allocator_size ||
+		settings.layers.size() < m_settings.layers.size();
+
+	for (size_t i = 0; i < std::min(settings.layers.size(), m_settings.layers.size()); i++) {
+		reinitialize |= settings.layers[i].broad_phase_layer != m_settings.layers[i].broad_phase_layer;
+	}
+
+	m_settings = settings;
+
+	if (!reinitialize) {
+		UpdateLayerFilters();
+		return true;
+	}
+
+	ORNG_PROFILE_FUNC();
+	if (mp_recording) {
+		ORNG_CORE_WARN("Physics recording stopped, the simulation was reinitialized by a settings change");
+		mp_recording = nullptr;
+	}
+
+	ResetInterpolation();
+	// Queued bodies are destroyed along with every other body when InitPhysicsSystem reconstructs physics_system
+	m_pending_body_adds.clear();
+	m_pending_body_removals.clear();
+	m_entities_awaiting_colliders.clear();
+	m_body_changes_since_optimization = 0;
+
+	InitPhysicsSystem();
+
+	// Every body id was invalidated, so bodies are recreated from their components
+	for (auto [entity, comp] : mp_scene->GetRegistry().view<PhysicsComponent>().each()) {
+		comp.body_id = BodyID{};
+		UpdateComponentState(&comp);
+	}
+
+	// Characters cache contacts with the old bodies
+	for (auto [entity, comp] : mp_scene->GetRegistry().view<CharacterControllerComponent>().each()) {
+		InitCharacter(&comp);
+	}
+
+	FlushBodyQueue();
+	return true;
+}
+
+void ORNG::PhysicsSystem::SetLayersCollide(ObjectLayer layer_a, ObjectLayer layer_b, bool collide) {
+	if (layer_a >= m_settings.layers.size() || layer_b >= m_settings.layers.size()) {
+		ORNG_CORE_ERROR("Can't set collision between physics layers {0} and {1}, only {2} layers exist", layer_a, layer_b, m_settings.layers.size());
+		return;
+	}
+
+	auto set_bit = [collide](uint32_t& mask, ObjectLayer layer) {
+		if (collide)
+			mask |= 1u << layer;
+		else
+			mask &= ~(1u << layer);
+	};
+
+	set_bit(m_settings.layers[layer_a].collision_mask, layer_b);
+	set_bit(m_settings.layers[layer_b].collision_mask, layer_a);
+	UpdateLayerFilters();
+}
+
+ObjectLayer ORNG::PhysicsSystem::GetLayer(const std::string& name) const {
+	for (size_t i = 0; i < m_settings.layers.size(); i++) {
+		if (m_settings.layers[i].name == name)
+			return static_cast<ObjectLayer>(i);
+	}
+
+	return Layers::AUTO;
+}
+
+ObjectLayer ORNG::PhysicsSystem::GetObjectLayer(const PhysicsComponent* p_comp) const {
+	if (p_comp->m_layer < m_settings.layers.size())
+		return p_comp->m_layer;
+
+	if (p_comp->m_is_trigger)
+		return Layers::TRIGGER;
+
+	return p_comp->m_body_type == PhysicsComponent::STATIC ? Layers::NON_MOVING : Layers::MOVING;
+}
+
+uint8_t ORNG::PhysicsSystem::GetBroadPhaseMask(uint32_t layer_mask) const {
+	uint8_t mask = 0;
+	for (size_t i = 0; i < m_settings.layers.size(); i++) {
+		if ((layer_mask >> i) & 1u)
+			mask |= static_cast<uint8_t>(1u << m_settings.layers[i].broad_phase_layer);
+	}
+
+	return mask;
+}
+
+namespace {
+// Filters for a single query, layer filtering is by mask rather than by a querying layer so scripts can pick any combination
+class QueryFilters {
+public:
+	QueryFilters(uint32_t layer_mask, uint8_t broad_phase_mask, BodyID ignored_body) : m_broad_phase_filter(broad_phase_mask), m_object_layer_filter(layer_mask), m_body_filter(ignored_body) {}
+
+	class BroadPhaseMaskFilter final : public BroadPhaseLayerFilter {
+	public:
+		explicit BroadPhaseMaskFilter(uint8_t mask) : m_mask(mask) {}
+
+		bool ShouldCollide(BroadPhaseLayer inLayer) const override {
+			return (m_mask >> static_cast<BroadPhaseLayer::Type>(inLayer)) & 1u;
+		}
+
+	private:
+		uint8_t m_mask;
+	};
+
+	class ObjectLayerMaskFilter final : public ObjectLayerFilter {
+	public:
+		explicit ObjectLayerMaskFilter(uint32_t mask) : m_mask(mask) {}
+
+		bool ShouldCollide(ObjectLayer inLayer) const override {
+			return inLayer < Layers::MAX_LAYERS && ((m_mask >> inLayer) & 1u);
+		}
+
+	private:
+		uint32_t m_mask;
+	};
+
+	class QueryBodyFilter final : public BodyFilter {
+	public:
+		explicit QueryBodyFilter(BodyID ignored_body) : m_ignored_body(ignored_body) {}
+
+		bool ShouldCollide(const BodyID& inBodyID) const override {
+			return inBodyID != m_ignored_body;
+		}
+
+		// Bodies queued for removal have had their user data cleared
+		bool ShouldCollideLocked(const Body& inBody) const override {
+			return inBody.GetUserData() != 0;
+		}
+
+	private:
+		BodyID m_ignored_body;
+	};
+
+	BroadPhaseMaskFilter m_broad_phase_filter;
+	ObjectLayerMaskFilter m_object_layer_filter;
+	QueryBodyFilter m_body_filter;
+};
+
+// Collects the distinct entities a shape overlaps into a fixed size span
+class EntityOverlapCollector final : public CollideShapeCollector {
+public:
+	EntityOverlapCollector(std::span<SceneEntity*> output, const BodyInterface& body_interface) : m_output(output), m_body_interface(body_interface) {}
+
+	void AddHit(const CollideShapeResult& inResult) override {
+		auto* p_entity = reinterpret_cast<SceneEntity*>(m_body_interface.GetUserData(inResult.mBodyID2));
+		const auto found = m_output.first(m_count);
+
+		// A body is reported once for each of its sub shapes that overlap
+		if (!p_entity || std::ranges::find(found, p_entity) != found.end())
+			return;
+
+		m_output[m_count++] = p_entity;
+		if (m_count == m_output.size())
+			ForceEarlyOut();
+	}
+
+	[[nodiscard]] unsigned GetCount() const noexcept { return m_count; }
+
+private:
+	std::span<SceneEntity*> m_output;
+	const BodyInterface& m_body_interface;
+	unsigned m_count = 0;
+};
+}
+
+// Calls func(job_index, begin, end) over at most max_jobs ranges of [0, count) on the job system and waits for them to finish
+// Counts no larger than min_per_job run on the calling thread as job 0
+template<typename F>
+static void RunBatchedJobs(JobSystem& job_system, unsigned count, unsigned min_per_job, unsigned max_jobs, const F& func) {
+	constexpr unsigned job_limit = 64;
+	max_jobs = std::clamp(max_jobs, 1u, job_limit);
+
+	if (count <= min_per_job || max_jobs == 1) {
+		func(0u, 0u, count);
+		return;
+	}
+
+	const unsigned per_job = std::max(min_per_job, (count + max_jobs - 1) / max_jobs);
+	std::array<JobHandle, job_limit> handles;
+	unsigned num_jobs = 0;
+
+	for (unsigned begin = 0; begin < count; begin += per_job) {
+		const unsigned end = std::min(begin + per_job, count);
+		const unsigned job_index = num_jobs;
+		// Capture is kept small enough for the job's std::function to store inline
+		handles[num_jobs++] = job_system.CreateJob("PhysicsBatch", Color::sCyan, [&func, job_index, begin, end] { func(job_index, begin, end); });
+	}
+
+	// The waiting thread helps execute the jobs
+	JobSystem::Barrier* p_barrier = job_system.CreateBarrier();
+	p_barrier->AddJobs(handles.data(), num_jobs);
+	job_system.WaitForJobs(p_barrier);
+	job_system.DestroyBarrier(p_barrier);
+}
+
+// Calls func(begin, end) over ranges of [0, count) on the job system and waits for them to finish, small counts run on the calling thread
+template<typename F>
+static void RunQueryJobs(JobSystem& job_system, unsigned count, const F& func) {
+	RunBatchedJobs(job_system, count, 32, 64, [&func](unsigned, unsigned begin, unsigned end) { func(begin, end); });
+}
+
+// Calls func with a shape matching query, the shape lives on the stack for the duration of the call
+template<typename F>
+static void WithQueryShape(const ORNG::PhysicsSystem::ShapeQuery& query, const F& func) {
+	if (query.type == ORNG::PhysicsSystem::QueryShapeType::SPHERE) {
+		SphereShape sphere{ glm::max(query.half_extents.x, 0.001f) };
+		sphere.SetEmbedded();
+		func(static_cast<const Shape&>(sphere));
+	}
+	else {
+		const Vec3 half_extents = GlmToJph(glm::max(query.half_extents, glm::vec3(0.001f)));
+		BoxShape box{ half_extents, std::min(cDefaultConvexRadius, half_extents.ReduceMin()) };
+		box.SetEmbedded();
+		func(static_cast<const Shape&>(box));
+	}
+}
+
+static void FillQueryHit(RaycastResults& result, const BodyLockInterface& lock_interface, const BodyID& body_id, RVec3 hit_pos, float hit_dist, const Vec3* p_normal, const SubShapeID& sub_shape_id) {
+	BodyLockRead lock{ lock_interface, body_id };
+	if (!lock.Succeeded())
+		return;
+
+	const Body& body = lock.GetBody();
+	const Vec3 normal = p_normal ? *p_normal : body.GetWorldSpaceSurfaceNormal(sub_shape_id, hit_pos);
+
+	result.hit = true;
+	result.hit_pos = glm::vec3{ hit_pos.GetX(), hit_pos.GetY(), hit_pos.GetZ() };
+	result.hit_normal = glm::vec3{ normal.GetX(), normal.GetY(), normal.GetZ() };
+	result.hit_dist = hit_dist;
+	result.p_entity = reinterpret_cast<SceneEntity*>(body.GetUserData());
+	result.p_phys_comp = result.p_entity->GetComponent<PhysicsComponent>();
+}
+
+void ORNG::PhysicsSystem::CastRays(std::span<const RayQuery> queries, std::span<RaycastResults> results) const {
+	if (results.size() != queries.size()) {
+		ORNG_CORE_ERROR("CastRays given {0} queries but space for {1} results", queries.size(), results.size());
+		return;
+	}
+
+	ORNG_PROFILE_FUNC();
+	const NarrowPhaseQuery& narrow_phase = physics_system.GetNarrowPhaseQueryNoLock();
+	const BodyLockInterface& lock_interface = physics_system.GetBodyLockInterfaceNoLock();
+
+	RunQueryJobs(*mp_job_system, static_cast<unsigned>(queries.size()), [&](unsigned begin, unsigned end) {
+		for (unsigned i = begin; i < end; i++) {
+			const RayQuery& query = queries[i];
+			RaycastResults& result = results[i];
+			result = RaycastResults{};
+
+			const float length = glm::length(query.direction);
+			if (length <= 0.f || query.max_distance <= 0.f)
+				continue;
+
+			const RRayCast ray{ GlmToJph(query.origin), GlmToJph(query.direction * (query.max_distance / length)) };
+			const QueryFilters filters{ query.layer_mask, GetBroadPhaseMask(query.layer_mask), query.ignored_body };
+
+			RayCastResult hit;
+			if (narrow_phase.CastRay(ray, hit, filters.m_broad_phase_filter, filters.m_object_layer_filter, filters.m_body_filter))
+				FillQueryHit(result, lock_interface, hit.mBodyID, ray.GetPointOnRay(hit.mFraction), hit.mFraction * query.max_distance, nullptr, hit.mSubShapeID2);
+		}
+	});
+}
+
+void ORNG::PhysicsSystem::CastShapes(std::span<const ShapeCastQuery> queries, std::span<RaycastResults> results) const {
+	if (results.size() != queries.size()) {
+		ORNG_CORE_ERROR("CastShapes given {0} queries but space for {1} results", queries.size(), results.size());
+		return;
+	}
+
+	ORNG_PROFILE_FUNC();
+	const NarrowPhaseQuery& narrow_phase = physics_system.GetNarrowPhaseQueryNoLock();
+	const BodyLockInterface& lock_interface = physics_system.GetBodyLockInterfaceNoLock();
+
+	RunQueryJobs(*mp_job_system, static_cast<unsigned>(queries.size()), [&](unsigned begin, unsigned end) {
+		for (unsigned i = begin; i < end; i++) {
+			const ShapeCastQuery& query = queries[i];
+			RaycastResults& result = results[i];
+			result = RaycastResults{};
+
+			const float length = glm::length(query.direction);
+			if (length <= 0.f || query.max_distance <= 0.f)
+				continue;
+
+			const QueryFilters filters{ query.shape.layer_mask, GetBroadPhaseMask(query.shape.layer_mask), query.shape.ignored_body };
+
+			WithQueryShape(query.shape, [&](const Shape& shape) {
+				const RShapeCast cast = RShapeCast::sFromWorldTransform(&shape, Vec3::sReplicate(1.f), RMat44::sRotationTranslation(GlmToJph(query.shape.orientation), GlmToJph(query.shape.position)),
+					GlmToJph(query.direction * (query.max_distance / length)));
+
+				ClosestHitCollisionCollector<CastShapeCollector> collector;
+				narrow_phase.CastShape(cast, ShapeCastSettings{}, RVec3::sZero(), collector, filters.m_broad_phase_filter, filters.m_object_layer_filter, filters.m_body_filter);
+				if (!collector.HadHit())
+					return;
+
+				const ShapeCastResult& hit = collector.mHit;
+				// Penetration axis points from the cast shape into the hit body
+				const Vec3 normal = -hit.mPenetrationAxis.NormalizedOr(Vec3::sAxisY());
+				FillQueryHit(result, lock_interface, hit.mBodyID2, hit.mContactPointOn2, hit.mFraction * query.max_distance, &normal, hit.mSubShapeID2);
+			});
+		}
+	});
+}
+
+void ORNG::PhysicsSystem::OverlapShapes(std::span<const ShapeQuery> queries, std::span<SceneEntity*> hits, unsigned max_hits_per_query, std::span<unsigned> hit_counts) const {
+	if (hit_counts.size() != queries.size() || hits.size() < queries.size() * max_hits_per_query) {
+		ORNG_CORE_ERROR("OverlapShapes given {0} queries but space for {1} hit counts and {2} hits", queries.size(), hit_counts.size(), hits.size());
+		return;
+	}
+
+	ORNG_PROFILE_FUNC();
+	const NarrowPhaseQuery& narrow_phase = physics_system.GetNarrowPhaseQueryNoLock();
+	const BodyInterface& body_interface = physics_system.GetBodyInterfaceNoLock();
+
+	RunQueryJobs(*mp_job_system, static_cast<unsigned>(queries.size()), [&](unsigned begin, unsigned end) {
+		for (unsigned i = begin; i < end; i++) {
+			const ShapeQuery& query = queries[i];
+			hit_counts[i] = 0;
+
+			if (max_hits_per_query == 0)
+				continue;
+
+			const QueryFilters filters{ query.layer_mask, GetBroadPhaseMask(query.layer_mask), query.ignored_body };
+			EntityOverlapCollector collector{ hits.subspan(static_cast<size_t>(i) * max_hits_per_query, max_hits_per_query), body_interface };
+
+			WithQueryShape(query, [&](const Shape& shape) {
+				narrow_phase.CollideShape(&shape, Vec3::sReplicate(1.f), RMat44::sRotationTranslation(GlmToJph(query.orientation), GlmToJph(query.position)), CollideShapeSettings{},
+					RVec3::sZero(), collector, filters.m_broad_phase_filter, filters.m_object_layer_filter, filters.m_body_filter);
+			});
+
+			hit_counts[i] = collector.GetCount();
+		}
+	});
+}
+
+ORNG::PhysicsSystem::Stats ORNG::PhysicsSystem::GetStats() const {
+	Stats stats;
+	stats.num_bodies = physics_system.GetNumBodies();
+	stats.num_active_bodies = physics_system.GetNumActiveBodies(EBodyType::RigidBody);
+	stats.max_bodies = physics_system.GetMaxBodies();
+	stats.num_contacts = m_contact_recorder.GetContactCount();
+	stats.num_contact_events = static_cast<unsigned>(m_contacts.size());
+	stats.num_characters = static_cast<unsigned>(mp_scene->GetRegistry().view<CharacterControllerComponent>().size());
+
+	if (mp_temp_allocator) {
+		stats.temp_allocator_high_water_mark = mp_temp_allocator->GetHighWaterMark();
+		stats.temp_allocator_size = mp_temp_allocator->GetCapacity();
+	}
+
+	return stats;
+}
+
+void ORNG::PhysicsSystem::SerializeSettings(YAML::Emitter& out) const {
+	out << YAML::Key << "Physics" << YAML::BeginMap;
+	out << YAML::Key << "MaxBodies" << YAML::Value << m_settings.max_bodies;
+	out << YAML::Key << "MaxBodyPairs" << YAML::Value << m_settings.max_body_pairs;
+	out << YAML::Key << "MaxContactConstraints" << YAML::Value << m_settings.max_contact_constraints;
+	out << YAML::Key << "TempAllocatorSize" << YAML::Value << m_settings.temp_allocator_size;
+	out << YAML::Key << "StepSize" << YAML::Value << step_size;
+	out << YAML::Key << "MaxSubsteps" << YAML::Value << max_substeps;
+	out << YAML::Key << "Interpolation" << YAML::Value << static_cast<unsigned>(interpolation_mode);
+
+	out << YAML::Key << "Layers" << YAML::Value << YAML::BeginSeq;
+	for (const auto& layer : m_settings.layers) {
+		out << YAML::BeginMap;
+		out << YAML::Key << "Name" << YAML::Value << layer.name;
+		out << YAML::Key << "BroadPhaseLayer" << YAML::Value << static_cast<unsigned>(layer.broad_phase_layer);
+		out << YAML::Key << "CollisionMask" << YAML::Value << layer.collision_mask;
+		out << YAML::EndMap;
+	}
+	out << YAML::EndSeq;
+
+	out << YAML::EndMap;
+}
+
+void ORNG::PhysicsSystem::DeserializeSettings(const YAML::Node& node) {
+	// Scenes saved before physics settings existed keep the defaults
+	auto physics_node = node["Physics"];
+	if (!physics_node)
+		return;
+
+	Settings settings;
+	settings.max_bodies = physics_node["MaxBodies"].as<unsigned>();
+	settings.max_body_pairs = physics_node["MaxBodyPairs"].as<unsigned>();
+	settings.max_contact_constraints = physics_node["MaxContactConstraints"].as<unsigned>();
+	settings.temp_allocator_size = physics_node["TempAllocatorSize"].as<unsigned>();
+	step_size = physics_node["StepSize"].as<float>();
+	max_substeps = physics_node["MaxSubsteps"].as<unsigned>();
+	interpolation_mode = static_cast<InterpolationMode>(physics_node["Interpolation"].as<unsigned>());
+
+	settings.layers.clear();
+	for (const auto& layer_node : physics_node["Layers"]) {
+		auto& layer = settings.layers.emplace_back();
+		layer.name = layer_node["Name"].as<std::string>();
+		layer.broad_phase_layer = static_cast<uint8_t>(layer_node["BroadPhaseLayer"].as<unsigned>());
+		layer.collision_mask = layer_node["CollisionMask"].as<uint32_t>();
+	}
+
+	ApplySettings(settings);
+}
+
 void ORNG::PhysicsSystem::OnLoad() {
 	s_num_loaded_instances++;
 
@@ -69,27 +571,9 @@ void ORNG::PhysicsSystem::OnLoad() {
 		JPH::RegisterTypes();
 	}
 
-	mp_temp_allocator = std::make_unique<TempAllocatorImpl>(1024 * 1024 * 10);
 	mp_job_system = std::make_unique<JobSystemThreadPool>(cMaxPhysicsJobs, cMaxPhysicsBarriers, std::thread::hardware_concurrency() - 1);
+	InitPhysicsSystem();
 
-	// Maximum amount of rigid bodies that can be added to the physics system
-	constexpr unsigned max_bodies = 10'000;
-
-	// This determines how many mutexes to allocate to protect rigid bodies from concurrent access. Set it to 0 for the default settings.
-	constexpr unsigned num_body_mutexes = 0;
-
-	// This is the max amount of body pairs that can be queued at any time (the broad phase will detect overlapping
-	// body pairs based on their bounding boxes and will insert them into a queue for the narrowphase). If you make this buffer
-	// too small the queue will fill up and the broad phase jobs will start to do narrow phase work. This is slightly less efficient.
-	constexpr unsigned max_body_pairs = max_bodies;
-
-	// This is the maximum size of the contact constraint buffer. If more contacts (collisions between bodies) are detected than this
-	// number then these contacts will be ignored and bodies will start interpenetrating / fall through the world.
-	constexpr unsigned max_contact_constraints = max_bodies / 2;
-
-	physics_system.Init(max_bodies, num_body_mutexes, max_body_pairs, max_contact_constraints, m_broad_phase_layer_interface,
-		m_object_vs_broadphase_layer_filter, m_object_vs_object_layer_filter);
-	
 	mp_scene->RegisterComponent<PhysicsComponent>();
 	mp_scene->RegisterComponent<CharacterControllerComponent>();
 	mp_scene->RegisterComponent<JointComponent>();
@@ -117,6 +601,20 @@ void ORNG::PhysicsSystem::SerializeEntity(SceneEntity& entity, YAML::Emitter* p_
 		out << YAML::Key << "RigidBodyType" << YAML::Value << p_physics_comp->m_body_type;
 		out << YAML::Key << "GeometryType" << YAML::Value << p_physics_comp->m_geometry_type;
 		out << YAML::Key << "IsTrigger" << YAML::Value << p_physics_comp->IsTrigger();
+		out << YAML::Key << "Layer" << YAML::Value << p_physics_comp->m_layer;
+		out << YAML::EndMap;
+	}
+
+	if (auto* p_character = entity.GetComponent<CharacterControllerComponent>()) {
+		out << YAML::Key << "CharacterController";
+		out << YAML::BeginMap;
+
+		out << YAML::Key << "Radius" << YAML::Value << p_character->m_radius;
+		out << YAML::Key << "Height" << YAML::Value << p_character->m_height;
+		out << YAML::Key << "MaxSlope" << YAML::Value << p_character->max_slope_degrees;
+		out << YAML::Key << "StepHeight" << YAML::Value << p_character->step_height;
+		out << YAML::Key << "StickToFloor" << YAML::Value << p_character->stick_to_floor_distance;
+		out << YAML::Key << "UseGravity" << YAML::Value << p_character->use_gravity;
 		out << YAML::EndMap;
 	}
 }
@@ -126,8 +624,31 @@ void ORNG::PhysicsSystem::DeserializeEntity(SceneEntity& entity, const YAML::Nod
 		auto geometry_type = static_cast<PhysicsComponent::GeometryType>(node["GeometryType"].as<unsigned int>());
 		auto body_type = static_cast<PhysicsComponent::RigidBodyType>(node["RigidBodyType"].as<unsigned int>());
 		auto is_trigger = node["IsTrigger"].as<bool>();
+		auto layer = node["Layer"] ? node["Layer"].as<ObjectLayer>() : Layers::AUTO;
+
+		entity.AddComponent<PhysicsComponent>(is_trigger, geometry_type, body_type, layer);
+	}
+
+	if (auto node = (*p_node)["CharacterController"]) {
+		auto* p_character = entity.AddComponent<CharacterControllerComponent>(node["Radius"].as<float>(), node["Height"].as<float>());
+		p_character->max_slope_degrees = node["MaxSlope"].as<float>();
+		p_character->step_height = node["StepHeight"].as<float>();
+		p_character->stick_to_floor_distance = node["StickToFloor"].as<float>();
+		p_character->use_gravity = node["UseGravity"].as<bool>();
+	}
+}
+
+void ORNG::PhysicsSystem::CloneEntity(SceneEntity& src, SceneEntity& dst) {
+	if (const auto* p_src_comp = src.GetComponent<PhysicsComponent>()) {
+		dst.AddComponent<PhysicsComponent>(p_src_comp->IsTrigger(), p_src_comp->m_geometry_type, p_src_comp->m_body_type, p_src_comp->m_layer);
+	}
 
-		entity.AddComponent<PhysicsComponent>(is_trigger, geometry_type, body_type);
+	if (const auto* p_src_character = src.GetComponent<CharacterControllerComponent>()) {
+		auto* p_character = dst.AddComponent<CharacterControllerComponent>(p_src_character->m_radius, p_src_character->m_height);
+		p_character->max_slope_degrees = p_src_character->max_slope_degrees;
+		p_character->step_height = p_src_character->step_height;
+		p_character->stick_to_floor_distance = p_src_character->stick_to_floor_distance;
+		p_character->use_gravity = p_src_character->use_gravity;
 	}
 }
 
@@ -149,6 +670,14 @@ void ORNG::PhysicsSystem::InitListeners() {
 		}
 	};
 
+	m_character_listener.scene_id = GetSceneUUID();
+	m_character_listener.OnEvent = [this](const Events::ECS_Event<CharacterControllerComponent>& t_event) {
+		if (t_event.event_type == Events::ECS_EventType::COMP_DELETED)
+			t_event.p_component->mp_character = nullptr;
+		else
+			InitCharacter(t_event.p_component);
+	};
+
 	// Transform update listener
 	m_transform_listener.scene_id = GetSceneUUID();
 	m_transform_listener.OnEvent = [this](const Events::ECS_Event<TransformComponent>& t_event) {
@@ -160,14 +689,46 @@ void ORNG::PhysicsSystem::InitListeners() {
 			SerializeEntity(*_event.p_entity, _event.data.p_emitter);
 		else if (_event.event_type == EntitySerializationEvent::Type::DESERIALIZING)
 			DeserializeEntity(*_event.p_entity, _event.data.p_node);
+		else if (_event.event_type == EntitySerializationEvent::Type::CLONING)
+			CloneEntity(*_event.data.p_src, *_event.p_entity);
+	};
+
+	m_scene_serialization_listener.OnEvent = [this](const SceneSerializationEvent& _event) {
+		// Scene events aren't filtered by scene like ECS events
+		if (&_event.scene != mp_scene)
+			return;
+
+		if (_event.event_type == SceneSerializationEvent::Type::SERIALIZING)
+			SerializeSettings(*_event.data.p_emitter);
+		else
+			DeserializeSettings(*_event.data.p_node);
+	};
+
+	// Shapes are cached by mesh uuid, so reloading or deleting a mesh invalidates them
+	m_asset_listener.OnEvent = [this](const Events::AssetEvent& _event) {
+		if (_event.event_type == Events::AssetEventType::MESH_LOADED) {
+			auto* p_data = reinterpret_cast<std::pair<AssetSerializer::MeshAssets*, MeshLoadResult*>*>(_event.data_payload);
+			OnMeshChanged(p_data->first->p_mesh->uuid(), true);
+		}
+		else if (_event.event_type == Events::AssetEventType::MESH_DELETED) {
+			// Components using the mesh are given a different one by the mesh component system, which updates their bodies
+			OnMeshChanged(reinterpret_cast<MeshAsset*>(_event.data_payload)->uuid(), false);
+		}
 	};
 
 	Events::EventManager::RegisterListener(m_phys_listener);
+	Events::EventManager::RegisterListener(m_character_listener);
 	Events::EventManager::RegisterListener(m_transform_listener);
 	Events::EventManager::RegisterListener(m_serialization_listener);
+	Events::EventManager::RegisterListener(m_scene_serialization_listener);
+	Events::EventManager::RegisterListener(m_asset_listener);
 }
 
 void ORNG::PhysicsSystem::OnUnload() {
+	// Queued adds exist in the body manager without being in the broadphase and queued removals aren't destroyed yet,
+	// flushing handles both like any other frame so neither are leaked
+	FlushBodyQueue();
+
 	s_num_loaded_instances--;
 
 	if (s_num_loaded_instances == 0) {
@@ -180,13 +741,24 @@ void ORNG::PhysicsSystem::OnUnload() {
 		connection.release();
 	}
 
+	m_body_changes_since_optimization = 0;
+	m_shape_cache.clear();
+	m_collider_cooker.Clear();
+	m_entities_awaiting_colliders.clear();
+	m_interpolated_bodies.clear();
+	m_characters.clear();
+	m_touching_sub_shape_counts.clear();
+
 	DeinitListeners();
 }
 
 void ORNG::PhysicsSystem::DeinitListeners() {
 	Events::EventManager::DeregisterListener(m_phys_listener.GetRegisterID());
+	Events::EventManager::DeregisterListener(m_character_listener.GetRegisterID());
 	Events::EventManager::DeregisterListener(m_transform_listener.GetRegisterID());
 	Events::EventManager::DeregisterListener(m_serialization_listener.GetRegisterID());
+	Events::EventManager::DeregisterListener(m_scene_serialization_listener.GetRegisterID());
+	Events::EventManager::DeregisterListener(m_asset_listener.GetRegisterID());
 }
 
 void ORNG::PhysicsSystem::OnTransformEvent(const Events::ECS_Event<TransformComponent>& t_event) {
@@ -194,185 +766,1255 @@ void ORNG::PhysicsSystem::OnTransformEvent(const Events::ECS_Event<TransformComp
 
 	auto* p_transform = t_event.p_component;
 
-	if (p_transform == mp_currently_updating_transform) // Ignore transform event if it was updated by the physics engine, as the states are already synced
+	// Ignore transform events from the write-back, as the states are already synced, and render-only updates
+	if (t_event.p_data == this || t_event.sub_event_type == TransformComponent::UpdateType::RENDER)
 		return;
 
 	// Check for both types of physics component
 	auto* p_ent = t_event.p_component->GetEntity();
 
 	if (auto* p_phys_comp = p_ent->GetComponent<PhysicsComponent>()) {
-		if (t_event.sub_event_type == TransformComponent::UpdateType::SCALE || t_event.sub_event_type == TransformComponent::UpdateType::ALL) { // Whole shape needs to be rebuilt
-			UpdateComponentState(p_phys_comp);
+		if (p_phys_comp->body_id.IsInvalid())
 			return;
+
+		// Shapes are shared and scaled through wrappers, so a scale change only swaps the body's shape rather than rebuilding the body
+		if (t_event.sub_event_type == TransformComponent::UpdateType::SCALE || t_event.sub_event_type == TransformComponent::UpdateType::ALL) {
+			UpdateBodyShape(p_phys_comp);
+
+			if (t_event.sub_event_type == TransformComponent::UpdateType::SCALE)
+				return;
 		}
 
 		// TODO: Could batch these
 		BodyInterface& body_interface = physics_system.GetBodyInterface();
-		body_interface.SetPositionAndRotation(p_phys_comp->body_id, GlmToJph(p_transform->GetAbsPosition()),
-			GlmToJph(p_transform->GetAbsOrientationQuat()), EActivation::Activate);
+		const RVec3 pos = GlmToJph(p_transform->GetAbsPosition());
+		const Quat orientation = GlmToJph(p_transform->GetAbsOrientationQuat());
+		body_interface.SetPositionAndRotation(p_phys_comp->body_id, pos, orientation, EActivation::Activate);
+
+		// Bodies not added yet are recorded with their pose when they're added
+		if (mp_recording && body_interface.IsAdded(p_phys_comp->body_id)) {
+			auto& stream = mp_recording->stream;
+			stream.Write(RecordedCommand::SET_POSE);
+			stream.Write(p_phys_comp->body_id.GetIndexAndSequenceNumber());
+			stream.Write(pos);
+			stream.Write(orientation);
+		}
+	}
+	else if (auto* p_character = p_ent->GetComponent<CharacterControllerComponent>(); p_character && p_character->mp_character) {
+		// Teleports the character, its velocity is kept
+		p_character->mp_character->SetPosition(GlmToJph(p_transform->GetAbsPosition()));
 	}
 }
 
-void ORNG::PhysicsSystem::UpdateComponentState(PhysicsComponent* p_comp) {
-	ORNG_TRACY_PROFILE;
+void ORNG::PhysicsSystem::UpdateBodyShape(PhysicsComponent* p_comp) {
+	RefConst<Shape> p_shape = GetCachedShape(p_comp);
+	if (!p_shape)
+		return;
+
+	BodyInterface& body_interface = physics_system.GetBodyInterface();
+	if (body_interface.GetShape(p_comp->body_id).GetPtr() == p_shape.GetPtr())
+		return;
+
+	body_interface.SetShape(p_comp->body_id, p_shape, true, EActivation::Activate);
+
+	if (mp_recording && body_interface.IsAdded(p_comp->body_id)) {
+		auto& recording = *mp_recording;
+		recording.stream.Write(RecordedCommand::SET_SHAPE);
+		recording.stream.Write(p_comp->body_id.GetIndexAndSequenceNumber());
+		p_shape->SaveWithChildren(recording.stream, recording.shape_ids, recording.material_ids);
+		recording.RetainWrittenObjects();
+	}
+}
+
+RefConst<Shape> ORNG::PhysicsSystem::GetCachedShape(PhysicsComponent* p_comp) {
+	const auto geometry_type = p_comp->m_geometry_type;
 
 	auto* p_mesh_comp = p_comp->GetEntity()->GetComponent<MeshComponent>();
-	TransformComponent& transform = *p_comp->GetEntity()->GetComponent<TransformComponent>();
-	const AABB& aabb = p_mesh_comp ? p_mesh_comp->GetMeshData()->GetAABB() : AABB(glm::vec3(1.f));
+	const MeshAsset* p_mesh = p_mesh_comp ? p_mesh_comp->GetMeshData() : nullptr;
 
-	glm::vec3 scale_factor = p_comp->GetEntity()->GetComponent<TransformComponent>()->GetAbsScale();
-	glm::vec3 scaled_extents = aabb.extents * scale_factor;
+	if (geometry_type == PhysicsComponent::TRIANGLE_MESH && !p_mesh)
+		return nullptr;
 
-	// The main way to interact with the bodies in the physics system is through the body interface. There is a locking and a non-locking
-	// variant of this. We're going to use the locking version (even though we're not planning to access bodies from multiple threads)
-	BodyInterface& body_interface = physics_system.GetBodyInterface(); // TODO: Use non-locking variant
+	glm::vec3 scale = p_comp->GetEntity()->GetComponent<TransformComponent>()->GetAbsScale();
+	// Spheres can only be scaled uniformly
+	if (geometry_type == PhysicsComponent::SPHERE)
+		scale = glm::vec3(glm::max(glm::max(scale.x, scale.y), scale.z));
 
-	if (!p_comp->body_id.IsInvalid()) {
-		body_interface.RemoveBody(p_comp->body_id);
-		body_interface.DestroyBody(p_comp->body_id);
-		num_body_events_since_last_broadphase_optimization++;
+	// Dynamic bodies can't use triangle meshes so get a convex hull of the mesh instead
+	const bool convex_hull = geometry_type == PhysicsComponent::TRIANGLE_MESH && p_comp->m_body_type == PhysicsComponent::DYNAMIC;
+
+	ShapeKey key{ geometry_type, p_mesh ? p_mesh->uuid() : 0, glm::max(glm::ivec3(glm::round(scale * SHAPE_SCALE_QUANTIZATION)), glm::ivec3(1)), convex_hull };
+	if (auto it = m_shape_cache.find(key); it != m_shape_cache.end())
+		return it->second;
+
+	// Unit scale shape shared by every scaled shape of the same geometry
+	ShapeKey base_key{ geometry_type, key.mesh_uuid, glm::ivec3(0), convex_hull };
+	RefConst<Shape> p_base_shape;
+	if (auto it = m_shape_cache.find(base_key); it != m_shape_cache.end()) {
+		p_base_shape = it->second;
 	}
+	else if (geometry_type == PhysicsComponent::TRIANGLE_MESH) {
+		// Cooked shapes are moved into the cache by OnUpdate, the body is created once that happens
+		if (m_collider_cooker.RequestShape(*p_mesh, convex_hull ? MeshColliderCooker::ColliderType::CONVEX_HULL : MeshColliderCooker::ColliderType::TRIANGLE_MESH))
+			m_entities_awaiting_colliders.push_back(p_comp->GetEntity()->GetUUID());
 
-	EMotionType motion_type = p_comp->m_body_type == PhysicsComponent::STATIC ? EMotionType::Static : EMotionType::Dynamic;
-	ObjectLayer layer = p_comp->m_body_type == PhysicsComponent::STATIC ? Layers::NON_MOVING : Layers::MOVING;
+		return nullptr;
+	}
+	else if (geometry_type == PhysicsComponent::SPHERE) {
+		p_base_shape = new SphereShape{ 1.f };
+	}
+	else {
+		const glm::vec3 extents = p_mesh ? p_mesh->GetAABB().extents : glm::vec3(1.f);
+		const Vec3 half_extents = GlmToJph(glm::max(extents, glm::vec3(0.001f)));
+		// The default convex radius is larger than the extents of very thin meshes
+		p_base_shape = new BoxShape{ half_extents, std::min(cDefaultConvexRadius, half_extents.ReduceMin()) };
+	}
+	m_shape_cache[base_key] = p_base_shape;
 
-	if (p_comp->m_geometry_type == PhysicsComponent::SPHERE) {
-		BodyCreationSettings sphere_settings{new SphereShape{glm::max(glm::max(scale_factor.x, scale_factor.y), scale_factor.z)},
-			GlmToJph(transform.GetAbsPosition()), GlmToJph(transform.GetAbsOrientationQuat()), motion_type, layer};
+	const glm::vec3 quantized_scale = glm::vec3(key.quantized_scale) / SHAPE_SCALE_QUANTIZATION;
+	RefConst<Shape> p_shape = p_base_shape;
+	if (quantized_scale != glm::vec3(1.f))
+		p_shape = new ScaledShape{ p_base_shape, GlmToJph(quantized_scale) };
 
-		p_comp->body_id = body_interface.CreateAndAddBody(sphere_settings, EActivation::Activate);
-	} else if (p_comp->m_geometry_type == PhysicsComponent::BOX) {
-		BoxShapeSettings box_shape_settings{Vec3{scaled_extents.x, scaled_extents.y, scaled_extents.z}};
-		ShapeSettings::ShapeResult box_shape_result;
-		BodyCreationSettings box_settings{new BoxShape{box_shape_settings, box_shape_result},
-			GlmToJph(transform.GetAbsPosition()), GlmToJph(transform.GetAbsOrientationQuat()), motion_type, layer};
+	m_shape_cache[key] = p_shape;
+	return p_shape;
+}
 
-		p_comp->body_id = body_interface.CreateAndAddBody(box_settings, EActivation::Activate);
+void ORNG::PhysicsSystem::CreateAwaitingBodies() {
+	// Entities still waiting on a different shape are added back to the list by UpdateComponentState
+	std::vector<uint64_t> awaiting;
+	awaiting.swap(m_entities_awaiting_colliders);
+
+	for (auto uuid : awaiting) {
+		auto* p_ent = mp_scene->GetEntity(uuid);
+		auto* p_comp = p_ent ? p_ent->GetComponent<PhysicsComponent>() : nullptr;
+		if (!p_comp)
+			continue;
+
+		// Bodies waiting on a recook after their mesh was reloaded keep the old shape until now
+		if (p_comp->body_id.IsInvalid())
+			UpdateComponentState(p_comp);
+		else
+			UpdateBodyShape(p_comp);
 	}
+}
 
-	body_interface.SetUserData(p_comp->body_id, reinterpret_cast<size_t>(p_comp->GetEntity()));
-	num_body_events_since_last_broadphase_optimization++;
+void ORNG::PhysicsSystem::OnMeshChanged(uint64_t mesh_uuid, bool update_bodies) {
+	// Bodies hold their own references, so shapes erased here stay alive until each body is given a new one
+	const size_t num_erased = std::erase_if(m_shape_cache, [mesh_uuid](const auto& pair) { return pair.first.mesh_uuid == mesh_uuid; });
+	m_collider_cooker.Invalidate(mesh_uuid);
 
-	// Arbitrary threshold
-	// OptimizeBroadPhase is expensive so it shouldn't be done very frequently, just whenever a bunch of bodies are added or removed
-	if (num_body_events_since_last_broadphase_optimization > 50) {
-		physics_system.OptimizeBroadPhase();
-		num_body_events_since_last_broadphase_optimization = 0;
+	if (!update_bodies || num_erased == 0)
+		return;
+
+	for (auto [entity, comp] : mp_scene->GetRegistry().view<PhysicsComponent>().each()) {
+		if (comp.body_id.IsInvalid())
+			continue;
+
+		auto* p_mesh_comp = comp.GetEntity()->GetComponent<MeshComponent>();
+		const MeshAsset* p_mesh = p_mesh_comp ? p_mesh_comp->GetMeshData() : nullptr;
+		if (p_mesh && p_mesh->uuid() == mesh_uuid)
+			UpdateBodyShape(&comp);
 	}
 }
 
+void ORNG::PhysicsSystem::PruneShapeCache() {
+	// Scaled shapes reference their base shape so they're released first, shapes only referenced by the cache aren't used by any body
+	std::erase_if(m_shape_cache, [](const auto& pair) { return pair.first.quantized_scale != glm::ivec3(0) && pair.second->GetRefCount() == 1; });
+	std::erase_if(m_shape_cache, [](const auto& pair) { return pair.second->GetRefCount() == 1; });
+	m_shape_cache_prune_threshold = std::max(m_shape_cache.size() * 2, MIN_SHAPE_CACHE_PRUNE_THRESHOLD);
+}
+
+void ORNG::PhysicsSystem::UpdateComponentState(PhysicsComponent* p_comp) {
+	ORNG_TRACY_PROFILE;
 
-void ORNG::PhysicsSystem::InitComponent(PhysicsComponent* p_comp) {
-	UpdateComponentState(p_comp);
+	TransformComponent& transform = *p_comp->GetEntity()->GetComponent<TransformComponent>();
+
+	if (!p_comp->body_id.IsInvalid()) {
+		QueueBodyRemoval(p_comp->body_id);
+		p_comp->body_id = BodyID{};
+	}
+
+	RefConst<Shape> p_shape = GetCachedShape(p_comp);
+	if (!p_shape)
+		return;
+
+	EMotionType motion_type = p_comp->m_body_type == PhysicsComponent::STATIC ? EMotionType::Static : EMotionType::Dynamic;
+	// Triggers only follow their transform, kinematic sensors also detect sleeping bodies which static ones don't
+	if (p_comp->m_is_trigger)
+		motion_type = EMotionType::Kinematic;
+
+	ObjectLayer layer = GetObjectLayer(p_comp);
+
+	BodyCreationSettings settings{ p_shape, GlmToJph(transform.GetAbsPosition()), GlmToJph(transform.GetAbsOrientationQuat()), motion_type, layer };
+	settings.mIsSensor = p_comp->m_is_trigger;
+	CreateQueuedBody(p_comp, settings);
 }
 
-void ORNG::PhysicsSystem::RemoveComponent(PhysicsComponent* p_comp) {
-	if (p_comp->body_id.IsInvalid()) return;
+void ORNG::PhysicsSystem::CreateQueuedBody(PhysicsComponent* p_comp, const BodyCreationSettings& settings) {
+	// Bodies are only created here and in FlushBodyQueue on the main thread while the simulation isn't running, so no locking is needed
+	BodyInterface& body_interface = physics_system.GetBodyInterfaceNoLock();
 
-	BodyInterface& body_interface = physics_system.GetBodyInterface(); // TODO: Use non-locking variant
-	//delete body_interface.GetShape(p_comp->body_id).GetPtr();
-	body_interface.RemoveBody(p_comp->body_id);
-	body_interface.DestroyBody(p_comp->body_id);
+	Body* p_body = body_interface.CreateBody(settings);
+	if (!p_body) {
+		ORNG_CORE_ERROR("Failed to create physics body for entity '{0}', body limit reached", p_comp->GetEntity()->GetName());
+		return;
+	}
 
-	num_body_events_since_last_broadphase_optimization++;
+	p_body->SetUserData(reinterpret_cast<uint64>(p_comp->GetEntity()));
+	p_comp->body_id = p_body->GetID();
+	m_pending_body_adds.push_back(p_comp->body_id);
 }
 
+void ORNG::PhysicsSystem::QueueBodyRemoval(BodyID id) {
+	physics_system.GetBodyInterfaceNoLock().SetUserData(id, 0);
+	m_pending_body_removals.push_back(id);
+}
 
-void ORNG::PhysicsSystem::OnUpdate() {
-	if (!m_is_updating)
+void ORNG::PhysicsSystem::FlushBodyQueue() {
+	if (m_pending_body_adds.empty() && m_pending_body_removals.empty())
 		return;
 
 	ORNG_PROFILE_FUNC();
-	float ts = FrameTiming::GetTimeStep();
+	BodyInterface& body_interface = physics_system.GetBodyInterfaceNoLock();
+
+	// Adds go first so bodies created and removed within the same frame can be removed like any other
+	if (!m_pending_body_adds.empty()) {
+		const int num_adds = static_cast<int>(m_pending_body_adds.size());
+		if (mp_recording) {
+			mp_recording->stream.Write(RecordedCommand::ADD_BODIES);
+			WriteRecordedBodies(m_pending_body_adds);
+		}
 
-	m_accumulator += ts * 0.001f;
-	if (m_accumulator < step_size) return;
+		// Builds a tree for the whole batch up front which is then inserted into the broadphase at once, rather than one insertion per body
+		BodyInterface::AddState add_state = body_interface.AddBodiesPrepare(m_pending_body_adds.data(), num_adds);
+		body_interface.AddBodiesFinalize(m_pending_body_adds.data(), num_adds, add_state, EActivation::Activate);
 
-	int num_steps = static_cast<int>(ceil(m_accumulator / step_size));
-	float adjusted_step_size = m_accumulator / static_cast<float>(num_steps);
-	physics_system.Update(adjusted_step_size, num_steps, mp_temp_allocator.get(), mp_job_system.get());
+		m_body_changes_since_optimization += static_cast<unsigned>(num_adds);
+		m_pending_body_adds.clear();
+	}
 
-	m_accumulator = 0.f;
+	if (!m_pending_body_removals.empty()) {
+		const int num_removals = static_cast<int>(m_pending_body_removals.size());
+		if (mp_recording) {
+			auto& stream = mp_recording->stream;
+			stream.Write(RecordedCommand::REMOVE_BODIES);
+			stream.Write(static_cast<uint32_t>(num_removals));
+			for (BodyID id : m_pending_body_removals) {
+				stream.Write(id.GetIndexAndSequenceNumber());
+			}
+		}
 
-	BodyInterface& body_interface = physics_system.GetBodyInterface(); // TODO: Use non-locking variant
-	BodyIDVector active_bodies;
-	physics_system.GetActiveBodies(EBodyType::RigidBody, active_bodies);
-	for (const auto& body : active_bodies) {
-		Quat q;
-		Vec3 p;
-		body_interface.GetPositionAndRotation(body, p, q);
+		body_interface.RemoveBodies(m_pending_body_removals.data(), num_removals);
+		body_interface.DestroyBodies(m_pending_body_removals.data(), num_removals);
 
-		auto* p_ent = reinterpret_cast<SceneEntity*>(body_interface.GetUserData(body));
-		TransformComponent& transform = *p_ent->GetComponent<TransformComponent>();
-		mp_currently_updating_transform = &transform; // Set this so it's ignored by the transform event callbacks while being updated
-		transform.SetAbsolutePosition(glm::vec3{p.GetX(), p.GetY(), p.GetZ()});
-		transform.SetAbsOrientationQuat(glm::quat{q.GetW(), q.GetX(), q.GetY(), q.GetZ()});
-	}
-
-	mp_currently_updating_transform = nullptr;
-}
-
-void ORNG::PhysicsSystem::Tick() {
-	//auto& reg = mp_scene->GetRegistry();
-	//float ts = FrameTiming::GetTimeStep();
-
-	// TODO: Update scene, then update all component transforms and collision callbacks
-
-	// for (int i = 0; i < num_active_actors; i++) {
-	// 	SceneEntity* p_ent = static_cast<SceneEntity*>(active_actors[i]->userData);
-	// 	auto* p_transform = p_ent->GetComponent<TransformComponent>();
-	// 	mp_currently_updating_transform = p_transform;
-	// 	UpdateTransformCompFromGlobalPose(static_cast<PxRigidActor*>(active_actors[i])->getGlobalPose(), *p_transform, p_ent->HasComponent<CharacterControllerComponent>() ? ActorType::CHARACTER_CONTROLLER : ActorType::RIGID_BODY);
-	// 	mp_currently_updating_transform = nullptr;
-	// }
-	//
-	//
-	// // Process OnCollision callbacks
-	// for (auto& pair : m_entity_collision_queue) {
-	// 	auto* p_first_script = reg.try_get<ScriptComponent>(pair.first);
-	// 	auto* p_second_script = reg.try_get<ScriptComponent>(pair.second);
-	// 	try {
-	// 		if (p_first_script)
-	// 			p_first_script->p_instance->OnCollide(reg.get<TransformComponent>(pair.second).GetEntity());
-	//
-	// 		if (p_second_script)
-	// 			p_second_script->p_instance->OnCollide(reg.get<TransformComponent>(pair.first).GetEntity());
-	// 	}
-	// 	catch (std::exception e) {
-	// 		ORNG_CORE_ERROR("Script OnCollision err for collision pair '{0}', '{1}' : '{2}'", p_first_script->GetEntity()->name, p_second_script->GetEntity()->name, e.what());
-	// 	}
-	// }
-
-	// for (auto& [event_type, ent, trigger] : m_trigger_event_queue) {
-	// 	auto* p_script = reg.try_get<ScriptComponent>(trigger);
-	// 	if (!p_script)
-	// 		continue;
-	//
-	// 	auto* p_ent = reg.try_get<TransformComponent>(ent)->GetEntity();
-	// 	try {
-	// 		if (event_type == ENTERED)
-	// 			p_script->p_instance->OnTriggerEnter(p_ent);
-	// 		else
-	// 			p_script->p_instance->OnTriggerLeave(p_ent);
-	// 	}
-	// 	catch (std::exception e) {
-	// 		ORNG_CORE_ERROR("Script trigger event err for pair '{0}', trigger: '{1}' : '{2}'", p_ent->name, p_script->GetEntity()->name, e.what());
-	// 	}
-	// }
-	//
-	// for (auto* p_joint : m_joints_to_break) {
-	// 	BreakJoint(p_joint);
-	// }
-	//
-	// unsigned size = m_entity_collision_queue.size();
-	// unsigned size_trigger = m_entity_collision_queue.size();
-	// unsigned size_broken_joints = m_joints_to_break.size();
-	//
-	// m_entity_collision_queue.clear();
-	// m_trigger_event_queue.clear();
-	// m_joints_to_break.clear();
-	//
-	// m_entity_collision_queue.reserve(size);
-	// m_trigger_event_queue.reserve(size_trigger);
-	// m_joints_to_break.reserve(size_broken_joints);
+		m_body_changes_since_optimization += static_cast<unsigned>(num_removals);
+		m_pending_body_removals.clear();
+
+		if (m_shape_cache.size() > m_shape_cache_prune_threshold)
+			PruneShapeCache();
+	}
+
+	OptimizeBroadPhaseIfDegraded();
+}
+
+void ORNG::PhysicsSystem::OptimizeBroadPhaseIfDegraded() {
+	// Jolt doesn't expose the quality of its trees, but they only degrade through insertions and removals (each batch becomes its own subtree and removals
+	// leave empty nodes behind), so the share of bodies changed since the last rebuild is used instead. Rebuilding costs about as much as all of these changes did.
+	const unsigned num_bodies = physics_system.GetNumBodies();
+	if (m_body_changes_since_optimization == 0 || m_body_changes_since_optimization * 4 < num_bodies)
+		return;
+
+	physics_system.OptimizeBroadPhase();
+	m_body_changes_since_optimization = 0;
+
+	if (mp_recording)
+		mp_recording->stream.Write(RecordedCommand::OPTIMIZE_BROAD_PHASE);
+}
+
+
+void ORNG::PhysicsSystem::InitComponent(PhysicsComponent* p_comp) {
+	UpdateComponentState(p_comp);
+}
+
+void ORNG::PhysicsSystem::RemoveComponent(PhysicsComponent* p_comp) {
+	if (p_comp->body_id.IsInvalid()) return;
+
+	QueueBodyRemoval(p_comp->body_id);
+	p_comp->body_id = BodyID{};
+}
+
+
+void ORNG::PhysicsSystem::OnUpdate() {
+	if (m_collider_cooker.Poll(m_cooked_shapes)) {
+		// The cache holds the only reference to these until bodies use them, so unused ones are released by the next prune
+		for (auto& cooked : m_cooked_shapes) {
+			m_shape_cache[ShapeKey{ PhysicsComponent::TRIANGLE_MESH, cooked.mesh_uuid, glm::ivec3(0), cooked.type == MeshColliderCooker::ColliderType::CONVEX_HULL }] = cooked.p_shape;
+		}
+		m_cooked_shapes.clear();
+
+		CreateAwaitingBodies();
+	}
+
+	// Flushed even while paused so queries see bodies created in the editor
+	FlushBodyQueue();
+
+	if (!m_is_updating)
+		return;
+
+	ORNG_PROFILE_FUNC();
+	float ts = FrameTiming::GetTimeStep();
+
+	m_accumulator += ts * 0.001f;
+
+	unsigned num_steps = static_cast<unsigned>(m_accumulator / step_size);
+	if (num_steps > max_substeps) {
+		// Drop the whole steps that can't be simulated this update rather than carrying them into the next one
+		num_steps = max_substeps;
+		m_accumulator = std::fmod(m_accumulator, step_size) + static_cast<float>(num_steps) * step_size;
+	}
+
+	const bool interpolate = interpolation_mode != InterpolationMode::NONE;
+	if (num_steps > 0) {
+		m_contacts.clear();
+		m_characters.clear();
+		for (auto [entity, comp] : mp_scene->GetRegistry().view<CharacterControllerComponent>().each()) {
+			comp.moved_during_frame = false;
+			if (comp.mp_character)
+				m_characters.push_back(&comp);
+		}
+	}
+
+	for (unsigned i = 0; i < num_steps; i++) {
+		if (interpolate && i == num_steps - 1)
+			CaptureInterpolationStates();
+
+		// Before the step so bodies react to characters pushing them in the same step
+		UpdateCharacters(step_size);
+
+		m_contact_recorder.ResetContactCount();
+		physics_system.Update(step_size, 1, mp_temp_allocator.get(), mp_job_system.get());
+		CollectContacts();
+
+		if (mp_recording) {
+			mp_recording->stream.Write(RecordedCommand::STEP);
+			mp_recording->stream.Write(GetActiveBodyChecksum());
+			mp_recording->num_steps++;
+		}
+
+		m_accumulator -= step_size;
+	}
+
+	m_accumulator = glm::max(m_accumulator, 0.f);
+
+	if (num_steps > 0) {
+		WriteBackActiveTransforms();
+		WriteBackCharacters();
+		// After the write-back so scripts see the poses the contacts happened at
+		DispatchContactEvents();
+
+		if (interpolate)
+			FinishInterpolationStates();
+	}
+
+	if (interpolate)
+		UpdateRenderTransforms(num_steps > 0);
+	else if (!m_interpolated_bodies.empty())
+		ResetInterpolation();
+}
+
+void ORNG::PhysicsSystem::CaptureInterpolationStates() {
+	ResetInterpolation();
+
+	const BodyInterface& body_interface = physics_system.GetBodyInterfaceNoLock();
+	physics_system.GetActiveBodies(EBodyType::RigidBody, m_active_bodies);
+
+	for (const auto& body : m_active_bodies) {
+		auto* p_ent = reinterpret_cast<SceneEntity*>(body_interface.GetUserData(body));
+		if (!p_ent)
+			continue;
+
+		RVec3 p;
+		Quat q;
+		body_interface.GetPositionAndRotation(body, p, q);
+
+		auto& state = m_interpolated_bodies.emplace_back(p_ent->GetEnttHandle(), body);
+		state.prev_pos = glm::vec3{ p.GetX(), p.GetY(), p.GetZ() };
+		state.prev_orientation = glm::quat{ q.GetW(), q.GetX(), q.GetY(), q.GetZ() };
+	}
+
+	// Characters aren't bodies, they're interpolated between the positions from before and after their move in the step
+	for (auto* p_comp : m_characters) {
+		auto* p_transform = p_comp->GetEntity()->GetComponent<TransformComponent>();
+		const RVec3 p = p_comp->mp_character->GetPosition();
+
+		auto& state = m_interpolated_bodies.emplace_back(p_comp->GetEnttHandle(), BodyID{});
+		state.prev_pos = glm::vec3{ p.GetX(), p.GetY(), p.GetZ() };
+		state.prev_orientation = p_transform->GetAbsOrientationQuat();
+	}
+}
+
+void ORNG::PhysicsSystem::FinishInterpolationStates() {
+	const BodyInterface& body_interface = physics_system.GetBodyInterfaceNoLock();
+	auto& reg = mp_scene->GetRegistry();
+
+	for (auto& state : m_interpolated_bodies) {
+		if (state.body_id.IsInvalid()) {
+			// Characters keep the orientation of their transform
+			auto* p_character = reg.try_get<CharacterControllerComponent>(state.entity);
+			if (p_character && p_character->mp_character) {
+				const RVec3 p = p_character->mp_character->GetPosition();
+				state.curr_pos = glm::vec3{ p.GetX(), p.GetY(), p.GetZ() };
+			}
+			else {
+				state.curr_pos = state.prev_pos;
+			}
+			state.curr_orientation = state.prev_orientation;
+			continue;
+		}
+
+		RVec3 p;
+		Quat q;
+		body_interface.GetPositionAndRotation(state.body_id, p, q);
+
+		state.curr_pos = glm::vec3{ p.GetX(), p.GetY(), p.GetZ() };
+		state.curr_orientation = glm::quat{ q.GetW(), q.GetX(), q.GetY(), q.GetZ() };
+	}
+}
+
+void ORNG::PhysicsSystem::UpdateRenderTransforms(bool stepped_this_update) {
+	ORNG_PROFILE_FUNC();
+	auto& reg = mp_scene->GetRegistry();
+	const float alpha = glm::clamp(m_accumulator / step_size, 0.f, 1.f);
+
+	m_render_transforms.clear();
+
+	for (const auto& state : m_interpolated_bodies) {
+		// Entity may have been deleted since the step
+		auto* p_transform = reg.try_get<TransformComponent>(state.entity);
+		if (!p_transform)
+			continue;
+
+		// The transform was rebuilt by something else since the step, e.g teleported by a script, so it's left alone until the next step
+		if (!stepped_this_update && !p_transform->HasRenderMatrix())
+			continue;
+
+		glm::vec3 pos;
+		glm::quat orientation;
+		if (interpolation_mode == InterpolationMode::INTERPOLATE) {
+			pos = glm::mix(state.prev_pos, state.curr_pos, alpha);
+			orientation = glm::slerp(state.prev_orientation, state.curr_orientation, alpha);
+		} else {
+			pos = state.curr_pos + (state.curr_pos - state.prev_pos) * alpha;
+			orientation = glm::slerp(state.prev_orientation, state.curr_orientation, 1.f + alpha);
+		}
+
+		p_transform->SetRenderMatrix(glm::translate(pos) * glm::mat4_cast(orientation) * glm::scale(p_transform->GetAbsScale()), false);
+		m_render_transforms.push_back(p_transform);
+	}
+
+	Events::EventManager::DispatchEventBatch<TransformComponent>(Events::ECS_EventType::COMP_UPDATED, m_render_transforms, TransformComponent::UpdateType::RENDER, this);
+}
+
+void ORNG::PhysicsSystem::ResetInterpolation() {
+	auto& reg = mp_scene->GetRegistry();
+	m_render_transforms.clear();
+
+	for (const auto& state : m_interpolated_bodies) {
+		auto* p_transform = reg.try_get<TransformComponent>(state.entity);
+		if (p_transform && p_transform->HasRenderMatrix()) {
+			p_transform->ClearRenderMatrix(false);
+			m_render_transforms.push_back(p_transform);
+		}
+	}
+
+	m_interpolated_bodies.clear();
+	Events::EventManager::DispatchEventBatch<TransformComponent>(Events::ECS_EventType::COMP_UPDATED, m_render_transforms, TransformComponent::UpdateType::RENDER, this);
+}
+
+void ORNG::PhysicsSystem::WriteBackActiveTransforms() {
+	ORNG_PROFILE_FUNC();
+	// Bodies are only modified on this thread and the simulation has finished stepping, so nothing else can hold a body lock here
+	const BodyInterface& body_interface = physics_system.GetBodyInterfaceNoLock();
+	physics_system.GetActiveBodies(EBodyType::RigidBody, m_active_bodies);
+
+	m_written_back_transforms.clear();
+	m_written_back_transforms.reserve(m_active_bodies.size());
+
+	for (const auto& body : m_active_bodies) {
+		auto* p_ent = reinterpret_cast<SceneEntity*>(body_interface.GetUserData(body));
+		if (!p_ent)
+			continue;
+
+		RVec3 p;
+		Quat q;
+		body_interface.GetPositionAndRotation(body, p, q);
+
+		auto* p_transform = p_ent->GetComponent<TransformComponent>();
+		p_transform->SetAbsolutePose(glm::vec3{ p.GetX(), p.GetY(), p.GetZ() }, glm::quat{ q.GetW(), q.GetX(), q.GetY(), q.GetZ() }, false);
+		m_written_back_transforms.push_back(p_transform);
+	}
+
+	// p_data marks the events as coming from here so OnTransformEvent doesn't push the poses straight back into the bodies
+	Events::EventManager::DispatchEventBatch<TransformComponent>(Events::ECS_EventType::COMP_UPDATED, m_written_back_transforms, TransformComponent::UpdateType::POSE, this);
+}
+
+uint32_t ORNG::ContactRecorder::NextGeneration() {
+	static std::atomic<uint32_t> s_next_generation = 1;
+	return s_next_generation.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ORNG::ContactRecorder::Push(BodyID body1, BodyID body2, ContactEventType type) {
+	struct ThreadClaim {
+		uint32_t generation = 0;
+		unsigned buffer_index = 0;
+	};
+	thread_local ThreadClaim claim;
+
+	// m_generation only changes between steps, the job system synchronizes it with the worker threads
+	if (claim.generation != m_generation)
+		claim = { m_generation, m_num_claimed_buffers.fetch_add(1, std::memory_order_relaxed) };
+
+	uint32_t a = body1.GetIndexAndSequenceNumber();
+	uint32_t b = body2.GetIndexAndSequenceNumber();
+	if (a > b)
+		std::swap(a, b);
+
+	if (claim.buffer_index < m_buffers.size()) {
+		m_buffers[claim.buffer_index].records.emplace_back(a, b, type);
+	}
+	else {
+		std::scoped_lock lock{ m_overflow_mutex };
+		m_overflow.emplace_back(a, b, type);
+	}
+}
+
+void ORNG::ContactRecorder::Collect(std::vector<Record>& output) {
+	output.clear();
+
+	const unsigned num_claimed = std::min(m_num_claimed_buffers.load(std::memory_order_relaxed), static_cast<unsigned>(m_buffers.size()));
+	for (unsigned i = 0; i < num_claimed; i++) {
+		auto& records = m_buffers[i].records;
+		output.insert(output.end(), records.begin(), records.end());
+		records.clear();
+	}
+
+	output.insert(output.end(), m_overflow.begin(), m_overflow.end());
+	m_overflow.clear();
+
+	m_num_claimed_buffers.store(0, std::memory_order_relaxed);
+	m_generation = NextGeneration();
+
+	std::ranges::sort(output);
+}
+
+void ORNG::PhysicsSystem::CollectContacts() {
+	m_contact_recorder.Collect(m_contact_records);
+	if (m_contact_records.empty())
+		return;
+
+	ORNG_PROFILE_FUNC();
+	const BodyInterface& body_interface = physics_system.GetBodyInterfaceNoLock();
+
+	auto is_trigger = [](SceneEntity* p_ent) {
+		auto* p_comp = p_ent->GetComponent<PhysicsComponent>();
+		return p_comp && p_comp->IsTrigger();
+	};
+
+	// Both the records and the counts are sorted by body pair, so the counts are merged into m_next_touching_sub_shape_counts in one pass
+	auto& counts = m_touching_sub_shape_counts;
+	auto& next_counts = m_next_touching_sub_shape_counts;
+	next_counts.clear();
+	size_t count_index = 0;
+
+	for (size_t i = 0; i < m_contact_records.size();) {
+		const uint32_t body_a = m_contact_records[i].body_a;
+		const uint32_t body_b = m_contact_records[i].body_b;
+
+		// Each record is one sub shape pair starting, continuing or stopping touching
+		int64_t delta = 0;
+		for (; i < m_contact_records.size() && m_contact_records[i].body_a == body_a && m_contact_records[i].body_b == body_b; i++) {
+			if (m_contact_records[i].type == ContactEventType::ADDED)
+				delta++;
+			else if (m_contact_records[i].type == ContactEventType::REMOVED)
+				delta--;
+		}
+
+		// Counts are updated even for pairs that aren't reported below, so pairs with removed bodies are dropped once Jolt reports their removals
+		const uint64_t key = static_cast<uint64_t>(body_a) << 32 | body_b;
+
+		// Pairs with no records this step keep their count
+		while (count_index < counts.size() && counts[count_index].first < key) {
+			next_counts.push_back(counts[count_index++]);
+		}
+
+		uint32_t prev_count = 0;
+		if (count_index < counts.size() && counts[count_index].first == key)
+			prev_count = counts[count_index++].second;
+
+		const auto count = static_cast<uint32_t>(std::max<int64_t>(static_cast<int64_t>(prev_count) + delta, 0));
+		if (count != 0)
+			next_counts.emplace_back(key, count);
+
+		ContactEventType type;
+		if (prev_count == 0 && count != 0)
+			type = ContactEventType::ADDED;
+		else if (prev_count != 0 && count == 0)
+			type = ContactEventType::REMOVED;
+		else if (count != 0)
+			type = ContactEventType::PERSISTED;
+		else
+			continue;
+
+		BodyID body0{ body_a };
+		BodyID body1{ body_b };
+
+		// Bodies removed from the simulation have no user data, or no longer exist at all
+		auto* p0 = reinterpret_cast<SceneEntity*>(body_interface.GetUserData(body0));
+		auto* p1 = reinterpret_cast<SceneEntity*>(body_interface.GetUserData(body1));
+		if (!p0 || !p1)
+			continue;
+
+		m_contacts.emplace_back(p0, p1, body0, body1, type, is_trigger(p0) || is_trigger(p1));
+	}
+
+	next_counts.insert(next_counts.end(), counts.begin() + static_cast<std::ptrdiff_t>(count_index), counts.end());
+	std::swap(counts, next_counts);
+}
+
+static void NotifyScript(SceneEntity* p_ent, SceneEntity* p_other, ContactEventType type, bool trigger) {
+	auto* p_script = p_ent->GetComponent<ScriptComponent>();
+	if (!p_script || !p_script->p_instance)
+		return;
+
+	try {
+		if (!trigger)
+			p_script->p_instance->OnCollide(p_other);
+		else if (type == ContactEventType::ADDED)
+			p_script->p_instance->OnTriggerEnter(p_other);
+		else
+			p_script->p_instance->OnTriggerLeave(p_other);
+	}
+	catch (std::exception& e) {
+		ORNG_CORE_ERROR("Script contact event err for entity '{0}', other entity: '{1}' : '{2}'", p_ent->GetName(), p_other->GetName(), e.what());
+	}
+}
+
+void ORNG::PhysicsSystem::DispatchContactEvents() {
+	if (m_contacts.empty())
+		return;
+
+	ORNG_PROFILE_FUNC();
+	Events::EventManager::DispatchEvent(PhysicsCollisionEvent{ mp_scene, m_contacts });
+
+	const BodyInterface& body_interface = physics_system.GetBodyInterfaceNoLock();
+	// Scripts can delete entities, which clears their bodies' user data, so both entities are checked against their bodies before each call
+	auto is_alive = [&](BodyID body, const SceneEntity* p_ent) {
+		return reinterpret_cast<const SceneEntity*>(body_interface.GetUserData(body)) == p_ent;
+	};
+
+	for (const auto& contact : m_contacts) {
+		// Collisions are only reported as they start, triggers as they're entered and left
+		if (contact.type == ContactEventType::PERSISTED || (!contact.is_trigger && contact.type == ContactEventType::REMOVED))
+			continue;
+
+		auto notify = [&](SceneEntity* p_ent, SceneEntity* p_other) {
+			if (!is_alive(contact.body0, contact.p0) || !is_alive(contact.body1, contact.p1))
+				return;
+
+			// Only the trigger's script is notified of trigger contacts, with the entity that entered or left it
+			if (contact.is_trigger) {
+				auto* p_comp = p_ent->GetComponent<PhysicsComponent>();
+				if (!p_comp || !p_comp->IsTrigger())
+					return;
+			}
+
+			NotifyScript(p_ent, p_other, contact.type, contact.is_trigger);
+		};
+
+		notify(contact.p0, contact.p1);
+		notify(contact.p1, contact.p0);
+	}
+}
+
+void ORNG::PhysicsSystem::InitCharacter(CharacterControllerComponent* p_comp) {
+	if (mp_recording) {
+		ORNG_CORE_ERROR("Physics recording discarded, a character was added while recording");
+		mp_recording = nullptr;
+	}
+
+	auto* p_transform = p_comp->GetEntity()->GetComponent<TransformComponent>();
+
+	// Height is the total height of the capsule, the shape is offset so the character's position is at its base
+	const float radius = p_comp->m_radius;
+	const float half_cylinder_height = glm::max(p_comp->m_height * 0.5f - radius, 0.f);
+	RefConst<Shape> p_capsule = new CapsuleShape{ half_cylinder_height, radius };
+	RefConst<Shape> p_shape = RotatedTranslatedShapeSettings{ Vec3{ 0.f, half_cylinder_height + radius, 0.f }, Quat::sIdentity(), p_capsule }.Create().Get();
+
+	CharacterVirtualSettings settings;
+	settings.mShape = p_shape;
+	settings.mMaxSlopeAngle = glm::radians(p_comp->max_slope_degrees);
+	// Only contacts with the lower cap can support the character
+	settings.mSupportingVolume = Plane{ Vec3::sAxisY(), -radius };
+
+	p_comp->mp_character = new CharacterVirtual{ &settings, GlmToJph(p_transform->GetAbsPosition()), Quat::sIdentity(), &physics_system };
+}
+
+namespace {
+// Characters walk through triggers rather than being blocked by them
+class CharacterBodyFilter final : public BodyFilter {
+public:
+	bool ShouldCollideLocked(const Body& body) const override {
+		return !body.IsSensor();
+	}
+};
+}
+
+void ORNG::PhysicsSystem::UpdateCharacters(float dt) {
+	if (m_characters.empty())
+		return;
+
+	ORNG_PROFILE_FUNC();
+	constexpr unsigned min_characters_per_job = 16;
+	constexpr unsigned character_temp_allocator_size = 256 * 1024;
+
+	if (m_character_allocators.empty()) {
+		m_character_allocators.resize(std::max(std::thread::hardware_concurrency(), 1u));
+		for (auto& p_allocator : m_character_allocators) {
+			p_allocator = std::make_unique<TempAllocatorImpl>(character_temp_allocator_size);
+		}
+	}
+
+	const Vec3 gravity = physics_system.GetGravity();
+	const DefaultBroadPhaseLayerFilter broad_phase_filter = physics_system.GetDefaultBroadPhaseLayerFilter(Layers::CHARACTER);
+	const DefaultObjectLayerFilter object_layer_filter = physics_system.GetDefaultLayerFilter(Layers::CHARACTER);
+	const CharacterBodyFilter body_filter;
+	const ShapeFilter shape_filter;
+
+	// Each job moves its own characters, the only shared state they write is the push impulses applied to dynamic bodies
+	// Those go through the body write locks so are thread safe, but bodies pushed by characters in different jobs receive their impulses in no fixed order
+	RunBatchedJobs(*mp_job_system, static_cast<unsigned>(m_characters.size()), min_characters_per_job, static_cast<unsigned>(m_character_allocators.size()), [&](unsigned job_index, unsigned begin, unsigned end) {
+		TempAllocator& allocator = *m_character_allocators[job_index];
+
+		for (unsigned i = begin; i < end; i++) {
+			CharacterControllerComponent& comp = *m_characters[i];
+			CharacterVirtual& character = *comp.mp_character;
+
+			character.SetMaxSlopeAngle(glm::radians(comp.max_slope_degrees));
+			character.UpdateGroundVelocity();
+
+			const Vec3 up = character.GetUp();
+			const Vec3 vertical_velocity = up * character.GetLinearVelocity().Dot(up);
+			const Vec3 ground_velocity = character.GetGroundVelocity();
+
+			Vec3 new_velocity;
+			// Unless moving away from the ground (e.g mid jump), grounded characters move with whatever they're standing on
+			if (character.GetGroundState() == CharacterBase::EGroundState::OnGround && (vertical_velocity - ground_velocity).Dot(up) < 0.1f) {
+				new_velocity = ground_velocity;
+				if (comp.m_jump_speed > 0.f)
+					new_velocity += up * comp.m_jump_speed;
+			}
+			else {
+				new_velocity = vertical_velocity;
+			}
+			comp.m_jump_speed = 0.f;
+
+			if (comp.use_gravity)
+				new_velocity += gravity * dt;
+
+			Vec3 desired_velocity = GlmToJph(comp.desired_velocity);
+			new_velocity += desired_velocity - up * desired_velocity.Dot(up);
+			character.SetLinearVelocity(new_velocity);
+
+			CharacterVirtual::ExtendedUpdateSettings update_settings;
+			update_settings.mStickToFloorStepDown = -up * comp.stick_to_floor_distance;
+			update_settings.mWalkStairsStepUp = up * comp.step_height;
+
+			const RVec3 prev_pos = character.GetPosition();
+			character.ExtendedUpdate(dt, comp.use_gravity ? gravity : Vec3::sZero(), update_settings, broad_phase_filter, object_layer_filter, body_filter, shape_filter, allocator);
+
+			const RVec3 pos = character.GetPosition();
+			comp.moved_during_frame |= pos != prev_pos;
+
+			// Same order as CharacterBase::EGroundState
+			comp.m_ground_state = static_cast<CharacterControllerComponent::GroundState>(character.GetGroundState());
+			const Vec3 normal = character.GetGroundNormal();
+			const Vec3 velocity = character.GetLinearVelocity();
+			comp.m_ground_normal = glm::vec3{ normal.GetX(), normal.GetY(), normal.GetZ() };
+			comp.m_velocity = glm::vec3{ velocity.GetX(), velocity.GetY(), velocity.GetZ() };
+		}
+	});
+}
+
+void ORNG::PhysicsSystem::WriteBackCharacters() {
+	if (m_characters.empty())
+		return;
+
+	m_written_back_transforms.clear();
+	for (auto* p_comp : m_characters) {
+		if (!p_comp->moved_during_frame)
+			continue;
+
+		auto* p_transform = p_comp->GetEntity()->GetComponent<TransformComponent>();
+		const RVec3 pos = p_comp->mp_character->GetPosition();
+		p_transform->SetAbsolutePose(glm::vec3{ pos.GetX(), pos.GetY(), pos.GetZ() }, p_transform->GetAbsOrientationQuat(), false);
+		m_written_back_transforms.push_back(p_transform);
+	}
+
+	Events::EventManager::DispatchEventBatch<TransformComponent>(Events::ECS_EventType::COMP_UPDATED, m_written_back_transforms, TransformComponent::UpdateType::POSE, this);
+}
+
+void ORNG::PhysicsSystem::SaveState(std::vector<std::byte>& output) const {
+	StateRecorderImpl recorder;
+	physics_system.SaveState(recorder);
+
+	const std::string data = recorder.GetData();
+	output.resize(data.size());
+	std::memcpy(output.data(), data.data(), data.size());
+}
+
+bool ORNG::PhysicsSystem::RestoreState(std::span<const std::byte> state) {
+	ORNG_PROFILE_FUNC();
+	StateRecorderImpl recorder;
+	recorder.WriteBytes(state.data(), state.size());
+
+	if (!physics_system.RestoreState(recorder)) {
+		ORNG_CORE_ERROR("Failed to restore physics state, the bodies in the simulation don't match the snapshot");
+		return false;
+	}
+
+	ResetInterpolation();
+
+	// Any body may have moved, not just active ones
+	const BodyInterface& body_interface = physics_system.GetBodyInterfaceNoLock();
+	m_written_back_transforms.clear();
+	for (auto [entity, comp, transform] : mp_scene->GetRegistry().view<PhysicsComponent, TransformComponent>().each()) {
+		if (comp.body_id.IsInvalid() || !body_interface.IsAdded(comp.body_id))
+			continue;
+
+		RVec3 p;
+		Quat q;
+		body_interface.GetPositionAndRotation(comp.body_id, p, q);
+		transform.SetAbsolutePose(glm::vec3{ p.GetX(), p.GetY(), p.GetZ() }, glm::quat{ q.GetW(), q.GetX(), q.GetY(), q.GetZ() }, false);
+		m_written_back_transforms.push_back(&transform);
+	}
+
+	Events::EventManager::DispatchEventBatch<TransformComponent>(Events::ECS_EventType::COMP_UPDATED, m_written_back_transforms, TransformComponent::UpdateType::POSE, this);
+	return true;
+}
+
+bool ORNG::PhysicsSystem::StartRecording() {
+	ORNG_PROFILE_FUNC();
+	mp_recording = nullptr;
+
+	if (!mp_scene->GetRegistry().view<CharacterControllerComponent>().empty()) {
+		ORNG_CORE_ERROR("Can't record physics while the scene has characters, they aren't part of recordings");
+		return false;
+	}
+
+	FlushBodyQueue();
+
+	// Replays add every body in one batch, rebuilding the broadphase here and there means both start stepping with the same trees
+	physics_system.OptimizeBroadPhase();
+	m_body_changes_since_optimization = 0;
+
+	mp_recording = std::make_unique<Recording>();
+	auto& stream = mp_recording->stream;
+
+	stream.Write(RECORDING_MAGIC);
+	stream.Write(RECORDING_VERSION);
+	stream.Write(step_size);
+	stream.Write(m_settings.max_bodies);
+	stream.Write(m_settings.max_body_pairs);
+	stream.Write(m_settings.max_contact_constraints);
+	stream.Write(m_settings.temp_allocator_size);
+
+	stream.Write(static_cast<uint32_t>(m_settings.layers.size()));
+	for (const auto& layer : m_settings.layers) {
+		stream.Write(layer.broad_phase_layer);
+		stream.Write(layer.collision_mask);
+	}
+
+	stream.Write(physics_system.GetGravity());
+
+	BodyIDVector bodies;
+	physics_system.GetBodies(bodies);
+	WriteRecordedBodies(bodies);
+
+	physics_system.GetActiveBodies(EBodyType::RigidBody, bodies);
+	stream.Write(static_cast<uint32_t>(bodies.size()));
+	for (BodyID id : bodies) {
+		stream.Write(id.GetIndexAndSequenceNumber());
+	}
+
+	physics_system.SaveState(stream);
+	return true;
+}
+
+bool ORNG::PhysicsSystem::StopRecording(std::vector<std::byte>& output) {
+	if (!mp_recording)
+		return false;
+
+	auto& stream = mp_recording->stream;
+	stream.Write(RecordedCommand::END);
+	// Read from the end of the data by LoadReplay so the number of steps is known up front
+	stream.Write(static_cast<uint32_t>(mp_recording->num_steps));
+
+	const std::string data = stream.GetData();
+	output.resize(data.size());
+	std::memcpy(output.data(), data.data(), data.size());
+
+	mp_recording = nullptr;
+	return true;
+}
+
+// Ids are handed out in insertion order, so only entries with ids past the end of retained are new
+template<typename T, typename IDMap>
+static void RetainNewObjects(const IDMap& ids, std::vector<RefConst<T>>& retained) {
+	const size_t prev_size = retained.size();
+	if (ids.size() == prev_size)
+		return;
+
+	retained.resize(ids.size());
+	for (const auto& [p_object, id] : ids) {
+		if (id >= prev_size)
+			retained[id] = p_object;
+	}
+}
+
+void ORNG::PhysicsSystem::Recording::RetainWrittenObjects() {
+	RetainNewObjects(shape_ids, shapes);
+	RetainNewObjects(material_ids, materials);
+	RetainNewObjects(group_filter_ids, group_filters);
+}
+
+void ORNG::PhysicsSystem::WriteRecordedBodies(std::span<const BodyID> bodies) {
+	auto& recording = *mp_recording;
+	const BodyLockInterfaceNoLock& lock_interface = physics_system.GetBodyLockInterfaceNoLock();
+
+	recording.stream.Write(static_cast<uint32_t>(bodies.size()));
+	for (BodyID id : bodies) {
+		BodyLockRead lock{ lock_interface, id };
+		recording.stream.Write(id.GetIndexAndSequenceNumber());
+		lock.GetBody().GetBodyCreationSettings().SaveWithChildren(recording.stream, &recording.shape_ids, &recording.material_ids, &recording.group_filter_ids);
+	}
+
+	// The bodies keep everything they were written with alive until here
+	recording.RetainWrittenObjects();
+}
+
+bool ORNG::PhysicsSystem::ReadRecordedBodies(BodyIDVector& output) {
+	auto& replay = *mp_replay;
+	BodyInterface& body_interface = physics_system.GetBodyInterfaceNoLock();
+
+	uint32_t num_bodies = 0;
+	replay.stream.Read(num_bodies);
+	output.clear();
+
+	for (uint32_t i = 0; i < num_bodies; i++) {
+		uint32_t id = 0;
+		replay.stream.Read(id);
+
+		auto result = BodyCreationSettings::sRestoreWithChildren(replay.stream, replay.shapes, replay.materials, replay.group_filters);
+		if (replay.stream.IsFailed() || result.HasError()) {
+			ORNG_CORE_ERROR("Failed to read recorded physics body: '{0}'", result.HasError() ? result.GetError().c_str() : "unexpected end of data");
+			return false;
+		}
+
+		BodyCreationSettings settings = result.Get();
+		// Recorded user data points to entities of the recorded session
+		settings.mUserData = 0;
+
+		Body* p_body = body_interface.CreateBodyWithID(BodyID{ id }, settings);
+		if (!p_body) {
+			ORNG_CORE_ERROR("Failed to create recorded physics body {0}, its id is in use or the body limit is reached", id);
+			return false;
+		}
+
+		output.push_back(p_body->GetID());
+	}
+
+	return true;
+}
+
+bool ORNG::PhysicsSystem::LoadReplay(std::span<const std::byte> recording) {
+	ORNG_PROFILE_FUNC();
+	mp_recording = nullptr;
+	mp_replay = std::make_unique<Replay>();
+	auto& replay = *mp_replay;
+	auto& stream = replay.stream;
+
+	auto fail = [this](const char* reason) {
+		ORNG_CORE_ERROR("Failed to load physics replay: {0}", reason);
+		mp_replay = nullptr;
+		return false;
+	};
+
+	if (recording.size() < sizeof(uint32_t) * 2)
+		return fail("data too small");
+
+	std::memcpy(&replay.num_steps, recording.data() + recording.size() - sizeof(uint32_t), sizeof(uint32_t));
+	stream.WriteBytes(recording.data(), recording.size() - sizeof(uint32_t));
+
+	uint32_t magic = 0;
+	uint32_t version = 0;
+	stream.Read(magic);
+	stream.Read(version);
+	if (magic != RECORDING_MAGIC || version != RECORDING_VERSION)
+		return fail("not a physics recording or recorded by an unsupported version");
+
+	Settings settings;
+	uint32_t num_layers = 0;
+	stream.Read(step_size);
+	stream.Read(settings.max_bodies);
+	stream.Read(settings.max_body_pairs);
+	stream.Read(settings.max_contact_constraints);
+	stream.Read(settings.temp_allocator_size);
+	stream.Read(num_layers);
+
+	if (stream.IsFailed() || num_layers < Layers::NUM_DEFAULT_LAYERS || num_layers > Layers::MAX_LAYERS || settings.max_bodies == 0 || settings.temp_allocator_size == 0)
+		return fail("invalid settings");
+
+	settings.layers.resize(num_layers);
+	for (uint32_t i = 0; i < num_layers; i++) {
+		auto& layer = settings.layers[i];
+		if (i >= Layers::NUM_DEFAULT_LAYERS)
+			layer.name = std::format("Layer {}", i);
+
+		stream.Read(layer.broad_phase_layer);
+		stream.Read(layer.collision_mask);
+		if (layer.broad_phase_layer >= BroadPhaseLayers::NUM_LAYERS)
+			return fail("invalid broadphase layer");
+	}
+
+	Vec3 gravity;
+	stream.Read(gravity);
+
+	// Every body id is about to be reused by the recording's bodies
+	for (auto [entity, comp] : mp_scene->GetRegistry().view<PhysicsComponent>().each()) {
+		comp.body_id = BodyID{};
+	}
+
+	ResetInterpolation();
+	m_pending_body_adds.clear();
+	m_pending_body_removals.clear();
+	m_entities_awaiting_colliders.clear();
+	m_body_changes_since_optimization = 0;
+
+	m_settings = std::move(settings);
+	InitPhysicsSystem();
+	physics_system.SetGravity(gravity);
+
+	BodyInterface& body_interface = physics_system.GetBodyInterfaceNoLock();
+	BodyIDVector bodies;
+	if (!ReadRecordedBodies(bodies))
+		return fail("invalid body");
+
+	if (!bodies.empty()) {
+		BodyInterface::AddState add_state = body_interface.AddBodiesPrepare(bodies.data(), static_cast<int>(bodies.size()));
+		body_interface.AddBodiesFinalize(bodies.data(), static_cast<int>(bodies.size()), add_state, EActivation::DontActivate);
+	}
+
+	uint32_t num_active_bodies = 0;
+	stream.Read(num_active_bodies);
+	bodies.clear();
+	for (uint32_t i = 0; i < num_active_bodies && !stream.IsFailed(); i++) {
+		uint32_t id = 0;
+		stream.Read(id);
+		bodies.push_back(BodyID{ id });
+	}
+
+	if (stream.IsFailed())
+		return fail("unexpected end of data");
+
+	body_interface.ActivateBodies(bodies.data(), static_cast<int>(bodies.size()));
+	physics_system.OptimizeBroadPhase();
+
+	if (!physics_system.RestoreState(stream))
+		return fail("invalid simulation state");
+
+	return true;
+}
+
+bool ORNG::PhysicsSystem::StepReplay(ReplayStep& result) {
+	if (!mp_replay || mp_replay->finished)
+		return false;
+
+	auto& replay = *mp_replay;
+	auto& stream = replay.stream;
+	BodyInterface& body_interface = physics_system.GetBodyInterfaceNoLock();
+	BodyIDVector bodies;
+
+	auto fail = [&replay](const char* reason) {
+		ORNG_CORE_ERROR("Physics replay stopped: {0}", reason);
+		replay.finished = true;
+		return false;
+	};
+
+	while (true) {
+		RecordedCommand command = RecordedCommand::END;
+		stream.Read(command);
+		if (stream.IsFailed())
+			return fail("unexpected end of data");
+
+		switch (command) {
+		case RecordedCommand::STEP: {
+			uint64_t checksum = 0;
+			stream.Read(checksum);
+
+			TimeStep timer{ TimeStep::TimeUnits::MICROSECONDS };
+			physics_system.Update(step_size, 1, mp_temp_allocator.get(), mp_job_system.get());
+			// Merging contacts is part of the cost of a live step, and keeps the recorder's buffers from growing
+			CollectContacts();
+			result.time_ms = static_cast<float>(timer.GetTimeInterval()) / 1000.f;
+
+			result.num_active_bodies = physics_system.GetNumActiveBodies(EBodyType::RigidBody);
+			result.diverged = GetActiveBodyChecksum() != checksum;
+			return true;
+		}
+		case RecordedCommand::ADD_BODIES: {
+			if (!ReadRecordedBodies(bodies))
+				return fail("invalid body");
+
+			if (!bodies.empty()) {
+				BodyInterface::AddState add_state = body_interface.AddBodiesPrepare(bodies.data(), static_cast<int>(bodies.size()));
+				body_interface.AddBodiesFinalize(bodies.data(), static_cast<int>(bodies.size()), add_state, EActivation::Activate);
+			}
+			break;
+		}
+		case RecordedCommand::REMOVE_BODIES: {
+			uint32_t num_bodies = 0;
+			stream.Read(num_bodies);
+			bodies.clear();
+			for (uint32_t i = 0; i < num_bodies && !stream.IsFailed(); i++) {
+				uint32_t id = 0;
+				stream.Read(id);
+				bodies.push_back(BodyID{ id });
+			}
+
+			body_interface.RemoveBodies(bodies.data(), static_cast<int>(bodies.size()));
+			body_interface.DestroyBodies(bodies.data(), static_cast<int>(bodies.size()));
+			break;
+		}
+		case RecordedCommand::SET_POSE: {
+			uint32_t id = 0;
+			RVec3 pos;
+			Quat orientation;
+			stream.Read(id);
+			stream.Read(pos);
+			stream.Read(orientation);
+			body_interface.SetPositionAndRotation(BodyID{ id }, pos, orientation, EActivation::Activate);
+			break;
+		}
+		case RecordedCommand::SET_SHAPE: {
+			uint32_t id = 0;
+			stream.Read(id);
+
+			auto shape_result = Shape::sRestoreWithChildren(stream, replay.shapes, replay.materials);
+			if (shape_result.HasError())
+				return fail("invalid shape");
+
+			body_interface.SetShape(BodyID{ id }, shape_result.Get(), true, EActivation::Activate);
+			break;
+		}
+		case RecordedCommand::OPTIMIZE_BROAD_PHASE:
+			physics_system.OptimizeBroadPhase();
+			break;
+		case RecordedCommand::SET_LAYER_MASKS: {
+			uint32_t num_layers = 0;
+			stream.Read(num_layers);
+			if (num_layers < m_settings.layers.size() || num_layers > Layers::MAX_LAYERS)
+				return fail("invalid layer count");
+
+			m_settings.layers.resize(num_layers);
+			for (auto& layer : m_settings.layers) {
+				stream.Read(layer.broad_phase_layer);
+				stream.Read(layer.collision_mask);
+				if (layer.broad_phase_layer >= BroadPhaseLayers::NUM_LAYERS)
+					return fail("invalid broadphase layer");
+			}
+			UpdateLayerFilters();
+			break;
+		}
+		case RecordedCommand::END:
+			replay.finished = true;
+			return false;
+		default:
+			return fail("unknown command");
+		}
+	}
+}
+
+bool ORNG::PhysicsSystem::ReplayFile(const std::string& filepath, bool log_each_step) {
+	std::vector<std::byte> recording;
+	if (!ReadBinaryFile(filepath, recording)) {
+		ORNG_CORE_ERROR("Failed to read physics recording '{0}'", filepath);
+		return false;
+	}
+
+	Scene scene;
+	auto* p_physics = scene.AddSystem(new PhysicsSystem{ &scene }, 0);
+	scene.LoadScene();
+
+	if (!p_physics->LoadReplay(recording))
+		return false;
+
+	std::vector<std::pair<float, unsigned>> step_times;
+	step_times.reserve(p_physics->GetNumReplaySteps());
+	unsigned num_diverged = 0;
+	unsigned first_divergence = 0;
+	float total_ms = 0.f;
+
+	ReplayStep step;
+	while (p_physics->StepReplay(step)) {
+		const auto index = static_cast<unsigned>(step_times.size());
+		if (step.diverged && num_diverged++ == 0)
+			first_divergence = index;
+
+		if (log_each_step)
+			ORNG_CORE_INFO("Step {0}: {1:.3f}ms, {2} active bodies{3}", index, step.time_ms, step.num_active_bodies, step.diverged ? ", diverged" : "");
+
+		total_ms += step.time_ms;
+		step_times.emplace_back(step.time_ms, index);
+	}
+
+	if (step_times.empty()) {
+		ORNG_CORE_INFO("Physics replay '{0}' has no steps", filepath);
+		return p_physics->GetNumReplaySteps() == 0;
+	}
+
+	ORNG_CORE_INFO("Physics replay '{0}', {1}/{2} steps, total: {3:.3f}ms, average: {4:.3f}ms", filepath, step_times.size(), p_physics->GetNumReplaySteps(),
+		total_ms, total_ms / static_cast<float>(step_times.size()));
+
+	std::ranges::sort(step_times, std::greater{});
+	for (size_t i = 0; i < std::min<size_t>(step_times.size(), 5); i++) {
+		ORNG_CORE_INFO("Slowest step {0}: {1:.3f}ms", step_times[i].second, step_times[i].first);
+	}
+
+	if (num_diverged > 0)
+		ORNG_CORE_WARN("Replay diverged from the recording on {0} steps, first on step {1}", num_diverged, first_divergence);
+	else
+		ORNG_CORE_INFO("Replay matched the recording on every step");
+
+	// A replay stopped by invalid data has fewer steps than recorded
+	return num_diverged == 0 && step_times.size() == p_physics->GetNumReplaySteps();
+}
+
+uint64_t ORNG::PhysicsSystem::GetActiveBodyChecksum() {
+	const BodyInterface& body_interface = physics_system.GetBodyInterfaceNoLock();
+	physics_system.GetActiveBodies(EBodyType::RigidBody, m_active_bodies);
+
+	uint64 hash = HashBytes(nullptr, 0);
+	for (BodyID id : m_active_bodies) {
+		RVec3 p;
+		Quat q;
+		body_interface.GetPositionAndRotation(id, p, q);
+
+		const uint32 raw_id = id.GetIndexAndSequenceNumber();
+		const std::array<float, 7> pose{ p.GetX(), p.GetY(), p.GetZ(), q.GetX(), q.GetY(), q.GetZ(), q.GetW() };
+		hash = HashBytes(&raw_id, sizeof(raw_id), hash);
+		hash = HashBytes(pose.data(), sizeof(pose), hash);
+	}
+
+	return hash;
 }
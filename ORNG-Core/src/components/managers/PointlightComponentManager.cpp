@@ -1,5 +1,6 @@
 #include "pch/pch.h"
 #include "core/GLStateManager.h"
+#include "rendering/LightClusterBuilder.h"
 #include "scene/SceneEntity.h"
 #include "components/systems/PointlightSystem.h"
 
@@ -39,7 +40,8 @@ namespace ORNG {
 		output_vec[index++] = pos.x;
 		output_vec[index++] = pos.y;
 		output_vec[index++] = pos.z;
-		output_vec[index++] = 0; //padding
+		// Light cull radius, see LightClusterBuilder
+		output_vec[index++] = LightClusterBuilder::CalculateLightRadius(colour, light.attenuation.constant, light.attenuation.linear, light.attenuation.exp);
 		// - END colour - START MAX_DISTANCE
 		output_vec[index++] = light.shadows_enabled ?  light.shadow_distance : -1.f;
 		// - END MAX_DISTANCE - START ATTENUATION
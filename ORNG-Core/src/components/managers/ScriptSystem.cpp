@@ -19,6 +19,10 @@ void ScriptSystem::OnLoad() {
 }
 
 void ScriptSystem::OnUpdate() {
+	// Scripts could otherwise run against a partially built scene
+	if (mp_scene->IsInstantiatingAsync())
+		return;
+
 	const float dt = FrameTiming::GetTimeStep() * 0.001f;
 	for (auto [entity, script] : mp_scene->GetRegistry().view<ScriptComponent>().each()) {
 		script.p_instance->OnUpdate(dt); 
@@ -1,6 +1,7 @@
 #include "pch/pch.h"
 #include "components/ComponentSystems.h"
 #include "core/GLStateManager.h"
+#include "rendering/LightClusterBuilder.h"
 #include "scene/SceneEntity.h"
 #include "core/GLStateManager.h"
 #include "components/systems/SpotlightSystem.h"
@@ -53,7 +54,8 @@ namespace ORNG {
 		output_vec[index++] = pos.x;
 		output_vec[index++] = pos.y;
 		output_vec[index++] = pos.z;
-		output_vec[index++] = 0; //padding
+		// Light cull radius, see LightClusterBuilder
+		output_vec[index++] = LightClusterBuilder::CalculateLightRadius(colour, light.attenuation.constant, light.attenuation.linear, light.attenuation.exp);
 		//32 - END POS, START DIR
 		auto dir = light.GetEntity()->GetComponent<TransformComponent>()->forward;
 		output_vec[index++] = dir.x;
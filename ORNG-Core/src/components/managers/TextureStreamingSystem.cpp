@@ -0,0 +1,71 @@
+#include "pch/pch.h"
+#include "components/systems/TextureStreamingSystem.h"
+#include "components/systems/CameraSystem.h"
+#include "components/MeshComponent.h"
+#include "components/TransformComponent.h"
+#include "assets/AssetManager.h"
+#include "rendering/MeshAsset.h"
+#include "core/Window.h"
+#include "util/Timers.h"
+
+using namespace ORNG;
+
+void TextureStreamingSystem::ReportMaterial(const Material* p_material, float screen_size_pixels) {
+	auto& streamer = AssetManager::GetTextureStreamer();
+
+	// Tiled textures repeat across the surface, so each repetition covers fewer pixels
+	float size = screen_size_pixels / glm::max(glm::max(p_material->tile_scale.x, p_material->tile_scale.y), 1.f);
+
+	for (const Texture2D* p_tex : { p_material->base_colour_texture.Get(), p_material->normal_map_texture.Get(), p_material->metallic_texture.Get(), p_material->roughness_texture.Get(),
+		p_material->ao_texture.Get(), p_material->displacement_texture.Get(), p_material->emissive_texture.Get() }) {
+		if (p_tex)
+			streamer.ReportScreenSize(p_tex, size);
+	}
+}
+
+void TextureStreamingSystem::OnUpdate() {
+	ORNG_PROFILE_FUNC();
+
+	auto& streamer = AssetManager::GetTextureStreamer();
+	if (!streamer.enabled || streamer.GetPolicy().GetNumTextures() == 0)
+		return;
+
+	auto* p_cam = mp_scene->GetSystem<CameraSystem>().GetActiveCamera();
+	if (!p_cam)
+		return;
+
+	glm::vec3 cam_pos = p_cam->GetEntity()->GetComponent<TransformComponent>()->GetAbsPosition();
+	const ExtraMath::Frustum& frustum = p_cam->view_frustum;
+
+	// Projection matrix is built with a vertical fov of (fov * 0.5)
+	float tan_half_fov = glm::tan(glm::radians(p_cam->fov * 0.5f) * 0.5f);
+	auto screen_height = static_cast<float>(Window::GetHeight());
+
+	for (auto [entity, mesh, transform] : mp_scene->GetRegistry().view<MeshComponent, TransformComponent>().each()) {
+		MeshAsset* p_mesh_asset = mesh.GetMeshData();
+		if (!p_mesh_asset)
+			continue;
+
+		// Bounding sphere of the transformed mesh AABB
+		const AABB& aabb = p_mesh_asset->GetAABB();
+		glm::vec3 center = transform.GetMatrix() * glm::vec4(aabb.center, 1.f);
+		float radius = glm::length(aabb.extents * glm::abs(transform.GetAbsScale()));
+
+		bool visible = true;
+		for (const ExtraMath::Plane* p_plane : { &frustum.top_plane, &frustum.bottom_plane, &frustum.left_plane, &frustum.right_plane, &frustum.near_plane, &frustum.far_plane }) {
+			visible &= p_plane->GetSignedDistanceToPlane(center) >= -radius;
+		}
+
+		if (!visible)
+			continue;
+
+		float distance = glm::max(glm::length(center - cam_pos) - radius, p_cam->zNear);
+		// Not clamped to the screen, objects larger than the screen still need higher texel density
+		float screen_size_pixels = radius / (distance * tan_half_fov) * screen_height;
+
+		for (const Material* p_material : mesh.GetMaterials()) {
+			if (p_material)
+				ReportMaterial(p_material, screen_size_pixels);
+		}
+	}
+}
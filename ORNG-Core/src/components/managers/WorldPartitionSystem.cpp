@@ -0,0 +1,473 @@
+#include "pch/pch.h"
+#include "components/systems/WorldPartitionSystem.h"
+#include "components/systems/CameraSystem.h"
+#include "components/TransformComponent.h"
+#include "scene/Scene.h"
+#include "scene/SceneEntity.h"
+#include "scene/SerializationUtil.h"
+#include "assets/AssetManager.h"
+#include "util/TimeStep.h"
+#include "util/Timers.h"
+
+using namespace ORNG;
+
+std::string WorldPartitionSystem::GetCellFilepath(int x, int z) const {
+	return std::format("{}/cell_{}_{}.ocell", m_directory, x, z);
+}
+
+WorldPartitionSystem::CellData WorldPartitionSystem::ReadCell(std::string filepath) {
+	CellData cell;
+	if (!ReadBinaryFile(filepath, cell.data))
+		return cell;
+
+	if (!BinarySceneSerializer::Decode(cell.data, cell.decoded) || cell.decoded.type != BinarySceneSerializer::ContentType::ENTITY_ARRAY) {
+		ORNG_CORE_ERROR("World partition cell '{0}' is corrupt", filepath);
+		return cell;
+	}
+
+	const auto& entities = cell.decoded.entities;
+	std::unordered_map<uint64_t, int> uuid_to_index;
+	for (size_t i = 0; i < entities.size(); i++) {
+		uuid_to_index[entities[i].uuid] = static_cast<int>(i);
+	}
+
+	// Entities are written parents first, so a parent always has a lower index
+	cell.parent_indices.resize(entities.size(), -1);
+	for (size_t i = 0; i < entities.size(); i++) {
+		if (auto it = uuid_to_index.find(entities[i].parent_uuid); entities[i].parent_uuid != 0 && it != uuid_to_index.end() && it->second < static_cast<int>(i))
+			cell.parent_indices[i] = it->second;
+	}
+
+	BinarySceneSerializer::CollectAssetDependencies(cell.data, cell.decoded, cell.dependency_uuids);
+	cell.valid = true;
+	return cell;
+}
+
+bool WorldPartitionSystem::BuildPartition(Scene& scene, const std::string& directory, float cell_size) {
+	if (cell_size <= 0.f) {
+		ORNG_CORE_ERROR("Failed to build world partition, cell size must be positive");
+		return false;
+	}
+
+	struct CellEntities {
+		int x;
+		int z;
+		std::vector<SceneEntity*> entities;
+	};
+
+	std::unordered_map<uint64_t, CellEntities> cells;
+
+	for (auto* p_entity : scene.GetEntities()) {
+		if (p_entity->GetParent() != entt::null)
+			continue;
+
+		// Hierarchies are kept together in the cell of their root
+		glm::vec3 pos = p_entity->GetComponent<TransformComponent>()->GetAbsPosition();
+		int x = static_cast<int>(glm::floor(pos.x / cell_size));
+		int z = static_cast<int>(glm::floor(pos.z / cell_size));
+
+		auto [it, inserted] = cells.try_emplace(CellKey(x, z), CellEntities{ x, z });
+		auto& cell_entities = it->second.entities;
+		cell_entities.push_back(p_entity);
+		p_entity->ForEachChildRecursive([&](entt::entity e) {
+			cell_entities.push_back(scene.GetEntity(e));
+			});
+	}
+
+	Create_Directory(directory);
+
+	YAML::Emitter out;
+	out << YAML::BeginMap;
+	Out(out, "CellSize", cell_size);
+	out << YAML::Key << "Cells" << YAML::Value << YAML::BeginSeq;
+
+	std::vector<std::byte> data;
+	for (auto& [key, cell] : cells) {
+		data.clear();
+		BinarySceneSerializer::SerializeEntities(cell.entities, data);
+		if (!WriteBinaryFile(std::format("{}/cell_{}_{}.ocell", directory, cell.x, cell.z), data.data(), data.size()))
+			return false;
+
+		out << YAML::Flow << YAML::BeginMap;
+		Out(out, "X", cell.x);
+		Out(out, "Z", cell.z);
+		Out(out, "Entities", static_cast<uint32_t>(cell.entities.size()));
+		out << YAML::EndMap;
+	}
+
+	out << YAML::EndSeq;
+	out << YAML::EndMap;
+
+	if (!WriteTextFile(directory + "/" + MANIFEST_FILENAME, out.c_str()))
+		return false;
+
+	ORNG_CORE_INFO("Built world partition with {0} cells in '{1}'", cells.size(), directory);
+	return true;
+}
+
+bool WorldPartitionSystem::SetPartition(const std::string& directory) {
+	Reset(true);
+
+	std::string manifest_path = directory + "/" + MANIFEST_FILENAME;
+	if (!FileExists(manifest_path)) {
+		ORNG_CORE_ERROR("Failed to set world partition, no manifest found at '{0}'", manifest_path);
+		return false;
+	}
+
+	try {
+		YAML::Node manifest = YAML::Load(ReadTextFile(manifest_path));
+		float cell_size = manifest["CellSize"].as<float>();
+		if (cell_size <= 0.f) {
+			ORNG_CORE_ERROR("Failed to set world partition, manifest '{0}' has an invalid cell size", manifest_path);
+			return false;
+		}
+
+		for (const auto& cell_node : manifest["Cells"]) {
+			int x = cell_node["X"].as<int>();
+			int z = cell_node["Z"].as<int>();
+
+			auto& cell = m_cells[CellKey(x, z)];
+			cell.x = x;
+			cell.z = z;
+			cell.num_entities = cell_node["Entities"].as<uint32_t>();
+		}
+
+		m_cell_size = cell_size;
+	}
+	catch (const YAML::Exception& e) {
+		ORNG_CORE_ERROR("Failed parsing world partition manifest '{0}', '{1}'", manifest_path, e.what());
+		m_cells.clear();
+		return false;
+	}
+
+	m_directory = directory;
+	return true;
+}
+
+void WorldPartitionSystem::ClearPartition() {
+	Reset(true);
+}
+
+void WorldPartitionSystem::OnUnload() {
+	Reset(false);
+}
+
+void WorldPartitionSystem::Reset(bool delete_entities) {
+	if (delete_entities) {
+		for (uint64_t key : m_resident_cells) {
+			Cell& cell = m_cells[key];
+			for (auto it = cell.entity_uuids.rbegin(); it != cell.entity_uuids.rend(); it++) {
+				if (auto* p_entity = mp_scene->GetEntity(*it))
+					mp_scene->DeleteEntity(p_entity);
+			}
+		}
+	}
+
+	// Waits for any reads in flight
+	m_cells.clear();
+	m_abandoned_reads.clear();
+	m_resident_cells.clear();
+	m_assets_released = false;
+	m_cell_size = 0.f;
+	m_directory.clear();
+}
+
+void WorldPartitionSystem::AddStreamingSource(uint64_t entity_uuid) {
+	if (std::ranges::find(m_source_uuids, entity_uuid) == m_source_uuids.end())
+		m_source_uuids.push_back(entity_uuid);
+}
+
+void WorldPartitionSystem::RemoveStreamingSource(uint64_t entity_uuid) {
+	std::erase(m_source_uuids, entity_uuid);
+}
+
+WorldPartitionSystem::Stats WorldPartitionSystem::GetStats() const noexcept {
+	Stats stats;
+	stats.num_resident_cells = static_cast<unsigned>(m_resident_cells.size());
+	stats.num_reads_in_flight = static_cast<unsigned>(m_abandoned_reads.size());
+
+	for (uint64_t key : m_resident_cells) {
+		const Cell& cell = m_cells.at(key);
+		stats.num_streamed_entities += cell.entity_uuids.size();
+
+		if (cell.state == CellState::INSTANTIATED)
+			stats.num_instantiated_cells++;
+		else if (cell.state == CellState::READING)
+			stats.num_reads_in_flight++;
+	}
+
+	return stats;
+}
+
+void WorldPartitionSystem::GatherSourcePositions(std::vector<glm::vec3>& output) {
+	output.clear();
+
+	if (mp_scene->HasSystem<CameraSystem>()) {
+		if (auto* p_cam = mp_scene->GetSystem<CameraSystem>().GetActiveCamera())
+			output.push_back(p_cam->GetEntity()->GetComponent<TransformComponent>()->GetAbsPosition());
+	}
+
+	for (uint64_t uuid : m_source_uuids) {
+		if (auto* p_entity = mp_scene->GetEntity(uuid))
+			output.push_back(p_entity->GetComponent<TransformComponent>()->GetAbsPosition());
+	}
+}
+
+void WorldPartitionSystem::UpdateCellDistances(const std::vector<glm::vec3>& sources) {
+	const float half_size = m_cell_size * 0.5f;
+
+	for (uint64_t key : m_candidates) {
+		Cell& cell = m_cells[key];
+		glm::vec2 centre = glm::vec2(static_cast<float>(cell.x), static_cast<float>(cell.z)) * m_cell_size + half_size;
+
+		cell.distance = std::numeric_limits<float>::max();
+		for (const auto& pos : sources) {
+			// Distance to the cell's bounds on the XZ plane, 0 if the source is inside the cell
+			glm::vec2 d = glm::max(glm::abs(glm::vec2(pos.x, pos.z) - centre) - half_size, glm::vec2(0.f));
+			cell.distance = glm::min(cell.distance, glm::length(d));
+		}
+	}
+}
+
+void WorldPartitionSystem::BeginRead(Cell& cell) {
+	cell.state = CellState::READING;
+	cell.read_future = std::async(std::launch::async, &WorldPartitionSystem::ReadCell, GetCellFilepath(cell.x, cell.z));
+	m_resident_cells.insert(CellKey(cell.x, cell.z));
+}
+
+void WorldPartitionSystem::ReleaseCell(Cell& cell) {
+	switch (cell.state) {
+	case CellState::READING:
+		m_abandoned_reads.push_back(std::move(cell.read_future));
+		[[fallthrough]];
+	case CellState::PREFETCHED:
+		m_assets_released |= !cell.dependencies.empty();
+		cell.loaded = CellData{};
+		cell.dependencies.clear();
+		cell.state = CellState::UNLOADED;
+		m_resident_cells.erase(CellKey(cell.x, cell.z));
+		break;
+	case CellState::INSTANTIATING:
+	case CellState::INSTANTIATED:
+		cell.state = CellState::UNLOADING;
+		cell.cursor = 0;
+		break;
+	default:
+		break;
+	}
+}
+
+bool WorldPartitionSystem::StepInstantiation(Cell& cell) {
+	const auto& decoded = cell.loaded.decoded;
+	const size_t num_entities = decoded.entities.size();
+
+	// Entities are created and deserialized in one pass as parents come first, then node refs are resolved in a second pass
+	if (cell.cursor < num_entities) {
+		const auto& record = decoded.entities[cell.cursor];
+
+		// Streamed entities keep their serialized uuids so they stay stable across reloads, unless the uuid is already taken
+		SceneEntity& entity = mp_scene->CreateEntity(record.name, mp_scene->GetEntity(record.uuid) ? 0 : record.uuid);
+		cell.entity_uuids.push_back(entity.GetUUID());
+		if (entity.GetUUID() != record.uuid)
+			cell.uuid_remaps[record.uuid] = entity.GetUUID();
+
+		if (int parent_index = cell.loaded.parent_indices[cell.cursor]; parent_index != -1) {
+			if (auto* p_parent = mp_scene->GetEntity(cell.entity_uuids[parent_index]))
+				entity.SetParent(*p_parent);
+		}
+
+		BinarySceneSerializer::DeserializeEntity(*mp_scene, cell.loaded.data, decoded, record, entity, true);
+	}
+	else if (cell.cursor < num_entities * 2) {
+		if (auto* p_entity = mp_scene->GetEntity(cell.entity_uuids[cell.cursor - num_entities])) {
+			// References within the cell to entities that were given a new uuid are remapped the same way prefab instances are
+			if (!cell.uuid_remaps.empty())
+				Events::EventManager::DispatchEvent(EntitySerializationEvent{ p_entity, &cell.uuid_remaps });
+
+			Events::EventManager::DispatchEvent(EntitySerializationEvent{ p_entity });
+		}
+	}
+	else {
+		// Component data is no longer needed, the dependency handles are kept until the cell is unloaded
+		cell.loaded = CellData{};
+		cell.uuid_remaps.clear();
+		cell.state = CellState::INSTANTIATED;
+		return true;
+	}
+
+	cell.cursor++;
+	return false;
+}
+
+bool WorldPartitionSystem::StepUnload(Cell& cell) {
+	if (cell.cursor == cell.entity_uuids.size()) {
+		cell.entity_uuids.clear();
+		cell.uuid_remaps.clear();
+		cell.loaded = CellData{};
+		m_assets_released |= !cell.dependencies.empty();
+		cell.dependencies.clear();
+		cell.state = CellState::UNLOADED;
+		return true;
+	}
+
+	// Deleted leaves first so each step removes a single entity rather than a whole hierarchy
+	if (auto* p_entity = mp_scene->GetEntity(cell.entity_uuids[cell.entity_uuids.size() - 1 - cell.cursor]))
+		mp_scene->DeleteEntity(p_entity);
+
+	cell.cursor++;
+	return false;
+}
+
+void WorldPartitionSystem::OnUpdate() {
+	ORNG_PROFILE_FUNC();
+
+	if (!HasPartition())
+		return;
+
+	std::erase_if(m_abandoned_reads, [](const auto& future) { return future.wait_for(std::chrono::nanoseconds(1)) == std::future_status::ready; });
+
+	GatherSourcePositions(m_source_positions);
+
+	// Only resident cells and cells around sources are considered, so this doesn't scale with the size of the partition
+	m_candidates.assign(m_resident_cells.begin(), m_resident_cells.end());
+	const float stream_radius = settings.load_radius + settings.prefetch_distance;
+	const int cell_radius = static_cast<int>(glm::ceil(stream_radius / m_cell_size));
+
+	for (const auto& pos : m_source_positions) {
+		int source_x = static_cast<int>(glm::floor(pos.x / m_cell_size));
+		int source_z = static_cast<int>(glm::floor(pos.z / m_cell_size));
+
+		for (int x = source_x - cell_radius; x <= source_x + cell_radius; x++) {
+			for (int z = source_z - cell_radius; z <= source_z + cell_radius; z++) {
+				if (uint64_t key = CellKey(x, z); m_cells.contains(key))
+					m_candidates.push_back(key);
+			}
+		}
+	}
+
+	std::ranges::sort(m_candidates);
+	m_candidates.erase(std::ranges::unique(m_candidates).begin(), m_candidates.end());
+	UpdateCellDistances(m_source_positions);
+
+	// Cells that should stay or become resident, nearest first
+	std::vector<Cell*> wanted;
+	for (uint64_t key : m_candidates) {
+		Cell& cell = m_cells[key];
+		bool keep = false;
+
+		switch (cell.state) {
+		case CellState::INSTANTIATING:
+		case CellState::INSTANTIATED:
+			keep = cell.distance <= settings.unload_radius;
+			break;
+		case CellState::UNLOADED:
+		case CellState::READING:
+		case CellState::PREFETCHED:
+			keep = cell.distance <= stream_radius;
+			break;
+		default:
+			break;
+		}
+
+		// Without any sources, cells are left as they are
+		if (keep || m_source_positions.empty()) {
+			if (cell.state != CellState::UNLOADING && cell.state != CellState::FAILED)
+				wanted.push_back(&cell);
+		}
+		else {
+			ReleaseCell(cell);
+		}
+	}
+
+	std::ranges::sort(wanted, [](const Cell* p_left, const Cell* p_right) { return p_left->distance < p_right->distance; });
+
+	unsigned num_reads_in_flight = static_cast<unsigned>(m_abandoned_reads.size());
+	for (auto* p_cell : wanted) {
+		num_reads_in_flight += p_cell->state == CellState::READING;
+	}
+
+	for (size_t i = 0; i < wanted.size(); i++) {
+		Cell& cell = *wanted[i];
+
+		if (i >= settings.max_resident_cells) {
+			ReleaseCell(cell);
+			continue;
+		}
+
+		switch (cell.state) {
+		case CellState::UNLOADED:
+			if (num_reads_in_flight < settings.max_concurrent_reads) {
+				BeginRead(cell);
+				num_reads_in_flight++;
+			}
+			break;
+		case CellState::READING:
+			if (cell.read_future.wait_for(std::chrono::nanoseconds(1)) != std::future_status::ready)
+				break;
+
+			cell.loaded = cell.read_future.get();
+			num_reads_in_flight--;
+
+			if (!cell.loaded.valid) {
+				cell.loaded = CellData{};
+				cell.state = CellState::FAILED;
+				m_resident_cells.erase(CellKey(cell.x, cell.z));
+				break;
+			}
+
+			// Referencing the assets reloads any that were unloaded, so they're resident before the entities using them are instantiated
+			cell.dependencies.reserve(cell.loaded.dependency_uuids.size());
+			for (uint64_t uuid : cell.loaded.dependency_uuids) {
+				if (auto* p_asset = AssetManager::GetAsset<Asset>(uuid))
+					cell.dependencies.emplace_back(p_asset);
+			}
+
+			cell.state = CellState::PREFETCHED;
+			[[fallthrough]];
+		case CellState::PREFETCHED:
+			if (cell.distance <= settings.load_radius) {
+				cell.state = CellState::INSTANTIATING;
+				cell.cursor = 0;
+				cell.entity_uuids.reserve(cell.loaded.decoded.entities.size());
+			}
+			break;
+		default:
+			break;
+		}
+	}
+
+	// Unloading is done first to free memory, then cells are instantiated nearest first
+	std::vector<Cell*> work;
+	for (uint64_t key : m_resident_cells) {
+		Cell& cell = m_cells[key];
+		if (cell.state == CellState::UNLOADING)
+			work.push_back(&cell);
+	}
+	for (auto* p_cell : wanted) {
+		if (p_cell->state == CellState::INSTANTIATING)
+			work.push_back(p_cell);
+	}
+
+	TimeStep time{ TimeStep::TimeUnits::MICROSECONDS };
+	const auto budget_us = static_cast<long long>(settings.budget_ms * 1000.f);
+
+	// At least one unit of work is done per update so streaming always progresses, even with a tiny budget
+	for (auto* p_cell : work) {
+		bool finished = false;
+		do {
+			finished = p_cell->state == CellState::UNLOADING ? StepUnload(*p_cell) : StepInstantiation(*p_cell);
+		} while (!finished && time.GetTimeInterval() < budget_us);
+
+		if (finished && p_cell->state == CellState::UNLOADED)
+			m_resident_cells.erase(CellKey(p_cell->x, p_cell->z));
+
+		if (time.GetTimeInterval() >= budget_us)
+			break;
+	}
+
+	// Done at most once a frame however many cells were released, as it visits every loaded asset
+	if (m_assets_released && settings.unload_released_assets) {
+		AssetManager::UnloadUnreferencedAssets();
+		m_assets_released = false;
+	}
+}
@@ -0,0 +1,194 @@
+#include "pch/pch.h"
+#include "rendering/LightClusterBuilder.h"
+#include "util/TimeStep.h"
+
+namespace ORNG {
+	float LightClusterBuilder::CalculateLightRadius(glm::vec3 colour, float constant, float linear, float exp) {
+		// Solve exp * d^2 + linear * d + constant = max_colour / LIGHT_CUTOFF for d
+		float target = glm::max(glm::max(colour.x, colour.y), colour.z) / LIGHT_CUTOFF;
+		if (target <= constant)
+			return 0.f;
+
+		if (exp > 0.f)
+			return (-linear + glm::sqrt(linear * linear - 4.f * exp * (constant - target))) / (2.f * exp);
+		else if (linear > 0.f)
+			return (target - constant) / linear;
+
+		return std::numeric_limits<float>::max();
+	}
+
+	uint32_t LightClusterBuilder::GetClusterIndex(glm::vec2 screen_uv, float view_depth, float znear, float zfar) {
+		screen_uv = glm::clamp(screen_uv, glm::vec2(0.f), glm::vec2(1.f));
+		auto x = glm::min(static_cast<uint32_t>(screen_uv.x * NUM_X), NUM_X - 1);
+		auto y = glm::min(static_cast<uint32_t>(screen_uv.y * NUM_Y), NUM_Y - 1);
+
+		float slice = glm::log(glm::max(view_depth, znear) / znear) / glm::log(zfar / znear) * NUM_Z;
+		auto z = glm::min(static_cast<uint32_t>(glm::max(slice, 0.f)), NUM_Z - 1);
+
+		return x + y * NUM_X + z * NUM_X * NUM_Y;
+	}
+
+	void LightClusterBuilder::GetClusterBounds(uint32_t x, uint32_t y, uint32_t z, const glm::mat4& inv_projection, float znear, float zfar, glm::vec3& bounds_min, glm::vec3& bounds_max) {
+		glm::vec2 ndc_min = glm::vec2(x / static_cast<float>(NUM_X), y / static_cast<float>(NUM_Y)) * 2.f - 1.f;
+		glm::vec2 ndc_max = glm::vec2((x + 1) / static_cast<float>(NUM_X), (y + 1) / static_cast<float>(NUM_Y)) * 2.f - 1.f;
+
+		float slice_near = znear * glm::pow(zfar / znear, z / static_cast<float>(NUM_Z));
+		float slice_far = znear * glm::pow(zfar / znear, (z + 1) / static_cast<float>(NUM_Z));
+
+		bounds_min = glm::vec3(std::numeric_limits<float>::max());
+		bounds_max = glm::vec3(std::numeric_limits<float>::lowest());
+
+		for (int i = 0; i < 4; i++) {
+			glm::vec2 ndc{ i & 1 ? ndc_max.x : ndc_min.x, i & 2 ? ndc_max.y : ndc_min.y };
+			// Point on the near plane, the tile's edges are rays from the origin through it
+			glm::vec4 p = inv_projection * glm::vec4(ndc, -1.f, 1.f);
+			glm::vec3 ray = glm::vec3(p) / p.w;
+
+			for (float depth : { slice_near, slice_far }) {
+				glm::vec3 corner = ray * (depth / -ray.z);
+				bounds_min = glm::min(bounds_min, corner);
+				bounds_max = glm::max(bounds_max, corner);
+			}
+		}
+	}
+
+	bool LightClusterBuilder::SphereIntersectsAABB(glm::vec3 centre, float radius, glm::vec3 bounds_min, glm::vec3 bounds_max) {
+		glm::vec3 closest = glm::clamp(centre, bounds_min, bounds_max);
+		glm::vec3 diff = closest - centre;
+		return glm::dot(diff, diff) <= radius * radius;
+	}
+
+	uint32_t LightClusterBuilder::AssignLights(uint32_t* p_indices, uint32_t num_existing, glm::vec3 bounds_min, glm::vec3 bounds_max, std::span<const glm::vec4> view_lights, bool& overflowed) {
+		uint32_t count = 0;
+		for (uint32_t i = 0; i < view_lights.size(); i++) {
+			if (!SphereIntersectsAABB(glm::vec3(view_lights[i]), view_lights[i].w, bounds_min, bounds_max))
+				continue;
+
+			if (num_existing + count == MAX_LIGHTS_PER_CLUSTER) {
+				overflowed = true;
+				break;
+			}
+
+			p_indices[num_existing + count++] = i;
+		}
+
+		return count;
+	}
+
+	void LightClusterBuilder::Build(const glm::mat4& view, const glm::mat4& projection, float znear, float zfar, std::span<const Light> point_lights, std::span<const Light> spot_lights) {
+		m_data.resize(NUM_CLUSTERS * CLUSTER_STRIDE);
+		m_num_overflowed_clusters = 0;
+
+		auto to_view_space = [&](std::span<const Light> lights, std::vector<glm::vec4>& output) {
+			output.resize(lights.size());
+			for (size_t i = 0; i < lights.size(); i++) {
+				output[i] = glm::vec4(glm::vec3(view * glm::vec4(lights[i].pos, 1.f)), lights[i].radius);
+			}
+		};
+
+		to_view_space(point_lights, m_view_point_lights);
+		to_view_space(spot_lights, m_view_spot_lights);
+
+		glm::mat4 inv_projection = glm::inverse(projection);
+
+		for (uint32_t z = 0; z < NUM_Z; z++) {
+			for (uint32_t y = 0; y < NUM_Y; y++) {
+				for (uint32_t x = 0; x < NUM_X; x++) {
+					glm::vec3 bounds_min, bounds_max;
+					GetClusterBounds(x, y, z, inv_projection, znear, zfar, bounds_min, bounds_max);
+
+					uint32_t* p_cluster = &m_data[(x + y * NUM_X + z * NUM_X * NUM_Y) * CLUSTER_STRIDE];
+					bool overflowed = false;
+					uint32_t num_points = AssignLights(p_cluster + 2, 0, bounds_min, bounds_max, m_view_point_lights, overflowed);
+					uint32_t num_spots = AssignLights(p_cluster + 2, num_points, bounds_min, bounds_max, m_view_spot_lights, overflowed);
+
+					p_cluster[0] = num_points;
+					p_cluster[1] = num_spots;
+					m_num_overflowed_clusters += overflowed;
+				}
+			}
+		}
+	}
+
+	std::span<const uint32_t> LightClusterBuilder::GetPointLights(uint32_t cluster) const {
+		const uint32_t* p_cluster = &m_data[cluster * CLUSTER_STRIDE];
+		return { p_cluster + 2, p_cluster[0] };
+	}
+
+	std::span<const uint32_t> LightClusterBuilder::GetSpotLights(uint32_t cluster) const {
+		const uint32_t* p_cluster = &m_data[cluster * CLUSTER_STRIDE];
+		return { p_cluster + 2 + p_cluster[0], p_cluster[1] };
+	}
+
+	LightClusterBuilder::ValidationResult LightClusterBuilder::Validate(const glm::mat4& view, const glm::mat4& projection, float znear, float zfar, std::span<const Light> point_lights, std::span<const Light> spot_lights, unsigned samples_per_axis) {
+		ValidationResult result;
+		LightClusterBuilder builder;
+
+		TimeStep timer{ TimeStep::TimeUnits::MICROSECONDS };
+		builder.Build(view, projection, znear, zfar, point_lights, spot_lights);
+		result.build_ms = timer.GetTimeInterval() / 1000.0;
+		result.num_overflowed_clusters = builder.GetNumOverflowedClusters();
+
+		glm::mat4 inv_projection = glm::inverse(projection);
+		glm::mat4 inv_view = glm::inverse(view);
+
+		// Returns the number of lights in range of world_pos that are missing from cluster_lights
+		auto check_lights = [&](std::span<const Light> lights, std::span<const uint32_t> cluster_lights, glm::vec3 world_pos, bool overflowed) {
+			unsigned num_missing = 0;
+			for (uint32_t i = 0; i < lights.size(); i++) {
+				glm::vec3 diff = lights[i].pos - world_pos;
+				if (glm::dot(diff, diff) > lights[i].radius * lights[i].radius)
+					continue;
+
+				result.avg_affecting_lights++;
+				if (!overflowed && std::ranges::find(cluster_lights, i) == cluster_lights.end())
+					num_missing++;
+			}
+			return num_missing;
+		};
+
+		timer.UpdateLastTime();
+		for (unsigned sz = 0; sz < samples_per_axis; sz++) {
+			// Spaced like the slices so near clusters get as many samples as far ones
+			float depth = znear * glm::pow(zfar / znear, (sz + 0.5f) / samples_per_axis);
+
+			for (unsigned sy = 0; sy < samples_per_axis; sy++) {
+				for (unsigned sx = 0; sx < samples_per_axis; sx++) {
+					glm::vec2 uv = (glm::vec2(sx, sy) + 0.5f) / static_cast<float>(samples_per_axis);
+
+					glm::vec4 p = inv_projection * glm::vec4(uv * 2.f - 1.f, -1.f, 1.f);
+					glm::vec3 ray = glm::vec3(p) / p.w;
+					glm::vec3 world_pos = inv_view * glm::vec4(ray * (depth / -ray.z), 1.f);
+
+					uint32_t cluster = GetClusterIndex(uv, depth, znear, zfar);
+					auto cluster_points = builder.GetPointLights(cluster);
+					auto cluster_spots = builder.GetSpotLights(cluster);
+					bool overflowed = cluster_points.size() + cluster_spots.size() == MAX_LIGHTS_PER_CLUSTER;
+
+					result.num_missing += check_lights(point_lights, cluster_points, world_pos, overflowed);
+					result.num_missing += check_lights(spot_lights, cluster_spots, world_pos, overflowed);
+					result.avg_cluster_lights += static_cast<double>(cluster_points.size() + cluster_spots.size());
+					result.num_samples++;
+				}
+			}
+		}
+		result.brute_force_ms = timer.GetTimeInterval() / 1000.0;
+
+		if (result.num_samples > 0) {
+			result.avg_cluster_lights /= result.num_samples;
+			result.avg_affecting_lights /= result.num_samples;
+		}
+
+		return result;
+	}
+
+	std::vector<std::string> LightClusterBuilder::GetShaderDefines() {
+		// Unsigned so they mix with cluster indices without casts
+		return {
+			std::format("LIGHT_CLUSTERS_X {}u", NUM_X),
+			std::format("LIGHT_CLUSTERS_Y {}u", NUM_Y),
+			std::format("LIGHT_CLUSTERS_Z {}u", NUM_Z),
+			std::format("MAX_LIGHTS_PER_CLUSTER {}u", MAX_LIGHTS_PER_CLUSTER),
+		};
+	}
+}
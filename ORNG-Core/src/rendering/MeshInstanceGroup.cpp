@@ -71,7 +71,7 @@ namespace ORNG {
 				for (auto entt_handle : m_entities_to_instance) {
 					m_instances[entt_handle] = m_used_transform_memory_end_idx;
 					m_used_transform_memory_end_idx++; // m_used_transform_memory_end_idx will only decrease when the buffer is reallocated
-					ConvertToBytes(p_byte, m_registry.get<TransformComponent>(entt_handle).GetMatrix());
+					ConvertToBytes(p_byte, m_registry.get<TransformComponent>(entt_handle).GetRenderMatrix());
 				}
 
 				glNamedBufferSubData(m_transform_ssbo.GetHandle(), prev_used_transform_memory_end_idx * sizeof(glm::mat4), transform_buf.size(),
@@ -99,7 +99,7 @@ namespace ORNG {
 		int first_index_of_chunk = -1;
 
 		// Below loop can't cover index 0 (first check puts it out of range) so handle separately here
-		transforms.push_back(m_registry.get<TransformComponent>(m_instances_to_update[0]).GetMatrix());
+		transforms.push_back(m_registry.get<TransformComponent>(m_instances_to_update[0]).GetRenderMatrix());
 		glNamedBufferSubData(m_transform_ssbo.GetHandle(), m_instances[m_instances_to_update[0]] * sizeof(glm::mat4), transforms.size() * sizeof(glm::mat4), &transforms[0]);
 		transforms.clear();
 		
@@ -107,12 +107,12 @@ namespace ORNG {
 			if (m_instances[m_instances_to_update[i]] == m_instances[m_instances_to_update[i - 1]] + 1) // Check if indices are sequential in the gpu transform buffer
 			{
 				if (first_index_of_chunk == -1) {
-					transforms.push_back(m_registry.get<TransformComponent>(m_instances_to_update[i - 1]).GetMatrix());
-					transforms.push_back(m_registry.get<TransformComponent>(m_instances_to_update[i]).GetMatrix());
+					transforms.push_back(m_registry.get<TransformComponent>(m_instances_to_update[i - 1]).GetRenderMatrix());
+					transforms.push_back(m_registry.get<TransformComponent>(m_instances_to_update[i]).GetRenderMatrix());
 					first_index_of_chunk = static_cast<int>(m_instances[m_instances_to_update[i - 1]]);
 				}
 				else {
-					transforms.push_back(m_registry.get<TransformComponent>(m_instances_to_update[i]).GetMatrix());
+					transforms.push_back(m_registry.get<TransformComponent>(m_instances_to_update[i]).GetRenderMatrix());
 				}
 			}
 			else if (first_index_of_chunk != -1) // This is the end of the chunk, so update for this chunk
@@ -124,12 +124,12 @@ namespace ORNG {
 
 				// Update current transform (i) separately as it's not a part of the chunk
 				glNamedBufferSubData(m_transform_ssbo.GetHandle(), m_instances[m_instances_to_update[i]] * sizeof(glm::mat4),
-					sizeof(glm::mat4), &m_registry.get<TransformComponent>(m_instances_to_update[i]).GetMatrix()[0][0]);
+					sizeof(glm::mat4), &m_registry.get<TransformComponent>(m_instances_to_update[i]).GetRenderMatrix()[0][0]);
 			}
 			else {
 				// Ensure no transforms get skipped
 				glNamedBufferSubData(m_transform_ssbo.GetHandle(), m_instances[m_instances_to_update[i]] * sizeof(glm::mat4),
-					sizeof(glm::mat4), &m_registry.get<TransformComponent>(m_instances_to_update[i]).GetMatrix()[0][0]);
+					sizeof(glm::mat4), &m_registry.get<TransformComponent>(m_instances_to_update[i]).GetRenderMatrix()[0][0]);
 			}
 		}
 
@@ -149,7 +149,7 @@ namespace ORNG {
 		unsigned current_idx = 0;
 		for (auto& [instance_handle, transform_idx] : m_instances) {
 			transform_idx = current_idx++;
-			ConvertToBytes(p_byte, m_registry.get<TransformComponent>(instance_handle).GetMatrix());
+			ConvertToBytes(p_byte, m_registry.get<TransformComponent>(instance_handle).GetRenderMatrix());
 		}
 
 		m_transform_ssbo.FillBuffer();
@@ -162,8 +162,9 @@ namespace ORNG {
 
 
 
-	void SceneRenderer::DrawMeshGBuffer(ShaderVariants* p_shader, const MeshAsset* p_mesh, RenderGroup render_group, int instances,
-		const Material* const* materials, MaterialFlags mat_flags, MaterialFlags mat_flags_excluded, bool allow_state_changes, GLenum primitive_type) {
+	template<typename MaterialPtr>
+	void SceneRenderer::DrawMeshGBufferImpl(ShaderVariants* p_shader, const MeshAsset* p_mesh, RenderGroup render_group, int instances,
+		const MaterialPtr* materials, MaterialFlags mat_flags, MaterialFlags mat_flags_excluded, bool allow_state_changes, GLenum primitive_type) {
 		DEBUG_ASSERT(instances >= 0);
 
 		for (unsigned int i = 0; i < p_mesh->m_submeshes.size(); i++) {
@@ -185,6 +186,16 @@ namespace ORNG {
 		}
 	}
 
+	void SceneRenderer::DrawMeshGBuffer(ShaderVariants* p_shader, const MeshAsset* p_mesh, RenderGroup render_group, int instances,
+		const Material* const* materials, MaterialFlags mat_flags, MaterialFlags mat_flags_excluded, bool allow_state_changes, GLenum primitive_type) {
+		DrawMeshGBufferImpl(p_shader, p_mesh, render_group, instances, materials, mat_flags, mat_flags_excluded, allow_state_changes, primitive_type);
+	}
+
+	void SceneRenderer::DrawMeshGBuffer(ShaderVariants* p_shader, const MeshAsset* p_mesh, RenderGroup render_group, int instances,
+		const AssetHandle<const Material>* materials, MaterialFlags mat_flags, MaterialFlags mat_flags_excluded, bool allow_state_changes, GLenum primitive_type) {
+		DrawMeshGBufferImpl(p_shader, p_mesh, render_group, instances, materials, mat_flags, mat_flags_excluded, allow_state_changes, primitive_type);
+	}
+
 	
 	//void SceneRenderer::DrawTerrain(CameraComponent* p_cam, Scene* p_scene) {
 	//	std::vector<TerrainQuadtree*> node_array;
@@ -0,0 +1,177 @@
+#include "pch/pch.h"
+
+#include "rendering/TextureResidencyPolicy.h"
+
+using namespace ORNG;
+
+uint8_t TextureResidencyPolicy::CalcNumMips(uint32_t width, uint32_t height) {
+	uint32_t max_dim = glm::max(glm::max(width, height), 1u);
+	uint8_t num_mips = 1;
+
+	while (max_dim > 1) {
+		max_dim >>= 1;
+		num_mips++;
+	}
+
+	return num_mips;
+}
+
+size_t TextureResidencyPolicy::CalcMipRangeBytes(uint32_t width, uint32_t height, uint32_t bytes_per_texel, uint8_t first_mip, uint8_t last_mip) {
+	size_t total = 0;
+	for (uint8_t i = first_mip; i < last_mip; i++) {
+		total += static_cast<size_t>(glm::max(width >> i, 1u)) * static_cast<size_t>(glm::max(height >> i, 1u)) * bytes_per_texel;
+	}
+
+	return total;
+}
+
+uint8_t TextureResidencyPolicy::RegisterTexture(uint64_t texture_id, uint32_t width, uint32_t height, uint32_t bytes_per_texel) {
+	if (m_entries.contains(texture_id))
+		UnregisterTexture(texture_id);
+
+	Entry entry;
+	entry.width = width;
+	entry.height = height;
+	entry.bytes_per_texel = bytes_per_texel;
+	entry.num_mips = CalcNumMips(width, height);
+
+	// Find the first mip small enough to always be kept resident
+	while (entry.base_mip < entry.num_mips - 1 &&
+		glm::max(width >> entry.base_mip, height >> entry.base_mip) > ALWAYS_RESIDENT_DIM) {
+		entry.base_mip++;
+	}
+
+	entry.resident_mip = entry.base_mip;
+	entry.required_mip = entry.base_mip;
+
+	m_committed_bytes += CalcRangeBytes(entry, entry.base_mip, entry.num_mips);
+	m_entries[texture_id] = entry;
+
+	return entry.base_mip;
+}
+
+void TextureResidencyPolicy::UnregisterTexture(uint64_t texture_id) {
+	auto it = m_entries.find(texture_id);
+	if (it == m_entries.end())
+		return;
+
+	const Entry& entry = it->second;
+	uint8_t first_committed_mip = entry.pending_mip == INVALID_MIP ? entry.resident_mip : entry.pending_mip;
+	m_committed_bytes -= CalcRangeBytes(entry, first_committed_mip, entry.num_mips);
+
+	m_entries.erase(it);
+}
+
+const TextureResidencyPolicy::Entry* TextureResidencyPolicy::GetEntry(uint64_t texture_id) const {
+	auto it = m_entries.find(texture_id);
+	return it == m_entries.end() ? nullptr : &it->second;
+}
+
+void TextureResidencyPolicy::ReportScreenSize(uint64_t texture_id, float screen_size_pixels, uint64_t frame) {
+	auto it = m_entries.find(texture_id);
+	if (it == m_entries.end())
+		return;
+
+	Entry& entry = it->second;
+	float max_dim = static_cast<float>(glm::max(entry.width, entry.height));
+
+	// Each mip halves resolution, so the mip where one texel maps to roughly one pixel is log2(texels / pixels)
+	float ratio = max_dim / glm::max(screen_size_pixels, 1.f);
+	auto mip = static_cast<uint8_t>(glm::clamp(glm::floor(glm::log2(glm::max(ratio, 1.f))), 0.f, static_cast<float>(entry.base_mip)));
+
+	// First report this frame overrides the previous frame's requirement, so textures moving away from the camera can drop mips
+	if (entry.last_needed_frame != frame) {
+		entry.required_mip = mip;
+		entry.last_needed_frame = frame;
+	}
+	else {
+		entry.required_mip = glm::min(entry.required_mip, mip);
+	}
+}
+
+bool TextureResidencyPolicy::MakeRoom(size_t bytes_needed, uint64_t frame, uint64_t requesting_id, std::vector<EvictRequest>& evict_requests) {
+	for (auto [id, p_entry] : m_eviction_candidates) {
+		if (m_committed_bytes + bytes_needed <= m_budget_bytes)
+			return true;
+
+		// May have already been evicted or have had a request issued this frame
+		if (id == requesting_id || p_entry->pending_mip != INVALID_MIP || p_entry->resident_mip >= p_entry->required_mip)
+			continue;
+
+		// Textures still in use are only trimmed down to what they currently need
+		uint8_t new_resident_mip = frame - p_entry->last_needed_frame > eviction_grace_frames ? p_entry->base_mip : p_entry->required_mip;
+		m_committed_bytes -= CalcRangeBytes(*p_entry, p_entry->resident_mip, new_resident_mip);
+		p_entry->resident_mip = new_resident_mip;
+		evict_requests.push_back(EvictRequest{ id, new_resident_mip });
+	}
+
+	return m_committed_bytes + bytes_needed <= m_budget_bytes;
+}
+
+void TextureResidencyPolicy::Update(uint64_t frame, std::vector<StreamRequest>& stream_requests, std::vector<EvictRequest>& evict_requests) {
+	stream_requests.clear();
+	evict_requests.clear();
+	m_candidates.clear();
+	m_eviction_candidates.clear();
+
+	for (auto& [id, entry] : m_entries) {
+		if (frame - entry.last_needed_frame > eviction_grace_frames)
+			entry.required_mip = entry.base_mip;
+
+		if (entry.pending_mip != INVALID_MIP)
+			continue;
+
+		if (entry.required_mip < entry.resident_mip)
+			m_candidates.emplace_back(id, &entry);
+		else if (entry.resident_mip < entry.required_mip)
+			m_eviction_candidates.emplace_back(id, &entry);
+	}
+
+	// Least recently needed mips are evicted first
+	std::ranges::sort(m_eviction_candidates, [](const auto& a, const auto& b) {
+		return a.second->last_needed_frame < b.second->last_needed_frame;
+		});
+
+	// Budget may have been lowered since the last update
+	if (m_committed_bytes > m_budget_bytes)
+		MakeRoom(0, frame, 0, evict_requests);
+
+	// Textures needed most recently go first, then the ones furthest from their required resolution
+	std::ranges::sort(m_candidates, [](const auto& a, const auto& b) {
+		if (a.second->last_needed_frame != b.second->last_needed_frame)
+			return a.second->last_needed_frame > b.second->last_needed_frame;
+
+		return a.second->resident_mip - a.second->required_mip > b.second->resident_mip - b.second->required_mip;
+		});
+
+	for (auto [id, p_entry] : m_candidates) {
+		// If the full requirement doesn't fit, settle for the highest resolution that does
+		for (uint8_t target = p_entry->required_mip; target < p_entry->resident_mip; target++) {
+			size_t cost = CalcRangeBytes(*p_entry, target, p_entry->resident_mip);
+			if (!MakeRoom(cost, frame, id, evict_requests))
+				continue;
+
+			m_committed_bytes += cost;
+			p_entry->pending_mip = target;
+			stream_requests.push_back(StreamRequest{ id, target });
+			break;
+		}
+	}
+}
+
+void TextureResidencyPolicy::OnStreamComplete(uint64_t texture_id, bool success) {
+	auto it = m_entries.find(texture_id);
+	if (it == m_entries.end())
+		return;
+
+	Entry& entry = it->second;
+	if (entry.pending_mip == INVALID_MIP)
+		return;
+
+	if (success)
+		entry.resident_mip = entry.pending_mip;
+	else
+		m_committed_bytes -= CalcRangeBytes(entry, entry.pending_mip, entry.resident_mip);
+
+	entry.pending_mip = INVALID_MIP;
+}
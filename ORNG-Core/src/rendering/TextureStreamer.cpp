@@ -0,0 +1,212 @@
+#include "pch/pch.h"
+
+#include "rendering/TextureStreamer.h"
+#include "rendering/Textures.h"
+#include "assets/AssetSerializer.h"
+#include "core/FrameTiming.h"
+#include "util/Timers.h"
+
+using namespace ORNG;
+
+TextureStreamer::~TextureStreamer() {
+	// Futures returned from std::async block on destruction, results are discarded as textures may already be gone
+	m_stream_queue.clear();
+}
+
+bool TextureStreamer::IsStreamed(const Texture2D* p_tex) const {
+	return m_textures.contains(p_tex->uuid());
+}
+
+bool TextureStreamer::GenerateMipRange(std::byte* p_encoded_data, size_t size, uint8_t first_mip, uint8_t last_mip, std::vector<MipData>& output, int& channels) {
+	int width = 0;
+	int height = 0;
+
+	// Vertical flip is set globally by every texture loading path before any streaming happens
+	stbi_uc* p_image = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(p_encoded_data), static_cast<int>(size), &width, &height, &channels, 0);
+	if (!p_image)
+		return false;
+
+	auto* p_image_bytes = reinterpret_cast<std::byte*>(p_image);
+	std::vector<std::byte> current{ p_image_bytes, p_image_bytes + static_cast<size_t>(width) * height * channels };
+	stbi_image_free(p_image);
+
+	for (uint8_t level = 0; level < last_mip; level++) {
+		if (level + 1 == last_mip) {
+			output.push_back(MipData{ width, height, std::move(current) });
+			break;
+		}
+
+		if (level >= first_mip)
+			output.push_back(MipData{ width, height, current });
+
+		// 2x2 box filter, edges are clamped so odd dimensions don't read out of bounds
+		int next_width = glm::max(width / 2, 1);
+		int next_height = glm::max(height / 2, 1);
+		std::vector<std::byte> next(static_cast<size_t>(next_width) * next_height * channels);
+
+		for (int y = 0; y < next_height; y++) {
+			int y0 = glm::min(y * 2, height - 1);
+			int y1 = glm::min(y * 2 + 1, height - 1);
+
+			for (int x = 0; x < next_width; x++) {
+				int x0 = glm::min(x * 2, width - 1);
+				int x1 = glm::min(x * 2 + 1, width - 1);
+
+				for (int c = 0; c < channels; c++) {
+					unsigned sum = static_cast<unsigned>(current[(static_cast<size_t>(y0) * width + x0) * channels + c]) +
+						static_cast<unsigned>(current[(static_cast<size_t>(y0) * width + x1) * channels + c]) +
+						static_cast<unsigned>(current[(static_cast<size_t>(y1) * width + x0) * channels + c]) +
+						static_cast<unsigned>(current[(static_cast<size_t>(y1) * width + x1) * channels + c]);
+
+					next[(static_cast<size_t>(y) * next_width + x) * channels + c] = static_cast<std::byte>((sum + 2) / 4);
+				}
+			}
+		}
+
+		current = std::move(next);
+		width = next_width;
+		height = next_height;
+	}
+
+	return true;
+}
+
+bool TextureStreamer::LoadResidentMips(Texture2D& tex, std::vector<std::byte>& encoded_data) {
+	const Texture2DSpec& spec = tex.GetSpec();
+	int width = 0;
+	int height = 0;
+	int channels = 0;
+
+	// Streamed mips are re-read from the serialized file, so textures without one are uploaded in full
+	bool can_stream = enabled && spec.generate_mipmaps && spec.storage_type != GL_FLOAT && FileExists(tex.filepath) &&
+		stbi_info_from_memory(reinterpret_cast<const stbi_uc*>(encoded_data.data()), static_cast<int>(encoded_data.size()), &width, &height, &channels) &&
+		!stbi_is_hdr_from_memory(reinterpret_cast<const stbi_uc*>(encoded_data.data()), static_cast<int>(encoded_data.size()));
+
+	if (!can_stream)
+		return tex.LoadFromBinary(encoded_data.data(), encoded_data.size(), false);
+
+	uint64_t id = tex.uuid();
+	uint8_t base_mip = m_policy.RegisterTexture(id, static_cast<uint32_t>(width), static_cast<uint32_t>(height), static_cast<uint32_t>(channels));
+	if (base_mip == 0) { // Small enough to always be fully resident
+		m_policy.UnregisterTexture(id);
+		return tex.LoadFromBinary(encoded_data.data(), encoded_data.size(), false);
+	}
+
+	uint8_t num_mips = TextureResidencyPolicy::CalcNumMips(static_cast<uint32_t>(width), static_cast<uint32_t>(height));
+
+	stbi_set_flip_vertically_on_load(1);
+	std::vector<MipData> mips;
+	if (!GenerateMipRange(encoded_data.data(), encoded_data.size(), base_mip, num_mips, mips, channels)) {
+		ORNG_CORE_ERROR("Can't load binary texture data, - '{0}'", stbi_failure_reason());
+		m_policy.UnregisterTexture(id);
+		return false;
+	}
+
+	for (size_t i = 0; i < mips.size(); i++) {
+		tex.UploadMipLevel(static_cast<uint8_t>(base_mip + i), mips[i].width, mips[i].height, channels, mips[i].data.data());
+	}
+
+	tex.SetMipRange(base_mip, num_mips - 1);
+	m_textures[id] = StreamedTexture{ &tex, channels, base_mip, num_mips };
+
+	return true;
+}
+
+void TextureStreamer::ReportScreenSize(const Texture2D* p_tex, float screen_size_pixels) {
+	m_policy.ReportScreenSize(p_tex->uuid(), screen_size_pixels, FrameTiming::GetFrameCount());
+}
+
+void TextureStreamer::OnTextureDeleted(Texture2D* p_tex) {
+	// Any in-flight request for this texture is discarded when it finishes
+	m_policy.UnregisterTexture(p_tex->uuid());
+	m_textures.erase(p_tex->uuid());
+}
+
+void TextureStreamer::StopStreaming(Texture2D& tex) {
+	if (!IsStreamed(&tex))
+		return;
+
+	OnTextureDeleted(&tex);
+	// 1000 is the GL default max level
+	tex.SetMipRange(0, 1000);
+}
+
+void TextureStreamer::ProcessFinishedRequests() {
+	for (size_t i = 0; i < m_stream_queue.size(); i++) {
+		if (m_stream_queue[i].wait_for(std::chrono::nanoseconds(1)) != std::future_status::ready)
+			continue;
+
+		StreamResult result = m_stream_queue[i].get();
+		m_stream_queue.erase(m_stream_queue.begin() + static_cast<long long>(i));
+		i--;
+
+		auto it = m_textures.find(result.texture_id);
+		if (it == m_textures.end())
+			continue;
+
+		StreamedTexture& streamed = it->second;
+		if (result.success) {
+			for (size_t j = 0; j < result.mips.size(); j++) {
+				MipData& mip = result.mips[j];
+				result.success &= streamed.p_tex->UploadMipLevel(static_cast<uint8_t>(result.first_mip + j), mip.width, mip.height, streamed.channels, mip.data.data());
+			}
+		}
+
+		if (result.success) {
+			streamed.p_tex->SetMipRange(result.first_mip, streamed.num_mips - 1);
+			streamed.resident_mip = result.first_mip;
+		}
+		else {
+			ORNG_CORE_ERROR("Failed streaming mips of texture '{0}'", streamed.p_tex->filepath);
+		}
+
+		m_policy.OnStreamComplete(result.texture_id, result.success);
+	}
+}
+
+void TextureStreamer::Update() {
+	ORNG_PROFILE_FUNC();
+	ProcessFinishedRequests();
+
+	if (m_textures.empty())
+		return;
+
+	m_policy.Update(FrameTiming::GetFrameCount(), m_stream_requests, m_evict_requests);
+
+	for (auto [id, new_resident_mip] : m_evict_requests) {
+		StreamedTexture& streamed = m_textures[id];
+		streamed.p_tex->SetMipRange(new_resident_mip, streamed.num_mips - 1);
+
+		for (uint8_t level = streamed.resident_mip; level < new_resident_mip; level++) {
+			streamed.p_tex->ReleaseMipLevel(level, streamed.channels);
+		}
+
+		streamed.resident_mip = new_resident_mip;
+	}
+
+	for (auto [id, target_mip] : m_stream_requests) {
+		if (m_stream_queue.size() >= max_concurrent_requests) {
+			// Releases the reservation, request will be reissued next frame
+			m_policy.OnStreamComplete(id, false);
+			continue;
+		}
+
+		const StreamedTexture& streamed = m_textures[id];
+		uint8_t resident_mip = streamed.resident_mip;
+		std::string filepath = streamed.p_tex->filepath;
+
+		m_stream_queue.push_back(std::async(std::launch::async, [id, target_mip, resident_mip, filepath] {
+			StreamResult result;
+			result.texture_id = id;
+			result.first_mip = target_mip;
+
+			std::vector<std::byte> encoded_data;
+			if (!AssetSerializer::ReadRawTextureDataFromBinaryFile(filepath, encoded_data))
+				return result;
+
+			int channels = 0;
+			result.success = GenerateMipRange(encoded_data.data(), encoded_data.size(), target_mip, resident_mip, result.mips, channels);
+			return result;
+			}));
+	}
+}
@@ -169,37 +169,12 @@ bool Texture2D::LoadFromBinary(std::byte* p_data, size_t size, bool is_decompres
 	int internal_format = 0;
 	unsigned format = 0;
 
-	if (!is_float) {
-		switch (bpp) {
-		case 1:
-			internal_format = GL_R8;
-			format = GL_RED;
-			break;
-		case 2:
-			internal_format = GL_RG8;
-			format = GL_RG;
-			break;
-		case 3:
-			if (m_spec.srgb_space)
-				internal_format = GL_SRGB8;
-			else
-				internal_format = GL_RGB8;
-
-			format = GL_RGB;
-			break;
-		case 4:
-			if (m_spec.srgb_space)
-				internal_format = GL_SRGB8_ALPHA8;
-			else
-				internal_format = GL_RGBA8;
-
-			format = GL_RGBA;
-			break;
-		default:
-			ORNG_CORE_ERROR("Failed loading binary texture', unsupported number of channels");
+	if (!is_float && !GetFormatsFromChannels(bpp, m_spec.srgb_space, internal_format, format)) {
+		ORNG_CORE_ERROR("Failed loading binary texture', unsupported number of channels");
+		if (!is_decompressed)
 			stbi_image_free(image_data);
-			return false;
-		}
+
+		return false;
 	}
 
 	GL_StateManager::BindTexture(m_texture_target, m_texture_obj, GL_TEXTURE0, true);
@@ -221,6 +196,68 @@ bool Texture2D::LoadFromBinary(std::byte* p_data, size_t size, bool is_decompres
 	return true;
 }
 
+bool Texture2D::GetFormatsFromChannels(int channels, bool srgb, int& internal_format, unsigned& format) {
+	switch (channels) {
+	case 1:
+		internal_format = GL_R8;
+		format = GL_RED;
+		return true;
+	case 2:
+		internal_format = GL_RG8;
+		format = GL_RG;
+		return true;
+	case 3:
+		internal_format = srgb ? GL_SRGB8 : GL_RGB8;
+		format = GL_RGB;
+		return true;
+	case 4:
+		internal_format = srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8;
+		format = GL_RGBA;
+		return true;
+	default:
+		return false;
+	}
+}
+
+bool Texture2D::UploadMipLevel(uint8_t level, int width, int height, int channels, const std::byte* p_data) {
+	int internal_format = 0;
+	unsigned format = 0;
+
+	if (!GetFormatsFromChannels(channels, m_spec.srgb_space, internal_format, format)) {
+		ORNG_CORE_ERROR("Failed uploading mip level {0} of texture '{1}', unsupported number of channels", level, m_name);
+		return false;
+	}
+
+	GL_StateManager::BindTexture(m_texture_target, m_texture_obj, GL_TEXTURE0, true);
+
+	// Small mips of 1/3 channel textures won't have 4-byte aligned rows
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexImage2D(m_texture_target, level, internal_format, width, height, 0, format, GL_UNSIGNED_BYTE, p_data);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+	GL_StateManager::BindTexture(m_texture_target, 0, GL_TEXTURE0, true);
+
+	return true;
+}
+
+void Texture2D::ReleaseMipLevel(uint8_t level, int channels) {
+	int internal_format = 0;
+	unsigned format = 0;
+	if (!GetFormatsFromChannels(channels, m_spec.srgb_space, internal_format, format))
+		return;
+
+	GL_StateManager::BindTexture(m_texture_target, m_texture_obj, GL_TEXTURE0, true);
+	glTexImage2D(m_texture_target, level, internal_format, 0, 0, 0, format, GL_UNSIGNED_BYTE, nullptr);
+	GL_StateManager::BindTexture(m_texture_target, 0, GL_TEXTURE0, true);
+}
+
+void Texture2D::SetMipRange(uint8_t base_level, uint8_t max_level) {
+	GL_StateManager::BindTexture(m_texture_target, m_texture_obj, GL_TEXTURE0, true);
+	glTexParameteri(m_texture_target, GL_TEXTURE_BASE_LEVEL, base_level);
+	glTexParameteri(m_texture_target, GL_TEXTURE_MAX_LEVEL, max_level);
+	GL_StateManager::BindTexture(m_texture_target, 0, GL_TEXTURE0, true);
+}
+
 bool Texture2D::LoadFromFile() {
 	if (m_spec.filepath.empty()) {
 		ORNG_CORE_ERROR("2D Texture failed loading from file: Invalid spec");
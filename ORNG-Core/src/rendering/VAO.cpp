@@ -150,6 +150,12 @@ m_flags(flags), m_is_mutable(is_mutable) {  };
 		glDeleteBuffers(static_cast<GLsizei>(m_buffers.size()), &m_buffers[0]);
 	};
 
+	void MeshVAO::ReleaseBuffers() {
+		for (unsigned buffer : m_buffers) {
+			glNamedBufferData(buffer, 0, nullptr, GL_STATIC_DRAW);
+		}
+	}
+
 	void MeshVAO::FillBuffers() {
 		GL_StateManager::BindVAO(GetHandle());
 
@@ -169,7 +169,7 @@ void GBufferPass::DoPass() {
 		// TODO: These should be sorted by material for minimal state changes, DecalSystem could handle this
 		if (!decal.p_material) continue;
 		SceneRenderer::SetGBufferMaterial(&sv, decal.p_material);
-		sv.SetUniform("u_transform", transform.GetMatrix());
+		sv.SetUniform("u_transform", transform.GetRenderMatrix());
 		Renderer::DrawCube();
 	}
 	glEnable(GL_DEPTH_TEST);
@@ -11,6 +11,7 @@
 #include "rendering/renderpasses/VoxelPass.h"
 #include "rendering/renderpasses/SSAOPass.h"
 #include "rendering/Renderer.h"
+#include "rendering/LightClusterBuilder.h"
 #include "rendering/RenderGraph.h"
 #include "scene/Scene.h"
 #include "util/Timers.h"
@@ -19,10 +20,16 @@ using namespace ORNG;
 
 void LightingPass::Init() {
 	p_scene = mp_graph->GetData<Scene>("Scene");
-	shader.AddStage(GL_COMPUTE_SHADER, "res/core-res/shaders/LightingCS.glsl");
+	shader.AddStage(GL_COMPUTE_SHADER, "res/core-res/shaders/LightingCS.glsl", LightClusterBuilder::GetShaderDefines());
 	shader.Init();
 	shader.AddUniforms("u_ibl_active", "u_ssao_active");
 
+	light_cluster_shader.AddStage(GL_COMPUTE_SHADER, "res/core-res/shaders/LightClusterCS.glsl", LightClusterBuilder::GetShaderDefines());
+	light_cluster_shader.Init();
+
+	light_cluster_ssbo.Init();
+	light_cluster_ssbo.Resize(LightClusterBuilder::NUM_CLUSTERS * LightClusterBuilder::CLUSTER_STRIDE * sizeof(uint32_t));
+
 	if (auto* _p_voxel_pass = mp_graph->GetRenderpass<VoxelPass>()) {
 		this->p_voxel_pass = _p_voxel_pass;
 
@@ -66,6 +73,137 @@ inline int Groups(int size, int group_size) {
 	return static_cast<int>(glm::ceil(static_cast<float>(size) / static_cast<float>(group_size)));
 }
 
+// Copies the whole buffer bound at index of target into output, binding_query is the target's GL_*_BINDING
+template<typename T>
+static void ReadBoundBuffer(GLenum binding_query, unsigned index, std::vector<T>& output) {
+	GLint handle = 0;
+	glGetIntegeri_v(binding_query, index, &handle);
+
+	GLint size = 0;
+	if (handle != 0)
+		glGetNamedBufferParameteriv(handle, GL_BUFFER_SIZE, &size);
+
+	output.resize(size / sizeof(T));
+	if (!output.empty())
+		glGetNamedBufferSubData(handle, 0, output.size() * sizeof(T), output.data());
+}
+
+unsigned LightingPass::ValidateLightClusters() {
+	glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+
+	// Inputs are read from the buffers the cluster shader used, so the reference sees exactly the same view, projection and lights
+	std::vector<glm::mat4> matrices;
+	ReadBoundBuffer(GL_UNIFORM_BUFFER_BINDING, GL_StateManager::UniformBindingPoints::PVMATRICES, matrices);
+
+	// ubo_common is 8 vec4's followed by time_elapsed, cam_zfar, cam_znear
+	std::vector<float> common;
+	ReadBoundBuffer(GL_UNIFORM_BUFFER_BINDING, GL_StateManager::UniformBindingPoints::GLOBALS, common);
+
+	if (matrices.size() < 2 || common.size() < 35) {
+		ORNG_CORE_ERROR("Light cluster validation failed, matrix or common UBO not bound");
+		return 0;
+	}
+
+	const glm::mat4& projection = matrices[0];
+	const glm::mat4& view = matrices[1];
+	const float zfar = common[33];
+	const float znear = common[34];
+
+	// Light structs are 12 (point) and 36 (spot) floats with pos.xyz + cull radius at floats 4-7, see CommonINCL.glsl
+	auto read_lights = [](unsigned binding, size_t stride, std::vector<LightClusterBuilder::Light>& output) {
+		std::vector<float> data;
+		ReadBoundBuffer(GL_SHADER_STORAGE_BUFFER_BINDING, binding, data);
+
+		output.resize(data.size() / stride);
+		for (size_t i = 0; i < output.size(); i++) {
+			const float* p_pos = &data[i * stride + 4];
+			output[i] = { glm::vec3(p_pos[0], p_pos[1], p_pos[2]), p_pos[3] };
+		}
+	};
+
+	std::vector<LightClusterBuilder::Light> point_lights;
+	std::vector<LightClusterBuilder::Light> spot_lights;
+	read_lights(GL_StateManager::SSBO_BindingPoints::POINT_LIGHTS, 12, point_lights);
+	read_lights(GL_StateManager::SSBO_BindingPoints::SPOT_LIGHTS, 36, spot_lights);
+
+	LightClusterBuilder builder;
+	builder.Build(view, projection, znear, zfar, point_lights, spot_lights);
+	const auto& expected = builder.GetData();
+
+	std::vector<uint32_t> gpu_data;
+	ReadBoundBuffer(GL_SHADER_STORAGE_BUFFER_BINDING, GL_StateManager::SSBO_BindingPoints::LIGHT_CLUSTERS, gpu_data);
+	if (gpu_data.size() < expected.size()) {
+		ORNG_CORE_ERROR("Light cluster validation failed, cluster SSBO holds {0} values, expected {1}", gpu_data.size(), expected.size());
+		return 0;
+	}
+
+	const glm::mat4 inv_projection = glm::inverse(projection);
+
+	// Lights whose sphere is within float precision of just touching the bounds, the GPU and CPU can disagree on these
+	auto is_grazing = [&](const LightClusterBuilder::Light& light, glm::vec3 bounds_min, glm::vec3 bounds_max) {
+		const glm::vec3 centre = glm::vec3(view * glm::vec4(light.pos, 1.f));
+		const float distance = glm::length(glm::clamp(centre, bounds_min, bounds_max) - centre);
+		return glm::abs(distance - light.radius) <= 1e-3f * glm::max(light.radius, 1.f);
+	};
+
+	// True if every light only one side assigned is grazing the bounds
+	auto only_grazing_differ = [&](std::span<const uint32_t> gpu_indices, std::span<const uint32_t> cpu_indices, const std::vector<LightClusterBuilder::Light>& lights,
+		glm::vec3 bounds_min, glm::vec3 bounds_max) {
+		std::vector<uint32_t> gpu_sorted{ gpu_indices.begin(), gpu_indices.end() };
+		std::vector<uint32_t> cpu_sorted{ cpu_indices.begin(), cpu_indices.end() };
+		std::ranges::sort(gpu_sorted);
+		std::ranges::sort(cpu_sorted);
+
+		std::vector<uint32_t> differing;
+		std::ranges::set_symmetric_difference(gpu_sorted, cpu_sorted, std::back_inserter(differing));
+		return std::ranges::all_of(differing, [&](uint32_t idx) { return idx < lights.size() && is_grazing(lights[idx], bounds_min, bounds_max); });
+	};
+
+	// Slots past each cluster's counts are never written by the shader so only the counts and the indices before them are compared
+	unsigned num_mismatched = 0;
+	unsigned num_grazing = 0;
+	for (uint32_t cluster = 0; cluster < LightClusterBuilder::NUM_CLUSTERS; cluster++) {
+		const size_t base = cluster * LightClusterBuilder::CLUSTER_STRIDE;
+		const uint32_t num_lights = expected[base] + expected[base + 1];
+
+		bool matches = gpu_data[base] == expected[base] && gpu_data[base + 1] == expected[base + 1] &&
+			std::equal(expected.begin() + base + 2, expected.begin() + base + 2 + num_lights, gpu_data.begin() + base + 2);
+
+		if (matches)
+			continue;
+
+		const uint32_t gpu_points = gpu_data[base];
+		const uint32_t gpu_spots = gpu_data[base + 1];
+		if (gpu_points <= LightClusterBuilder::MAX_LIGHTS_PER_CLUSTER && gpu_spots <= LightClusterBuilder::MAX_LIGHTS_PER_CLUSTER - gpu_points) {
+			glm::vec3 bounds_min;
+			glm::vec3 bounds_max;
+			LightClusterBuilder::GetClusterBounds(cluster % LightClusterBuilder::NUM_X, (cluster / LightClusterBuilder::NUM_X) % LightClusterBuilder::NUM_Y,
+				cluster / (LightClusterBuilder::NUM_X * LightClusterBuilder::NUM_Y), inv_projection, znear, zfar, bounds_min, bounds_max);
+
+			std::span<const uint32_t> gpu_indices{ gpu_data.data() + base + 2, gpu_points + gpu_spots };
+			if (only_grazing_differ(gpu_indices.first(gpu_points), builder.GetPointLights(cluster), point_lights, bounds_min, bounds_max) &&
+				only_grazing_differ(gpu_indices.subspan(gpu_points), builder.GetSpotLights(cluster), spot_lights, bounds_min, bounds_max)) {
+				num_grazing++;
+				continue;
+			}
+		}
+
+		if (num_mismatched++ < 5)
+			ORNG_CORE_ERROR("Light cluster {0} differs, GPU: {1} point {2} spot, CPU: {3} point {4} spot", cluster, gpu_data[base], gpu_data[base + 1], expected[base], expected[base + 1]);
+	}
+
+	if (num_mismatched > 0)
+		ORNG_CORE_ERROR("{0}/{1} GPU light clusters differ from the CPU reference, {2} point lights, {3} spot lights", num_mismatched, LightClusterBuilder::NUM_CLUSTERS,
+			point_lights.size(), spot_lights.size());
+	else
+		ORNG_CORE_INFO("GPU light clusters match the CPU reference, {0} point lights, {1} spot lights", point_lights.size(), spot_lights.size());
+
+	if (num_grazing > 0)
+		ORNG_CORE_INFO("{0} clusters only differed by lights grazing their bounds", num_grazing);
+
+	return num_mismatched;
+}
+
 void LightingPass::DoPass() {
 	auto* p_output_tex = mp_graph->GetData<Texture2D>("OutCol");
 
@@ -89,6 +227,17 @@ void LightingPass::DoPass() {
 	GL_StateManager::BindTexture(GL_TEXTURE_CUBE_MAP_ARRAY, p_pointlight_depth_tex->GetTextureHandle(), GL_StateManager::TextureUnits::POINTLIGHT_DEPTH, false);
 	//GL_StateManager::BindTexture(GL_TEXTURE_2D, blue_noise_tex.GetTextureHandle(), GL_StateManager::TextureUnits::BLUE_NOISE, false);
 
+	// Rebuilt every frame as the lights and camera are read straight from the light SSBOs and matrix UBO
+	GL_StateManager::BindSSBO(light_cluster_ssbo.GetHandle(), GL_StateManager::SSBO_BindingPoints::LIGHT_CLUSTERS);
+	light_cluster_shader.ActivateProgram();
+	GL_StateManager::DispatchCompute(Groups(LightClusterBuilder::NUM_CLUSTERS, 64), 1, 1);
+	glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+	if (validate_light_clusters) {
+		validate_light_clusters = false;
+		ValidateLightClusters();
+	}
+
 	shader.ActivateProgram();
 
 	if (p_scene->HasSystem<EnvMapSystem>()) {
@@ -0,0 +1,218 @@
+#include "pch/pch.h"
+
+#include "scene/AsyncSceneLoader.h"
+#include "scene/Scene.h"
+#include "scene/SceneEntity.h"
+#include "scene/SceneSerializer.h"
+#include "scene/SerializationUtil.h"
+#include "assets/SceneAsset.h"
+#include "assets/AssetManager.h"
+#include "util/TimeStep.h"
+#include "util/Timers.h"
+
+using namespace ORNG;
+
+AsyncSceneLoader::AsyncSceneLoader(Scene& scene, const SceneAsset& scene_asset, Callback on_complete) : m_scene(scene), m_on_complete(std::move(on_complete)) {
+	// The worker gets its own copy of the data, copies of a YAML::Node share the original's memory and looking up a missing key allocates in it,
+	// so handing the worker the asset's node would race with anything reading it on the main thread
+	if (!scene_asset.binary_data.empty()) {
+		m_parse_future = std::async(std::launch::async, [data = scene_asset.binary_data]() mutable {
+			return ParseBinary(std::move(data));
+			});
+	}
+	else {
+		m_parse_future = std::async(std::launch::async, [data = YAML::Clone(scene_asset.node)]() mutable {
+			return Parse(std::move(data));
+			});
+	}
+}
+
+AsyncSceneLoader::AsyncSceneLoader(Scene& scene, const std::string& filepath, Callback on_complete) : m_scene(scene), m_on_complete(std::move(on_complete)) {
+	m_parse_future = std::async(std::launch::async, [filepath] {
+		std::stringstream str_stream;
+		std::ifstream stream(filepath);
+		str_stream << stream.rdbuf();
+
+		try {
+			return Parse(YAML::Load(str_stream.str()));
+		}
+		catch (const YAML::Exception& e) {
+			ORNG_CORE_ERROR("Failed parsing scene file '{0}', '{1}'", filepath, e.what());
+			return ParsedScene{};
+		}
+		});
+}
+
+AsyncSceneLoader::ParsedScene AsyncSceneLoader::Parse(YAML::Node data) {
+	ParsedScene parsed;
+	if (!data.IsDefined() || data.IsNull() || !data["Scene"])
+		return parsed;
+
+	const auto& entities = data["Entities"];
+	parsed.entity_nodes.reserve(entities.size());
+	parsed.entity_uuids.reserve(entities.size());
+	parsed.entity_names.reserve(entities.size());
+
+	for (const auto& entity_node : entities) {
+		parsed.entity_nodes.push_back(entity_node);
+		parsed.entity_uuids.push_back(entity_node["Entity"].as<uint64_t>());
+		parsed.entity_names.push_back(entity_node["Name"].as<std::string>());
+	}
+
+	parsed.data = std::move(data);
+	parsed.valid = true;
+	return parsed;
+}
+
+AsyncSceneLoader::ParsedScene AsyncSceneLoader::ParseBinary(std::vector<std::byte> data) {
+	ParsedScene parsed;
+	if (!BinarySceneSerializer::Decode(data, parsed.decoded) || parsed.decoded.type != BinarySceneSerializer::ContentType::SCENE)
+		return parsed;
+
+	parsed.entity_uuids.reserve(parsed.decoded.entities.size());
+	parsed.entity_names.reserve(parsed.decoded.entities.size());
+
+	for (const auto& record : parsed.decoded.entities) {
+		parsed.entity_uuids.push_back(record.uuid);
+		parsed.entity_names.push_back(record.name);
+	}
+
+	parsed.binary_data = std::move(data);
+	parsed.is_binary = true;
+	parsed.valid = true;
+	return parsed;
+}
+
+void AsyncSceneLoader::BeginInstantiation() {
+	std::string scene_name = m_parsed.is_binary ? m_parsed.decoded.name : m_parsed.data["Scene"].as<std::string>();
+	ORNG_CORE_TRACE("Instantiating scene '{0}'", scene_name);
+
+	m_scene.m_name = scene_name;
+	m_scene.m_asset_uuid = UUID<uint64_t>{ m_parsed.is_binary ? m_parsed.decoded.uuid : m_parsed.data["SceneUUID"].as<uint64_t>() };
+
+	m_num_previous_entities = m_scene.m_entities.size();
+	m_stage = Stage::CLEARING_PREVIOUS;
+	m_cursor = 0;
+}
+
+bool AsyncSceneLoader::Update(float budget_ms) {
+	ORNG_PROFILE_FUNC();
+
+	if (m_stage == Stage::FINISHED || m_stage == Stage::FAILED)
+		return true;
+
+	if (m_stage == Stage::PARSING) {
+		if (m_parse_future.wait_for(std::chrono::nanoseconds(1)) != std::future_status::ready)
+			return false;
+
+		m_parsed = m_parse_future.get();
+		if (!m_parsed.valid) {
+			ORNG_CORE_ERROR("Async scene load failed, scene data is invalid");
+			m_stage = Stage::FAILED;
+			return true;
+		}
+
+		BeginInstantiation();
+	}
+
+	TimeStep time{ TimeStep::TimeUnits::MICROSECONDS };
+	const auto budget_us = static_cast<long long>(budget_ms * 1000.f);
+	const size_t num_entities = m_parsed.entity_uuids.size();
+
+	// At least one unit of work is done per update so the load always progresses, even with a tiny budget
+	do {
+		switch (m_stage) {
+		case Stage::CLEARING_PREVIOUS:
+			if (m_scene.m_entities.empty()) {
+				m_stage = Stage::CREATING_ENTITIES;
+				break;
+			}
+
+			// Deletes children too, so this may remove several entities at once
+			m_scene.DeleteEntity(m_scene.m_entities.back());
+			break;
+		case Stage::CREATING_ENTITIES:
+			// Entities are all created before any are deserialized so they can be linked as parent/children
+			if (m_cursor == num_entities) {
+				m_stage = Stage::DESERIALIZING_ENTITIES;
+				m_cursor = 0;
+				break;
+			}
+
+			m_scene.CreateEntity(m_parsed.entity_names[m_cursor], m_parsed.entity_uuids[m_cursor]);
+			m_cursor++;
+			break;
+		case Stage::DESERIALIZING_ENTITIES:
+			if (m_cursor == num_entities) {
+				m_stage = Stage::RESOLVING_REFERENCES;
+				m_cursor = 0;
+				break;
+			}
+
+			if (auto* p_entity = m_scene.GetEntity(m_parsed.entity_uuids[m_cursor])) {
+				if (m_parsed.is_binary)
+					BinarySceneSerializer::DeserializeEntity(m_scene, m_parsed.binary_data, m_parsed.decoded, m_parsed.decoded.entities[m_cursor], *p_entity);
+				else
+					SceneSerializer::DeserializeEntity(m_scene, m_parsed.entity_nodes[m_cursor], *p_entity);
+			}
+
+			m_cursor++;
+			break;
+		case Stage::RESOLVING_REFERENCES:
+			// Resolve/connect any node refs now scene tree is fully built
+			if (m_cursor == num_entities) {
+				if (m_parsed.is_binary)
+					BinarySceneSerializer::DeserializeSceneSettings(m_scene, m_parsed.binary_data, m_parsed.decoded);
+				else
+					SceneSerializer::DeserializeSceneSettings(m_scene, m_parsed.data);
+
+				// The outgoing scene's entities are gone and the new ones hold handles to everything they use,
+				// so anything unreferenced now was only used by the previous scene
+				if (m_scene.unload_unreferenced_assets_on_load)
+					AssetManager::UnloadUnreferencedAssets();
+
+				m_stage = Stage::FINISHED;
+				return true;
+			}
+
+			if (auto* p_entity = m_scene.GetEntity(m_parsed.entity_uuids[m_cursor]))
+				Events::EventManager::DispatchEvent(EntitySerializationEvent{ p_entity });
+
+			m_cursor++;
+			break;
+		default:
+			return true;
+		}
+	} while (time.GetTimeInterval() < budget_us);
+
+	return false;
+}
+
+void AsyncSceneLoader::InvokeCallback() {
+	if (m_on_complete)
+		m_on_complete(m_scene, m_stage == Stage::FINISHED);
+}
+
+float AsyncSceneLoader::GetProgress() const noexcept {
+	switch (m_stage) {
+	case Stage::PARSING:
+	case Stage::FAILED:
+		return 0.f;
+	case Stage::FINISHED:
+		return 1.f;
+	default:
+		break;
+	}
+
+	const size_t num_entities = m_parsed.entity_uuids.size();
+	// Clearing, then three passes over the new entities, then the scene settings
+	const size_t total = m_num_previous_entities + num_entities * 3 + 1;
+
+	size_t done = 0;
+	if (m_stage == Stage::CLEARING_PREVIOUS)
+		done = m_num_previous_entities - glm::min(m_scene.m_entities.size(), m_num_previous_entities);
+	else
+		done = m_num_previous_entities + (static_cast<size_t>(m_stage) - static_cast<size_t>(Stage::CREATING_ENTITIES)) * num_entities + m_cursor;
+
+	return static_cast<float>(done) / static_cast<float>(total);
+}
@@ -0,0 +1,1452 @@
+#include "pch/pch.h"
+
+#include "scene/BinarySceneSerializer.h"
+#include "scene/PrefabTemplate.h"
+#include "scene/SceneSerializer.h"
+#include "scene/SerializationUtil.h"
+#include "scene/Scene.h"
+#include "scene/SceneEntity.h"
+#include "assets/AssetSerializer.h"
+#include "assets/AssetManager.h"
+#include "assets/Prefab.h"
+#include "components/ComponentAPI.h"
+#include "util/InterpolatorSerializer.h"
+
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Weverything"
+#endif
+#include <bitsery/traits/string.h>
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif
+
+using namespace ORNG;
+
+using ChunkID = BinarySceneSerializer::ChunkID;
+
+constexpr size_t MAX_EXTENSION_YAML_SIZE = 100'000'000;
+constexpr size_t MAX_CHUNK_ELEMENTS = 10'000;
+
+// Plain data for each chunk type, shared by the live-scene path and the YAML converter
+// Fields are written in the same units as the YAML, so conversions between the two are exact
+// Bump VERSION when a layout changes and handle older versions in the chunk readers
+namespace {
+	struct TransformData {
+		static constexpr uint16_t VERSION = 1;
+
+		glm::vec3 pos{ 0 };
+		glm::vec3 scale{ 1 };
+		// Euler angles in degrees
+		glm::vec3 orientation{ 0 };
+		bool absolute = false;
+
+		template<typename S>
+		void serialize(S& s) {
+			s.object(pos);
+			s.object(scale);
+			s.object(orientation);
+			s.value1b(absolute);
+		}
+
+		void FromYAML(const YAML::Node& node) {
+			pos = node["Pos"].as<glm::vec3>();
+			scale = node["Scale"].as<glm::vec3>();
+			orientation = node["Orientation"].as<glm::vec3>();
+			absolute = node["Absolute"].as<bool>();
+		}
+
+		void ToYAML(YAML::Emitter& out) const {
+			out << YAML::Key << "TransformComp" << YAML::BeginMap;
+			Out(out, "Pos", pos);
+			Out(out, "Scale", scale);
+			Out(out, "Orientation", orientation);
+			Out(out, "Absolute", absolute);
+			out << YAML::EndMap;
+		}
+	};
+
+	struct MeshData {
+		static constexpr uint16_t VERSION = 1;
+
+		uint64_t mesh_uuid = 0;
+		std::vector<uint64_t> material_uuids;
+
+		template<typename S>
+		void serialize(S& s) {
+			s.value8b(mesh_uuid);
+			s.container8b(material_uuids, MAX_CHUNK_ELEMENTS);
+		}
+
+		void FromYAML(const YAML::Node& node) {
+			mesh_uuid = node["MeshAssetID"].as<uint64_t>();
+			material_uuids = node["Materials"].as<std::vector<uint64_t>>();
+		}
+
+		void ToYAML(YAML::Emitter& out) const {
+			out << YAML::Key << "MeshComp" << YAML::BeginMap;
+			Out(out, "MeshAssetID", mesh_uuid);
+			out << YAML::Key << "Materials" << YAML::Value << YAML::Flow << YAML::BeginSeq;
+			for (auto uuid : material_uuids) {
+				out << uuid;
+			}
+			out << YAML::EndSeq;
+			out << YAML::EndMap;
+		}
+	};
+
+	struct LightData {
+		static constexpr uint16_t VERSION = 1;
+
+		glm::vec3 colour{ 1 };
+		float atten_constant = 1.f;
+		float atten_linear = 0.f;
+		float atten_exp = 0.f;
+		// Only used by spotlights
+		float aperture = 0.f;
+		bool shadows = false;
+		float shadow_distance = 0.f;
+
+		template<typename S>
+		void serialize(S& s) {
+			s.object(colour);
+			s.value4b(atten_constant);
+			s.value4b(atten_linear);
+			s.value4b(atten_exp);
+			s.value4b(aperture);
+			s.value1b(shadows);
+			s.value4b(shadow_distance);
+		}
+
+		void FromYAML(const YAML::Node& node, bool spotlight) {
+			colour = node["Colour"].as<glm::vec3>();
+			atten_constant = node["AttenConstant"].as<float>();
+			atten_linear = node["AttenLinear"].as<float>();
+			atten_exp = node["AttenExp"].as<float>();
+			if (spotlight) aperture = node["Aperture"].as<float>();
+			shadows = node["Shadows"].as<bool>();
+			shadow_distance = node["ShadowDistance"].as<float>();
+		}
+
+		void ToYAML(YAML::Emitter& out, bool spotlight) const {
+			out << YAML::Key << (spotlight ? "SpotlightComp" : "PointlightComp") << YAML::BeginMap;
+			Out(out, "Colour", colour);
+			Out(out, "AttenConstant", atten_constant);
+			Out(out, "AttenLinear", atten_linear);
+			Out(out, "AttenExp", atten_exp);
+			if (spotlight) Out(out, "Aperture", aperture);
+			Out(out, "Shadows", shadows);
+			Out(out, "ShadowDistance", shadow_distance);
+			out << YAML::EndMap;
+		}
+	};
+
+	struct CameraData {
+		static constexpr uint16_t VERSION = 1;
+
+		float z_near = 0.f;
+		float z_far = 0.f;
+		float fov = 0.f;
+		float exposure = 0.f;
+
+		template<typename S>
+		void serialize(S& s) {
+			s.value4b(z_near);
+			s.value4b(z_far);
+			s.value4b(fov);
+			s.value4b(exposure);
+		}
+
+		void FromYAML(const YAML::Node& node) {
+			z_near = node["zNear"].as<float>();
+			z_far = node["zFar"].as<float>();
+			fov = node["FOV"].as<float>();
+			exposure = node["Exposure"].as<float>();
+		}
+
+		void ToYAML(YAML::Emitter& out) const {
+			out << YAML::Key << "CameraComp" << YAML::BeginMap;
+			Out(out, "zNear", z_near);
+			Out(out, "zFar", z_far);
+			Out(out, "FOV", fov);
+			Out(out, "Exposure", exposure);
+			out << YAML::EndMap;
+		}
+	};
+
+	struct ScriptData {
+		static constexpr uint16_t VERSION = 1;
+
+		uint64_t script_uuid = 0;
+
+		template<typename S>
+		void serialize(S& s) {
+			s.value8b(script_uuid);
+		}
+
+		void FromYAML(const YAML::Node& node) {
+			script_uuid = node["ScriptUUID"].as<uint64_t>();
+		}
+
+		void ToYAML(YAML::Emitter& out) const {
+			out << YAML::Key << "ScriptComp" << YAML::BeginMap;
+			Out(out, "ScriptUUID", script_uuid);
+			out << YAML::EndMap;
+		}
+	};
+
+	struct AudioData {
+		static constexpr uint16_t VERSION = 1;
+
+		float volume = 1.f;
+		float pitch = 1.f;
+		uint64_t sound_uuid = 0;
+		float min_range = 0.f;
+		float max_range = 0.f;
+
+		template<typename S>
+		void serialize(S& s) {
+			s.value4b(volume);
+			s.value4b(pitch);
+			s.value8b(sound_uuid);
+			s.value4b(min_range);
+			s.value4b(max_range);
+		}
+
+		void FromYAML(const YAML::Node& node) {
+			volume = node["Volume"].as<float>();
+			pitch = node["Pitch"].as<float>();
+			sound_uuid = node["AudioUUID"].as<uint64_t>();
+			min_range = node["MinRange"].as<float>();
+			max_range = node["MaxRange"].as<float>();
+		}
+
+		void ToYAML(YAML::Emitter& out) const {
+			out << YAML::Key << "AudioComp" << YAML::BeginMap;
+			Out(out, "Volume", volume);
+			Out(out, "Pitch", pitch);
+			Out(out, "AudioUUID", sound_uuid);
+			Out(out, "MinRange", min_range);
+			Out(out, "MaxRange", max_range);
+			out << YAML::EndMap;
+		}
+	};
+
+	template<typename PointType>
+	struct InterpolatorData {
+		std::vector<PointType> points;
+		float scale = 1.f;
+
+		template<typename S>
+		void serialize(S& s) {
+			s.container(points, MAX_CHUNK_ELEMENTS);
+			s.value4b(scale);
+		}
+
+		void FromYAML(const YAML::Node& node) {
+			points.clear();
+			for (auto point : node["Points"]) {
+				points.push_back(point.as<PointType>());
+			}
+			scale = node["Scale"].as<float>();
+		}
+
+		void ToYAML(YAML::Emitter& out, const std::string& name) const {
+			out << YAML::Key << name << YAML::Value << YAML::BeginMap;
+			out << YAML::Key << "Points" << YAML::Value << YAML::BeginSeq;
+			for (auto point : points) {
+				out << point;
+			}
+			out << YAML::EndSeq;
+			Out(out, "Scale", scale);
+			out << YAML::EndMap;
+		}
+	};
+
+	struct ParticleEmitterData {
+		static constexpr uint16_t VERSION = 1;
+
+		float spread = 0.f;
+		glm::vec3 spawn_extents{ 0 };
+		glm::vec2 velocity_range{ 0 };
+		uint32_t num_particles = 0;
+		float lifespan = 0.f;
+		float spawn_delay = 0.f;
+		uint32_t type = 0;
+		glm::vec3 acceleration{ 0 };
+		bool active = true;
+
+		InterpolatorData<glm::vec4> colour_interpolator;
+		InterpolatorData<glm::vec2> alpha_interpolator;
+		InterpolatorData<glm::vec4> scale_interpolator;
+
+		// Billboard emitters
+		uint64_t material_uuid = 0;
+
+		// Mesh emitters
+		uint64_t mesh_uuid = 0;
+		std::vector<uint64_t> material_uuids;
+
+		template<typename S>
+		void serialize(S& s) {
+			s.value4b(spread);
+			s.object(spawn_extents);
+			s.object(velocity_range);
+			s.value4b(num_particles);
+			s.value4b(lifespan);
+			s.value4b(spawn_delay);
+			s.value4b(type);
+			s.object(acceleration);
+			s.value1b(active);
+			s.object(colour_interpolator);
+			s.object(alpha_interpolator);
+			s.object(scale_interpolator);
+
+			if (type == ParticleEmitterComponent::BILLBOARD) {
+				s.value8b(material_uuid);
+			}
+			else {
+				s.value8b(mesh_uuid);
+				s.container8b(material_uuids, MAX_CHUNK_ELEMENTS);
+			}
+		}
+
+		void FromYAML(const YAML::Node& node) {
+			spread = node["Spread"].as<float>();
+			spawn_extents = node["Spawn extents"].as<glm::vec3>();
+			velocity_range = node["Velocity range"].as<glm::vec2>();
+			num_particles = node["Nb. particles"].as<uint32_t>();
+			lifespan = node["Lifespan"].as<float>();
+			spawn_delay = node["Spawn delay"].as<float>();
+			type = node["Type"].as<uint32_t>();
+			acceleration = node["Acceleration"].as<glm::vec3>();
+			active = node["Active"].as<bool>();
+
+			colour_interpolator.FromYAML(node["Colour over time"]);
+			alpha_interpolator.FromYAML(node["Alpha over time"]);
+			scale_interpolator.FromYAML(node["Scale over time"]);
+
+			if (type == ParticleEmitterComponent::BILLBOARD) {
+				material_uuid = node["MaterialUUID"].as<uint64_t>();
+			}
+			else {
+				mesh_uuid = node["MeshUUID"].as<uint64_t>();
+				material_uuids = node["Materials"].as<std::vector<uint64_t>>();
+			}
+		}
+
+		void ToYAML(YAML::Emitter& out) const {
+			out << YAML::Key << "ParticleEmitterComp" << YAML::BeginMap;
+			Out(out, "Spread", spread);
+			Out(out, "Spawn extents", spawn_extents);
+			Out(out, "Velocity range", velocity_range);
+			Out(out, "Nb. particles", num_particles);
+			Out(out, "Lifespan", lifespan);
+			Out(out, "Spawn delay", spawn_delay);
+			Out(out, "Type", type);
+			Out(out, "Acceleration", acceleration);
+			Out(out, "Active", active);
+
+			colour_interpolator.ToYAML(out, "Colour over time");
+			alpha_interpolator.ToYAML(out, "Alpha over time");
+			scale_interpolator.ToYAML(out, "Scale over time");
+
+			if (type == ParticleEmitterComponent::BILLBOARD) {
+				Out(out, "MaterialUUID", material_uuid);
+			}
+			else {
+				Out(out, "MeshUUID", mesh_uuid);
+				out << YAML::Key << "Materials" << YAML::Value << YAML::Flow << YAML::BeginSeq;
+				for (auto uuid : material_uuids) {
+					out << uuid;
+				}
+				out << YAML::EndSeq;
+			}
+
+			out << YAML::EndMap;
+		}
+	};
+
+	struct ParticleBufferData {
+		static constexpr uint16_t VERSION = 1;
+
+		uint32_t buffer_id = 0;
+		uint32_t min_allocated_particles = 0;
+
+		template<typename S>
+		void serialize(S& s) {
+			s.value4b(buffer_id);
+			s.value4b(min_allocated_particles);
+		}
+
+		void FromYAML(const YAML::Node& node) {
+			buffer_id = node["BufferID"].as<uint32_t>();
+			min_allocated_particles = node["Min allocated particles"].as<uint32_t>();
+		}
+
+		void ToYAML(YAML::Emitter& out) const {
+			out << YAML::Key << "ParticleBufferComp" << YAML::BeginMap;
+			Out(out, "BufferID", buffer_id);
+			Out(out, "Min allocated particles", min_allocated_particles);
+			out << YAML::EndMap;
+		}
+	};
+
+	struct SceneSettingsData {
+		static constexpr uint16_t VERSION = 1;
+
+		bool shadows = true;
+		glm::vec3 light_colour{ 1 };
+		glm::vec3 light_direction{ 0, 1, 0 };
+		glm::vec3 cascade_ranges{ 0 };
+		glm::vec3 z_mults{ 0 };
+
+		float fog_density = 0.f;
+		float fog_absorption = 0.f;
+		float fog_scattering = 0.f;
+		float fog_anisotropy = 0.f;
+		glm::vec3 fog_colour{ 1 };
+		int32_t fog_steps = 0;
+		float fog_emission = 0.f;
+
+		float bloom_intensity = 0.f;
+		float bloom_knee = 0.f;
+		float bloom_threshold = 0.f;
+
+		template<typename S>
+		void serialize(S& s) {
+			s.value1b(shadows);
+			s.object(light_colour);
+			s.object(light_direction);
+			s.object(cascade_ranges);
+			s.object(z_mults);
+
+			s.value4b(fog_density);
+			s.value4b(fog_absorption);
+			s.value4b(fog_scattering);
+			s.value4b(fog_anisotropy);
+			s.object(fog_colour);
+			s.value4b(fog_steps);
+			s.value4b(fog_emission);
+
+			s.value4b(bloom_intensity);
+			s.value4b(bloom_knee);
+			s.value4b(bloom_threshold);
+		}
+
+		void FromScene(Scene& scene) {
+			const auto& light = scene.directional_light;
+			shadows = light.shadows_enabled;
+			light_colour = light.colour;
+			light_direction = light.GetLightDirection();
+			cascade_ranges = { light.cascade_ranges[0], light.cascade_ranges[1], light.cascade_ranges[2] };
+			z_mults = { light.z_mults[0], light.z_mults[1], light.z_mults[2] };
+
+			const auto& fog = scene.post_processing.global_fog;
+			fog_density = fog.density_coef;
+			fog_absorption = fog.absorption_coef;
+			fog_scattering = fog.scattering_coef;
+			fog_anisotropy = fog.scattering_anisotropy;
+			fog_colour = fog.colour;
+			fog_steps = fog.step_count;
+			fog_emission = fog.emissive_factor;
+
+			const auto& bloom = scene.post_processing.bloom;
+			bloom_intensity = bloom.intensity;
+			bloom_knee = bloom.knee;
+			bloom_threshold = bloom.threshold;
+		}
+
+		void ApplyToScene(Scene& scene) const {
+			auto& light = scene.directional_light;
+			light.shadows_enabled = shadows;
+			light.colour = light_colour;
+			light.SetLightDirection(light_direction);
+			light.cascade_ranges = std::array<float, 3>{cascade_ranges.x, cascade_ranges.y, cascade_ranges.z};
+			light.z_mults = std::array<float, 3>{z_mults.x, z_mults.y, z_mults.z};
+
+			auto& fog = scene.post_processing.global_fog;
+			fog.density_coef = fog_density;
+			fog.absorption_coef = fog_absorption;
+			fog.scattering_coef = fog_scattering;
+			fog.scattering_anisotropy = fog_anisotropy;
+			fog.colour = fog_colour;
+			fog.step_count = fog_steps;
+			fog.emissive_factor = fog_emission;
+
+			auto& bloom = scene.post_processing.bloom;
+			bloom.intensity = bloom_intensity;
+			bloom.knee = bloom_knee;
+			bloom.threshold = bloom_threshold;
+		}
+
+		void FromYAML(const YAML::Node& node) {
+			const auto& dir_light = node["DirLight"];
+			shadows = dir_light["Shadows"].as<bool>();
+			light_colour = dir_light["Colour"].as<glm::vec3>();
+			light_direction = dir_light["Direction"].as<glm::vec3>();
+			cascade_ranges = dir_light["CascadeRanges"].as<glm::vec3>();
+			z_mults = dir_light["Zmults"].as<glm::vec3>();
+
+			const auto& fog = node["Fog"];
+			fog_density = fog["Density"].as<float>();
+			fog_absorption = fog["Absorption"].as<float>();
+			fog_scattering = fog["Scattering"].as<float>();
+			fog_anisotropy = fog["Anisotropy"].as<float>();
+			fog_colour = fog["Colour"].as<glm::vec3>();
+			fog_steps = fog["Steps"].as<int>();
+			fog_emission = fog["Emission"].as<float>();
+
+			const auto& bloom = node["Bloom"];
+			bloom_intensity = bloom["Intensity"].as<float>();
+			bloom_knee = bloom["Knee"].as<float>();
+			bloom_threshold = bloom["Threshold"].as<float>();
+		}
+
+		// Same layout as SceneSerializer::SerializeScene
+		void ToYAML(YAML::Emitter& out) const {
+			out << YAML::Key << "DirLight" << YAML::BeginMap;
+			Out(out, "Shadows", shadows);
+			Out(out, "Colour", light_colour);
+			Out(out, "Direction", light_direction);
+			Out(out, "CascadeRanges", cascade_ranges);
+			Out(out, "Zmults", z_mults);
+			out << YAML::EndMap;
+
+			out << YAML::Key << "Fog" << YAML::BeginMap;
+			Out(out, "Density", fog_density);
+			Out(out, "Absorption", fog_absorption);
+			Out(out, "Scattering", fog_scattering);
+			Out(out, "Anisotropy", fog_anisotropy);
+			Out(out, "Colour", fog_colour);
+			Out(out, "Steps", fog_steps);
+			Out(out, "Emission", fog_emission);
+			out << YAML::EndMap;
+
+			out << YAML::Key << "Bloom" << YAML::BeginMap;
+			Out(out, "Intensity", bloom_intensity);
+			Out(out, "Knee", bloom_knee);
+			Out(out, "Threshold", bloom_threshold);
+			out << YAML::EndMap;
+		}
+	};
+
+	struct ExtensionData {
+		static constexpr uint16_t VERSION = 1;
+
+		// YAML map of extension keys
+		std::string yaml;
+
+		template<typename S>
+		void serialize(S& s) {
+			s.text1b(yaml, MAX_EXTENSION_YAML_SIZE);
+		}
+	};
+
+	// Keys of an entity node that are part of the record rather than a chunk
+	bool IsEntityRecordKey(const std::string& key) {
+		return key == "Entity" || key == "Name" || key == "ParentID";
+	}
+
+	// Keys of a scene node that are stored outside of the scene extension chunk
+	bool IsSceneKey(const std::string& key) {
+		return key == "Scene" || key == "SceneUUID" || key == "Entities" || key == "DirLight" || key == "Fog" || key == "Bloom";
+	}
+
+	// Empty YAML maps are emitted as "{}", which isn't worth storing
+	bool IsEmptyYAMLMap(const YAML::Emitter& out) {
+		return std::string_view{ out.c_str() } == "{}";
+	}
+
+	template<typename T>
+	bool ReadChunk(const BinarySceneSerializer::ChunkRef& chunk, const std::vector<std::byte>& data, T& output) {
+		if (chunk.version > T::VERSION) {
+			ORNG_CORE_ERROR("Binary scene chunk '{0}' has version {1}, newer than the supported version {2}", static_cast<unsigned>(chunk.id), chunk.version, T::VERSION);
+			return false;
+		}
+
+		// Only version 1 exists so far, older versions would be migrated here
+		BufferDeserializer des{ data.begin() + chunk.offset, data.begin() + chunk.offset + chunk.size };
+		des.object(output);
+
+		if (des.adapter().error() != bitsery::ReaderError::NoError) {
+			ORNG_CORE_ERROR("Binary scene chunk '{0}' is corrupt", static_cast<unsigned>(chunk.id));
+			return false;
+		}
+
+		return true;
+	}
+}
+
+// Chunks are written with a placeholder size which is patched once the payload is written, so no intermediate buffers are needed
+struct BinarySceneSerializer::ChunkWriter {
+	explicit ChunkWriter(std::vector<std::byte>& output) : ser(output) {}
+
+	void BeginRecord(uint64_t uuid, uint64_t parent_uuid, std::string& name) {
+		ser.value8b(uuid);
+		ser.value8b(parent_uuid);
+		ser.text1b(name, ORNG_MAX_NAME_SIZE);
+		BeginChunkList();
+	}
+
+	void BeginChunkList() {
+		chunk_count_pos = ser.adapter().currentWritePos();
+		num_chunks = 0;
+		ser.value2b(num_chunks);
+	}
+
+	void EndChunkList() {
+		Patch(chunk_count_pos, [&] { ser.value2b(num_chunks); });
+	}
+
+	template<typename T>
+	void WriteChunk(ChunkID id, T& data) {
+		ser.value2b(static_cast<uint16_t>(id));
+		ser.value2b(T::VERSION);
+
+		size_t size_pos = ser.adapter().currentWritePos();
+		ser.value4b(uint32_t{ 0 });
+
+		size_t payload_pos = ser.adapter().currentWritePos();
+		ser.object(data);
+		auto size = static_cast<uint32_t>(ser.adapter().currentWritePos() - payload_pos);
+
+		Patch(size_pos, [&] { ser.value4b(size); });
+		num_chunks++;
+	}
+
+	template<typename F>
+	void Patch(size_t pos, F write_func) {
+		size_t end = ser.adapter().currentWritePos();
+		ser.adapter().currentWritePos(pos);
+		write_func();
+		ser.adapter().currentWritePos(end);
+	}
+
+	void WriteHeader(ContentType type) {
+		ser.value4b(MAGIC);
+		ser.value2b(FORMAT_VERSION);
+		ser.value1b(static_cast<uint8_t>(type));
+	}
+
+	// Trims the output to what was actually written
+	void Finish(std::vector<std::byte>& output) {
+		ser.adapter().flush();
+		output.resize(ser.adapter().writtenBytesCount());
+	}
+
+	BufferSerializer ser;
+	size_t chunk_count_pos = 0;
+	uint16_t num_chunks = 0;
+};
+
+bool BinarySceneSerializer::IsBinaryScene(const std::vector<std::byte>& data) {
+	uint32_t magic = 0;
+	if (data.size() < sizeof(magic))
+		return false;
+
+	BufferDeserializer des{ data.begin(), data.end() };
+	des.value4b(magic);
+	return magic == MAGIC;
+}
+
+namespace {
+	bool ReadHeaderFields(BufferDeserializer& des, BinarySceneSerializer::ContentType& type, std::string& name, uint64_t& uuid) {
+		uint32_t magic = 0;
+		uint16_t version = 0;
+		uint8_t content_type = 0;
+		des.value4b(magic);
+		des.value2b(version);
+		des.value1b(content_type);
+
+		if (magic != BinarySceneSerializer::MAGIC || des.adapter().error() != bitsery::ReaderError::NoError) {
+			ORNG_CORE_ERROR("Data is not a binary scene");
+			return false;
+		}
+
+		if (version > BinarySceneSerializer::FORMAT_VERSION) {
+			ORNG_CORE_ERROR("Binary scene format version {0} is newer than the supported version {1}", version, BinarySceneSerializer::FORMAT_VERSION);
+			return false;
+		}
+
+		type = static_cast<BinarySceneSerializer::ContentType>(content_type);
+		if (type == BinarySceneSerializer::ContentType::SCENE) {
+			des.text1b(name, ORNG_MAX_NAME_SIZE);
+			des.value8b(uuid);
+		}
+
+		return des.adapter().error() == bitsery::ReaderError::NoError;
+	}
+}
+
+bool BinarySceneSerializer::ReadHeader(const std::vector<std::byte>& data, ContentType& type, std::string& name, uint64_t& uuid) {
+	BufferDeserializer des{ data.begin(), data.end() };
+	return ReadHeaderFields(des, type, name, uuid);
+}
+
+bool BinarySceneSerializer::Decode(const std::vector<std::byte>& data, DecodedScene& output) {
+	BufferDeserializer des{ data.begin(), data.end() };
+	if (!ReadHeaderFields(des, output.type, output.name, output.uuid))
+		return false;
+
+	const auto ReadChunkList = [&](std::vector<ChunkRef>& chunks) -> bool {
+		uint16_t num_chunks = 0;
+		des.value2b(num_chunks);
+
+		for (uint16_t i = 0; i < num_chunks; i++) {
+			ChunkRef& chunk = chunks.emplace_back();
+			uint16_t id = 0;
+			des.value2b(id);
+			des.value2b(chunk.version);
+			des.value4b(chunk.size);
+			chunk.id = static_cast<ChunkID>(id);
+			chunk.offset = static_cast<uint32_t>(des.adapter().currentReadPos());
+
+			if (des.adapter().error() != bitsery::ReaderError::NoError || static_cast<size_t>(chunk.offset) + chunk.size > data.size())
+				return false;
+
+			des.adapter().currentReadPos(static_cast<size_t>(chunk.offset) + chunk.size);
+		}
+
+		return true;
+	};
+
+	if (output.type == ContentType::SCENE && !ReadChunkList(output.scene_chunks)) {
+		ORNG_CORE_ERROR("Binary scene '{0}' is corrupt", output.name);
+		return false;
+	}
+
+	uint32_t num_entities = 0;
+	des.value4b(num_entities);
+	output.entities.reserve(num_entities);
+
+	for (uint32_t i = 0; i < num_entities; i++) {
+		EntityRecord& record = output.entities.emplace_back();
+		des.value8b(record.uuid);
+		des.value8b(record.parent_uuid);
+		des.text1b(record.name, ORNG_MAX_NAME_SIZE);
+
+		record.first_chunk = static_cast<uint32_t>(output.chunks.size());
+		if (!ReadChunkList(output.chunks)) {
+			ORNG_CORE_ERROR("Binary scene '{0}' is corrupt", output.name);
+			return false;
+		}
+
+		record.num_chunks = static_cast<uint32_t>(output.chunks.size()) - record.first_chunk;
+	}
+
+	return des.adapter().error() == bitsery::ReaderError::NoError;
+}
+
+void BinarySceneSerializer::CollectAssetDependencies(const std::vector<std::byte>& data, const DecodedScene& decoded, std::vector<uint64_t>& output) {
+	std::unordered_set<uint64_t> seen{ output.begin(), output.end() };
+	const auto Add = [&](uint64_t uuid) {
+		if (uuid != 0 && seen.insert(uuid).second)
+			output.push_back(uuid);
+		};
+
+	for (const ChunkRef& chunk : decoded.chunks) {
+		switch (chunk.id) {
+		case ChunkID::MESH: {
+			MeshData d;
+			if (!ReadChunk(chunk, data, d))
+				break;
+
+			Add(d.mesh_uuid);
+			std::ranges::for_each(d.material_uuids, Add);
+			break;
+		}
+		case ChunkID::AUDIO: {
+			AudioData d;
+			if (ReadChunk(chunk, data, d))
+				Add(d.sound_uuid);
+			break;
+		}
+		case ChunkID::PARTICLE_EMITTER: {
+			ParticleEmitterData d;
+			if (!ReadChunk(chunk, data, d))
+				break;
+
+			Add(d.material_uuid);
+			Add(d.mesh_uuid);
+			std::ranges::for_each(d.material_uuids, Add);
+			break;
+		}
+		default:
+			break;
+		}
+	}
+}
+
+void BinarySceneSerializer::WriteEntity(SceneEntity& entity, ChunkWriter& writer) {
+	auto* p_parent = entity.GetScene()->GetEntity(entity.GetParent());
+	writer.BeginRecord(entity.GetUUID(), p_parent ? p_parent->GetUUID() : 0, entity.GetName());
+
+	{
+		const auto* p_transform = entity.GetComponent<TransformComponent>();
+		TransformData data{ p_transform->GetPosition(), p_transform->GetScale(), p_transform->GetOrientation(), p_transform->m_is_absolute };
+		writer.WriteChunk(ChunkID::TRANSFORM, data);
+	}
+
+	if (auto* p_mesh_comp = entity.GetComponent<MeshComponent>()) {
+		MeshData data{ p_mesh_comp->GetMeshData()->uuid() };
+		for (const Material* p_material : p_mesh_comp->GetMaterials()) {
+			data.material_uuids.push_back(p_material->uuid());
+		}
+		writer.WriteChunk(ChunkID::MESH, data);
+	}
+
+	if (auto* p_pointlight = entity.GetComponent<PointLightComponent>()) {
+		LightData data{ p_pointlight->colour, p_pointlight->attenuation.constant, p_pointlight->attenuation.linear, p_pointlight->attenuation.exp,
+			0.f, p_pointlight->shadows_enabled, p_pointlight->shadow_distance };
+		writer.WriteChunk(ChunkID::POINTLIGHT, data);
+	}
+
+	if (auto* p_spotlight = entity.GetComponent<SpotLightComponent>()) {
+		LightData data{ p_spotlight->colour, p_spotlight->attenuation.constant, p_spotlight->attenuation.linear, p_spotlight->attenuation.exp,
+			p_spotlight->m_aperture, p_spotlight->shadows_enabled, p_spotlight->shadow_distance };
+		writer.WriteChunk(ChunkID::SPOTLIGHT, data);
+	}
+
+	if (auto* p_cam = entity.GetComponent<CameraComponent>()) {
+		CameraData data{ p_cam->zNear, p_cam->zFar, p_cam->fov, p_cam->exposure };
+		writer.WriteChunk(ChunkID::CAMERA, data);
+	}
+
+	if (const auto* p_script_comp = entity.GetComponent<ScriptComponent>()) {
+		ScriptData data{ p_script_comp->GetSymbols() ? p_script_comp->GetSymbols()->uuid : ScriptSymbols::INVALID_SCRIPT_UUID };
+		writer.WriteChunk(ChunkID::SCRIPT, data);
+	}
+
+	if (const auto* p_audio_comp = entity.GetComponent<AudioComponent>()) {
+		AudioData data{ p_audio_comp->m_volume, p_audio_comp->m_pitch, p_audio_comp->m_sound_asset_uuid, p_audio_comp->m_range.min, p_audio_comp->m_range.max };
+		writer.WriteChunk(ChunkID::AUDIO, data);
+	}
+
+	if (const auto* p_emitter = entity.GetComponent<ParticleEmitterComponent>()) {
+		ParticleEmitterData data;
+		data.spread = p_emitter->GetSpread();
+		data.spawn_extents = p_emitter->GetSpawnExtents();
+		data.velocity_range = p_emitter->GetVelocityScale();
+		data.num_particles = p_emitter->GetNbParticles();
+		data.lifespan = p_emitter->GetParticleLifespan();
+		data.spawn_delay = p_emitter->GetSpawnDelay();
+		data.type = static_cast<uint32_t>(p_emitter->GetType());
+		data.acceleration = p_emitter->GetAcceleration();
+		data.active = p_emitter->IsActive();
+
+		data.colour_interpolator = { p_emitter->m_life_colour_interpolator.points, p_emitter->m_life_colour_interpolator.scale };
+		data.alpha_interpolator = { p_emitter->m_life_alpha_interpolator.points, p_emitter->m_life_alpha_interpolator.scale };
+		data.scale_interpolator = { p_emitter->m_life_scale_interpolator.points, p_emitter->m_life_scale_interpolator.scale };
+
+		if (p_emitter->GetType() == ParticleEmitterComponent::BILLBOARD) {
+			data.material_uuid = entity.GetComponent<ParticleBillboardResources>()->p_material->uuid();
+		}
+		else {
+			auto* p_res = entity.GetComponent<ParticleMeshResources>();
+			data.mesh_uuid = p_res->p_mesh->uuid();
+			for (const Material* p_material : p_res->materials) {
+				data.material_uuids.push_back(p_material->uuid());
+			}
+		}
+
+		writer.WriteChunk(ChunkID::PARTICLE_EMITTER, data);
+	}
+
+	if (auto* p_buffer = entity.GetComponent<ParticleBufferComponent>()) {
+		ParticleBufferData data{ p_buffer->GetBufferID(), p_buffer->GetMinAllocatedParticles() };
+		writer.WriteChunk(ChunkID::PARTICLE_BUFFER, data);
+	}
+
+	// Components serialized by systems outside of the serializer
+	YAML::Emitter out;
+	out << YAML::BeginMap;
+	Events::EventManager::DispatchEvent(EntitySerializationEvent{ &entity, &out });
+	out << YAML::EndMap;
+
+	if (!IsEmptyYAMLMap(out)) {
+		ExtensionData data{ out.c_str() };
+		writer.WriteChunk(ChunkID::EXTENSION_YAML, data);
+	}
+
+	writer.EndChunkList();
+}
+
+void BinarySceneSerializer::SerializeScene(Scene& scene, std::vector<std::byte>& output) {
+	ChunkWriter writer{ output };
+	writer.WriteHeader(ContentType::SCENE);
+	writer.ser.text1b(scene.m_name, ORNG_MAX_NAME_SIZE);
+	writer.ser.value8b(scene.m_asset_uuid());
+
+	writer.BeginChunkList();
+	SceneSettingsData settings;
+	settings.FromScene(scene);
+	writer.WriteChunk(ChunkID::SCENE_SETTINGS, settings);
+
+	YAML::Emitter out;
+	out << YAML::BeginMap;
+	Events::EventManager::DispatchEvent(SceneSerializationEvent{ &out, scene });
+	out << YAML::EndMap;
+
+	if (!IsEmptyYAMLMap(out)) {
+		ExtensionData data{ out.c_str() };
+		writer.WriteChunk(ChunkID::EXTENSION_YAML, data);
+	}
+	writer.EndChunkList();
+
+	writer.ser.value4b(static_cast<uint32_t>(scene.m_entities.size()));
+	for (auto* p_entity : scene.m_entities) {
+		WriteEntity(*p_entity, writer);
+	}
+
+	writer.Finish(output);
+}
+
+void BinarySceneSerializer::SerializeEntities(const std::vector<SceneEntity*>& entities, std::vector<std::byte>& output) {
+	ChunkWriter writer{ output };
+	writer.WriteHeader(ContentType::ENTITY_ARRAY);
+
+	writer.ser.value4b(static_cast<uint32_t>(entities.size()));
+	for (auto* p_entity : entities) {
+		WriteEntity(*p_entity, writer);
+	}
+
+	writer.Finish(output);
+}
+
+void BinarySceneSerializer::ApplyComponentChunk(const ChunkRef& chunk, const std::vector<std::byte>& data, SceneEntity& entity) {
+	switch (chunk.id) {
+	case ChunkID::TRANSFORM: {
+		TransformData d;
+		if (!ReadChunk(chunk, data, d)) return;
+
+		auto* p_transform = entity.GetComponent<TransformComponent>();
+		p_transform->m_pos = d.pos;
+		p_transform->m_scale = d.scale;
+		p_transform->m_orientation = glm::quat{ glm::radians(d.orientation) };
+		p_transform->m_is_absolute = d.absolute;
+		p_transform->RebuildMatrix(TransformComponent::UpdateType::ALL);
+		break;
+	}
+	case ChunkID::MESH: {
+		MeshData d;
+		if (!ReadChunk(chunk, data, d)) return;
+
+		auto* p_mesh_asset = AssetManager::GetAsset<MeshAsset>(d.mesh_uuid);
+		std::vector<const Material*> material_vec(d.material_uuids.size());
+		for (size_t i = 0; i < d.material_uuids.size(); i++) {
+			auto* p_mat = AssetManager::GetAsset<Material>(d.material_uuids[i]);
+			material_vec[i] = p_mat ? p_mat : AssetManager::GetAsset<Material>(static_cast<uint64_t>(BaseAssetIDs::DEFAULT_MATERIAL));
+		}
+
+		entity.AddComponent<MeshComponent>(p_mesh_asset ? p_mesh_asset : AssetManager::GetAsset<MeshAsset>(static_cast<uint64_t>(BaseAssetIDs::CUBE_MESH)), std::move(material_vec));
+		break;
+	}
+	case ChunkID::POINTLIGHT: {
+		LightData d;
+		if (!ReadChunk(chunk, data, d)) return;
+
+		auto* p_light = entity.AddComponent<PointLightComponent>();
+		p_light->colour = d.colour;
+		p_light->attenuation.constant = d.atten_constant;
+		p_light->attenuation.linear = d.atten_linear;
+		p_light->attenuation.exp = d.atten_exp;
+		p_light->shadows_enabled = d.shadows;
+		p_light->shadow_distance = d.shadow_distance;
+		break;
+	}
+	case ChunkID::SPOTLIGHT: {
+		LightData d;
+		if (!ReadChunk(chunk, data, d)) return;
+
+		auto* p_light = entity.AddComponent<SpotLightComponent>();
+		p_light->colour = d.colour;
+		p_light->attenuation.constant = d.atten_constant;
+		p_light->attenuation.linear = d.atten_linear;
+		p_light->attenuation.exp = d.atten_exp;
+		p_light->m_aperture = d.aperture;
+		p_light->shadows_enabled = d.shadows;
+		p_light->shadow_distance = d.shadow_distance;
+		break;
+	}
+	case ChunkID::CAMERA: {
+		CameraData d;
+		if (!ReadChunk(chunk, data, d)) return;
+
+		auto* p_cam = entity.AddComponent<CameraComponent>();
+		p_cam->fov = d.fov;
+		p_cam->exposure = d.exposure;
+		p_cam->zFar = d.z_far;
+		p_cam->zNear = d.z_near;
+		break;
+	}
+	case ChunkID::SCRIPT: {
+		ScriptData d;
+		if (!ReadChunk(chunk, data, d)) return;
+
+		auto* p_script_comp = entity.AddComponent<ScriptComponent>();
+		auto* p_asset = AssetManager::GetAsset<ScriptAsset>(d.script_uuid);
+		if (!p_asset) {
+			ORNG_CORE_ERROR("Scene deserialization error: no script file with UUID '{0}' found", d.script_uuid);
+			p_asset = AssetManager::GetAsset<ScriptAsset>(static_cast<uint64_t>(BaseAssetIDs::DEFAULT_SCRIPT));
+		}
+
+		p_script_comp->SetSymbols(&p_asset->symbols);
+		break;
+	}
+	case ChunkID::AUDIO: {
+		AudioData d;
+		if (!ReadChunk(chunk, data, d)) return;
+
+		auto* p_audio = entity.AddComponent<AudioComponent>();
+		p_audio->SetVolume(d.volume);
+		p_audio->SetPitch(d.pitch);
+		p_audio->SetSoundAssetUUID(AssetManager::GetAsset<SoundAsset>(d.sound_uuid) ? d.sound_uuid : static_cast<uint64_t>(BaseAssetIDs::CLICK_SOUND));
+		p_audio->SetMinMaxRange(d.min_range, d.max_range);
+		break;
+	}
+	case ChunkID::PARTICLE_EMITTER: {
+		ParticleEmitterData d;
+		if (!ReadChunk(chunk, data, d)) return;
+
+		auto* p_emitter = entity.AddComponent<ParticleEmitterComponent>();
+		p_emitter->m_spread = d.spread;
+		p_emitter->m_spawn_extents = d.spawn_extents;
+		p_emitter->m_velocity_min_max_scalar = d.velocity_range;
+		p_emitter->m_num_particles = d.num_particles;
+		p_emitter->m_particle_lifespan_ms = d.lifespan;
+		p_emitter->m_particle_spawn_delay_ms = d.spawn_delay;
+		p_emitter->acceleration = d.acceleration;
+		p_emitter->m_active = d.active;
+		p_emitter->SetType(static_cast<ParticleEmitterComponent::EmitterType>(d.type));
+
+		p_emitter->m_life_colour_interpolator.points = d.colour_interpolator.points;
+		p_emitter->m_life_colour_interpolator.scale = d.colour_interpolator.scale;
+		p_emitter->m_life_alpha_interpolator.points = d.alpha_interpolator.points;
+		p_emitter->m_life_alpha_interpolator.scale = d.alpha_interpolator.scale;
+		p_emitter->m_life_scale_interpolator.points = d.scale_interpolator.points;
+		p_emitter->m_life_scale_interpolator.scale = d.scale_interpolator.scale;
+
+		if (p_emitter->GetType() == ParticleEmitterComponent::BILLBOARD) {
+			auto* p_mat = AssetManager::GetAsset<Material>(d.material_uuid);
+			entity.GetComponent<ParticleBillboardResources>()->p_material = p_mat ? p_mat : AssetManager::GetAsset<Material>(static_cast<uint64_t>(BaseAssetIDs::DEFAULT_MATERIAL));
+		}
+		else {
+			auto* p_res = entity.GetComponent<ParticleMeshResources>();
+			auto* p_mesh = AssetManager::GetAsset<MeshAsset>(d.mesh_uuid);
+			p_res->p_mesh = p_mesh ? p_mesh : AssetManager::GetAsset<MeshAsset>(static_cast<uint64_t>(BaseAssetIDs::CUBE_MESH));
+			p_res->materials.resize(p_res->p_mesh->m_num_materials);
+
+			for (size_t i = 0; i < p_res->materials.size(); i++) {
+				auto* p_mat = i < d.material_uuids.size() ? AssetManager::GetAsset<Material>(d.material_uuids[i]) : nullptr;
+				p_res->materials[i] = p_mat ? p_mat : AssetManager::GetAsset<Material>(static_cast<uint64_t>(BaseAssetIDs::DEFAULT_MATERIAL));
+			}
+		}
+
+		int dif = static_cast<int>(p_emitter->m_num_particles) - ParticleEmitterComponent::BASE_NUM_PARTICLES;
+		p_emitter->DispatchUpdateEvent(ParticleEmitterComponent::FULL_UPDATE, &dif);
+		break;
+	}
+	case ChunkID::PARTICLE_BUFFER: {
+		ParticleBufferData d;
+		if (!ReadChunk(chunk, data, d)) return;
+
+		auto* p_buffer = entity.AddComponent<ParticleBufferComponent>();
+		p_buffer->m_buffer_id = d.buffer_id;
+		p_buffer->m_min_allocated_particles = d.min_allocated_particles;
+
+		Events::ECS_Event<ParticleBufferComponent> e_event{ e_event.event_type = Events::ECS_EventType::COMP_UPDATED, p_buffer };
+		Events::EventManager::DispatchEvent(e_event);
+		break;
+	}
+	default:
+		// Unknown chunks are skipped so newer data can still be partially loaded
+		break;
+	}
+}
+
+void BinarySceneSerializer::DeserializeEntity(Scene& scene, const std::vector<std::byte>& data, const DecodedScene& decoded, const EntityRecord& record, SceneEntity& entity, bool ignore_parent) {
+	if (!ignore_parent && record.parent_uuid != 0 && entity.GetParent() == entt::null)
+		entity.SetParent(*scene.GetEntity(record.parent_uuid));
+
+	entity.SetName(record.name);
+
+	for (uint32_t i = record.first_chunk; i < record.first_chunk + record.num_chunks; i++) {
+		const ChunkRef& chunk = decoded.chunks[i];
+		if (chunk.id != ChunkID::EXTENSION_YAML) {
+			ApplyComponentChunk(chunk, data, entity);
+			continue;
+		}
+
+		ExtensionData extension;
+		if (!ReadChunk(chunk, data, extension))
+			continue;
+
+		YAML::Node node = YAML::Load(extension.yaml);
+		Events::EventManager::DispatchEvent(EntitySerializationEvent{ &entity, &node });
+	}
+
+	Events::EventManager::DispatchEvent(EntitySerializationEvent{ &entity });
+}
+
+void BinarySceneSerializer::DeserializeSceneSettings(Scene& scene, const std::vector<std::byte>& data, const DecodedScene& decoded) {
+	for (const ChunkRef& chunk : decoded.scene_chunks) {
+		if (chunk.id == ChunkID::SCENE_SETTINGS) {
+			SceneSettingsData settings;
+			if (ReadChunk(chunk, data, settings))
+				settings.ApplyToScene(scene);
+		}
+		else if (chunk.id == ChunkID::EXTENSION_YAML) {
+			ExtensionData extension;
+			if (!ReadChunk(chunk, data, extension))
+				continue;
+
+			YAML::Node node = YAML::Load(extension.yaml);
+			Events::EventManager::DispatchEvent(SceneSerializationEvent{ &node, scene });
+		}
+	}
+}
+
+bool BinarySceneSerializer::DeserializeScene(Scene& scene, const std::vector<std::byte>& data) {
+	DecodedScene decoded;
+	if (!Decode(data, decoded) || decoded.type != ContentType::SCENE)
+		return false;
+
+	ORNG_CORE_TRACE("Deserializing binary scene '{0}'", decoded.name);
+
+	scene.m_name = decoded.name;
+	scene.m_asset_uuid = UUID<uint64_t>{ decoded.uuid };
+
+	// Create entities in first pass so they can be linked as parent/children in 2nd pass
+	for (const auto& record : decoded.entities) {
+		scene.CreateEntity(record.name, record.uuid);
+	}
+	for (const auto& record : decoded.entities) {
+		DeserializeEntity(scene, data, decoded, record, *scene.GetEntity(record.uuid));
+	}
+
+	// Resolve/connect any node refs now scene tree is fully built
+	for (const auto& record : decoded.entities) {
+		Events::EventManager::DispatchEvent(EntitySerializationEvent{ scene.GetEntity(record.uuid) });
+	}
+
+	DeserializeSceneSettings(scene, data, decoded);
+
+	return true;
+}
+
+std::vector<SceneEntity*> BinarySceneSerializer::DeserializePrefab(Scene& scene, const Prefab& prefab) {
+	ORNG_TRACY_PROFILE;
+
+	std::vector<SceneEntity*> ents;
+
+	DecodedScene decoded;
+	if (!Decode(prefab.binary_data, decoded)) {
+		ORNG_CORE_ERROR("Failed to decode binary prefab '{0}'", prefab.filepath);
+		return ents;
+	}
+
+	// key = serialized uuid, val = instantiation uuid
+	std::unordered_map<uint64_t, uint64_t> id_mappings;
+
+	for (const auto& record : decoded.entities) {
+		auto* p_ent = &scene.CreateEntity(record.name);
+		ents.push_back(p_ent);
+		id_mappings[record.uuid] = p_ent->GetUUID();
+	}
+
+	for (size_t i = 0; i < decoded.entities.size(); i++) {
+		const auto& record = decoded.entities[i];
+
+		if (record.parent_uuid != 0) {
+			auto* p_parent = scene.GetEntity(id_mappings[record.parent_uuid]);
+			ASSERT(p_parent);
+			ents[i]->SetParent(*p_parent);
+		}
+
+		DeserializeEntity(scene, prefab.binary_data, decoded, record, *ents[i], true);
+	}
+
+	SceneSerializer::RemapEntityReferences(id_mappings, ents);
+
+	return ents;
+}
+
+std::shared_ptr<const PrefabTemplate> BinarySceneSerializer::CompilePrefab(const Prefab& prefab) {
+	auto p_template = std::make_shared<PrefabTemplate>();
+
+	if (!prefab.binary_data.empty())
+		p_template->data = prefab.binary_data;
+	else if (!ConvertYAMLToBinary(prefab.node, p_template->data))
+		return nullptr;
+
+	if (!Decode(p_template->data, p_template->decoded) || p_template->decoded.entities.empty()) {
+		ORNG_CORE_ERROR("Failed to compile prefab '{0}'", prefab.filepath);
+		return nullptr;
+	}
+
+	const auto& entities = p_template->decoded.entities;
+	std::unordered_map<uint64_t, int> uuid_to_index;
+	for (size_t i = 0; i < entities.size(); i++) {
+		uuid_to_index[entities[i].uuid] = static_cast<int>(i);
+	}
+
+	p_template->parent_indices.resize(entities.size(), -1);
+	p_template->extensions.resize(entities.size());
+
+	for (size_t i = 0; i < entities.size(); i++) {
+		const auto& record = entities[i];
+		if (auto it = uuid_to_index.find(record.parent_uuid); record.parent_uuid != 0 && it != uuid_to_index.end()) {
+			ASSERT(it->second < static_cast<int>(i));
+			p_template->parent_indices[i] = it->second;
+		}
+
+		for (uint32_t c = record.first_chunk; c < record.first_chunk + record.num_chunks; c++) {
+			const ChunkRef& chunk = p_template->decoded.chunks[c];
+			ExtensionData extension;
+			if (chunk.id != ChunkID::EXTENSION_YAML || !ReadChunk(chunk, p_template->data, extension))
+				continue;
+
+			p_template->extensions[i] = YAML::Load(extension.yaml);
+			p_template->has_extensions = true;
+		}
+	}
+
+	return p_template;
+}
+
+void BinarySceneSerializer::InstantiateTemplate(Scene& scene, const PrefabTemplate& prefab_template, const PrefabInstanceTransform* p_root_transform, std::vector<SceneEntity*>& output_entities) {
+	const auto& decoded = prefab_template.decoded;
+	const size_t first = output_entities.size();
+
+	for (const auto& record : decoded.entities) {
+		output_entities.push_back(&scene.CreateEntity(record.name));
+	}
+
+	for (size_t i = 0; i < decoded.entities.size(); i++) {
+		const auto& record = decoded.entities[i];
+		SceneEntity& entity = *output_entities[first + i];
+
+		const int parent_index = prefab_template.parent_indices[i];
+		if (parent_index != -1)
+			entity.SetParent(*output_entities[first + parent_index]);
+
+		for (uint32_t c = record.first_chunk; c < record.first_chunk + record.num_chunks; c++) {
+			const ChunkRef& chunk = decoded.chunks[c];
+			if (chunk.id != ChunkID::EXTENSION_YAML)
+				ApplyComponentChunk(chunk, prefab_template.data, entity);
+		}
+
+		if (p_root_transform && parent_index == -1) {
+			auto* p_transform = entity.GetComponent<TransformComponent>();
+			p_transform->m_pos = p_root_transform->pos;
+			p_transform->m_orientation = p_root_transform->orientation;
+			p_transform->m_scale = p_root_transform->scale;
+			p_transform->RebuildMatrix(TransformComponent::UpdateType::ALL);
+		}
+
+		if (const YAML::Node& extension = prefab_template.extensions[i]; extension.IsDefined() && !extension.IsNull())
+			Events::EventManager::DispatchEvent(EntitySerializationEvent{ &entity, &extension });
+
+		Events::EventManager::DispatchEvent(EntitySerializationEvent{ &entity });
+	}
+
+	if (!prefab_template.has_extensions)
+		return;
+
+	// key = serialized uuid, val = instantiation uuid
+	std::unordered_map<uint64_t, uint64_t> id_mappings;
+	std::vector<SceneEntity*> instance_entities{ output_entities.begin() + first, output_entities.end() };
+	for (size_t i = 0; i < decoded.entities.size(); i++) {
+		id_mappings[decoded.entities[i].uuid] = instance_entities[i]->GetUUID();
+	}
+
+	SceneSerializer::RemapEntityReferences(id_mappings, instance_entities);
+}
+
+bool BinarySceneSerializer::ConvertYAMLToBinary(const YAML::Node& node, std::vector<std::byte>& output) {
+	if (!node.IsDefined() || !node.IsMap() || !node["Entities"]) {
+		ORNG_CORE_ERROR("Failed converting YAML to binary scene, node isn't a scene or entity array");
+		return false;
+	}
+
+	try {
+		const bool is_scene = static_cast<bool>(node["Scene"]);
+
+		ChunkWriter writer{ output };
+		writer.WriteHeader(is_scene ? ContentType::SCENE : ContentType::ENTITY_ARRAY);
+
+		if (is_scene) {
+			auto name = node["Scene"].as<std::string>();
+			writer.ser.text1b(name, ORNG_MAX_NAME_SIZE);
+			writer.ser.value8b(node["SceneUUID"].as<uint64_t>());
+
+			writer.BeginChunkList();
+			SceneSettingsData settings;
+			settings.FromYAML(node);
+			writer.WriteChunk(ChunkID::SCENE_SETTINGS, settings);
+
+			YAML::Emitter extension_out;
+			extension_out << YAML::BeginMap;
+			for (auto it = node.begin(); it != node.end(); it++) {
+				if (auto key = it->first.as<std::string>(); !IsSceneKey(key))
+					extension_out << YAML::Key << key << YAML::Value << it->second;
+			}
+			extension_out << YAML::EndMap;
+
+			if (!IsEmptyYAMLMap(extension_out)) {
+				ExtensionData data{ extension_out.c_str() };
+				writer.WriteChunk(ChunkID::EXTENSION_YAML, data);
+			}
+			writer.EndChunkList();
+		}
+
+		const auto& entities = node["Entities"];
+		writer.ser.value4b(static_cast<uint32_t>(entities.size()));
+
+		for (const auto& entity_node : entities) {
+			auto name = entity_node["Name"].as<std::string>();
+			writer.BeginRecord(entity_node["Entity"].as<uint64_t>(), entity_node["ParentID"].as<uint64_t>(), name);
+
+			YAML::Emitter extension_out;
+			extension_out << YAML::BeginMap;
+
+			for (auto it = entity_node.begin(); it != entity_node.end(); it++) {
+				auto tag = it->first.as<std::string>();
+				const YAML::Node& comp_node = it->second;
+
+				if (IsEntityRecordKey(tag)) {
+					continue;
+				}
+				else if (tag == "TransformComp") {
+					TransformData d; d.FromYAML(comp_node);
+					writer.WriteChunk(ChunkID::TRANSFORM, d);
+				}
+				else if (tag == "MeshComp") {
+					MeshData d; d.FromYAML(comp_node);
+					writer.WriteChunk(ChunkID::MESH, d);
+				}
+				else if (tag == "PointlightComp") {
+					LightData d; d.FromYAML(comp_node, false);
+					writer.WriteChunk(ChunkID::POINTLIGHT, d);
+				}
+				else if (tag == "SpotlightComp") {
+					LightData d; d.FromYAML(comp_node, true);
+					writer.WriteChunk(ChunkID::SPOTLIGHT, d);
+				}
+				else if (tag == "CameraComp") {
+					CameraData d; d.FromYAML(comp_node);
+					writer.WriteChunk(ChunkID::CAMERA, d);
+				}
+				else if (tag == "ScriptComp") {
+					ScriptData d; d.FromYAML(comp_node);
+					writer.WriteChunk(ChunkID::SCRIPT, d);
+				}
+				else if (tag == "AudioComp") {
+					AudioData d; d.FromYAML(comp_node);
+					writer.WriteChunk(ChunkID::AUDIO, d);
+				}
+				else if (tag == "ParticleEmitterComp") {
+					ParticleEmitterData d; d.FromYAML(comp_node);
+					writer.WriteChunk(ChunkID::PARTICLE_EMITTER, d);
+				}
+				else if (tag == "ParticleBufferComp") {
+					ParticleBufferData d; d.FromYAML(comp_node);
+					writer.WriteChunk(ChunkID::PARTICLE_BUFFER, d);
+				}
+				else {
+					extension_out << YAML::Key << tag << YAML::Value << comp_node;
+				}
+			}
+
+			extension_out << YAML::EndMap;
+			if (!IsEmptyYAMLMap(extension_out)) {
+				ExtensionData data{ extension_out.c_str() };
+				writer.WriteChunk(ChunkID::EXTENSION_YAML, data);
+			}
+
+			writer.EndChunkList();
+		}
+
+		writer.Finish(output);
+	}
+	catch (const YAML::Exception& e) {
+		ORNG_CORE_ERROR("Failed converting YAML to binary scene, '{0}'", e.what());
+		output.clear();
+		return false;
+	}
+
+	return true;
+}
+
+bool BinarySceneSerializer::ConvertBinaryToYAML(const std::vector<std::byte>& data, std::string& output) {
+	DecodedScene decoded;
+	if (!Decode(data, decoded))
+		return false;
+
+	const auto EmitExtension = [&](YAML::Emitter& out, const ChunkRef& chunk) {
+		ExtensionData extension;
+		if (!ReadChunk(chunk, data, extension))
+			return;
+
+		YAML::Node node = YAML::Load(extension.yaml);
+		for (auto it = node.begin(); it != node.end(); it++) {
+			out << YAML::Key << it->first << YAML::Value << it->second;
+		}
+	};
+
+	YAML::Emitter out;
+	out << YAML::BeginMap;
+
+	if (decoded.type == ContentType::SCENE) {
+		Out(out, "Scene", decoded.name);
+		Out(out, "SceneUUID", decoded.uuid);
+	}
+
+	out << YAML::Key << "Entities" << YAML::Value << YAML::BeginSeq;
+	for (const auto& record : decoded.entities) {
+		out << YAML::BeginMap;
+		Out(out, "Entity", record.uuid);
+		Out(out, "Name", record.name);
+		Out(out, "ParentID", record.parent_uuid);
+
+		for (uint32_t i = record.first_chunk; i < record.first_chunk + record.num_chunks; i++) {
+			const ChunkRef& chunk = decoded.chunks[i];
+
+			switch (chunk.id) {
+			case ChunkID::TRANSFORM: { TransformData d; if (ReadChunk(chunk, data, d)) d.ToYAML(out); break; }
+			case ChunkID::MESH: { MeshData d; if (ReadChunk(chunk, data, d)) d.ToYAML(out); break; }
+			case ChunkID::POINTLIGHT: { LightData d; if (ReadChunk(chunk, data, d)) d.ToYAML(out, false); break; }
+			case ChunkID::SPOTLIGHT: { LightData d; if (ReadChunk(chunk, data, d)) d.ToYAML(out, true); break; }
+			case ChunkID::CAMERA: { CameraData d; if (ReadChunk(chunk, data, d)) d.ToYAML(out); break; }
+			case ChunkID::SCRIPT: { ScriptData d; if (ReadChunk(chunk, data, d)) d.ToYAML(out); break; }
+			case ChunkID::AUDIO: { AudioData d; if (ReadChunk(chunk, data, d)) d.ToYAML(out); break; }
+			case ChunkID::PARTICLE_EMITTER: { ParticleEmitterData d; if (ReadChunk(chunk, data, d)) d.ToYAML(out); break; }
+			case ChunkID::PARTICLE_BUFFER: { ParticleBufferData d; if (ReadChunk(chunk, data, d)) d.ToYAML(out); break; }
+			case ChunkID::EXTENSION_YAML: EmitExtension(out, chunk); break;
+			default:
+				ORNG_CORE_WARN("Unknown binary scene chunk '{0}' dropped during YAML conversion", static_cast<unsigned>(chunk.id));
+				break;
+			}
+		}
+
+		out << YAML::EndMap;
+	}
+	out << YAML::EndSeq;
+
+	for (const ChunkRef& chunk : decoded.scene_chunks) {
+		if (chunk.id == ChunkID::SCENE_SETTINGS) {
+			SceneSettingsData settings;
+			if (ReadChunk(chunk, data, settings))
+				settings.ToYAML(out);
+		}
+		else if (chunk.id == ChunkID::EXTENSION_YAML) {
+			EmitExtension(out, chunk);
+		}
+	}
+
+	out << YAML::EndMap;
+	output = out.c_str();
+
+	return true;
+}
@@ -0,0 +1,156 @@
+#include "pch/pch.h"
+#include "scene/FlatHierarchy.h"
+#include "util/Timers.h"
+
+namespace ORNG {
+	void FlatHierarchy::OnEntityCreated(entt::entity entity) {
+		// Entities are appended as roots, anything more involved is left for the rebuild
+		if (m_dirty || m_registry.get<RelationshipComponent>(entity).parent != entt::null) {
+			m_dirty = true;
+			return;
+		}
+
+		Append(entity, -1);
+	}
+
+	void FlatHierarchy::OnParentChanged(entt::entity entity) {
+		if (m_dirty)
+			return;
+
+		// Only a subtree at the end of the arrays can move without shifting the ones after it
+		uint32_t idx = GetIndex(entity);
+		if (idx == INVALID_INDEX || idx + m_subtree_sizes[idx] != m_entities.size()) {
+			m_dirty = true;
+			return;
+		}
+
+		// Being last, it's also last in each of its old ancestors' subtrees, so they just shrink
+		const auto size = static_cast<int>(m_subtree_sizes[idx]);
+		AddToSubtreeSizes(m_parent_indices[idx], -size);
+
+		int parent_index = -1;
+		if (entt::entity parent = m_registry.get<RelationshipComponent>(entity).parent; parent != entt::null) {
+			uint32_t new_parent_idx = GetIndex(parent);
+			// The new parent's subtree has to end where this one starts for both to stay contiguous, true when children are attached in the order they're created
+			if (new_parent_idx == INVALID_INDEX || new_parent_idx + m_subtree_sizes[new_parent_idx] != idx) {
+				m_dirty = true;
+				return;
+			}
+
+			parent_index = static_cast<int>(new_parent_idx);
+		}
+
+		m_parent_indices[idx] = parent_index;
+		AddToSubtreeSizes(parent_index, size);
+	}
+
+	void FlatHierarchy::OnEntityDestroyed(entt::entity entity) {
+		if (m_dirty)
+			return;
+
+		uint32_t idx = GetIndex(entity);
+		if (idx == INVALID_INDEX)
+			return;
+
+		// Scene::DeleteEntity detaches children before destroying their parent, so this is usually a leaf
+		if (idx + 1 != m_entities.size() || m_subtree_sizes[idx] != 1) {
+			m_dirty = true;
+			return;
+		}
+
+		AddToSubtreeSizes(m_parent_indices[idx], -1);
+		m_index_lookup[entt::to_entity(entity)] = INVALID_INDEX;
+		m_entities.pop_back();
+		m_parent_indices.pop_back();
+		m_subtree_sizes.pop_back();
+	}
+
+	void FlatHierarchy::AddToSubtreeSizes(int index, int delta) {
+		for (; index != -1; index = m_parent_indices[index]) {
+			m_subtree_sizes[index] = static_cast<uint32_t>(static_cast<int>(m_subtree_sizes[index]) + delta);
+		}
+	}
+
+	void FlatHierarchy::Update() {
+		if (m_dirty)
+			Rebuild();
+	}
+
+	uint32_t FlatHierarchy::GetIndex(entt::entity entity) const noexcept {
+		auto lookup_idx = entt::to_entity(entity);
+		if (lookup_idx >= m_index_lookup.size())
+			return INVALID_INDEX;
+
+		uint32_t idx = m_index_lookup[lookup_idx];
+		// The slot may belong to a destroyed entity with the same index but a different version
+		return idx < m_entities.size() && m_entities[idx] == entity ? idx : INVALID_INDEX;
+	}
+
+	std::span<const entt::entity> FlatHierarchy::GetSubtree(entt::entity entity) const noexcept {
+		uint32_t idx = GetIndex(entity);
+		if (idx == INVALID_INDEX)
+			return {};
+
+		return { m_entities.data() + idx, m_subtree_sizes[idx] };
+	}
+
+	void FlatHierarchy::Append(entt::entity entity, int parent_index) {
+		auto lookup_idx = entt::to_entity(entity);
+		if (lookup_idx >= m_index_lookup.size())
+			m_index_lookup.resize(lookup_idx + 1, INVALID_INDEX);
+
+		m_index_lookup[lookup_idx] = static_cast<uint32_t>(m_entities.size());
+		m_entities.push_back(entity);
+		m_parent_indices.push_back(parent_index);
+		m_subtree_sizes.push_back(1);
+	}
+
+	void FlatHierarchy::Rebuild() {
+		ORNG_PROFILE_FUNC();
+
+		m_entities.clear();
+		m_parent_indices.clear();
+		m_subtree_sizes.clear();
+		std::ranges::fill(m_index_lookup, INVALID_INDEX);
+
+		auto view = m_registry.view<RelationshipComponent>();
+		m_entities.reserve(view.size());
+		m_parent_indices.reserve(view.size());
+		m_subtree_sizes.reserve(view.size());
+
+		for (auto [root, root_rel] : view.each()) {
+			if (root_rel.parent != entt::null)
+				continue;
+
+			// Explicit stack so deep hierarchies can't overflow, children are pushed in reverse so they're visited in sibling order
+			m_stack.clear();
+			m_stack.emplace_back(root, -1);
+			while (!m_stack.empty()) {
+				auto [entity, parent_index] = m_stack.back();
+				m_stack.pop_back();
+
+				Append(entity, parent_index);
+				int index = static_cast<int>(m_entities.size() - 1);
+
+				auto& rel = view.get<RelationshipComponent>(entity);
+				m_children.clear();
+				for (auto child = rel.first; child != entt::null; child = view.get<RelationshipComponent>(child).next) {
+					m_children.push_back(child);
+				}
+
+				for (auto it = m_children.rbegin(); it != m_children.rend(); it++) {
+					m_stack.emplace_back(*it, index);
+				}
+			}
+		}
+
+		// Children always come after their parents so sizes can be accumulated in a single reverse pass
+		for (size_t i = m_entities.size(); i > 1; i--) {
+			int parent_index = m_parent_indices[i - 1];
+			if (parent_index != -1)
+				m_subtree_sizes[parent_index] += m_subtree_sizes[i - 1];
+		}
+
+		m_dirty = false;
+	}
+}
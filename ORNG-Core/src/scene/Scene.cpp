@@ -8,12 +8,19 @@
 #include "assets/AssetManager.h"
 #include "assets/SceneAsset.h"
 #include "scene/SceneSerializer.h"
+#include "scene/BinarySceneSerializer.h"
+#include "scene/PrefabTemplate.h"
+#include "scene/AsyncSceneLoader.h"
 #include "components/ComponentAPI.h"
 #include "components/systems/ComponentSystem.h"
 
 
 namespace ORNG {
+	Scene::Scene() = default;
+
 	Scene::~Scene() {
+		mp_async_loader = nullptr;
+
 		if (m_is_loaded)
 			UnloadScene();
 	}
@@ -39,17 +46,43 @@ namespace ORNG {
 			p_system->OnUpdate();
 		}
 
-		for (auto* p_entity : m_entity_deletion_queue) {
-			DeleteEntity(p_entity);
+		// Entities in the queue may already have been deleted along with a parent
+		for (uint64_t uuid : m_entity_deletion_queue) {
+			if (auto* p_entity = GetEntity(uuid))
+				DeleteEntity(p_entity);
 		}
 
 		m_entity_deletion_queue.clear();
 
-		if (mp_pending_deserialization_asset) {
-			ClearAllEntities(false); // Don't clear registry as if we're in the editor it'll destroy the camera
-			SceneSerializer::DeserializeScene(*this, "", false, &mp_pending_deserialization_asset->node);
-			mp_pending_deserialization_asset = nullptr;
-		}
+		if (mp_async_loader)
+			UpdateAsyncLoad();
+	}
+
+	void Scene::UpdateAsyncLoad() {
+		if (!mp_async_loader->Update(async_load_budget_ms))
+			return;
+
+		// Detached first so the callback can begin another load
+		std::unique_ptr<AsyncSceneLoader> p_loader = std::move(mp_async_loader);
+		p_loader->InvokeCallback();
+	}
+
+	void Scene::LoadAsync(const SceneAsset& scene_asset, std::function<void(Scene& scene, bool success)> on_complete) {
+		mp_async_loader = nullptr;
+		mp_async_loader = std::make_unique<AsyncSceneLoader>(*this, scene_asset, std::move(on_complete));
+	}
+
+	void Scene::LoadAsync(const std::string& filepath, std::function<void(Scene& scene, bool success)> on_complete) {
+		mp_async_loader = nullptr;
+		mp_async_loader = std::make_unique<AsyncSceneLoader>(*this, filepath, std::move(on_complete));
+	}
+
+	bool Scene::IsInstantiatingAsync() const noexcept {
+		return mp_async_loader && mp_async_loader->IsInstantiating();
+	}
+
+	float Scene::GetAsyncLoadProgress() const noexcept {
+		return mp_async_loader ? mp_async_loader->GetProgress() : 1.f;
 	}
 
 	void Scene::OnImGuiRender() {
@@ -65,8 +98,11 @@ namespace ORNG {
 	}
 
 	void Scene::DeleteEntityAtEndOfFrame(SceneEntity* p_entity) {
-		if (!VectorContains(m_entity_deletion_queue, p_entity))
-			m_entity_deletion_queue.push_back(p_entity);
+		if (p_entity->m_pending_deletion)
+			return;
+
+		p_entity->m_pending_deletion = true;
+		m_entity_deletion_queue.push_back(p_entity->GetUUID());
 	}
 
 	void Scene::DeleteEntity(SceneEntity* p_entity) {
@@ -86,27 +122,85 @@ namespace ORNG {
 			current_child_entity = next;
 		}
 
-		if (m_root_entities.contains(p_entity->GetEnttHandle()))
-			m_root_entities.erase(p_entity->GetEnttHandle());
-		
-		auto it = std::ranges::find(m_entities, p_entity);
-		ASSERT(it != m_entities.end());
+		m_root_entities.erase(p_entity->GetEnttHandle());
+		m_child_name_tables.erase(p_entity->GetEnttHandle());
 
+		const size_t index = p_entity->m_scene_index;
+		ASSERT(index < m_entities.size() && m_entities[index] == p_entity);
+		m_entities[index] = m_entities.back();
+		m_entities[index]->m_scene_index = index;
+		m_entities.pop_back();
+
+		UnindexEntityName(*p_entity);
 		m_entity_uuid_lookup.erase(p_entity->GetUUID());
-		delete p_entity;
-		m_entities.erase(it);
+		m_entity_pool.Delete(p_entity);
 	}
 
+	void Scene::ClearAllEntities(bool clear_reg) {
+		ORNG_TRACY_PROFILE;
 
-	SceneEntity* Scene::GetEntity(uint64_t uuid) {
-		if (!m_entity_uuid_lookup.contains(uuid)) return nullptr;
+		if (m_started) {
+			for (auto [entity, script] : m_registry.view<ScriptComponent>().each()) {
+				if (script.p_instance) script.p_instance->OnDestroy();
+			}
+		}
 
-		return m_entity_uuid_lookup[uuid];
+		std::vector<entt::entity> handles;
+		handles.reserve(m_entities.size());
+		for (auto* p_entity : m_entities) {
+			handles.push_back(p_entity->GetEnttHandle());
+		}
+
+		// Every entity goes so hierarchies are left linked, component destruction signals still fire per entity
+		m_registry.destroy(handles.begin(), handles.end());
+
+		// Handles are now invalid so SceneEntity destructors don't touch the registry
+		for (auto* p_entity : m_entities) {
+			m_entity_pool.Delete(p_entity);
+		}
+
+		m_entities.clear();
+		m_entity_uuid_lookup.clear();
+		m_name_index.clear();
+		m_root_entities.clear();
+		m_entity_deletion_queue.clear();
+		m_child_name_tables.clear();
+		m_root_generation++;
+
+		if (clear_reg) m_registry.clear();
+	}
+
+	SceneEntity* Scene::GetEntity(uint64_t uuid) {
+		auto it = m_entity_uuid_lookup.find(uuid);
+		return it == m_entity_uuid_lookup.end() ? nullptr : it->second;
 	}
 
 	SceneEntity* Scene::GetEntity(const std::string& name) {
-		auto it = std::find_if(m_entities.begin(), m_entities.end(), [&](const auto* p_entity) {return p_entity->name == name; });
-		return it == m_entities.end() ? nullptr : *it;
+		// Names can only change through SetName so the index is always complete
+		auto it = m_name_index.find(name);
+		return it == m_name_index.end() ? nullptr : it->second.front();
+	}
+
+	void Scene::IndexEntityName(SceneEntity& entity) {
+		auto& bucket = m_name_index[entity.m_name];
+		entity.m_name_index_slot = bucket.size();
+		bucket.push_back(&entity);
+	}
+
+	void Scene::UnindexEntityName(SceneEntity& entity) {
+		auto it = m_name_index.find(entity.m_name);
+		ASSERT(it != m_name_index.end());
+
+		auto& bucket = it->second;
+		const size_t slot = entity.m_name_index_slot;
+		bucket[slot] = bucket.back();
+		bucket[slot]->m_name_index_slot = slot;
+		bucket.pop_back();
+
+		if (bucket.empty())
+			m_name_index.erase(it);
+
+		entity.m_name_index_slot = std::numeric_limits<size_t>::max();
 	}
 
 	SceneEntity* Scene::GetEntity(entt::entity handle) {
@@ -119,16 +213,46 @@ namespace ORNG {
 	}
 
 	SceneEntity& Scene::InstantiatePrefab(const Prefab& prefab, bool call_on_create) {
-		auto vec = SceneSerializer::DeserializePrefab(*this, prefab);
-		
+		auto roots = InstantiatePrefab(prefab, 1, {}, call_on_create);
+		ASSERT(!roots.empty());
+
+		return *roots[0];
+	}
+
+	std::vector<SceneEntity*> Scene::InstantiatePrefab(const Prefab& prefab, size_t count, std::span<const PrefabInstanceTransform> transforms, bool call_on_create) {
+		ORNG_TRACY_PROFILE;
+		ASSERT(transforms.empty() || transforms.size() == count);
+
+		std::vector<SceneEntity*> roots;
+
+		if (!prefab.p_compiled_template)
+			prefab.p_compiled_template = BinarySceneSerializer::CompilePrefab(prefab);
+
+		if (!prefab.p_compiled_template)
+			return roots;
+
+		const PrefabTemplate& prefab_template = *prefab.p_compiled_template;
+		const size_t entities_per_instance = prefab_template.decoded.entities.size();
+
+		std::vector<SceneEntity*> entities;
+		entities.reserve(entities_per_instance * count);
+		roots.reserve(count);
+
+		for (size_t i = 0; i < count; i++) {
+			const size_t first = entities.size();
+			BinarySceneSerializer::InstantiateTemplate(*this, prefab_template, transforms.empty() ? nullptr : &transforms[i], entities);
+
+			// Prefab entities are serialized so that the root/top-parent is first
+			roots.push_back(entities[first]);
+		}
+
 		if (call_on_create) {
-			for (auto* p_ent : vec) {
+			for (auto* p_ent : entities) {
 				if (auto* p_script = p_ent->GetComponent<ScriptComponent>(); p_script && p_script->p_instance) p_script->p_instance->OnCreate();
 			}
 		}
 
-		// Prefab entities are serialized so that the root/top-parent is first
-		return *vec[0];
+		return roots;
 	}
 
 	SceneEntity* Scene::InstantiatePrefab(uint64_t prefab_uuid, bool call_on_create) {
@@ -162,10 +286,9 @@ namespace ORNG {
 	}
 
 	SceneEntity& Scene::DuplicateEntityAsPartOfGroup(SceneEntity& original, std::unordered_map<uint64_t, uint64_t>& uuid_map) {
-		SceneEntity& new_entity = CreateEntity(original.name + " - Duplicate");
+		SceneEntity& new_entity = CreateEntity(original.GetName() + " - Duplicate");
 		uuid_map[original.GetUUID()] = new_entity.GetUUID();
-		std::string str = SceneSerializer::SerializeEntityIntoString(original);
-		SceneSerializer::DeserializeEntityFromString(*this, str, new_entity, true);
+		SceneSerializer::CloneEntityComponents(original, new_entity);
 
 		original.ForEachLevelOneChild(
 			[&](entt::entity e) {
@@ -178,9 +301,11 @@ namespace ORNG {
 	}
 
 	SceneEntity& Scene::DuplicateEntity(SceneEntity& original) {
-		SceneEntity& new_entity = CreateEntity(original.name + " - Duplicate");
-		std::string str = SceneSerializer::SerializeEntityIntoString(original);
-		SceneSerializer::DeserializeEntityFromString(*this, str, new_entity);
+		SceneEntity& new_entity = CreateEntity(original.GetName() + " - Duplicate");
+		if (auto* p_parent = GetEntity(original.GetParent()))
+			new_entity.SetParent(*p_parent);
+
+		SceneSerializer::CloneEntityComponents(original, new_entity);
 
 		std::unordered_map<uint64_t, uint64_t> uuid_map;
 		uuid_map[original.GetUUID()] = new_entity.GetUUID();
@@ -233,26 +358,68 @@ namespace ORNG {
 	}
 
 	SceneEntity* Scene::TryFindRootEntityByName(const std::string& name) {
-		for (auto handle : m_root_entities) {
-			auto* p_ent = GetEntity(handle);
-			if (p_ent->name == name)
-				return p_ent;
+		if (auto it = m_name_index.find(name); it != m_name_index.end()) {
+			for (auto* p_ent : it->second) {
+				if (p_ent->GetParent() == entt::null)
+					return p_ent;
+			}
 		}
 
 		return nullptr;
 	}
 
+	SceneEntity* Scene::TryFindChildByName(SceneEntity& parent, const std::string& name) {
+		auto& rel_comp = m_registry.get<RelationshipComponent>(parent.GetEnttHandle());
+		if (rel_comp.num_children < CHILD_NAME_TABLE_THRESHOLD)
+			return parent.GetChild(name);
+
+		// Only this parent's table is rebuilt when one of its children is added, removed or renamed
+		auto& [table_generation, table] = m_child_name_tables[parent.GetEnttHandle()];
+		if (table.empty() || table_generation != rel_comp.generation) {
+			table.clear();
+			table_generation = rel_comp.generation;
+			table.reserve(rel_comp.num_children);
+			for (auto child = rel_comp.first; child != entt::null; child = m_registry.get<RelationshipComponent>(child).next) {
+				// try_emplace keeps the first child with a name, matching GetChild
+				table.try_emplace(GetEntity(child)->GetName(), child);
+			}
+		}
 
-	SceneEntity* Scene::TryFindEntity(const EntityNodeRef& ref) {
-		SceneEntity* p_current_ent = nullptr;
-		unsigned start_index = 0;
+		auto child_it = table.find(name);
+		return child_it == table.end() ? nullptr : GetEntity(child_it->second);
+	}
 
+
+	SceneEntity* Scene::TryFindEntity(const EntityNodeRef& ref) {
 		auto& instructions = ref.GetInstructions();
 
 		if (instructions.empty())
 			return nullptr;
 
-		if (instructions[0] == "::") { // Path is absolute
+		const bool absolute = instructions[0] == "::";
+
+		// Only the entities along the path are checked, changes anywhere else in the hierarchy don't invalidate the cache
+		if (ref.mp_cached_scene == this && (!absolute || ref.m_cached_root_generation == m_root_generation)) {
+			bool valid = m_registry.valid(ref.m_cached_target);
+			for (auto [entity, generation] : ref.m_cached_path) {
+				if (!valid)
+					break;
+
+				valid = m_registry.valid(entity) && m_registry.get<RelationshipComponent>(entity).generation == generation;
+			}
+
+			if (valid)
+				return GetEntity(ref.m_cached_target);
+		}
+
+		ref.m_cached_path.clear();
+		SceneEntity* p_current_ent = nullptr;
+		unsigned start_index = 0;
+
+		if (absolute) {
+			if (instructions.size() < 2)
+				return nullptr;
+
 			p_current_ent = TryFindRootEntityByName(instructions[1]);
 			start_index = 2;
 		}
@@ -264,20 +431,32 @@ namespace ORNG {
 			if (p_current_ent == nullptr)
 				return p_current_ent;
 
+			ref.m_cached_path.emplace_back(p_current_ent->GetEnttHandle(), p_current_ent->GetComponent<RelationshipComponent>()->generation);
+
 			if (instructions[i] == "..") {
 				p_current_ent = GetEntity(p_current_ent->GetParent());
 			}
 			else {
-				p_current_ent = p_current_ent->GetChild(instructions[i]);
+				p_current_ent = TryFindChildByName(*p_current_ent, instructions[i]);
 			}
 		}
 
+		// Failed lookups aren't cached as the target may be created later without any generation on the path changing
+		if (p_current_ent) {
+			ref.m_cached_target = p_current_ent->GetEnttHandle();
+			ref.m_cached_root_generation = m_root_generation;
+			ref.mp_cached_scene = this;
+		}
+		else {
+			ref.mp_cached_scene = nullptr;
+		}
+
 		return p_current_ent;
 	}
 
 
 	EntityNodeRef Scene::GenEntityNodeRef(SceneEntity* p_src, SceneEntity* p_target) {
-		std::vector<std::string> instructions = { p_target->name };
+		std::vector<std::string> instructions = { p_target->GetName() };
 
 		std::set<SceneEntity*> src_parents;
 		std::vector<SceneEntity*> ordered_src_parents;
@@ -307,7 +486,7 @@ namespace ORNG {
 					break;
 				}
 				else {
-					instructions.push_back(p_current_parent->name);
+					instructions.push_back(p_current_parent->GetName());
 				}
 
 				p_current_parent = GetEntity(p_current_parent->GetParent());
@@ -367,10 +546,15 @@ namespace ORNG {
 			entt::entity entity = _event.p_component->GetEnttHandle();
 			entt::entity parent = _event.p_component->GetEntity()->GetParent();
 
-			if (parent != entt::null && m_root_entities.contains(entity))
+			// Absolute paths start from the root entities, so only changes to the set of roots invalidate them here
+			if (parent != entt::null && m_root_entities.contains(entity)) {
 				m_root_entities.erase(entity);
-			else if (parent == entt::null && !m_root_entities.contains(entity))
+				m_root_generation++;
+			}
+			else if (parent == entt::null && !m_root_entities.contains(entity)) {
 				m_root_entities.insert(entity);
+				m_root_generation++;
+			}
 			};
 
 		Events::EventManager::RegisterListener(m_hierarchy_modification_listener);
@@ -409,11 +593,10 @@ namespace ORNG {
 	void Scene::UnloadScene() {
 		ORNG_CORE_INFO("Unloading scene...");
 		m_time_elapsed = 0.0;
+		mp_async_loader = nullptr;
 
-		while (!m_entities.empty()) {
-			// Safe deletion method
-			DeleteEntity(m_entities[0]);
-		}
+		// Registry is cleared below
+		ClearAllEntities(false);
 
 		for (auto [p_sys, _] : m_systems_with_priority) {
 			p_sys->OnUnload();
@@ -435,14 +618,20 @@ namespace ORNG {
 
 
 	void Scene::DeserializeAtEndOfFrame(SceneAsset &scene_asset) {
-		mp_pending_deserialization_asset = &scene_asset;
+		// Previous entities are cleared once parsing finishes, registry isn't cleared as if we're in the editor it'll destroy the camera
+		LoadAsync(scene_asset, [](Scene& scene, bool success) {
+			if (success && scene.m_started)
+				scene.Start();
+			});
 	}
 
 	SceneEntity& Scene::CreateEntity(const std::string& name, uint64_t uuid) {
 		auto reg_ent = m_registry.create();
-		SceneEntity* ent = uuid == 0 ? new SceneEntity(this, reg_ent, &m_registry, this->m_static_uuid()) : new SceneEntity(uuid, reg_ent, this, &m_registry, this->m_static_uuid());
+		SceneEntity* ent = uuid == 0 ? m_entity_pool.New(this, reg_ent, &m_registry, this->m_static_uuid()) : m_entity_pool.New(uuid, reg_ent, this, &m_registry, this->m_static_uuid());
 		uuid = ent->GetUUID();
-		ent->name = name;
+		ent->m_name = name;
+		IndexEntityName(*ent);
+		ent->m_scene_index = m_entities.size();
 		m_entities.push_back(ent);
 		DEBUG_ASSERT(!m_entity_uuid_lookup.contains(uuid));
 		m_entity_uuid_lookup[uuid] = ent;
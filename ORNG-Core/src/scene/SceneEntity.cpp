@@ -10,8 +10,6 @@ namespace ORNG {
 		auto* p_comp = GetComponent<RelationshipComponent>();
 		auto* p_parent_comp = parent_entity.GetComponent<RelationshipComponent>();
 
-		entt::entity current_parent_child = p_parent_comp->first;
-
 		// Make sure parent is not a child of this entity, if it is return - the parent will not be set
 		entt::entity current_parent = p_parent_comp->parent;
 		while (current_parent != entt::null) {
@@ -22,21 +20,20 @@ namespace ORNG {
 		p_comp->parent = entt::entity{ parent_entity.GetEnttHandle() };
 
 		// If parent has no children, link this to first
-		if (current_parent_child == entt::null) {
+		if (p_parent_comp->first == entt::null) {
 			p_parent_comp->first = m_entt_handle;
 		}
 		else {
-			while (mp_registry->get<RelationshipComponent>(current_parent_child).next != entt::null) {
-				current_parent_child = mp_registry->get<RelationshipComponent>(current_parent_child).next;
-			}
-
-			// Link this entity to last entity found in parents linked list of children
-			auto& prev_child_of_parent = mp_registry->get<RelationshipComponent>(current_parent_child);
+			// Link this entity to the end of the parents linked list of children
+			auto& prev_child_of_parent = mp_registry->get<RelationshipComponent>(p_parent_comp->last);
 			prev_child_of_parent.next = m_entt_handle;
 			p_comp->prev = entt::entity{ prev_child_of_parent.GetEnttHandle() };
 		}
+		p_parent_comp->last = m_entt_handle;
 
 		p_parent_comp->num_children++;
+		p_parent_comp->generation++;
+		p_comp->generation++;
 		// Update transform hierarchy
 		auto* p_transform = GetComponent<TransformComponent>();
 		p_transform->m_parent_handle = p_parent_comp->GetEnttHandle();
@@ -57,6 +54,9 @@ namespace ORNG {
 		if (parent_comp.first == m_entt_handle)
 			parent_comp.first = p_comp->next;
 
+		if (parent_comp.last == m_entt_handle)
+			parent_comp.last = p_comp->prev;
+
 		// Patch hole in linked list
 		if (auto* prev = mp_registry->try_get<RelationshipComponent>(p_comp->prev))
 			prev->next = p_comp->next;
@@ -67,6 +67,8 @@ namespace ORNG {
 		p_comp->next = entt::null;
 		p_comp->prev = entt::null;
 		p_comp->parent = entt::null;
+		parent_comp.generation++;
+		p_comp->generation++;
 
 		GetComponent<TransformComponent>()->m_parent_handle = entt::null;
 
@@ -78,16 +80,24 @@ namespace ORNG {
 		return mp_scene->DuplicateEntity(*this);
 	}
 
-	void SceneEntity::ForEachChildRecursive(std::function<void(entt::entity)> func_ptr) {
-		auto& rel_comp = mp_registry->get<RelationshipComponent>(m_entt_handle);
-		entt::entity current_entity = rel_comp.first;
+	void SceneEntity::SetName(const std::string& new_name) {
+		// Entities not created through the scene (e.g the editor camera) aren't indexed
+		bool indexed = m_name_index_slot != std::numeric_limits<size_t>::max();
+		if (indexed)
+			mp_scene->UnindexEntityName(*this);
+
+		m_name = new_name;
 
-		for (int i = 0; i < rel_comp.num_children; i++) {
-			// Store 'next' up here in case func_ptr ends up changing it which can cause this loop to jump between entities
-			auto next = mp_registry->get<RelationshipComponent>(current_entity).next;
-			func_ptr(current_entity);
-			ForEachChildRecursiveInternal(func_ptr, current_entity);
-			current_entity = next;
+		if (indexed) {
+			mp_scene->IndexEntityName(*this);
+
+			// Invalidates paths through this entity and lookups among its siblings
+			auto* p_comp = GetComponent<RelationshipComponent>();
+			p_comp->generation++;
+			if (p_comp->parent != entt::null)
+				mp_registry->get<RelationshipComponent>(p_comp->parent).generation++;
+			else
+				mp_scene->m_root_generation++;
 		}
 	}
 
@@ -97,29 +107,4 @@ namespace ORNG {
 		Events::EventManager::DispatchEvent(UUIDChangeEvent{ old_uuid, new_uuid });
 	}
 
-	void SceneEntity::ForEachLevelOneChild(std::function<void(entt::entity)> func_ptr) {
-		auto& rel_comp = mp_registry->get<RelationshipComponent>(m_entt_handle);
-		entt::entity current_entity = rel_comp.first;
-
-		for (int i = 0; i < rel_comp.num_children; i++) {
-			// Store 'next' up here in case func_ptr ends up changing it which can cause this loop to jump between entities
-			auto next = mp_registry->get<RelationshipComponent>(current_entity).next;
-			func_ptr(current_entity);
-			current_entity = next;
-		}
-	}
-
-
-	void SceneEntity::ForEachChildRecursiveInternal(std::function<void(entt::entity)> func_ptr, entt::entity search_entity) {
-		auto& rel_comp = mp_registry->get<RelationshipComponent>(search_entity);
-		entt::entity current_entity = rel_comp.first;
-
-		for (int i = 0; i < rel_comp.num_children; i++) {
-			// Store 'next' up here in case func_ptr ends up changing it which can cause this loop to jump between entities
-			auto next = mp_registry->get<RelationshipComponent>(current_entity).next;
-			func_ptr(current_entity);
-			ForEachChildRecursiveInternal(func_ptr, current_entity);
-			current_entity = next;
-		}
-	}
 }
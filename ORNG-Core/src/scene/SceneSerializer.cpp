@@ -10,6 +10,7 @@
 #include "assets/Prefab.h"
 #include "assets/SceneAsset.h"
 #include "scene/SerializationUtil.h"
+#include "scene/BinarySceneSerializer.h"
 
 namespace ORNG {
 	std::string SceneSerializer::SerializeEntityIntoString(SceneEntity& entity) {
@@ -93,7 +94,7 @@ namespace ORNG {
 	void SceneSerializer::SerializeEntity(SceneEntity& entity, YAML::Emitter& out) {
 		out << YAML::BeginMap;
 		out << YAML::Key << "Entity" << YAML::Value << entity.GetUUID();
-		out << YAML::Key << "Name" << YAML::Value << entity.name;
+		out << YAML::Key << "Name" << YAML::Value << entity.GetName();
 		auto* p_parent = entity.GetScene()->GetEntity(entity.GetParent());
 		out << YAML::Key << "ParentID" << YAML::Value << (p_parent ? p_parent->GetUUID() : 0);
 
@@ -115,7 +116,7 @@ namespace ORNG {
 			out << YAML::Key << "Materials" << YAML::Value;
 			out << YAML::Flow;
 			out << YAML::BeginSeq;
-			for (auto* p_material : p_mesh_comp->GetMaterials()) {
+			for (const Material* p_material : p_mesh_comp->GetMaterials()) {
 				out << p_material->uuid();
 			}
 			out << YAML::EndSeq;
@@ -206,7 +207,7 @@ namespace ORNG {
 
 				Out(out, "Materials", YAML::Flow);
 				out << YAML::BeginSeq;
-				for (auto* p_material : p_res->materials) {
+				for (const Material* p_material : p_res->materials) {
 					out << p_material->uuid();
 				}
 				out << YAML::EndSeq;
@@ -229,6 +230,108 @@ namespace ORNG {
 		out << YAML::EndMap;
 	}
 
+	void SceneSerializer::CloneEntityComponents(SceneEntity& src, SceneEntity& dst) {
+		ORNG_TRACY_PROFILE;
+
+		{
+			const auto* p_src_transform = src.GetComponent<TransformComponent>();
+			auto* p_transform = dst.GetComponent<TransformComponent>();
+			p_transform->m_pos = p_src_transform->m_pos;
+			p_transform->m_scale = p_src_transform->m_scale;
+			p_transform->m_orientation = p_src_transform->m_orientation;
+			p_transform->m_is_absolute = p_src_transform->m_is_absolute;
+			p_transform->RebuildMatrix(TransformComponent::UpdateType::ALL);
+		}
+
+		if (auto* p_src_mesh = src.GetComponent<MeshComponent>()) {
+			std::vector<const Material*> materials{ p_src_mesh->GetMaterials().begin(), p_src_mesh->GetMaterials().end() };
+			dst.AddComponent<MeshComponent>(p_src_mesh->GetMeshData(), std::move(materials));
+		}
+
+		if (const auto* p_src_light = src.GetComponent<PointLightComponent>()) {
+			auto* p_light = dst.AddComponent<PointLightComponent>();
+			p_light->colour = p_src_light->colour;
+			p_light->attenuation = p_src_light->attenuation;
+			p_light->shadows_enabled = p_src_light->shadows_enabled;
+			p_light->shadow_distance = p_src_light->shadow_distance;
+		}
+
+		if (const auto* p_src_light = src.GetComponent<SpotLightComponent>()) {
+			auto* p_light = dst.AddComponent<SpotLightComponent>();
+			p_light->colour = p_src_light->colour;
+			p_light->attenuation = p_src_light->attenuation;
+			p_light->m_aperture = p_src_light->m_aperture;
+			p_light->shadows_enabled = p_src_light->shadows_enabled;
+			p_light->shadow_distance = p_src_light->shadow_distance;
+		}
+
+		if (const auto* p_src_cam = src.GetComponent<CameraComponent>()) {
+			auto* p_cam = dst.AddComponent<CameraComponent>();
+			p_cam->fov = p_src_cam->fov;
+			p_cam->exposure = p_src_cam->exposure;
+			p_cam->zFar = p_src_cam->zFar;
+			p_cam->zNear = p_src_cam->zNear;
+		}
+
+		if (const auto* p_src_script = src.GetComponent<ScriptComponent>()) {
+			auto* p_script_comp = dst.AddComponent<ScriptComponent>();
+			const auto* p_symbols = p_src_script->GetSymbols();
+			p_script_comp->SetSymbols(p_symbols ? p_symbols : &AssetManager::GetAsset<ScriptAsset>(static_cast<uint64_t>(BaseAssetIDs::DEFAULT_SCRIPT))->symbols);
+		}
+
+		if (const auto* p_src_audio = src.GetComponent<AudioComponent>()) {
+			auto* p_audio = dst.AddComponent<AudioComponent>();
+			p_audio->SetVolume(p_src_audio->m_volume);
+			p_audio->SetPitch(p_src_audio->m_pitch);
+			p_audio->SetSoundAssetUUID(p_src_audio->m_sound_asset_uuid);
+			p_audio->SetMinMaxRange(p_src_audio->m_range.min, p_src_audio->m_range.max);
+		}
+
+		if (const auto* p_src_emitter = src.GetComponent<ParticleEmitterComponent>()) {
+			auto* p_emitter = dst.AddComponent<ParticleEmitterComponent>();
+			p_emitter->m_spread = p_src_emitter->m_spread;
+			p_emitter->m_spawn_extents = p_src_emitter->m_spawn_extents;
+			p_emitter->m_velocity_min_max_scalar = p_src_emitter->m_velocity_min_max_scalar;
+			p_emitter->m_num_particles = p_src_emitter->m_num_particles;
+			p_emitter->m_particle_lifespan_ms = p_src_emitter->m_particle_lifespan_ms;
+			p_emitter->m_particle_spawn_delay_ms = p_src_emitter->m_particle_spawn_delay_ms;
+			p_emitter->acceleration = p_src_emitter->acceleration;
+			p_emitter->m_active = p_src_emitter->m_active;
+			p_emitter->SetType(p_src_emitter->m_type);
+
+			p_emitter->m_life_colour_interpolator.points = p_src_emitter->m_life_colour_interpolator.points;
+			p_emitter->m_life_colour_interpolator.scale = p_src_emitter->m_life_colour_interpolator.scale;
+			p_emitter->m_life_alpha_interpolator.points = p_src_emitter->m_life_alpha_interpolator.points;
+			p_emitter->m_life_alpha_interpolator.scale = p_src_emitter->m_life_alpha_interpolator.scale;
+			p_emitter->m_life_scale_interpolator.points = p_src_emitter->m_life_scale_interpolator.points;
+			p_emitter->m_life_scale_interpolator.scale = p_src_emitter->m_life_scale_interpolator.scale;
+
+			if (p_emitter->GetType() == ParticleEmitterComponent::BILLBOARD) {
+				dst.GetComponent<ParticleBillboardResources>()->p_material = src.GetComponent<ParticleBillboardResources>()->p_material;
+			}
+			else {
+				auto* p_res = dst.GetComponent<ParticleMeshResources>();
+				auto* p_src_res = src.GetComponent<ParticleMeshResources>();
+				p_res->p_mesh = p_src_res->p_mesh;
+				p_res->materials = p_src_res->materials;
+			}
+
+			int dif = static_cast<int>(p_emitter->m_num_particles) - ParticleEmitterComponent::BASE_NUM_PARTICLES;
+			p_emitter->DispatchUpdateEvent(ParticleEmitterComponent::FULL_UPDATE, &dif);
+		}
+
+		if (auto* p_src_buffer = src.GetComponent<ParticleBufferComponent>()) {
+			auto* p_buffer = dst.AddComponent<ParticleBufferComponent>();
+			p_buffer->m_buffer_id = p_src_buffer->m_buffer_id;
+			p_buffer->m_min_allocated_particles = p_src_buffer->m_min_allocated_particles;
+
+			Events::ECS_Event<ParticleBufferComponent> e_event{ e_event.event_type = Events::ECS_EventType::COMP_UPDATED, p_buffer };
+			Events::EventManager::DispatchEvent(e_event);
+		}
+
+		Events::EventManager::DispatchEvent(EntitySerializationEvent{&dst, &src});
+	}
+
 	void SceneSerializer::DeserializePointlightComp(const YAML::Node& light_node, SceneEntity& entity) {
 		auto* p_pointlight_comp = entity.AddComponent<PointLightComponent>();
 		p_pointlight_comp->colour = light_node["Colour"].as<glm::vec3>();
@@ -304,8 +407,8 @@ namespace ORNG {
 		}
 		else {
 			auto* p_res = entity.GetComponent<ParticleMeshResources>();
-			p_res->p_mesh = AssetManager::GetAsset<MeshAsset>(emitter_node["MeshUUID"].as<uint64_t>());
-			p_res->p_mesh = p_res->p_mesh ? p_res->p_mesh : AssetManager::GetAsset<MeshAsset>(static_cast<uint64_t>(BaseAssetIDs::CUBE_MESH));
+			auto* p_mesh = AssetManager::GetAsset<MeshAsset>(emitter_node["MeshUUID"].as<uint64_t>());
+			p_res->p_mesh = p_mesh ? p_mesh : AssetManager::GetAsset<MeshAsset>(static_cast<uint64_t>(BaseAssetIDs::CUBE_MESH));
 
 			auto materials = emitter_node["Materials"];
 			std::vector<uint64_t> material_ids = materials.as<std::vector<uint64_t>>();
@@ -350,6 +453,7 @@ namespace ORNG {
 	}
 
 	void SceneSerializer::DeserializeEntityNodeRef(const YAML::Node& node, EntityNodeRef& ref) {
+		ref.InvalidateCache();
 		for (auto instruction : node["Instructions"]) {
 			ref.m_instructions.push_back(instruction.as<std::string>());
 		}
@@ -385,7 +489,7 @@ namespace ORNG {
 		if (const auto parent_id = entity_node["ParentID"].as<uint64_t>(); !ignore_parent && parent_id != 0 && entity.GetParent() == entt::null) // Parent may be set externally (prefab deserialization)
 			entity.SetParent(*scene.GetEntity(parent_id)); 
 
-		entity.name = entity_node["Name"].as<std::string>();
+		entity.SetName(entity_node["Name"].as<std::string>());
 
 		std::unordered_map<std::string, std::function<void()>> deserializers = {
 			{"TransformComp",[&] { DeserializeTransformComp(entity_node["TransformComp"], entity); }}, 
@@ -534,6 +638,27 @@ namespace ORNG {
 
 	}
 
+	std::future<std::optional<YAML::Node>> SceneSerializer::SerializeSceneAsync(Scene& scene, const std::string& filepath) {
+		ORNG_TRACY_PROFILE;
+
+		// Taking a binary snapshot is much cheaper than emitting YAML, and is the only part that needs the scene
+		std::vector<std::byte> snapshot;
+		BinarySceneSerializer::SerializeScene(scene, snapshot);
+
+		// Absolute so the write isn't affected if the working directory changes (project switch) before the worker runs
+		std::string absolute_path = std::filesystem::absolute(filepath).string();
+
+		return std::async(std::launch::async, [snapshot = std::move(snapshot), absolute_path = std::move(absolute_path)]() -> std::optional<YAML::Node> {
+			std::string yaml;
+			if (!BinarySceneSerializer::ConvertBinaryToYAML(snapshot, yaml) || !WriteTextFileAtomic(absolute_path, yaml)) {
+				ORNG_CORE_ERROR("Failed to save scene to '{0}'", absolute_path);
+				return std::nullopt;
+			}
+
+			return YAML::Load(yaml);
+		});
+	}
+
 	bool SceneSerializer::DeserializeScene(Scene& scene, const std::string& input, bool input_is_filepath, std::optional<YAML::Node*> node) {
 		YAML::Node fallback;
 		YAML::Node& data = node.has_value() ? *node.value() : fallback;
@@ -574,6 +699,12 @@ namespace ORNG {
 			Events::EventManager::DispatchEvent(EntitySerializationEvent{p_entity});
 		}
 
+		DeserializeSceneSettings(scene, data);
+
+		return true;
+	}
+
+	void SceneSerializer::DeserializeSceneSettings(Scene& scene, YAML::Node& data) {
 		// Directional light
 		{
 			const auto& dir_light = data["DirLight"];
@@ -607,7 +738,5 @@ namespace ORNG {
 		}
 
 		Events::EventManager::DispatchEvent(SceneSerializationEvent{&data, scene});
-
-		return true;
 	}
 }
@@ -263,6 +263,38 @@ namespace ORNG {
 		return true;
 	}
 
+	bool WriteTextFileAtomic(const std::string& filepath, const std::string& content) {
+		const std::string temp_path = filepath + ".tmp";
+
+		{
+			std::ofstream out{ temp_path };
+			if (!out.is_open()) {
+				ORNG_CORE_ERROR("Failed to open text file '{0}' for writing", temp_path);
+				return false;
+			}
+
+			out << content;
+			out.flush();
+			if (!out.good()) {
+				ORNG_CORE_ERROR("Failed writing text file '{0}'", temp_path);
+				out.close();
+				TryFileDelete(temp_path);
+				return false;
+			}
+		}
+
+		try {
+			std::filesystem::rename(temp_path, filepath);
+		}
+		catch (const std::exception& e) {
+			ORNG_CORE_ERROR("Failed to replace '{0}' with '{1}', '{2}'", filepath, temp_path, e.what());
+			TryFileDelete(temp_path);
+			return false;
+		}
+
+		return true;
+	}
+
 	bool WriteBinaryFile(const std::string& filepath, std::byte* p_data, size_t size) {
 		std::ofstream out{ filepath, std::ios::binary };
 
@@ -2,6 +2,7 @@
 #include "assets/SoundAsset.h"
 #include "assets/SceneAsset.h"
 #include "rendering/Textures.h"
+#include "assets/AssetHandle.h"
 #include "scene/Scene.h"
 #include "events/Events.h"
 #include "rendering/RenderGraph.h"
@@ -109,7 +110,7 @@ namespace ORNG {
 		void CreateMeshPreview(MeshAsset* p_asset);
 		void OnProjectEvent(const Events::AssetEvent& t_event);
 		bool RenderMaterialEditorSection();
-		bool RenderMaterialTexture(const char* name, Texture2D*& p_tex);
+		bool RenderMaterialTexture(const char* name, AssetHandle<Texture2D>& p_tex);
 		void RenderTextureEditorSection();
 
 		bool RenderDirectory(const std::filesystem::path& path, std::string& active_path);
@@ -161,6 +161,9 @@ namespace ORNG {
 
 		void SaveProject();
 
+		// Applies the result of the in-flight scene save to the scene asset, if wait is true this blocks until the save finishes
+		void FinishSceneSave(bool wait);
+
 		void OpenLoadProjectMenu();
 
 		/*
@@ -188,7 +191,7 @@ namespace ORNG {
 
 		void RenderMeshComponentEditor(MeshComponent* comp);
 
-		void RenderMeshWithMaterials(const MeshAsset* p_asset, std::vector<const Material*>& materials, std::function<void(MeshAsset* p_new)> OnMeshDrop, std::function<void(unsigned index, Material* p_new)> OnMaterialDrop);
+		void RenderMeshWithMaterials(const MeshAsset* p_asset, const std::vector<AssetHandle<const Material>>& materials, std::function<void(MeshAsset* p_new)> OnMeshDrop, std::function<void(unsigned index, Material* p_new)> OnMaterialDrop);
 
 		void RenderPointlightEditor(PointLightComponent* light);
 
@@ -200,6 +203,8 @@ namespace ORNG {
 
 		void RenderPhysicsComponentEditor(PhysicsComponent* p_comp);
 
+		void RenderCharacterControllerEditor(CharacterControllerComponent* p_comp);
+
 		void RenderScriptComponentEditor(ScriptComponent* p_script);
 
 		void RenderAudioComponentEditor(AudioComponent* p_audio);
@@ -282,7 +287,11 @@ namespace ORNG {
 			std::string executable_directory;
 			std::string current_project_directory; // Working directory will always be this
 
-			std::string temp_scene_serialization; // Stores temporary serialized yaml data to load back in after exiting simulation mode
+			std::vector<std::byte> temp_scene_serialization; // Stores temporary serialized binary scene data to load back in after exiting simulation mode
+
+			// Scene saves are written on a worker thread, see SceneSerializer::SerializeSceneAsync
+			std::future<std::optional<YAML::Node>> scene_save_future;
+			uint64_t saving_scene_asset_uuid = 0;
 
 			SelectionMode selection_mode = SelectionMode::ENTITY;
 
@@ -545,7 +545,9 @@ bool AssetManagerWindow::RenderDirectory(const std::filesystem::path& path, std:
 					for (auto& [uuid, asset] : AssetManager::Get().m_assets) {
 						if (!IsFilepathAChildOf(asset->filepath, path)) continue;
 
-						StringReplace(asset->filepath, old_path, new_path);
+						std::string new_asset_path = asset->filepath;
+						StringReplace(new_asset_path, old_path, new_path);
+						AssetManager::SetAssetFilepath(asset, new_asset_path);
 					}
 				} catch(std::exception& e) {
 					ORNG_CORE_ERROR("Failed to rename directory: {}", e.what());
@@ -678,8 +680,9 @@ bool AssetManagerWindow::RenderAddTexture2DAssetWindow() {
 
 	Texture2D* p_new_tex = new Texture2D{new_asset_fp};
 	p_new_tex->SetSpec(m_current_2d_tex_spec);
-	AssetManager::GetSerializer().LoadTexture2D(AssetManager::AddAsset(p_new_tex));
+	// SetSpec overwrites the filepath with the raw image path, must be corrected before the asset is added and indexed
 	p_new_tex->filepath = new_asset_fp;
+	AssetManager::GetSerializer().LoadTexture2D(AssetManager::AddAsset(p_new_tex));
 	new_asset_fp = "";
 	name = "New asset";
 
@@ -945,14 +948,14 @@ void AssetManagerWindow::OnProjectEvent(const Events::AssetEvent& t_event) {
 				const std::string filepath_no_extension = ReplaceFileExtension(filepath, "");
 				for (size_t i = 0; i < assets->materials.size(); i++) {
 					auto* p_mat = assets->materials[i];
-					p_mat->filepath = std::format("{}_mat_{}.omat", filepath_no_extension, p_mat->name.empty() ? std::to_string(i) : StripNonAlphaNumeric(p_mat->name));
+					AssetManager::SetAssetFilepath(p_mat, std::format("{}_mat_{}.omat", filepath_no_extension, p_mat->name.empty() ? std::to_string(i) : StripNonAlphaNumeric(p_mat->name)));
 					AssetManager::GetSerializer().SerializeAssetToBinaryFile(*p_mat, p_mat->filepath);
 				}
 
 				// Serialize textures
 				for (size_t i = 0; i < assets->textures.size(); i++) {
 					auto* p_tex = assets->textures[i];
-					p_tex->filepath = std::format("{}_tex_{}.otex", filepath_no_extension, p_tex->GetName().empty() ? std::to_string(i) : StripNonAlphaNumeric(p_tex->GetName()));
+					AssetManager::SetAssetFilepath(p_tex, std::format("{}_tex_{}.otex", filepath_no_extension, p_tex->GetName().empty() ? std::to_string(i) : StripNonAlphaNumeric(p_tex->GetName())));
 					AssetManager::GetSerializer().SerializeAssetToBinaryFile(*p_tex, p_tex->filepath);
 				}
 			}
@@ -966,6 +969,8 @@ void AssetManagerWindow::OnProjectEvent(const Events::AssetEvent& t_event) {
 		}
 		case Events::AssetEventType::TEXTURE_DELETED:
 		case Events::AssetEventType::TEXTURE_LOADED:
+		case Events::AssetEventType::MESH_DELETED:
+		case Events::AssetEventType::MATERIAL_DELETED:
 			break;
 	}
 }
@@ -1037,13 +1042,19 @@ bool AssetManagerWindow::RenderMaterialEditorSection() {
 		ImGui::InputText("##name input", &mp_selected_material->name);
 		ImGui::Spacing();
 
-		ret |= RenderMaterialTexture("Base", mp_selected_material->base_colour_texture);
-		ret |= RenderMaterialTexture("Normal", mp_selected_material->normal_map_texture);
-		ret |= RenderMaterialTexture("Roughness", mp_selected_material->roughness_texture);
-		ret |= RenderMaterialTexture("Metallic", mp_selected_material->metallic_texture);
-		ret |= RenderMaterialTexture("AO", mp_selected_material->ao_texture);
-		ret |= RenderMaterialTexture("Displacement", mp_selected_material->displacement_texture);
-		ret |= RenderMaterialTexture("Emissive", mp_selected_material->emissive_texture);
+		bool textures_changed = false;
+		textures_changed |= RenderMaterialTexture("Base", mp_selected_material->base_colour_texture);
+		textures_changed |= RenderMaterialTexture("Normal", mp_selected_material->normal_map_texture);
+		textures_changed |= RenderMaterialTexture("Roughness", mp_selected_material->roughness_texture);
+		textures_changed |= RenderMaterialTexture("Metallic", mp_selected_material->metallic_texture);
+		textures_changed |= RenderMaterialTexture("AO", mp_selected_material->ao_texture);
+		textures_changed |= RenderMaterialTexture("Displacement", mp_selected_material->displacement_texture);
+		textures_changed |= RenderMaterialTexture("Emissive", mp_selected_material->emissive_texture);
+
+		if (textures_changed) {
+			AssetManager::OnMaterialTexturesChanged(mp_selected_material);
+			ret = true;
+		}
 
 		ImGui::Text("Colors");
 		ImGui::Spacing();
@@ -1147,7 +1158,7 @@ window_end:
 
 
 
-bool AssetManagerWindow::RenderMaterialTexture(const char* name, Texture2D*& p_tex) {
+bool AssetManagerWindow::RenderMaterialTexture(const char* name, AssetHandle<Texture2D>& p_tex) {
 	bool ret = false;
 	ImGui::PushID(p_tex);
 	if (p_tex) {
@@ -1224,6 +1235,7 @@ void AssetManagerWindow::RenderTextureEditorSection() {
 			m_current_2d_tex_spec.generate_mipmaps = true;
 
 			if (ImGui::Button("Load")) {
+				AssetManager::GetTextureStreamer().StopStreaming(*mp_selected_texture);
 				mp_selected_texture->SetSpec(m_current_2d_tex_spec);
 				mp_selected_texture->LoadFromFile();
 			}
@@ -25,6 +25,7 @@
 
 #include "components/systems/EnvMapSystem.h"
 #include "scene/SceneSerializer.h"
+#include "scene/BinarySceneSerializer.h"
 #include "scene/SerializationUtil.h"
 #include "util/Timers.h"
 #include "assets/AssetManager.h"
@@ -46,6 +47,7 @@
 #include "components/systems/PointlightSystem.h"
 #include "components/systems/SpotlightSystem.h"
 #include "components/systems/SceneUBOSystem.h"
+#include "components/systems/TextureStreamingSystem.h"
 
 #include "components/PhysicsComponent.h"
 #include "components/systems/PhysicsSystem.h"
@@ -72,6 +74,8 @@ void EditorLayer::Init() {
 	m_state.executable_directory = buffer;
 	m_state.executable_directory = m_state.executable_directory.substr(0, m_state.executable_directory.find_last_of('\\'));
 
+	SetScene(mp_scene_context);
+
 	InitImGui();
 	InitLua();
 	m_logger_ui.Init();
@@ -220,7 +224,7 @@ void EditorLayer::UpdateSceneDisplayRect() {
 
 void EditorLayer::BeginPlayScene() {
 	ORNG_TRACY_PROFILE;
-	SceneSerializer::SerializeScene(*SCENE, m_state.temp_scene_serialization, true);
+	BinarySceneSerializer::SerializeScene(*SCENE, m_state.temp_scene_serialization);
 	m_state.simulate_mode_active = true;
 
 	// Set to fullscreen so mouse coordinate and gui operations in scripts work correctly as they would in a runtime layer
@@ -255,7 +259,7 @@ void EditorLayer::EndPlayScene() {
 	mp_editor_camera = nullptr;
 
 	SCENE->ClearAllEntities();
-	SceneSerializer::DeserializeScene(*SCENE, m_state.temp_scene_serialization, false);
+	BinarySceneSerializer::DeserializeScene(*SCENE, m_state.temp_scene_serialization);
 
 	// Reset render graph in case scripts have changed it
 	RenderGraph& render_graph = m_state.use_vr_in_simulation ? *m_state.p_vr_render_graph.get() : m_render_graph;
@@ -354,6 +358,8 @@ void EditorLayer::ShutdownVrForSimulationMode() {
 
 
 void EditorLayer::OnShutdown() {
+	FinishSceneSave(true);
+
 	if (m_state.simulate_mode_active)
 		EndPlayScene();
 
@@ -482,6 +488,8 @@ void EditorLayer::Update() {
 	ORNG_PROFILE_FUNC();
 	m_state.item_selected_this_frame = false;
 
+	FinishSceneSave(false);
+
 	PollKeybinds();
 
 	UpdateEditorCam();
@@ -1102,27 +1110,43 @@ void EditorLayer::OpenLoadProjectMenu() {
 }
 
 void EditorLayer::SaveProject() {
-	std::string uuid_filepath{ "./res/scripts/includes/uuids.h" };
+	// Only one save in flight at a time so saves can't complete out of order
+	FinishSceneSave(true);
+
 	AssetManager::GetSerializer().SerializeAssets();
 	auto* p_scene_asset = AssetManager::GetAsset<SceneAsset>(SCENE->m_asset_uuid());
 	std::string write_path = p_scene_asset ? p_scene_asset->filepath : "res/scene_temp.oscene";
-	std::string serialized;
 
 	if (!p_scene_asset) {
 		SCENE->m_asset_uuid = UUID<uint64_t>{};
 		p_scene_asset = AssetManager::AddAsset(new SceneAsset{"res/scene_temp.oscene", SCENE->m_asset_uuid()});
 	}
 
-	SceneSerializer::SerializeScene(*SCENE, serialized, true);
-	WriteTextFile(write_path, serialized);
+	m_state.scene_save_future = SceneSerializer::SerializeSceneAsync(*SCENE, write_path);
+	m_state.saving_scene_asset_uuid = p_scene_asset->uuid();
+
+	SerializeProjectToFile(m_state.current_project_directory + "/project.oproj");
+}
+
+void EditorLayer::FinishSceneSave(bool wait) {
+	if (!m_state.scene_save_future.valid())
+		return;
+
+	if (!wait && m_state.scene_save_future.wait_for(std::chrono::nanoseconds(1)) != std::future_status::ready)
+		return;
+
+	// Empty if the save failed, the scene asset and uuid file are left as they were
+	std::optional<YAML::Node> saved = m_state.scene_save_future.get();
+	if (!saved)
+		return;
 
 	// Update scene asset contents
-	p_scene_asset->node = YAML::Load(serialized);
+	if (auto* p_scene_asset = AssetManager::GetAsset<SceneAsset>(m_state.saving_scene_asset_uuid))
+		p_scene_asset->node = std::move(*saved);
 
 	// Update UUID file
+	std::string uuid_filepath{ "./res/scripts/includes/uuids.h" };
 	SceneSerializer::SerializeSceneUUIDs(AssetManager::GetView<SceneAsset>(), uuid_filepath);
-
-	SerializeProjectToFile(m_state.current_project_directory + "/project.oproj");
 }
 
 void EditorLayer::GenerateGameRuntimeSettings(const std::string &output_path, const RuntimeSettings& settings) {
@@ -1311,6 +1335,7 @@ bool EditorLayer::ValidateProjectDir([[maybe_unused]] const std::string& dir_pat
 
 void EditorLayer::AddDefaultSceneSystems() {
 	SCENE->AddSystem(new CameraSystem{ SCENE }, 0);
+	SCENE->AddSystem(new WorldPartitionSystem{ SCENE }, 500);
 	SCENE->AddSystem(new EnvMapSystem{ SCENE }, 1000);
 	SCENE->AddSystem(new AudioSystem{ SCENE }, 2000);
 	SCENE->AddSystem(new PointlightSystem{ SCENE }, 3000);
@@ -1321,18 +1346,23 @@ void EditorLayer::AddDefaultSceneSystems() {
 	SCENE->AddSystem(new ScriptSystem{ SCENE }, 8000);
 	SCENE->AddSystem(new SceneUBOSystem{ SCENE }, 9000);
 	SCENE->AddSystem(new MeshInstancingSystem{ SCENE }, 10000);
+	SCENE->AddSystem(new TextureStreamingSystem{ SCENE }, 11000);
 }
 
 
 bool EditorLayer::MakeProjectActive(const std::string& folder_path) {
 	ORNG_CORE_INFO("Attempting to make project '{0}' active", folder_path);
 
+	// Completion writes the uuid header relative to the working directory, so it must finish before the project changes
+	FinishSceneSave(true);
+
 	if (ValidateProjectDir(folder_path)) {
 		if (m_state.simulate_mode_active)
 			EndPlayScene();
 
 		m_state.current_project_directory = std::filesystem::absolute(folder_path).string();
 		std::filesystem::current_path(folder_path);
+		AssetManager::OnWorkingDirectoryChanged();
 
 		// Update resources
 		FileCopy(GetApplicationExecutableDirectory() + "/res/", m_state.current_project_directory + "/res/", true);
@@ -1616,7 +1646,7 @@ void EditorLayer::UpdateLuaEntityArray() {
 		auto rot = p_transform->GetOrientation();
 
 		std::string entity_push_script = std::format("entity_array[{0}] = entity.new(\"{1}\", {2}, vec3.new({3}, {4}, {5}),  vec3.new({6}, {7}, {8}), vec3.new({9}, {10}, {11}), {12})",
-			i+1, p_ent->name, static_cast<unsigned>(p_ent->GetEnttHandle()), pos.x, pos.y, pos.z, scale.x, scale.y, scale.z, rot.x, rot.y, rot.z,
+			i+1, p_ent->GetName(), static_cast<unsigned>(p_ent->GetEnttHandle()), pos.x, pos.y, pos.z, scale.x, scale.y, scale.z, rot.x, rot.y, rot.z,
 			static_cast<unsigned>(p_relation_comp->parent));
 
 		m_lua_cli.GetLua().script(entity_push_script);
@@ -1646,7 +1676,7 @@ void EditorLayer::InitLua() {
 		auto* p_transform = p_ent->GetComponent<TransformComponent>();
 		auto* p_relation_comp = p_ent->GetComponent<RelationshipComponent>();
 
-		return LuaEntity{ p_ent->name, static_cast<unsigned>(p_ent->GetEnttHandle()), p_transform->GetPosition(),
+		return LuaEntity{ p_ent->GetName(), static_cast<unsigned>(p_ent->GetEnttHandle()), p_transform->GetPosition(),
 			p_transform->GetScale(), p_transform->GetOrientation(), static_cast<unsigned>(p_relation_comp->parent)};
 		});
 
@@ -1654,6 +1684,43 @@ void EditorLayer::InitLua() {
 		m_logger_ui.ClearLogs();
 	});
 
+	lua.set_function("physics_stats", [this] {
+		if (!SCENE->HasSystem<PhysicsSystem>())
+			return;
+
+		auto stats = SCENE->GetSystem<PhysicsSystem>().GetStats();
+		ORNG_CORE_INFO("Physics bodies: {0}/{1} ({2} active), contacts last step: {3} ({4} events), temp allocator high-water mark: {5:.2f}/{6:.2f} MB", stats.num_bodies, stats.max_bodies,
+			stats.num_active_bodies, stats.num_contacts, stats.num_contact_events, static_cast<double>(stats.temp_allocator_high_water_mark) / (1024.0 * 1024.0), static_cast<double>(stats.temp_allocator_size) / (1024.0 * 1024.0));
+	});
+
+	lua.set_function("start_physics_recording", [this] {
+		SCENE->GetSystem<PhysicsSystem>().StartRecording();
+	});
+
+	lua.set_function("stop_physics_recording", [this](sol::optional<std::string> filepath) {
+		std::vector<std::byte> recording;
+		if (!SCENE->GetSystem<PhysicsSystem>().StopRecording(recording)) {
+			ORNG_CORE_ERROR("No physics recording in progress");
+			return;
+		}
+
+		const std::string path = filepath.value_or("./res/physics-recording.ophys");
+		if (WriteBinaryFile(path, recording.data(), recording.size()))
+			ORNG_CORE_INFO("Physics recording written to '{0}', {1:.2f} MB", path, static_cast<double>(recording.size()) / (1024.0 * 1024.0));
+	});
+
+	lua.set_function("validate_gpu_light_clusters", [this] {
+		auto* p_graph = SCENE->GetRenderGraph();
+		auto* p_lighting_pass = p_graph ? p_graph->GetRenderpass<LightingPass>() : nullptr;
+		if (!p_lighting_pass) {
+			ORNG_CORE_ERROR("No lighting pass to validate light clusters in");
+			return;
+		}
+
+		// Checked when the pass next runs, after the cluster shader has been dispatched
+		p_lighting_pass->validate_light_clusters = true;
+	});
+
 	std::string util_script = R"(
 		entity_array = {}
 		pos = 0;
@@ -1817,7 +1884,7 @@ EntityNodeData EditorLayer::RenderEntityNode(SceneEntity* p_entity, unsigned int
 	static std::string formatted_name; // Static to stop a new string being made every single call, only needed for c_str anyway
 	formatted_name.clear();
 
-	formatted_name = p_entity->name + " ";
+	formatted_name = p_entity->GetName() + " ";
 	if (ImGui::IsItemVisible()) {
 		formatted_name += p_entity->HasComponent<MeshComponent>() ? " " ICON_FA_BOX : "";
 		formatted_name += p_entity->HasComponent<PhysicsComponent>() || p_entity->HasComponent<PhysicsComponent>() ? " " ICON_FA_BEZIER_CURVE : "";
@@ -2053,7 +2120,9 @@ void EditorLayer::DisplayEntityEditor() {
 		}
 
 		ImGui::PushFont(m_res.p_l_font);
-		ExtraUI::AlphaNumTextInput(entity->name);
+		std::string name = entity->GetName();
+		if (ExtraUI::AlphaNumTextInput(name))
+			entity->SetName(name);
 		ImGui::SameLine(ImGui::GetContentRegionAvail().x - 55);
 		RenderCreationWidget(entity, ImGui::Button("+"));
 		ImGui::PopFont();
@@ -2064,6 +2133,7 @@ void EditorLayer::DisplayEntityEditor() {
 		RenderCompEditor<SpotLightComponent>(entity, "Spotlight component", [this](SpotLightComponent* p_comp) { RenderSpotlightEditor(p_comp); });
 		RenderCompEditor<CameraComponent>(entity, "Camera component", [this](CameraComponent* p_comp) { RenderCameraEditor(p_comp); });
 		RenderCompEditor<PhysicsComponent>(entity, "Physics component", [this](PhysicsComponent* p_comp) { RenderPhysicsComponentEditor(p_comp); });
+		RenderCompEditor<CharacterControllerComponent>(entity, "Character controller component", [this](CharacterControllerComponent* p_comp) { RenderCharacterControllerEditor(p_comp); });
 		RenderCompEditor<ScriptComponent>(entity, "Script component", [this](ScriptComponent* p_comp) { RenderScriptComponentEditor(p_comp); });
 		RenderCompEditor<AudioComponent>(entity, "Audio component", [this](AudioComponent* p_comp) { RenderAudioComponentEditor(p_comp); });
 		RenderCompEditor<ParticleEmitterComponent>(entity, "Particle emitter component", [this](ParticleEmitterComponent* p_comp) { RenderParticleEmitterComponentEditor(p_comp); });
@@ -2412,6 +2482,19 @@ void EditorLayer::RenderPhysicsComponentEditor(PhysicsComponent* p_comp) {
 			p_comp->SetTrigger(is_trigger);
 		}
 
+		const auto& layers = SCENE->GetSystem<PhysicsSystem>().GetSettings().layers;
+		const bool auto_layer = p_comp->GetLayer() >= layers.size();
+		if (ImGui::BeginCombo("Layer", auto_layer ? "Auto" : layers[p_comp->GetLayer()].name.c_str())) {
+			if (ImGui::Selectable("Auto", auto_layer))
+				p_comp->SetLayer(Layers::AUTO);
+
+			for (size_t i = 0; i < layers.size(); i++) {
+				if (ImGui::Selectable(layers[i].name.c_str(), p_comp->GetLayer() == i))
+					p_comp->SetLayer(static_cast<JPH::ObjectLayer>(i));
+			}
+			ImGui::EndCombo();
+		}
+
 		ImGui::TableNextColumn();
 		ImGui::SeparatorText("Material");
 		ImGui::Button(ICON_FA_FILE, { 125, 125 });
@@ -2422,6 +2505,21 @@ void EditorLayer::RenderPhysicsComponentEditor(PhysicsComponent* p_comp) {
 
 
 
+void EditorLayer::RenderCharacterControllerEditor(CharacterControllerComponent* p_comp) {
+	float radius = p_comp->GetRadius();
+	float height = p_comp->GetHeight();
+	bool shape_changed = ImGui::DragFloat("Radius", &radius, 0.01f, 0.01f, 10.f);
+	shape_changed |= ImGui::DragFloat("Height", &height, 0.01f, 0.02f, 20.f);
+
+	if (shape_changed)
+		p_comp->SetShape(radius, height);
+
+	ImGui::SliderFloat("Max slope", &p_comp->max_slope_degrees, 0.f, 90.f, "%.1f deg");
+	ImGui::DragFloat("Step height", &p_comp->step_height, 0.01f, 0.f, 5.f);
+	ImGui::DragFloat("Stick to floor", &p_comp->stick_to_floor_distance, 0.01f, 0.f, 5.f);
+	ImGui::Checkbox("Gravity", &p_comp->use_gravity);
+}
+
 void EditorLayer::RenderTransformComponentEditor(std::vector<TransformComponent*>& transforms) {
 	static bool render_gizmos = true;
 
@@ -2584,7 +2682,7 @@ Material* EditorLayer::RenderMaterialComponent(const Material* p_material) {
 
 
 
-void EditorLayer::RenderMeshWithMaterials(const MeshAsset* p_asset, std::vector<const Material*>& materials, std::function<void(MeshAsset* p_new)> OnMeshDrop, std::function<void(unsigned index, Material* p_new)> OnMaterialDrop) {
+void EditorLayer::RenderMeshWithMaterials(const MeshAsset* p_asset, const std::vector<AssetHandle<const Material>>& materials, std::function<void(MeshAsset* p_new)> OnMeshDrop, std::function<void(unsigned index, Material* p_new)> OnMaterialDrop) {
 	ImGui::PushID(p_asset);
 
 	ImGui::SeparatorText("Mesh");
@@ -2600,7 +2698,7 @@ void EditorLayer::RenderMeshWithMaterials(const MeshAsset* p_asset, std::vector<
 
 	ImGui::SeparatorText("Materials");
 	for (size_t i = 0; i < materials.size(); i++) {
-		auto p_material = materials[i];
+		const Material* p_material = materials[i];
 		ImGui::PushID(static_cast<int>(i));
 
 		if (auto* p_new_material = RenderMaterialComponent(p_material)) {
@@ -2887,6 +2985,8 @@ void EditorLayer::DeselectEntity(uint64_t id) {
 
 void EditorLayer::SetScene(Scene* p_scene) {
 	mp_scene_context = p_scene;
+	// Assets browsed in the editor shouldn't be unloaded just because the open scene doesn't reference them
+	p_scene->unload_unreferenced_assets_on_load = false;
 	m_asset_manager_window.SetScene(p_scene);
 }
 
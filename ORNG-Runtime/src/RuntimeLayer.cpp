@@ -78,6 +78,7 @@ void RuntimeLayer::OnInit() {
 		};
 
 	m_scene.AddSystem(new CameraSystem{ &m_scene }, 0);
+	m_scene.AddSystem(new WorldPartitionSystem{ &m_scene }, 500);
 	m_scene.AddSystem(new EnvMapSystem{ &m_scene }, 1000);
 	m_scene.AddSystem(new AudioSystem{ &m_scene }, 2000);
 	m_scene.AddSystem(new PointlightSystem{ &m_scene }, 3000);
@@ -89,6 +90,7 @@ void RuntimeLayer::OnInit() {
 	m_scene.AddSystem(new ScriptSystem{ &m_scene }, 8000);
 	m_scene.AddSystem(new SceneUBOSystem{ &m_scene }, 9000);
 	m_scene.AddSystem(new MeshInstancingSystem{ &m_scene }, 10000);
+	m_scene.AddSystem(new TextureStreamingSystem{ &m_scene }, 11000);
 	Events::EventManager::RegisterListener(m_window_event_listener);
 	AssetManager::GetSerializer().LoadAssetsFromProjectPath("./");
 	m_scene.LoadScene();
@@ -103,8 +105,16 @@ void RuntimeLayer::OnInit() {
 	}
 
 	ORNG_CORE_INFO("Loading scene: '{}'", p_start_scene->uuid());
-	SceneSerializer::DeserializeScene(m_scene, "", false, &p_start_scene->node);
-	m_scene.Start();
+	// Instantiated over the first few frames instead of stalling startup
+	// Every project asset was loaded above, the ones the start scene doesn't use are unloaded once it finishes, see Scene::unload_unreferenced_assets_on_load
+	m_scene.LoadAsync(*p_start_scene, [](Scene& scene, bool success) {
+		if (!success) {
+			ORNG_CORE_CRITICAL("Start scene failed to load, exiting\n");
+			BREAKPOINT;
+		}
+
+		scene.Start();
+		});
 }
 
 void RuntimeLayer::InitVR() {